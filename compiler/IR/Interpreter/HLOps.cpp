@@ -185,6 +185,34 @@ static void printCondBranchOp(OpAsmPrinter *p, CondBranchOp op) {
   p->printSuccessorAndUseList(op.getOperation(), CondBranchOp::falseIndex);
 }
 
+//===----------------------------------------------------------------------===//
+// Binary elementwise ops
+//===----------------------------------------------------------------------===//
+
+// Verifies that both operand shapes broadcast to the result shape. Operand
+// shapes are aligned to the trailing result dimensions and each operand
+// dimension must either match the result dimension or be 1.
+static LogicalResult verifyBinaryElementwiseOp(Operation *op) {
+  auto resultShape = op->getResult(0)->getType().cast<ShapedType>().getShape();
+  for (auto *operand : op->getOperands()) {
+    auto operandType = operand->getType().cast<ShapedType>();
+    auto operandShape = operandType.getShape();
+    bool isBroadcastable = operandShape.size() <= resultShape.size();
+    for (int i = 1; isBroadcastable && i <= operandShape.size(); ++i) {
+      int64_t operandDim = operandShape[operandShape.size() - i];
+      int64_t resultDim = resultShape[resultShape.size() - i];
+      isBroadcastable = operandDim == resultDim || operandDim == 1;
+    }
+    if (!isBroadcastable) {
+      return op->emitOpError()
+             << "operand type " << operandType
+             << " does not broadcast to result type "
+             << op->getResult(0)->getType();
+    }
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hl_interp.concat
 //===----------------------------------------------------------------------===//
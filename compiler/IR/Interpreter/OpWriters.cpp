@@ -166,6 +166,28 @@ LogicalResult writeOp(IREEInterp::LL::CmpFOp op, BytecodeWriter *writer) {
   return success();
 }
 
+LogicalResult writeOp(IREEInterp::LL::CmpSelectIOp op,
+                      BytecodeWriter *writer) {
+  RETURN_IF_FAILURE(writer->WriteOpcode(iree::InterpreterOpcode::kCmpSelectI));
+  RETURN_IF_FAILURE(
+      writer->WriteUint8(static_cast<uint8_t>(op.predicate().getZExtValue())));
+  for (auto *operand : op.getOperands()) {
+    RETURN_IF_FAILURE(writer->WriteLocal(operand));
+  }
+  return success();
+}
+
+LogicalResult writeOp(IREEInterp::LL::CmpSelectFOp op,
+                      BytecodeWriter *writer) {
+  RETURN_IF_FAILURE(writer->WriteOpcode(iree::InterpreterOpcode::kCmpSelectF));
+  RETURN_IF_FAILURE(
+      writer->WriteUint8(static_cast<uint8_t>(op.predicate().getZExtValue())));
+  for (auto *operand : op.getOperands()) {
+    RETURN_IF_FAILURE(writer->WriteLocal(operand));
+  }
+  return success();
+}
+
 LogicalResult writeOp(IREEInterp::LL::AllocHeapOp op, BytecodeWriter *writer) {
   auto memrefType = op.getType().cast<MemRefType>();
   RETURN_IF_FAILURE(writer->WriteOpcode(iree::InterpreterOpcode::kAllocHeap));
@@ -177,6 +199,18 @@ LogicalResult writeOp(IREEInterp::LL::AllocHeapOp op, BytecodeWriter *writer) {
   return success();
 }
 
+LogicalResult writeOp(IREEInterp::LL::AllocStackOp op,
+                      BytecodeWriter *writer) {
+  auto memrefType = op.getType().cast<MemRefType>();
+  RETURN_IF_FAILURE(writer->WriteOpcode(iree::InterpreterOpcode::kAllocStack));
+  RETURN_IF_FAILURE(writer->WriteInt32(0));
+  RETURN_IF_FAILURE(writer->WriteTypeIndex(memrefType.getElementType()));
+  RETURN_IF_FAILURE(writer->WriteShapePieces(memrefType));
+  RETURN_IF_FAILURE(writer->WriteLocals(op.getOperands()));
+  RETURN_IF_FAILURE(writer->WriteLocal(op.getResult()));
+  return success();
+}
+
 LogicalResult writeOp(IREEInterp::LL::StaticCopyOp op, BytecodeWriter *writer) {
   RETURN_IF_FAILURE(writer->WriteOpcode(iree::InterpreterOpcode::kStaticCopy));
   RETURN_IF_FAILURE(writer->WriteLocal(op.src()));
@@ -247,7 +281,10 @@ void registerInterpreterCustomWriters(VMFunctionBuilder *builder) {
   REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::ConvertUSOp);
   REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::CmpIOp);
   REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::CmpFOp);
+  REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::CmpSelectIOp);
+  REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::CmpSelectFOp);
   REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::AllocHeapOp);
+  REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::AllocStackOp);
   REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::StaticCopyOp);
   REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::ReduceSumIOp);
   REGISTER_CUSTOM_WRITER_IMPL(IREEInterp::LL::ReduceSumFOp);
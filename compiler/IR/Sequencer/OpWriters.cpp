@@ -199,7 +199,7 @@ LogicalResult writeOp(IREESeq::LL::AllocHeapOp op, BytecodeWriter *writer) {
 LogicalResult writeOp(IREESeq::LL::ComputeRangeOp op, BytecodeWriter *writer) {
   RETURN_IF_FAILURE(writer->WriteOpcode(iree::SequencerOpcode::kComputeRange));
   RETURN_IF_FAILURE(writer->WriteLocal(op.shape()));
-  RETURN_IF_FAILURE(writer->WriteUint8(op.elementSize().getZExtValue()));
+  RETURN_IF_FAILURE(writer->WriteInt32(op.elementSize().getZExtValue()));
   RETURN_IF_FAILURE(writer->WriteLocal(op.indices()));
   RETURN_IF_FAILURE(writer->WriteLocal(op.lengths()));
   RETURN_IF_FAILURE(writer->WriteLocal(op.dstOffset()));
@@ -212,7 +212,8 @@ LogicalResult writeOp(IREESeq::LL::StaticSliceOp op, BytecodeWriter *writer) {
   RETURN_IF_FAILURE(writer->WriteLocal(op.src()));
   RETURN_IF_FAILURE(writer->WriteInt32(op.offset().getZExtValue()));
   RETURN_IF_FAILURE(writer->WriteInt32(op.length().getZExtValue()));
-  RETURN_IF_FAILURE(writer->WriteTypeIndex(op.getResult()->getType()));
+  RETURN_IF_FAILURE(writer->WriteTypeIndex(
+      op.getResult()->getType().cast<MemRefType>().getElementType()));
   RETURN_IF_FAILURE(
       writer->WriteShapePieces(op.getResult()->getType().cast<ShapedType>()));
   RETURN_IF_FAILURE(writer->WriteLocal(op.getResult()));
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "third_party/llvm/llvm/include/llvm/ADT/APFloat.h"
 #include "third_party/llvm/llvm/include/llvm/ADT/DenseSet.h"
+#include "third_party/llvm/llvm/include/llvm/ADT/STLExtras.h"
 #include "third_party/llvm/llvm/include/llvm/ADT/SmallVector.h"
 #include "third_party/llvm/llvm/include/llvm/Support/Allocator.h"
 #include "third_party/llvm/llvm/include/llvm/Support/Casting.h"
@@ -133,6 +135,447 @@ class SimpleOpLowering : public OpRewritePattern<SrcOp> {
   }
 };
 
+// Returns true if |op| computes each element of its output solely from the
+// elements at the same position of its inputs. The runtime kernels read each
+// input element before writing the corresponding output element so such ops
+// may safely write their output over one of their inputs.
+bool isElementwiseOp(Operation *op) {
+  return isa<IREEInterp::LL::NotOp>(op) || isa<IREEInterp::LL::AndOp>(op) ||
+         isa<IREEInterp::LL::OrOp>(op) || isa<IREEInterp::LL::XorOp>(op) ||
+         isa<IREEInterp::LL::AddIOp>(op) || isa<IREEInterp::LL::AddFOp>(op) ||
+         isa<IREEInterp::LL::SubIOp>(op) || isa<IREEInterp::LL::SubFOp>(op) ||
+         isa<IREEInterp::LL::AbsIOp>(op) || isa<IREEInterp::LL::AbsFOp>(op) ||
+         isa<IREEInterp::LL::MulIOp>(op) || isa<IREEInterp::LL::MulFOp>(op) ||
+         isa<IREEInterp::LL::DivISOp>(op) ||
+         isa<IREEInterp::LL::DivIUOp>(op) || isa<IREEInterp::LL::DivFOp>(op) ||
+         isa<IREEInterp::LL::ExpFOp>(op) || isa<IREEInterp::LL::LogFOp>(op) ||
+         isa<IREEInterp::LL::RsqrtFOp>(op) || isa<IREEInterp::LL::CosFOp>(op) ||
+         isa<IREEInterp::LL::SinFOp>(op) || isa<IREEInterp::LL::TanhFOp>(op) ||
+         isa<IREEInterp::LL::MinISOp>(op) ||
+         isa<IREEInterp::LL::MinIUOp>(op) || isa<IREEInterp::LL::MinFOp>(op) ||
+         isa<IREEInterp::LL::MaxISOp>(op) ||
+         isa<IREEInterp::LL::MaxIUOp>(op) || isa<IREEInterp::LL::MaxFOp>(op) ||
+         isa<IREEInterp::LL::ClampFOp>(op) ||
+         isa<IREEInterp::LL::FloorFOp>(op) ||
+         isa<IREEInterp::LL::CeilFOp>(op) ||
+         isa<IREEInterp::LL::AddMaxFOp>(op) ||
+         isa<IREEInterp::LL::CmpSelectIOp>(op) ||
+         isa<IREEInterp::LL::CmpSelectFOp>(op);
+}
+
+// Returns the only op reading the temporary |value| written as the output of
+// |producer|, or nullptr if |value| is not a local allocation used solely to
+// pass data between the two ops. Only allocations and constants may appear
+// between them so that running |producer| as part of the consumer cannot
+// reorder it with respect to any other buffer access.
+Operation *getTemporaryConsumer(Value *value, Operation *producer) {
+  auto *allocOp = value->getDefiningOp();
+  if (!allocOp || !isa<IREEInterp::LL::AllocHeapOp>(allocOp) ||
+      allocOp->getBlock() != producer->getBlock() ||
+      allocOp->getNumOperands()) {
+    return nullptr;
+  }
+  Operation *consumer = nullptr;
+  for (auto &use : value->getUses()) {
+    auto *user = use.getOwner();
+    if (user == producer) {
+      if (use.getOperandNumber() != producer->getNumOperands() - 1) {
+        return nullptr;
+      }
+    } else if (consumer && consumer != user) {
+      return nullptr;
+    } else {
+      consumer = user;
+    }
+  }
+  if (!consumer || consumer->getBlock() != producer->getBlock() ||
+      !producer->isBeforeInBlock(consumer)) {
+    return nullptr;
+  }
+  for (auto *op = producer->getNextNode(); op != consumer;
+       op = op->getNextNode()) {
+    if (!isa<IREEInterp::LL::AllocHeapOp>(op) &&
+        !isa<IREEInterp::LL::AllocStackOp>(op) &&
+        !isa<IREEInterp::LL::ConstantOp>(op)) {
+      return nullptr;
+    }
+  }
+  return consumer;
+}
+
+Type getElementType(Value *value) {
+  return value->getType().cast<MemRefType>().getElementType();
+}
+
+// Replaces common pairs of elementwise ops communicating through a temporary
+// buffer with a single fused op. Each fused op runs one bytecode dispatch and
+// keeps the intermediate values in cache instead of writing and reading back
+// a full-sized temporary.
+//
+// Example:
+//   %t = iree_ll_interp.alloc_heap() : memref<4xf32>
+//   iree_ll_interp.add_f(%x, %bias, %t)
+//   iree_ll_interp.max_f(%t, %zero, %dst)
+//  ->
+//   iree_ll_interp.add_max_f(%x, %bias, %zero, %dst)
+void fuseElementwiseOps(FuncOp funcOp) {
+  for (auto &block : funcOp) {
+    SmallVector<Operation *, 8> producerOps;
+    for (auto &op : block) {
+      if (isa<IREEInterp::LL::AddFOp>(op) || isa<IREEInterp::LL::CmpIOp>(op) ||
+          isa<IREEInterp::LL::CmpFOp>(op)) {
+        producerOps.push_back(&op);
+      }
+    }
+    for (auto *producerOp : producerOps) {
+      auto *temp = producerOp->getOperand(producerOp->getNumOperands() - 1);
+      auto *consumerOp = getTemporaryConsumer(temp, producerOp);
+      if (!consumerOp) continue;
+
+      OpBuilder builder(consumerOp);
+      ArrayRef<Type> resultTypes;
+      if (auto addOp = dyn_cast<IREEInterp::LL::AddFOp>(producerOp)) {
+        // max(a + b, c) only: the fused kernel keeps the sum as the lhs of
+        // the max, which only matches max(c, a + b) when neither is NaN.
+        auto maxOp = dyn_cast<IREEInterp::LL::MaxFOp>(consumerOp);
+        if (!maxOp || maxOp.lhs() != temp || maxOp.dst() == temp) continue;
+        auto *bound = maxOp.rhs();
+        if (bound == temp) continue;
+        SmallVector<Value *, 4> operands{addOp.lhs(), addOp.rhs(), bound,
+                                         maxOp.dst()};
+        // The fused kernel does not broadcast its operands.
+        if (llvm::any_of(operands, [&](Value *operand) {
+              return operand->getType() != maxOp.dst()->getType();
+            })) {
+          continue;
+        }
+        builder.create<IREEInterp::LL::AddMaxFOp>(
+            consumerOp->getLoc(), resultTypes, operands,
+            ArrayRef<NamedAttribute>{});
+      } else {
+        // The fused kernel compares and selects in a single element type.
+        auto selectOp = dyn_cast<IREEInterp::LL::SelectOp>(consumerOp);
+        if (!selectOp || selectOp.cond() != temp ||
+            selectOp.lhs() == temp || selectOp.rhs() == temp ||
+            selectOp.dst() == temp) {
+          continue;
+        }
+        auto elementType = getElementType(producerOp->getOperand(0));
+        if (getElementType(selectOp.lhs()) != elementType ||
+            getElementType(selectOp.rhs()) != elementType ||
+            getElementType(selectOp.dst()) != elementType) {
+          continue;
+        }
+        SmallVector<Value *, 8> operands{
+            producerOp->getOperand(0), producerOp->getOperand(1),
+            selectOp.lhs(), selectOp.rhs(), selectOp.dst()};
+        if (isa<IREEInterp::LL::CmpIOp>(producerOp)) {
+          builder.create<IREEInterp::LL::CmpSelectIOp>(
+              consumerOp->getLoc(), resultTypes, operands,
+              producerOp->getAttrs());
+        } else {
+          builder.create<IREEInterp::LL::CmpSelectFOp>(
+              consumerOp->getLoc(), resultTypes, operands,
+              producerOp->getAttrs());
+        }
+      }
+      auto *tempAllocOp = temp->getDefiningOp();
+      consumerOp->erase();
+      producerOp->erase();
+      tempAllocOp->erase();
+    }
+  }
+}
+
+// Returns true if |bias| has one element per column of the 2D |result| such
+// that it can be added to each row by a fused matmul.
+bool isRowBias(Value *bias, Value *result) {
+  auto biasType = bias->getType().cast<MemRefType>();
+  auto resultType = result->getType().cast<MemRefType>();
+  if (!biasType.hasStaticShape() || !resultType.hasStaticShape() ||
+      biasType.getRank() < 1 || biasType.getRank() > 2 ||
+      resultType.getRank() != 2) {
+    return false;
+  }
+  int64_t columnCount = resultType.getDimSize(1);
+  return biasType.getShape().back() == columnCount &&
+         biasType.getNumElements() == columnCount;
+}
+
+Value *createScalarConstant(OpBuilder &builder, Location loc,
+                            Attribute value) {
+  auto elementType = value.getType();
+  auto valueAttr = DenseElementsAttr::get(
+      RankedTensorType::get({}, elementType), llvm::makeArrayRef(value));
+  return builder
+      .create<IREEInterp::LL::ConstantOp>(
+          loc, ArrayRef<Type>{builder.getMemRefType({}, elementType)},
+          ArrayRef<Value *>{},
+          ArrayRef<NamedAttribute>{builder.getNamedAttr("value", valueAttr)})
+      .getResult();
+}
+
+// Returns true if all elements of |value| are known to be equal, either
+// because it has a single element or because it is a splat constant.
+bool isScalarOperand(Value *value) {
+  auto type = value->getType().cast<MemRefType>();
+  if (type.hasStaticShape() && type.getNumElements() == 1) return true;
+  auto *constantOp = value->getDefiningOp();
+  if (!constantOp || !isa<IREEInterp::LL::ConstantOp>(constantOp)) {
+    return false;
+  }
+  auto valueAttr = constantOp->getAttrOfType<DenseElementsAttr>("value");
+  return valueAttr && valueAttr.isSplat();
+}
+
+// Returns a buffer whose first element is the value shared by all elements of
+// |value|, creating a scalar constant with |builder| if needed. |value| must
+// satisfy isScalarOperand.
+Value *getScalarOperand(Value *value, OpBuilder &builder) {
+  auto type = value->getType().cast<MemRefType>();
+  if (type.hasStaticShape() && type.getNumElements() == 1) return value;
+  auto *constantOp = value->getDefiningOp();
+  auto valueAttr = constantOp->getAttrOfType<DenseElementsAttr>("value");
+  return createScalarConstant(builder, constantOp->getLoc(),
+                              valueAttr.getSplatValue());
+}
+
+// Folds the bias add and clamping activation (max_f/min_f against a splat,
+// such as relu) that commonly follow a matmul into a single matmul_bias_f that
+// ruy applies while writing the result. This drops two full passes over the
+// output of dense layers.
+//
+// Example:
+//   %t0 = iree_ll_interp.alloc_heap() : memref<4x8xf32>
+//   iree_ll_interp.matmul_f(%x, %w, %t0)
+//   %t1 = iree_ll_interp.alloc_heap() : memref<4x8xf32>
+//   iree_ll_interp.add_f(%t0, %bias, %t1)
+//   iree_ll_interp.max_f(%t1, %zero, %dst)
+//  ->
+//   iree_ll_interp.matmul_bias_f(%x, %w, %bias, %zero, %inf, %dst)
+void fuseMatMulEpilogues(FuncOp funcOp) {
+  for (auto &block : funcOp) {
+    SmallVector<IREEInterp::LL::MatMulFOp, 8> matMulOps;
+    for (auto &op : block) {
+      if (auto matMulOp = dyn_cast<IREEInterp::LL::MatMulFOp>(op)) {
+        matMulOps.push_back(matMulOp);
+      }
+    }
+    for (auto matMulOp : matMulOps) {
+      auto *temp = matMulOp.dst();
+      auto addOp = dyn_cast_or_null<IREEInterp::LL::AddFOp>(
+          getTemporaryConsumer(temp, matMulOp));
+      if (!addOp || addOp.dst() == temp ||
+          addOp.dst()->getType() != temp->getType()) {
+        continue;
+      }
+      auto *bias = addOp.lhs() == temp ? addOp.rhs() : addOp.lhs();
+      if (bias == temp || !isRowBias(bias, temp)) continue;
+
+      // Fold at most one max_f and one min_f bounding the biased result.
+      SmallVector<Operation *, 4> fusedOps{matMulOp, addOp};
+      Value *dst = addOp.dst();
+      Value *clampMin = nullptr;
+      Value *clampMax = nullptr;
+      while (auto *consumerOp = getTemporaryConsumer(dst, fusedOps.back())) {
+        bool isMax = isa<IREEInterp::LL::MaxFOp>(consumerOp);
+        bool isMin = isa<IREEInterp::LL::MinFOp>(consumerOp);
+        if ((!isMax || clampMin) && (!isMin || clampMax)) break;
+        auto *lhs = consumerOp->getOperand(0);
+        auto *rhs = consumerOp->getOperand(1);
+        auto *consumerDst = consumerOp->getOperand(2);
+        auto *bound = lhs == dst ? rhs : lhs;
+        if (bound == dst || consumerDst == dst ||
+            consumerDst->getType() != dst->getType()) {
+          break;
+        }
+        if (!isScalarOperand(bound)) break;
+        if (isMax) {
+          clampMin = bound;
+        } else {
+          clampMax = bound;
+        }
+        fusedOps.push_back(consumerOp);
+        dst = consumerDst;
+      }
+
+      // All fused ops have been matched so the IR can now be modified.
+      auto *lastOp = fusedOps.back();
+      OpBuilder builder(lastOp);
+      auto elementType = getElementType(dst);
+      const auto &semantics = elementType.cast<FloatType>().getFloatSemantics();
+      if (clampMin) {
+        clampMin = getScalarOperand(clampMin, builder);
+      } else {
+        clampMin = createScalarConstant(
+            builder, lastOp->getLoc(),
+            builder.getFloatAttr(
+                elementType, APFloat::getInf(semantics, /*Negative=*/true)));
+      }
+      if (clampMax) {
+        clampMax = getScalarOperand(clampMax, builder);
+      } else {
+        clampMax = createScalarConstant(
+            builder, lastOp->getLoc(),
+            builder.getFloatAttr(
+                elementType, APFloat::getInf(semantics, /*Negative=*/false)));
+      }
+      SmallVector<Value *, 8> operands{matMulOp.lhs(), matMulOp.rhs(), bias,
+                                       clampMin,       clampMax,       dst};
+      builder.create<IREEInterp::LL::MatMulBiasFOp>(
+          lastOp->getLoc(), ArrayRef<Type>{}, operands,
+          ArrayRef<NamedAttribute>{});
+
+      SmallVector<Operation *, 4> tempAllocOps;
+      for (auto *op : llvm::reverse(fusedOps)) {
+        if (op != lastOp) {
+          tempAllocOps.push_back(
+              op->getOperand(op->getNumOperands() - 1)->getDefiningOp());
+        }
+        op->erase();
+      }
+      for (auto *tempAllocOp : tempAllocOps) {
+        tempAllocOp->erase();
+      }
+    }
+  }
+}
+
+// Returns true if |value| is a statically-shaped allocation in the block of
+// |op| that is defined before |op| and never referenced after it.
+bool isLocalAllocationDeadAfter(Value *value, Operation *op) {
+  auto *definingOp = value->getDefiningOp();
+  if (!definingOp || definingOp->getBlock() != op->getBlock()) return false;
+  if (!isa<IREEInterp::LL::AllocHeapOp>(definingOp) &&
+      !isa<IREEInterp::LL::AllocStackOp>(definingOp)) {
+    return false;
+  }
+  if (!value->getType().cast<MemRefType>().hasStaticShape()) return false;
+  for (auto &use : value->getUses()) {
+    auto *user = use.getOwner();
+    if (user == op) continue;
+    if (user->getBlock() != op->getBlock() || !user->isBeforeInBlock(op)) {
+      return false;
+    }
+    // Ops with results (reshape, slice, call) may return views of the buffer
+    // that outlive |op|.
+    if (user->getNumResults() > 0) return false;
+  }
+  return true;
+}
+
+// Rewrites elementwise ops to write their output over an input that dies at
+// the op, dropping the separate output allocation. Chains of activations then
+// run entirely within a single buffer.
+//
+// Example:
+//   %1 = iree_ll_interp.alloc_heap() : memref<4xf32>
+//   iree_ll_interp.exp_f(%0, %1)
+//   %2 = iree_ll_interp.alloc_heap() : memref<4xf32>
+//   iree_ll_interp.tanh_f(%1, %2)
+//  ->
+//   iree_ll_interp.exp_f(%0, %0)
+//   iree_ll_interp.tanh_f(%0, %0)
+void reuseDeadOperandBuffers(FuncOp funcOp) {
+  for (auto &block : funcOp) {
+    for (auto &op : block) {
+      if (!isElementwiseOp(&op)) continue;
+      unsigned dstIndex = op.getNumOperands() - 1;
+      auto *dst = op.getOperand(dstIndex);
+      auto *dstAllocOp = dst->getDefiningOp();
+      if (!dstAllocOp || !isa<IREEInterp::LL::AllocHeapOp>(dstAllocOp) ||
+          dstAllocOp->getBlock() != &block || dstAllocOp->getNumOperands()) {
+        continue;
+      }
+      bool dstReadBeforeOp = false;
+      for (auto &use : dst->getUses()) {
+        auto *user = use.getOwner();
+        if ((user == &op && use.getOperandNumber() != dstIndex) ||
+            (user != &op && user->getBlock() == &block &&
+             user->isBeforeInBlock(&op))) {
+          dstReadBeforeOp = true;
+          break;
+        }
+      }
+      if (dstReadBeforeOp) continue;
+      for (unsigned i = 0; i < dstIndex; ++i) {
+        auto *input = op.getOperand(i);
+        if (input->getType() != dst->getType()) continue;
+        if (!isLocalAllocationDeadAfter(input, &op)) continue;
+        dst->replaceAllUsesWith(input);
+        dstAllocOp->erase();
+        break;
+      }
+    }
+  }
+}
+
+// Returns true if the buffer |value| may be referenced after the function
+// returns, either directly or through a value that may alias it.
+bool mayEscapeFunction(Value *value) {
+  SmallVector<Value *, 8> worklist{value};
+  llvm::DenseSet<Value *> visitedValues;
+  while (!worklist.empty()) {
+    auto *currentValue = worklist.pop_back_val();
+    if (!visitedValues.insert(currentValue).second) continue;
+    for (auto &use : currentValue->getUses()) {
+      auto *user = use.getOwner();
+      if (isa<IREEInterp::LL::ReturnOp>(user) || isa<IREE::ReturnOp>(user)) {
+        return true;
+      } else if (!user->getName().getStringRef().startswith(
+                     "iree_ll_interp.")) {
+        // Unknown op; assume it retains the buffer.
+        return true;
+      }
+
+      // Values passed to successors continue as block arguments.
+      for (unsigned i = 0; i < user->getNumSuccessors(); ++i) {
+        unsigned firstOperand = user->getSuccessorOperandIndex(i);
+        unsigned operandIndex = use.getOperandNumber();
+        if (operandIndex >= firstOperand &&
+            operandIndex < firstOperand + user->getNumSuccessorOperands(i)) {
+          worklist.push_back(
+              user->getSuccessor(i)->getArgument(operandIndex - firstOperand));
+        }
+      }
+
+      // Ops returning real results (like reshape or call) may return views of
+      // or references to their operands.
+      if (!opTakesOutputOperands(user->getName().getStringRef())) {
+        for (auto *result : user->getResults()) {
+          worklist.push_back(result);
+        }
+      }
+    }
+  }
+  return false;
+}
+
+// Replaces statically-shaped alloc_heap ops in the entry block whose buffers
+// never leave the function with alloc_stack ops. The runtime serves those from
+// storage owned by the stack frame and releases it in bulk on return instead
+// of going through the allocator for each temporary. Allocations in other
+// blocks are left alone as those may execute many times per invocation.
+void promoteAllocationsToStack(FuncOp funcOp) {
+  if (funcOp.empty()) return;
+  SmallVector<IREEInterp::LL::AllocHeapOp, 8> allocOps;
+  for (auto &op : funcOp.getBlocks().front()) {
+    auto allocOp = dyn_cast<IREEInterp::LL::AllocHeapOp>(op);
+    if (!allocOp || allocOp.getNumOperands() > 0) continue;
+    if (!allocOp.getType().cast<MemRefType>().hasStaticShape()) continue;
+    if (mayEscapeFunction(allocOp.getResult())) continue;
+    allocOps.push_back(allocOp);
+  }
+  for (auto allocOp : allocOps) {
+    OpBuilder builder(allocOp.getOperation());
+    ArrayRef<Value *> dim_pieces;
+    auto stackOp = builder.create<IREEInterp::LL::AllocStackOp>(
+        allocOp.getLoc(), allocOp.getType(), dim_pieces);
+    allocOp.getResult()->replaceAllUsesWith(stackOp.getResult());
+    allocOp.erase();
+  }
+}
+
 }  // namespace
 
 class LowerInterpreterDialectPass
@@ -232,6 +675,11 @@ class LowerInterpreterDialectPass
     if (failed(applyFullConversion(getFunction(), target, patterns))) {
       return signalPassFailure();
     }
+
+    fuseMatMulEpilogues(getFunction());
+    fuseElementwiseOps(getFunction());
+    reuseDeadOperandBuffers(getFunction());
+    promoteAllocationsToStack(getFunction());
   }
 };
 
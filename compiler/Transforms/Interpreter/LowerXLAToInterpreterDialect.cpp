@@ -265,6 +265,32 @@ struct DynamicUpdateSliceOpLowering
   }
 };
 
+// Returns the source of |value| if it is produced by a broadcast that a binary
+// elementwise consumer can apply itself by reading the source with a stride of
+// 0 along the broadcast dimensions. Otherwise returns |value|.
+static Value *getBroadcastSource(Value *value) {
+  auto *op = value->getDefiningOp();
+  if (!isa_and_nonnull<IREEInterp::HL::TileOp>(op) &&
+      !isa_and_nonnull<IREEInterp::HL::BroadcastOp>(op)) {
+    return value;
+  }
+  auto *source = op->getOperand(0);
+  auto sourceShape = source->getType().cast<ShapedType>().getShape();
+  auto resultShape = value->getType().cast<ShapedType>().getShape();
+  if (sourceShape.size() > resultShape.size()) {
+    return value;
+  }
+  for (int i = 1; i <= sourceShape.size(); ++i) {
+    int64_t sourceDim = sourceShape[sourceShape.size() - i];
+    if (sourceDim != 1 && sourceDim != resultShape[resultShape.size() - i]) {
+      return value;
+    }
+  }
+  return source;
+}
+
+// Lowers a binary elementwise op, folding broadcast operands into the op so
+// that the broadcast result is never materialized.
 template <typename XlaOpType, typename IreeFloatOpType, typename IreeIntOpType>
 struct BinaryFloatIntOpLowering : public XlaOpLowering<XlaOpType> {
   using XlaOpLowering<XlaOpType>::XlaOpLowering;
@@ -272,20 +298,58 @@ struct BinaryFloatIntOpLowering : public XlaOpLowering<XlaOpType> {
   Operation *rewriteInternal(
       XlaOpType *op, ArrayRef<Value *> operands,
       ConversionPatternRewriter &rewriter) const override {
-    auto *lhs = operands[0];
-    auto *rhs = operands[1];
-    auto inputType = lhs->getType().cast<MemRefType>();
-    auto elementType = inputType.getElementType();
+    auto *lhs = getBroadcastSource(operands[0]);
+    auto *rhs = getBroadcastSource(operands[1]);
+    auto finalType = getFinalType(rewriter, *op);
+    auto elementType = finalType.getElementType();
 
     if (elementType.isa<FloatType>()) {
-      return rewriter.create<IreeFloatOpType>(op->getLoc(), inputType, lhs,
+      return rewriter.create<IreeFloatOpType>(op->getLoc(), finalType, lhs,
                                               rhs);
     }
 
-    return rewriter.create<IreeIntOpType>(op->getLoc(), inputType, lhs, rhs);
+    return rewriter.create<IreeIntOpType>(op->getLoc(), finalType, lhs, rhs);
+  }
+};
+
+// Lowers a binary elementwise op only when one of its operands is a
+// broadcast_in_dim that can be folded into it. All other ops are left for the
+// lowering through the standard dialect.
+template <typename XlaOpType, typename IreeFloatOpType, typename IreeIntOpType>
+struct BroadcastingBinaryOpLowering
+    : public BinaryFloatIntOpLowering<XlaOpType, IreeFloatOpType,
+                                      IreeIntOpType> {
+  using Base =
+      BinaryFloatIntOpLowering<XlaOpType, IreeFloatOpType, IreeIntOpType>;
+  using Base::Base;
+
+  PatternMatchResult matchAndRewrite(
+      Operation *op, ArrayRef<Value *> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (llvm::none_of(op->getOperands(), [](Value *operand) {
+          return isa_and_nonnull<xla_hlo::BroadcastInDimOp>(
+              operand->getDefiningOp());
+        })) {
+      return this->matchFailure();
+    }
+    return Base::matchAndRewrite(op, operands, rewriter);
   }
 };
 
+struct AddOpLowering
+    : public BroadcastingBinaryOpLowering<xla_hlo::AddOp,
+                                          IREEInterp::HL::AddFOp,
+                                          IREEInterp::HL::AddIOp> {
+  using BroadcastingBinaryOpLowering::BroadcastingBinaryOpLowering;
+};
+
+struct DivOpLowering
+    : public BroadcastingBinaryOpLowering<xla_hlo::DivOp,
+                                          IREEInterp::HL::DivFOp,
+                                          IREEInterp::HL::DivISOp> {
+  using BroadcastingBinaryOpLowering::BroadcastingBinaryOpLowering;
+};
+
 struct MaxOpLowering
     : public BinaryFloatIntOpLowering<xla_hlo::MaxOp, IREEInterp::HL::MaxFOp,
                                       IREEInterp::HL::MaxISOp> {
@@ -298,6 +362,20 @@ struct MinOpLowering
   using BinaryFloatIntOpLowering::BinaryFloatIntOpLowering;
 };
 
+struct MulOpLowering
+    : public BroadcastingBinaryOpLowering<xla_hlo::MulOp,
+                                          IREEInterp::HL::MulFOp,
+                                          IREEInterp::HL::MulIOp> {
+  using BroadcastingBinaryOpLowering::BroadcastingBinaryOpLowering;
+};
+
+struct SubOpLowering
+    : public BroadcastingBinaryOpLowering<xla_hlo::SubOp,
+                                          IREEInterp::HL::SubFOp,
+                                          IREEInterp::HL::SubIOp> {
+  using BroadcastingBinaryOpLowering::BroadcastingBinaryOpLowering;
+};
+
 struct ConvertLowering : public XlaOpLowering<xla_hlo::ConvertOp> {
   using XlaOpLowering<xla_hlo::ConvertOp>::XlaOpLowering;
 
@@ -493,15 +571,6 @@ struct PadOpLowering : public XlaOpLowering<xla_hlo::PadOp> {
     auto *src = operands[0];
     auto *paddingValue = operands[1];
 
-    // TODO(b/140836672) Support negative padding
-    for (int i = 0; i < op->edge_padding_high().getNumElements(); ++i) {
-      if (op->edge_padding_high().getValue<IntegerAttr>(i).getInt() < 0 ||
-          op->edge_padding_low().getValue<IntegerAttr>(i).getInt() < 0) {
-        op->emitRemark() << "Could not lower pad op with negative padding";
-        return nullptr;
-      }
-    }
-
     auto edgePaddingLowOp =
         rewriter.create<IREE::ConstantOp>(op->getLoc(), op->edge_padding_low());
     auto edgePaddingHighOp = rewriter.create<IREE::ConstantOp>(
@@ -560,12 +629,13 @@ class LowerXLAToInterpreterDialectPass
   void runOnFunction() override {
     OwningRewritePatternList patterns;
     patterns
-        .insert<BroadcastInDimOpLowering, ConcatOpLowering, ConstOpLowering,
-                ConvertLowering, CopyOpLowering, DotOpLowering,
-                DynamicUpdateSliceOpLowering, ExpOpLowering, FloorOpLowering,
-                GatherOpLowering, LogOpLowering, MaxOpLowering, MinOpLowering,
-                PadOpLowering, ReshapeOpLowering, ReverseOpLowering,
-                RsqrtOpLowering, SelectOpLowering, SliceOpLowering,
+        .insert<AddOpLowering, BroadcastInDimOpLowering, ConcatOpLowering,
+                ConstOpLowering, ConvertLowering, CopyOpLowering, DivOpLowering,
+                DotOpLowering, DynamicUpdateSliceOpLowering, ExpOpLowering,
+                FloorOpLowering, GatherOpLowering, LogOpLowering,
+                MaxOpLowering, MinOpLowering, MulOpLowering, PadOpLowering,
+                ReshapeOpLowering, ReverseOpLowering, RsqrtOpLowering,
+                SelectOpLowering, SliceOpLowering, SubOpLowering,
                 TransposeOpLowering, TanhOpLowering>(&getContext());
 
     ConversionTarget target(getContext());
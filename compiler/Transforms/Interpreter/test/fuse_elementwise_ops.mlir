@@ -0,0 +1,46 @@
+// RUN: iree-opt %s -lower-iree-interpreter-hl-to-ll -split-input-file | FileCheck %s --dump-input=fail
+
+// CHECK-LABEL: func @addMax
+// CHECK-SAME: [[X:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[BIAS:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[ZERO:%[a-zA-Z0-9]+]]
+func @addMax(%x: memref<4xf32>, %bias: memref<4xf32>, %zero: memref<4xf32>) -> memref<4xf32> {
+  // CHECK-NEXT: [[DST:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.add_max_f"([[X]], [[BIAS]], [[ZERO]], [[DST]])
+  %0 = "iree_hl_interp.add_f"(%x, %bias) : (memref<4xf32>, memref<4xf32>) -> memref<4xf32>
+  %1 = "iree_hl_interp.max_f"(%0, %zero) : (memref<4xf32>, memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[DST]] : memref<4xf32>
+  "iree_hl_interp.return"(%1) : (memref<4xf32>) -> ()
+}
+
+// -----
+
+// The fused kernel computes max(a + b, c), which differs from max(c, a + b)
+// for NaN inputs.
+// CHECK-LABEL: func @maxAddNotFused
+// CHECK-SAME: [[X:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[BIAS:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[ZERO:%[a-zA-Z0-9]+]]
+func @maxAddNotFused(%x: memref<4xf32>, %bias: memref<4xf32>, %zero: memref<4xf32>) -> memref<4xf32> {
+  // CHECK-NEXT: [[SUM:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.add_f"([[X]], [[BIAS]], [[SUM]])
+  %0 = "iree_hl_interp.add_f"(%x, %bias) : (memref<4xf32>, memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.max_f"([[ZERO]], [[SUM]], [[SUM]])
+  %1 = "iree_hl_interp.max_f"(%zero, %0) : (memref<4xf32>, memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[SUM]] : memref<4xf32>
+  "iree_hl_interp.return"(%1) : (memref<4xf32>) -> ()
+}
+
+// -----
+
+// CHECK-LABEL: func @cmpSelect
+// CHECK-SAME: [[LHS:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[RHS:%[a-zA-Z0-9]+]]
+func @cmpSelect(%lhs: memref<4xf32>, %rhs: memref<4xf32>) -> memref<4xf32> {
+  // CHECK-NEXT: [[DST:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.cmp_select_f"([[LHS]], [[RHS]], [[LHS]], [[RHS]], [[DST]]) {predicate = 2 : i32}
+  %0 = "iree_hl_interp.cmp_f"(%lhs, %rhs) {predicate = 2 : i32} : (memref<4xf32>, memref<4xf32>) -> memref<4xi1>
+  %1 = "iree_hl_interp.select"(%0, %lhs, %rhs) : (memref<4xi1>, memref<4xf32>, memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[DST]] : memref<4xf32>
+  "iree_hl_interp.return"(%1) : (memref<4xf32>) -> ()
+}
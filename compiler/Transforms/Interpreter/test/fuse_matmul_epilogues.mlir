@@ -0,0 +1,67 @@
+// RUN: iree-opt %s -lower-iree-interpreter-hl-to-ll -split-input-file | FileCheck %s --dump-input=fail
+
+// CHECK-LABEL: func @biasRelu
+// CHECK-SAME: [[X:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[W:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[BIAS:%[a-zA-Z0-9]+]]
+func @biasRelu(%x: memref<4x8xf32>, %w: memref<8x8xf32>, %bias: memref<8xf32>) -> memref<4x8xf32> {
+  %zero = "iree.constant"() {value = dense<0.0> : tensor<4x8xf32>} : () -> memref<4x8xf32>
+  // CHECK-NOT: matmul_f
+  // CHECK: [[DST:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4x8xf32>
+  // CHECK-NEXT: [[MIN:%.+]] = "iree_ll_interp.constant"() {value = dense<0.000000e+00> : tensor<f32>} : () -> memref<f32>
+  // CHECK-NEXT: [[MAX:%.+]] = "iree_ll_interp.constant"() {value = dense<0x7F800000> : tensor<f32>} : () -> memref<f32>
+  // CHECK-NEXT: "iree_ll_interp.matmul_bias_f"([[X]], [[W]], [[BIAS]], [[MIN]], [[MAX]], [[DST]])
+  %0 = "iree_hl_interp.matmul_f"(%x, %w) : (memref<4x8xf32>, memref<8x8xf32>) -> memref<4x8xf32>
+  %1 = "iree_hl_interp.add_f"(%0, %bias) : (memref<4x8xf32>, memref<8xf32>) -> memref<4x8xf32>
+  %2 = "iree_hl_interp.max_f"(%1, %zero) : (memref<4x8xf32>, memref<4x8xf32>) -> memref<4x8xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[DST]] : memref<4x8xf32>
+  "iree_hl_interp.return"(%2) : (memref<4x8xf32>) -> ()
+}
+
+// -----
+
+// A bias with one value per element cannot be applied per row by ruy.
+// CHECK-LABEL: func @nonRowBias
+func @nonRowBias(%x: memref<4x8xf32>, %w: memref<8x8xf32>, %bias: memref<4x8xf32>) -> memref<4x8xf32> {
+  // CHECK-NOT: matmul_bias_f
+  // CHECK: "iree_ll_interp.matmul_f"
+  // CHECK: "iree_ll_interp.add_f"
+  %0 = "iree_hl_interp.matmul_f"(%x, %w) : (memref<4x8xf32>, memref<8x8xf32>) -> memref<4x8xf32>
+  %1 = "iree_hl_interp.add_f"(%0, %bias) : (memref<4x8xf32>, memref<4x8xf32>) -> memref<4x8xf32>
+  "iree_hl_interp.return"(%1) : (memref<4x8xf32>) -> ()
+}
+
+// -----
+
+// The bias is fused but the bound varies per element so the max remains.
+// CHECK-LABEL: func @nonScalarBound
+// CHECK-SAME: [[X:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[W:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[BIAS:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[BOUND:%[a-zA-Z0-9]+]]
+func @nonScalarBound(%x: memref<4x8xf32>, %w: memref<8x8xf32>, %bias: memref<8xf32>, %bound: memref<4x8xf32>) -> memref<4x8xf32> {
+  // CHECK-NOT: "iree_ll_interp.matmul_f"
+  // CHECK: "iree_ll_interp.matmul_bias_f"([[X]], [[W]], [[BIAS]], {{%[a-zA-Z0-9_]+}}, {{%[a-zA-Z0-9_]+}}, [[SUM:%[a-zA-Z0-9_]+]])
+  // CHECK-NEXT: "iree_ll_interp.max_f"([[SUM]], [[BOUND]], [[SUM]])
+  %0 = "iree_hl_interp.matmul_f"(%x, %w) : (memref<4x8xf32>, memref<8x8xf32>) -> memref<4x8xf32>
+  %1 = "iree_hl_interp.add_f"(%0, %bias) : (memref<4x8xf32>, memref<8xf32>) -> memref<4x8xf32>
+  %2 = "iree_hl_interp.max_f"(%1, %bound) : (memref<4x8xf32>, memref<4x8xf32>) -> memref<4x8xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[SUM]] : memref<4x8xf32>
+  "iree_hl_interp.return"(%2) : (memref<4x8xf32>) -> ()
+}
+
+// -----
+
+// The unbiased matmul result is also read by the reverse so it must still be
+// written out.
+// CHECK-LABEL: func @interveningUse
+func @interveningUse(%x: memref<4x8xf32>, %w: memref<8x8xf32>, %bias: memref<8xf32>, %dims: memref<1xi32>) -> (memref<4x8xf32>, memref<4x8xf32>) {
+  // CHECK-NOT: matmul_bias_f
+  // CHECK: "iree_ll_interp.matmul_f"
+  // CHECK: "iree_ll_interp.reverse"
+  // CHECK: "iree_ll_interp.add_f"
+  %0 = "iree_hl_interp.matmul_f"(%x, %w) : (memref<4x8xf32>, memref<8x8xf32>) -> memref<4x8xf32>
+  %1 = "iree_hl_interp.reverse"(%0, %dims) : (memref<4x8xf32>, memref<1xi32>) -> memref<4x8xf32>
+  %2 = "iree_hl_interp.add_f"(%0, %bias) : (memref<4x8xf32>, memref<8xf32>) -> memref<4x8xf32>
+  "iree_hl_interp.return"(%1, %2) : (memref<4x8xf32>, memref<4x8xf32>) -> ()
+}
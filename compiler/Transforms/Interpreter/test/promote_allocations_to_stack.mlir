@@ -0,0 +1,42 @@
+// RUN: iree-opt %s -lower-iree-interpreter-hl-to-ll -split-input-file | FileCheck %s --dump-input=fail
+
+// CHECK-LABEL: func @promoted
+// CHECK-SAME: [[SRC:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[DIMS:%[a-zA-Z0-9]+]]
+func @promoted(%src: memref<4xf32>, %dims: memref<1xi32>) -> memref<4xf32> {
+  // CHECK-NEXT: [[TEMP:%.+]] = "iree_ll_interp.alloc_stack"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.exp_f"([[SRC]], [[TEMP]])
+  %0 = "iree_hl_interp.exp_f"(%src) : (memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: [[DST:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.reverse"([[TEMP]], [[DIMS]], [[DST]])
+  %1 = "iree_hl_interp.reverse"(%0, %dims) : (memref<4xf32>, memref<1xi32>) -> memref<4xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[DST]] : memref<4xf32>
+  "iree_hl_interp.return"(%1) : (memref<4xf32>) -> ()
+}
+
+// -----
+
+// Reshape returns a view of its input so the buffer escapes through the
+// returned value.
+// CHECK-LABEL: func @escapingThroughView
+// CHECK-SAME: [[SRC:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[SHAPE:%[a-zA-Z0-9]+]]
+func @escapingThroughView(%src: memref<4xf32>, %shape: memref<2xi32>) -> memref<2x2xf32> {
+  // CHECK-NEXT: [[TEMP:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.exp_f"([[SRC]], [[TEMP]])
+  %0 = "iree_hl_interp.exp_f"(%src) : (memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: [[VIEW:%.+]] = "iree_ll_interp.reshape"([[TEMP]], [[SHAPE]])
+  %1 = "iree_hl_interp.reshape"(%0, %shape) : (memref<4xf32>, memref<2xi32>) -> memref<2x2xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[VIEW]] : memref<2x2xf32>
+  "iree_hl_interp.return"(%1) : (memref<2x2xf32>) -> ()
+}
+
+// -----
+
+// CHECK-LABEL: func @escapingThroughReturn
+func @escapingThroughReturn(%src: memref<4xf32>) -> memref<4xf32> {
+  // CHECK-NOT: alloc_stack
+  // CHECK: "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  %0 = "iree_hl_interp.exp_f"(%src) : (memref<4xf32>) -> memref<4xf32>
+  "iree_hl_interp.return"(%0) : (memref<4xf32>) -> ()
+}
@@ -0,0 +1,55 @@
+// RUN: iree-opt %s -lower-iree-interpreter-hl-to-ll -split-input-file | FileCheck %s --dump-input=fail
+
+// CHECK-LABEL: func @deadOperand
+// CHECK-SAME: [[SRC:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[DIMS:%[a-zA-Z0-9]+]]
+func @deadOperand(%src: memref<4xf32>, %dims: memref<1xi32>) -> memref<4xf32> {
+  // CHECK-NEXT: [[TEMP:%.+]] = "iree_ll_interp.alloc_stack"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.exp_f"([[SRC]], [[TEMP]])
+  %0 = "iree_hl_interp.exp_f"(%src) : (memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.tanh_f"([[TEMP]], [[TEMP]])
+  %1 = "iree_hl_interp.tanh_f"(%0) : (memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: [[DST:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.reverse"([[TEMP]], [[DIMS]], [[DST]])
+  %2 = "iree_hl_interp.reverse"(%1, %dims) : (memref<4xf32>, memref<1xi32>) -> memref<4xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[DST]] : memref<4xf32>
+  "iree_hl_interp.return"(%2) : (memref<4xf32>) -> ()
+}
+
+// -----
+
+// %0 is still read by the add so the tanh needs its own buffer. The add is
+// the last use of %0 and may write over it.
+// CHECK-LABEL: func @liveOperand
+// CHECK-SAME: [[SRC:%[a-zA-Z0-9]+]]
+func @liveOperand(%src: memref<4xf32>) -> memref<4xf32> {
+  // CHECK-NEXT: [[TEMP0:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.exp_f"([[SRC]], [[TEMP0]])
+  %0 = "iree_hl_interp.exp_f"(%src) : (memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: [[TEMP1:%.+]] = "iree_ll_interp.alloc_stack"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.tanh_f"([[TEMP0]], [[TEMP1]])
+  %1 = "iree_hl_interp.tanh_f"(%0) : (memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.add_f"([[TEMP0]], [[TEMP1]], [[TEMP0]])
+  %2 = "iree_hl_interp.add_f"(%0, %1) : (memref<4xf32>, memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[TEMP0]] : memref<4xf32>
+  "iree_hl_interp.return"(%2) : (memref<4xf32>) -> ()
+}
+
+// -----
+
+// The reshape result aliases %0 so %0 must not be overwritten by the tanh.
+// CHECK-LABEL: func @aliasedOperand
+// CHECK-SAME: [[SRC:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[SHAPE:%[a-zA-Z0-9]+]]
+func @aliasedOperand(%src: memref<4xf32>, %shape: memref<1xi32>) -> (memref<4xf32>, memref<4xf32>) {
+  // CHECK-NEXT: [[TEMP:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.exp_f"([[SRC]], [[TEMP]])
+  %0 = "iree_hl_interp.exp_f"(%src) : (memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: [[VIEW:%.+]] = "iree_ll_interp.reshape"([[TEMP]], [[SHAPE]])
+  %1 = "iree_hl_interp.reshape"(%0, %shape) : (memref<4xf32>, memref<1xi32>) -> memref<4xf32>
+  // CHECK-NEXT: [[DST:%.+]] = "iree_ll_interp.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_interp.tanh_f"([[TEMP]], [[DST]])
+  %2 = "iree_hl_interp.tanh_f"(%0) : (memref<4xf32>) -> memref<4xf32>
+  // CHECK-NEXT: iree_ll_interp.return [[VIEW]], [[DST]] : memref<4xf32>, memref<4xf32>
+  "iree_hl_interp.return"(%1, %2) : (memref<4xf32>, memref<4xf32>) -> ()
+}
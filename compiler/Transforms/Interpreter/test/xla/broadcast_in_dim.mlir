@@ -0,0 +1,46 @@
+// RUN: iree-opt --lower-xla-to-iree-interpreter %s --split-input-file | FileCheck %s --dump-input=fail
+
+// CHECK-LABEL: func @add.broadcast_row
+// CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[ARG1:%[a-zA-Z0-9]+]]
+func @add.broadcast_row(%arg0 : tensor<4xf32>, %arg1 : tensor<3x4xf32>) -> tensor<3x4xf32> {
+  // CHECK-DAG: [[ARG0_MEMREF:%.+]] = iree.tensor_to_memref([[ARG0]]
+  // CHECK-DAG: [[ARG1_MEMREF:%.+]] = iree.tensor_to_memref([[ARG1]]
+  // CHECK:     [[ROW:%.+]] = "iree_hl_interp.reshape"([[ARG0_MEMREF]], {{.+}}) : ({{.+}}) -> memref<1x4xf32>
+  %0 = "xla_hlo.broadcast_in_dim"(%arg0) {broadcast_dimensions = dense<1> : tensor<1xi64>} : (tensor<4xf32>) -> tensor<3x4xf32>
+
+  // CHECK: [[RES:%.+]] = "iree_hl_interp.add_f"([[ROW]], [[ARG1_MEMREF]]) : (memref<1x4xf32>, memref<3x4xf32>) -> memref<3x4xf32>
+  %1 = "xla_hlo.add"(%0, %arg1) : (tensor<3x4xf32>, tensor<3x4xf32>) -> tensor<3x4xf32>
+
+  // CHECK: [[RES_TENSOR:%.+]] = iree.memref_to_tensor([[RES]]
+  // CHECK: return [[RES_TENSOR]]
+  return %1 : tensor<3x4xf32>
+}
+
+// -----
+
+// CHECK-LABEL: func @mul.broadcast_scalar
+// CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[ARG1:%[a-zA-Z0-9]+]]
+func @mul.broadcast_scalar(%arg0 : tensor<f32>, %arg1 : tensor<3x4xf32>) -> tensor<3x4xf32> {
+  // CHECK-DAG: [[ARG0_MEMREF:%.+]] = iree.tensor_to_memref([[ARG0]]
+  // CHECK-DAG: [[ARG1_MEMREF:%.+]] = iree.tensor_to_memref([[ARG1]]
+  // CHECK:     [[SCALAR:%.+]] = "iree_hl_interp.reshape"([[ARG0_MEMREF]], {{.+}}) : ({{.+}}) -> memref<f32>
+  %0 = "xla_hlo.broadcast_in_dim"(%arg0) : (tensor<f32>) -> tensor<3x4xf32>
+
+  // CHECK: [[RES:%.+]] = "iree_hl_interp.mul_f"([[ARG1_MEMREF]], [[SCALAR]]) : (memref<3x4xf32>, memref<f32>) -> memref<3x4xf32>
+  %1 = "xla_hlo.mul"(%arg1, %0) : (tensor<3x4xf32>, tensor<3x4xf32>) -> tensor<3x4xf32>
+
+  // CHECK: [[RES_TENSOR:%.+]] = iree.memref_to_tensor([[RES]]
+  // CHECK: return [[RES_TENSOR]]
+  return %1 : tensor<3x4xf32>
+}
+
+// -----
+
+// CHECK-LABEL: func @add.no_broadcast
+func @add.no_broadcast(%arg0 : tensor<3x4xf32>, %arg1 : tensor<3x4xf32>) -> tensor<3x4xf32> {
+  // CHECK: "xla_hlo.add"
+  %0 = "xla_hlo.add"(%arg0, %arg1) : (tensor<3x4xf32>, tensor<3x4xf32>) -> tensor<3x4xf32>
+  return %0 : tensor<3x4xf32>
+}
@@ -64,6 +64,14 @@ std::unique_ptr<OpPassBase<FuncOp>> createLowerSequencerDialectPass();
 // Optimizes std.load and std.store to remove unnessisary copies.
 std::unique_ptr<OpPassBase<FuncOp>> createLoadStoreDataFlowOptPass();
 
+//===----------------------------------------------------------------------===//
+// Memory Planning
+//===----------------------------------------------------------------------===//
+
+// Packs transient buffers with disjoint live ranges into per-block slab
+// allocations.
+std::unique_ptr<OpPassBase<FuncOp>> createPlanBufferAllocationsPass();
+
 //===----------------------------------------------------------------------===//
 // Module Analysis and Assignment
 //===----------------------------------------------------------------------===//
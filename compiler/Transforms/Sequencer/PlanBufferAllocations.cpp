@@ -0,0 +1,236 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "third_party/llvm/llvm/include/llvm/ADT/DenseMap.h"
+#include "third_party/llvm/llvm/include/llvm/ADT/SmallVector.h"
+#include "third_party/llvm/llvm/projects/google_mlir/include/mlir/IR/Builders.h"
+#include "third_party/llvm/llvm/projects/google_mlir/include/mlir/IR/MLIRContext.h"
+#include "third_party/llvm/llvm/projects/google_mlir/include/mlir/IR/StandardTypes.h"
+#include "third_party/llvm/llvm/projects/google_mlir/include/mlir/Pass/Pass.h"
+#include "third_party/llvm/llvm/projects/google_mlir/include/mlir/Pass/PassRegistry.h"
+#include "third_party/mlir_edge/iree/compiler/IR/Sequencer/LLOps.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+// Alignment of each buffer placed within a slab. Matches the alignment of
+// host allocations so that kernels may use aligned vector loads.
+constexpr int64_t kSlabAlignment = 64;
+
+// A transient buffer that may be assigned a range within a slab.
+struct PlannedBuffer {
+  IREESeq::LL::AllocHeapOp allocOp;
+  int64_t byteLength = 0;
+  // Inclusive range of op indices within the block during which the buffer
+  // (or any view of it) is used.
+  int firstUse = 0;
+  int lastUse = 0;
+  int64_t byteOffset = 0;
+};
+
+// Returns true if |use| only produces a view of the buffer that should be
+// tracked as part of the same allocation.
+bool isAliasingUse(OpOperand &use) {
+  auto *user = use.getOwner();
+  if (isa<IREESeq::LL::StaticSliceOp>(user) ||
+      isa<IREESeq::LL::DynamicSliceOp>(user) ||
+      isa<IREESeq::LL::ReshapeOp>(user)) {
+    return use.getOperandNumber() == 0;
+  }
+  return false;
+}
+
+// Returns true if |use| only accesses the buffer contents from device work
+// recorded into the command batch. Host reads (such as of offsets or
+// workloads) would force the entire slab to be flushed, and anything that may
+// retain the buffer beyond the block is not plannable.
+bool isDeviceUse(OpOperand &use) {
+  auto *user = use.getOwner();
+  unsigned operandIndex = use.getOperandNumber();
+  if (isa<IREESeq::LL::StaticDispatchOp>(user)) {
+    return true;
+  } else if (isa<IREESeq::LL::DynamicDispatchOp>(user)) {
+    return operandIndex != 0;  // workload
+  } else if (isa<IREESeq::LL::StaticCopyOp>(user) ||
+             isa<IREESeq::LL::CloneOp>(user)) {
+    return true;
+  } else if (isa<IREESeq::LL::DynamicCopyOp>(user)) {
+    return operandIndex == 0 || operandIndex == 2;  // src/dst
+  } else if (isa<IREESeq::LL::StaticFillOp>(user)) {
+    return true;
+  } else if (isa<IREESeq::LL::DynamicFillOp>(user)) {
+    return operandIndex == 1;  // dst
+  } else if (isa<IREESeq::LL::DiscardOp>(user)) {
+    return true;
+  }
+  return false;
+}
+
+// Computes the live range of the buffer defined by |allocOp| within |block|.
+// Returns false if the buffer escapes the block or has uses that prevent it
+// from sharing a slab with other buffers.
+bool computeLiveRange(IREESeq::LL::AllocHeapOp allocOp, Block *block,
+                      const llvm::DenseMap<Operation *, int> &opIndices,
+                      PlannedBuffer *plannedBuffer) {
+  plannedBuffer->firstUse = opIndices.lookup(allocOp.getOperation());
+  plannedBuffer->lastUse = plannedBuffer->firstUse;
+  SmallVector<Value *, 4> worklist{allocOp.getResult()};
+  while (!worklist.empty()) {
+    auto *value = worklist.pop_back_val();
+    for (auto &use : value->getUses()) {
+      auto *user = use.getOwner();
+      if (user->getBlock() != block) return false;
+      if (isAliasingUse(use)) {
+        worklist.push_back(user->getResult(0));
+      } else if (!isDeviceUse(use)) {
+        return false;
+      }
+      int index = opIndices.lookup(user);
+      plannedBuffer->firstUse = std::min(plannedBuffer->firstUse, index);
+      plannedBuffer->lastUse = std::max(plannedBuffer->lastUse, index);
+    }
+  }
+  return true;
+}
+
+// Assigns offsets to |plannedBuffers| such that buffers with overlapping live
+// ranges never overlap in memory and returns the total slab size.
+//
+// Buffers are placed largest-first at the lowest aligned offset that does not
+// conflict with any previously placed buffer live at the same time. This is
+// the usual greedy heuristic for offline memory planning and in practice is
+// close to the peak live size.
+int64_t assignSlabOffsets(MutableArrayRef<PlannedBuffer> plannedBuffers) {
+  SmallVector<PlannedBuffer *, 8> order;
+  for (auto &plannedBuffer : plannedBuffers) order.push_back(&plannedBuffer);
+  std::stable_sort(order.begin(), order.end(),
+                   [](PlannedBuffer *lhs, PlannedBuffer *rhs) {
+                     return lhs->byteLength > rhs->byteLength;
+                   });
+
+  int64_t slabLength = 0;
+  SmallVector<PlannedBuffer *, 8> placed;
+  for (auto *plannedBuffer : order) {
+    // Collect conflicting placements sorted by offset.
+    SmallVector<PlannedBuffer *, 8> conflicts;
+    for (auto *other : placed) {
+      if (other->firstUse <= plannedBuffer->lastUse &&
+          plannedBuffer->firstUse <= other->lastUse) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(),
+              [](PlannedBuffer *lhs, PlannedBuffer *rhs) {
+                return lhs->byteOffset < rhs->byteOffset;
+              });
+
+    // First fit into the gaps between the conflicting placements.
+    int64_t offset = 0;
+    for (auto *other : conflicts) {
+      if (offset + plannedBuffer->byteLength <= other->byteOffset) break;
+      int64_t otherEnd = other->byteOffset + other->byteLength;
+      offset = std::max(offset, (otherEnd + kSlabAlignment - 1) /
+                                    kSlabAlignment * kSlabAlignment);
+    }
+    plannedBuffer->byteOffset = offset;
+    slabLength = std::max(slabLength, offset + plannedBuffer->byteLength);
+    placed.push_back(plannedBuffer);
+  }
+  return slabLength;
+}
+
+// Plans all transient buffers within |block| into a single slab allocation.
+void planBlockAllocations(Block *block) {
+  llvm::DenseMap<Operation *, int> opIndices;
+  int nextIndex = 0;
+  for (auto &op : *block) {
+    opIndices[&op] = nextIndex++;
+  }
+
+  SmallVector<PlannedBuffer, 8> plannedBuffers;
+  for (auto &op : *block) {
+    auto allocOp = dyn_cast<IREESeq::LL::AllocHeapOp>(op);
+    if (!allocOp || allocOp.getNumOperands() > 0) continue;
+    auto memRefType = allocOp.getType().cast<MemRefType>();
+    if (!memRefType.hasStaticShape()) continue;
+    PlannedBuffer plannedBuffer;
+    plannedBuffer.allocOp = allocOp;
+    plannedBuffer.byteLength = memRefType.getNumElements() *
+                               ((memRefType.getElementTypeBitWidth() + 7) / 8);
+    if (plannedBuffer.byteLength == 0) continue;
+    if (!computeLiveRange(allocOp, block, opIndices, &plannedBuffer)) continue;
+    plannedBuffers.push_back(plannedBuffer);
+  }
+
+  // No benefit to wrapping a lone buffer in a slab.
+  if (plannedBuffers.size() < 2) return;
+
+  int64_t slabLength = assignSlabOffsets(plannedBuffers);
+
+  // Allocate the slab prior to the first planned allocation so that it
+  // dominates all uses.
+  OpBuilder builder(plannedBuffers.front().allocOp.getOperation());
+  auto slabOp = builder.create<IREESeq::LL::AllocHeapOp>(
+      plannedBuffers.front().allocOp.getLoc(),
+      builder.getMemRefType({slabLength}, builder.getIntegerType(8)),
+      ArrayRef<Value *>{});
+
+  for (auto &plannedBuffer : plannedBuffers) {
+    auto allocOp = plannedBuffer.allocOp;
+    builder.setInsertionPoint(allocOp);
+    auto sliceOp = builder.create<IREESeq::LL::StaticSliceOp>(
+        allocOp.getLoc(), allocOp.getType(), slabOp.getResult(),
+        builder.getIntegerAttr(builder.getIntegerType(64),
+                               plannedBuffer.byteOffset),
+        builder.getIntegerAttr(builder.getIntegerType(64),
+                               plannedBuffer.byteLength));
+    allocOp.getResult()->replaceAllUsesWith(sliceOp.getResult());
+    allocOp.erase();
+  }
+}
+
+}  // namespace
+
+// Plans the transient buffers of each block into a single slab allocation.
+//
+// Buffers that are statically shaped and only used by dispatches, copies, and
+// fills within the block they are allocated in are assigned byte ranges in a
+// per-block slab based on their live ranges such that buffers that are never
+// live at the same time share memory. The original allocations are replaced
+// with static slices of the slab, turning N allocations per invocation into
+// one.
+class PlanBufferAllocationsPass
+    : public FunctionPass<PlanBufferAllocationsPass> {
+ public:
+  void runOnFunction() override {
+    for (auto &block : getFunction()) {
+      planBlockAllocations(&block);
+    }
+  }
+};
+
+std::unique_ptr<OpPassBase<FuncOp>> createPlanBufferAllocationsPass() {
+  return std::make_unique<PlanBufferAllocationsPass>();
+}
+
+static PassRegistration<PlanBufferAllocationsPass> pass(
+    "iree-plan-buffer-allocations",
+    "Packs transient buffers into per-block slab allocations");
+
+}  // namespace iree_compiler
+}  // namespace mlir
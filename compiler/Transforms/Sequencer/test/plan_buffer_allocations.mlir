@@ -0,0 +1,52 @@
+// RUN: iree-opt -iree-plan-buffer-allocations %s --split-input-file | FileCheck %s --dump-input=fail
+
+// CHECK-LABEL: func @disjoint_and_overlapping
+// CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[ARG1:%[a-zA-Z0-9]+]]
+// CHECK-SAME: [[ARG2:%[a-zA-Z0-9]+]]
+func @disjoint_and_overlapping(%arg0 : memref<4xf32>, %arg1 : memref<8xi32>, %arg2 : memref<2xf32>) {
+  // The 16b and 32b buffers are never live at the same time and share offset 0
+  // while the 8b buffer overlaps the 32b one and is placed at the next aligned
+  // offset.
+  // CHECK-NEXT: [[SLAB:%.+]] = "iree_ll_seq.alloc_heap"() : () -> memref<72xi8>
+  // CHECK-NEXT: [[BUF0:%.+]] = "iree_ll_seq.static_slice"([[SLAB]]) {{.*}}offset = 0 : i64{{.*}} : (memref<72xi8>) -> memref<4xf32>
+  %0 = "iree_ll_seq.alloc_heap"() : () -> memref<4xf32>
+  // CHECK-NEXT: "iree_ll_seq.static_fill"([[BUF0]])
+  "iree_ll_seq.static_fill"(%0) {value = 0 : i32, dstOffset = 0 : i64, length = 16 : i64} : (memref<4xf32>) -> ()
+  // CHECK-NEXT: "iree_ll_seq.static_copy"([[BUF0]], [[ARG0]])
+  "iree_ll_seq.static_copy"(%0, %arg0) {srcOffset = 0 : i64, dstOffset = 0 : i64, length = 16 : i64} : (memref<4xf32>, memref<4xf32>) -> ()
+
+  // CHECK-NEXT: [[BUF1:%.+]] = "iree_ll_seq.static_slice"([[SLAB]]) {{.*}}offset = 0 : i64{{.*}} : (memref<72xi8>) -> memref<8xi32>
+  %1 = "iree_ll_seq.alloc_heap"() : () -> memref<8xi32>
+  // CHECK-NEXT: "iree_ll_seq.static_fill"([[BUF1]])
+  "iree_ll_seq.static_fill"(%1) {value = 1 : i32, dstOffset = 0 : i64, length = 32 : i64} : (memref<8xi32>) -> ()
+  // CHECK-NEXT: [[BUF2:%.+]] = "iree_ll_seq.static_slice"([[SLAB]]) {{.*}}offset = 64 : i64{{.*}} : (memref<72xi8>) -> memref<2xf32>
+  %2 = "iree_ll_seq.alloc_heap"() : () -> memref<2xf32>
+  // CHECK-NEXT: "iree_ll_seq.static_fill"([[BUF2]])
+  "iree_ll_seq.static_fill"(%2) {value = 2 : i32, dstOffset = 0 : i64, length = 8 : i64} : (memref<2xf32>) -> ()
+  // CHECK-NEXT: "iree_ll_seq.static_copy"([[BUF1]], [[ARG1]])
+  "iree_ll_seq.static_copy"(%1, %arg1) {srcOffset = 0 : i64, dstOffset = 0 : i64, length = 32 : i64} : (memref<8xi32>, memref<8xi32>) -> ()
+  // CHECK-NEXT: "iree_ll_seq.static_copy"([[BUF2]], [[ARG2]])
+  "iree_ll_seq.static_copy"(%2, %arg2) {srcOffset = 0 : i64, dstOffset = 0 : i64, length = 8 : i64} : (memref<2xf32>, memref<2xf32>) -> ()
+  // CHECK-NEXT: "iree_ll_seq.return"
+  "iree_ll_seq.return"() : () -> ()
+}
+
+// -----
+
+// CHECK-LABEL: func @escaping
+// CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+func @escaping(%arg0 : memref<4xf32>) -> memref<4xf32> {
+  // Returned buffers escape the block and must keep their own allocation. A
+  // single remaining transient buffer is not worth wrapping in a slab.
+  // CHECK-NOT: static_slice
+  // CHECK: [[BUF0:%.+]] = "iree_ll_seq.alloc_heap"() : () -> memref<4xf32>
+  %0 = "iree_ll_seq.alloc_heap"() : () -> memref<4xf32>
+  "iree_ll_seq.static_fill"(%0) {value = 0 : i32, dstOffset = 0 : i64, length = 16 : i64} : (memref<4xf32>) -> ()
+  // CHECK: [[BUF1:%.+]] = "iree_ll_seq.alloc_heap"() : () -> memref<4xf32>
+  %1 = "iree_ll_seq.alloc_heap"() : () -> memref<4xf32>
+  "iree_ll_seq.static_copy"(%0, %1) {srcOffset = 0 : i64, dstOffset = 0 : i64, length = 16 : i64} : (memref<4xf32>, memref<4xf32>) -> ()
+  // CHECK-NOT: static_slice
+  // CHECK: "iree_ll_seq.return"([[BUF1]])
+  "iree_ll_seq.return"(%1) : (memref<4xf32>) -> ()
+}
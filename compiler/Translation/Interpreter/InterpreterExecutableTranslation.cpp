@@ -22,6 +22,7 @@
 #include "third_party/flatbuffers/include/flatbuffers/minireflect.h"
 #include "third_party/llvm/llvm/include/llvm/ADT/STLExtras.h"
 #include "third_party/llvm/llvm/include/llvm/ADT/StringRef.h"
+#include "third_party/llvm/llvm/include/llvm/Support/CommandLine.h"
 #include "third_party/llvm/llvm/include/llvm/Support/Debug.h"
 #include "third_party/llvm/llvm/projects/google_mlir/include/mlir/IR/Attributes.h"
 #include "third_party/llvm/llvm/projects/google_mlir/include/mlir/IR/Module.h"
@@ -45,6 +46,18 @@
 #include "third_party/mlir_edge/iree/schemas/module_def_generated.h"
 #include "third_party/tensorflow/compiler/mlir/xla/transforms/passes.h"
 
+static llvm::cl::opt<bool> fastMath(
+    "iree-interpreter-fast-math",
+    llvm::cl::desc("Allow interpreter executables to use approximate "
+                   "transcendental kernels with bounded error."),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<bool> compensatedSummation(
+    "iree-interpreter-compensated-summation",
+    llvm::cl::desc("Use compensated (Kahan) summation for floating-point "
+                   "reductions in interpreter executables."),
+    llvm::cl::init(false));
+
 namespace mlir {
 namespace iree_compiler {
 
@@ -192,7 +205,23 @@ InterpreterTranslator::translateExecutable(IREE::ExecutableOp executableOp) {
   auto executableDef = std::make_unique<iree::ExecutableDefT>();
   executableDef->format =
       static_cast<uint32_t>(IREE::ExecutableFormat::IreeBytecode);
-  executableDef->supported_features = iree::ExecutableFeature::kDebugging;
+  uint32_t supportedFeatures =
+      static_cast<uint32_t>(iree::ExecutableFeature::kDebugging);
+  if (fastMath || executableOp.getAttr("iree.executable.fast_math")) {
+    // Allows the runtime to use approximate transcendental kernels. Enabled
+    // for all executables with --iree-interpreter-fast-math or for a single
+    // executable with the iree.executable.fast_math attribute.
+    supportedFeatures |=
+        static_cast<uint32_t>(iree::ExecutableFeature::kFastMath);
+  }
+  if (compensatedSummation ||
+      executableOp.getAttr("iree.executable.compensated_summation")) {
+    // Trades reduction throughput for bounded rounding error.
+    supportedFeatures |=
+        static_cast<uint32_t>(iree::ExecutableFeature::kCompensatedSummation);
+  }
+  executableDef->supported_features =
+      static_cast<iree::ExecutableFeature>(supportedFeatures);
   executableDef->contents = std::move(bytes);
   return executableDef;
 }
@@ -170,6 +170,9 @@ void buildSequencerLoweringPassPipeline(PassManager *passManager) {
   passManager->addPass(createMemRefDataFlowOptPass());
   passManager->addPass(createAggressiveOpEliminationPass());
 
+  // Pack transient buffers into slabs now that all allocations are explicit.
+  passManager->addPass(createPlanBufferAllocationsPass());
+
   // Assign ordinals used by the bytecode to reference executables and
   // functions.
   passManager->addPass(createAssignFunctionOrdinalsPass());
@@ -49,8 +49,9 @@ StatusOr<ref_ptr<Buffer>> Allocator::AllocateConstant(
 
   MemoryTypeBitfield memory_type =
       MemoryType::kDeviceLocal | MemoryType::kHostVisible;
-  ASSIGN_OR_RETURN(auto device_buffer, Allocate(memory_type, buffer_usage,
-                                                source_buffer->byte_length()));
+  ASSIGN_OR_RETURN(auto device_buffer,
+                   AllocateUninitialized(memory_type, buffer_usage,
+                                         source_buffer->byte_length()));
   ASSIGN_OR_RETURN(auto source_mapping,
                    source_buffer->MapMemory<uint8_t>(MemoryAccess::kRead));
   RETURN_IF_ERROR(device_buffer->WriteData(0, source_mapping.data(),
@@ -77,6 +77,16 @@ class Allocator {
                                              BufferUsageBitfield buffer_usage,
                                              size_t allocation_size) = 0;
 
+  // Allocates a buffer as with Allocate but leaves its initial contents
+  // undefined, much like mapping with MemoryAccess::kDiscardWrite. Callers
+  // must fully overwrite the buffer before reading from it. Allocators that
+  // zero-fill new buffers may skip doing so for these allocations.
+  virtual StatusOr<ref_ptr<Buffer>> AllocateUninitialized(
+      MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
+      size_t allocation_size) {
+    return Allocate(memory_type, buffer_usage, allocation_size);
+  }
+
   // Allocates a buffer from the allocator for use as a constant value.
   // The provided |source_buffer| may be returned if the device can use it
   // directly and otherwise will be copied.
@@ -87,6 +87,10 @@ class SubspanBuffer : public Buffer {
                parent_buffer->allowed_access(), parent_buffer->usage(),
                parent_buffer->allocation_size(), byte_offset, byte_length) {
     allocated_buffer_ = parent_buffer.get();
+    if (parent_buffer->host_data()) {
+      set_host_data(parent_buffer->host_data() - parent_buffer->byte_offset() +
+                    byte_offset);
+    }
     parent_buffer_ = std::move(parent_buffer);
   }
 
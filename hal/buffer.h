@@ -322,6 +322,12 @@ class Buffer : public Resource {
   constexpr device_size_t byte_offset() const noexcept { return byte_offset_; }
   constexpr device_size_t byte_length() const noexcept { return byte_length_; }
 
+  // Host pointer to the first byte of the buffer range if the buffer is host
+  // memory that remains mapped for its entire lifetime, otherwise nullptr.
+  // Hot paths may access [host_data(), host_data() + byte_length()) directly
+  // instead of going through MapMemory but must respect allowed_access().
+  uint8_t* host_data() const noexcept { return host_data_; }
+
   // TODO(benvanik): add debug_name.
 
   // Returns a longer debug string describing the buffer and its attributes.
@@ -449,6 +455,12 @@ class Buffer : public Resource {
     allowed_access_ = allowed_access;
   }
 
+  // Sets the pointer returned by host_data(). Only valid for buffers whose
+  // mapping operations do no work beyond returning an offset into |host_data|.
+  void set_host_data(void* host_data) {
+    host_data_ = static_cast<uint8_t*>(host_data);
+  }
+
   // Sets a range of the buffer to the given value.
   // State and parameters have already been validated. For the >8bit variants
   // the offset and length have already been validated to be aligned to the
@@ -594,6 +606,9 @@ class Buffer : public Resource {
   device_size_t byte_offset_ = 0;
   device_size_t byte_length_ = 0;
 
+  // Persistently mapped host pointer to byte_offset_, if any.
+  uint8_t* host_data_ = nullptr;
+
 #if HAS_IREE_BUFFER_DEBUG_NAME
   // Friendly name for the buffer used in DebugString. May be set by the app or
   // auto generated.
@@ -32,6 +32,9 @@ namespace hal {
 
 // A bitfield specifying the mode of operation for a command buffer.
 enum class CommandBufferMode : uint32_t {
+  // Command buffer may be submitted any number of times once recorded.
+  kNone = 0,
+
   // Command buffer will be submitted once and never used again.
   // This may enable in-place patching of command buffers that reduce overhead
   // when it's known that command buffers will not be reused.
@@ -316,6 +319,26 @@ class CommandBuffer : public Resource {
                             device_size_t length, const void* pattern,
                             size_t pattern_length) = 0;
 
+  // Fills the target buffer with a repeating 4-byte value like FillBuffer but
+  // with the value, target offset, and length sourced from device buffers at
+  // the time the command executes. This allows data-dependent fills to be
+  // recorded without first reading the parameters back on the host.
+  //
+  // Each parameter buffer is expected to contain a single int32 value at
+  // offset 0. The contents need not be available at the time of recording but
+  // must be made visible prior to execution of the fill command. As with
+  // FillBuffer the offset and length must be 4-byte aligned.
+  //
+  // All buffers must be compatible with the devices owned by this device queue
+  // and be allocated with BufferUsage::kTransfer.
+  //
+  // Only supported by the host backends; the Vulkan backend returns
+  // Unimplemented as vkCmdFillBuffer cannot source its parameters from device
+  // memory.
+  virtual Status FillBufferIndirect(Buffer* target_buffer, Buffer* value_buffer,
+                                    Buffer* offset_buffer,
+                                    Buffer* length_buffer) = 0;
+
   // Hints to the device queue that the given buffer will not be used again.
   // After encoding a discard the buffer contents will be considered undefined.
   // This is because the discard may be used to elide write backs to host memory
@@ -55,6 +55,9 @@ class ValidatingCommandBuffer : public CommandBuffer {
   Status FillBuffer(Buffer* target_buffer, device_size_t target_offset,
                     device_size_t length, const void* pattern,
                     size_t pattern_length) override;
+  Status FillBufferIndirect(Buffer* target_buffer, Buffer* value_buffer,
+                            Buffer* offset_buffer,
+                            Buffer* length_buffer) override;
   Status DiscardBuffer(Buffer* buffer) override;
   Status UpdateBuffer(const void* source_buffer, device_size_t source_offset,
                       Buffer* target_buffer, device_size_t target_offset,
@@ -294,6 +297,36 @@ Status ValidatingCommandBuffer::FillBuffer(Buffer* target_buffer,
                            pattern_length);
 }
 
+Status ValidatingCommandBuffer::FillBufferIndirect(Buffer* target_buffer,
+                                                   Buffer* value_buffer,
+                                                   Buffer* offset_buffer,
+                                                   Buffer* length_buffer) {
+  DVLOG(3) << "CommandBuffer::FillBufferIndirect("
+           << target_buffer->DebugString() << ", "
+           << value_buffer->DebugStringShort() << ", "
+           << offset_buffer->DebugStringShort() << ", "
+           << length_buffer->DebugStringShort() << ")";
+
+  RETURN_IF_ERROR(ValidateCategories(CommandCategory::kTransfer));
+  RETURN_IF_ERROR(
+      ValidateCompatibleMemoryType(target_buffer, MemoryType::kDeviceVisible));
+  RETURN_IF_ERROR(ValidateAccess(target_buffer, MemoryAccess::kWrite));
+  RETURN_IF_ERROR(ValidateUsage(target_buffer, BufferUsage::kTransfer));
+
+  // The target range is only known at execution time; here we can only ensure
+  // that the parameters themselves are readable.
+  for (auto* param_buffer : {value_buffer, offset_buffer, length_buffer}) {
+    RETURN_IF_ERROR(ValidateCompatibleMemoryType(param_buffer,
+                                                 MemoryType::kDeviceVisible));
+    RETURN_IF_ERROR(ValidateAccess(param_buffer, MemoryAccess::kRead));
+    RETURN_IF_ERROR(ValidateUsage(param_buffer, BufferUsage::kTransfer));
+    RETURN_IF_ERROR(ValidateRange(param_buffer, 0, sizeof(int32_t)));
+  }
+
+  return impl_->FillBufferIndirect(target_buffer, value_buffer, offset_buffer,
+                                   length_buffer);
+}
+
 Status ValidatingCommandBuffer::DiscardBuffer(Buffer* buffer) {
   DVLOG(3) << "CommandBuffer::DiscardBuffer(" << buffer->DebugString() << ")";
 
@@ -387,6 +420,16 @@ Status ValidatingCommandBuffer::Dispatch(
     // TODO(benvanik): validate buffer contains enough data for shape+size.
   }
 
+  if (dispatch_request.workload_buffer) {
+    auto* workload_buffer = dispatch_request.workload_buffer;
+    RETURN_IF_ERROR(ValidateCompatibleMemoryType(workload_buffer,
+                                                 MemoryType::kDeviceVisible))
+        << "workload buffer: " << workload_buffer->DebugStringShort();
+    RETURN_IF_ERROR(ValidateAccess(workload_buffer, MemoryAccess::kRead));
+    RETURN_IF_ERROR(ValidateUsage(workload_buffer, BufferUsage::kDispatch));
+    RETURN_IF_ERROR(ValidateRange(workload_buffer, 0, 3 * sizeof(int32_t)));
+  }
+
   // TODO(benvanik): validate no aliasing?
 
   return impl_->Dispatch(dispatch_request);
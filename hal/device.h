@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_DEVICE_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_DEVICE_H_
 
+#include <functional>
 #include <memory>
 
 #include "third_party/absl/time/clock.h"
@@ -151,6 +152,17 @@ class Device {
   }
   inline Status WaitIdle() { return WaitIdle(absl::InfiniteFuture()); }
 
+  // Schedules |task| to run asynchronously on a persistent host thread owned
+  // by the device. Devices pinned to a set of CPUs run the task on a thread
+  // pinned to the same CPUs so that host-side work driving the device (such as
+  // sequencing an invocation) stays local to its memory.
+  //
+  // Returns UNIMPLEMENTED if the device has no host threads of its own.
+  virtual Status ScheduleHostTask(std::function<void()> task) {
+    return UnimplementedErrorBuilder(ABSL_LOC)
+           << "Device " << info().name() << " does not run host tasks";
+  }
+
  protected:
   explicit Device(DeviceInfo device_info)
       : device_info_(std::move(device_info)) {}
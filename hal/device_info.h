@@ -53,6 +53,13 @@ enum class DeviceFeature : uint32_t {
   // during dispatch. Note that input executables must have partial embedded
   // debug information to allow mapping back to source offsets.
   kProfiling = 1 << 2,
+
+  // Device resolves the buffers referenced by recorded commands when the
+  // commands execute instead of when they are recorded.
+  // When present command buffers recorded against DeferredBuffers may be
+  // submitted multiple times with the DeferredBuffers rebound to different
+  // allocations between submissions.
+  kDeferredBinding = 1 << 3,
 };
 IREE_BITFIELD(DeviceFeature);
 using DeviceFeatureBitfield = DeviceFeature;
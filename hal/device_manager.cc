@@ -31,11 +31,14 @@ DeviceManager::~DeviceManager() = default;
 Status DeviceManager::RegisterDevice(std::shared_ptr<Device> device) {
   IREE_TRACE_SCOPE0("DeviceManager::RegisterDevice");
   absl::MutexLock lock(&device_mutex_);
-  if (std::find(devices_.begin(), devices_.end(), device) != devices_.end()) {
-    return FailedPreconditionErrorBuilder(ABSL_LOC)
-           << "Device already registered";
+  for (const auto& registered_device : devices_) {
+    if (registered_device.device == device) {
+      return FailedPreconditionErrorBuilder(ABSL_LOC)
+             << "Device already registered";
+    }
   }
-  devices_.push_back(std::move(device));
+  auto executable_cache = device->CreateExecutableCache();
+  devices_.push_back({std::move(device), std::move(executable_cache)});
   return OkStatus();
 }
 
@@ -43,8 +46,8 @@ Status DeviceManager::UnregisterDevice(Device* device) {
   IREE_TRACE_SCOPE0("DeviceManager::UnregisterDevice");
   absl::MutexLock lock(&device_mutex_);
   auto it = std::find_if(devices_.begin(), devices_.end(),
-                         [device](const std::shared_ptr<Device>& other_device) {
-                           return device == other_device.get();
+                         [device](const RegisteredDevice& registered_device) {
+                           return device == registered_device.device.get();
                          });
   if (it == devices_.end()) {
     return NotFoundErrorBuilder(ABSL_LOC) << "Device not registered";
@@ -53,21 +56,69 @@ Status DeviceManager::UnregisterDevice(Device* device) {
   return OkStatus();
 }
 
+// static
+bool DeviceManager::MatchesPlacementSpec(
+    const RegisteredDevice& registered_device,
+    const PlacementSpec& placement_spec) {
+  if (!placement_spec.device_name.empty() &&
+      registered_device.device->info().name() != placement_spec.device_name) {
+    return false;
+  }
+  if (!placement_spec.available_formats.empty()) {
+    bool any_format = false;
+    for (auto format : placement_spec.available_formats) {
+      if (registered_device.executable_cache->CanPrepareFormat(format)) {
+        any_format = true;
+        break;
+      }
+    }
+    if (!any_format) return false;
+  }
+  return true;
+}
+
 StatusOr<DevicePlacement> DeviceManager::ResolvePlacement(
     const PlacementSpec& placement_spec) const {
   IREE_TRACE_SCOPE0("DeviceManager::ResolvePlacement");
+  ASSIGN_OR_RETURN(auto device_placements, ResolvePlacements(placement_spec));
+  return device_placements.front();
+}
+
+StatusOr<std::vector<DevicePlacement>> DeviceManager::ResolvePlacements(
+    const PlacementSpec& placement_spec) const {
+  IREE_TRACE_SCOPE0("DeviceManager::ResolvePlacements");
   absl::MutexLock lock(&device_mutex_);
   if (devices_.empty()) {
     return NotFoundErrorBuilder(ABSL_LOC) << "No devices registered";
   }
 
-  // TODO(benvanik): multiple devices and placement.
-  QCHECK_EQ(devices_.size(), 1)
-      << "Multiple devices not yet supported (need placement)";
-  DevicePlacement device_placement;
-  device_placement.device = devices_.front();
+  // TODO(benvanik): rank by queue load and pick a queue_id.
+  std::vector<DevicePlacement> device_placements;
+  for (const auto& registered_device : devices_) {
+    if (!MatchesPlacementSpec(registered_device, placement_spec)) continue;
+    DevicePlacement device_placement;
+    device_placement.device = registered_device.device;
+    device_placements.push_back(std::move(device_placement));
+  }
+  if (device_placements.empty()) {
+    return NotFoundErrorBuilder(ABSL_LOC)
+           << "No registered device satisfies the placement spec";
+  }
 
-  return device_placement;
+  if (placement_spec.device_ordinal >= 0) {
+    if (static_cast<size_t>(placement_spec.device_ordinal) >=
+        device_placements.size()) {
+      return OutOfRangeErrorBuilder(ABSL_LOC)
+             << "Placement device ordinal " << placement_spec.device_ordinal
+             << " out of range; " << device_placements.size()
+             << " devices satisfy the spec";
+    }
+    auto device_placement =
+        std::move(device_placements[placement_spec.device_ordinal]);
+    device_placements.clear();
+    device_placements.push_back(std::move(device_placement));
+  }
+  return device_placements;
 }
 
 StatusOr<Allocator*> DeviceManager::FindCompatibleAllocator(
@@ -15,8 +15,10 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_DEVICE_MANAGER_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_DEVICE_MANAGER_H_
 
+#include <memory>
 #include <vector>
 
+#include "third_party/absl/strings/string_view.h"
 #include "third_party/absl/synchronization/mutex.h"
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/base/status.h"
@@ -24,6 +26,7 @@
 #include "third_party/mlir_edge/iree/hal/buffer.h"
 #include "third_party/mlir_edge/iree/hal/device.h"
 #include "third_party/mlir_edge/iree/hal/device_placement.h"
+#include "third_party/mlir_edge/iree/hal/executable_cache.h"
 #include "third_party/mlir_edge/iree/hal/executable_format.h"
 
 namespace iree {
@@ -39,6 +42,16 @@ struct PlacementSpec {
   // will be considered for placement. The formats can be sorted in descending
   // priority order to prefer the first available format in the case of ties.
   absl::Span<const ExecutableFormat> available_formats;
+
+  // Name of the device (as reported by DeviceInfo::name) to place on.
+  // Empty matches any device.
+  absl::string_view device_name;
+
+  // Ordinal of the device to place on among those satisfying the other
+  // requirements, in registration order. Callers running one model instance
+  // per device (such as one per socket) can use this to pin each instance.
+  // -1 selects the first satisfying device.
+  int device_ordinal = -1;
 };
 
 // Manages device lifetime and placement resolution.
@@ -66,12 +79,18 @@ class DeviceManager final {
 
   // Resolves a placement spec to a device placement based on the registered
   // devices.
-  // If the placement is not fully specified the device and queue may be chosen
-  // at random. See PlacementSpec for more information about resolution and
-  // ranking.
+  // If the placement is not fully specified the first satisfying device in
+  // registration order is chosen. See PlacementSpec for more information about
+  // resolution and ranking.
   StatusOr<DevicePlacement> ResolvePlacement(
       const PlacementSpec& placement_spec) const;
 
+  // Resolves a placement spec to all device placements that satisfy it, in
+  // registration order. Useful for splitting data-parallel work across
+  // devices. Fails if no device satisfies the spec.
+  StatusOr<std::vector<DevicePlacement>> ResolvePlacements(
+      const PlacementSpec& placement_spec) const;
+
   // Finds an allocator that can allocate buffers of the given |memory_type| and
   // |buffer_usage| such that the buffers can be used interchangebly.
   // Fails if there is no Allocator that can satisfy that requirement.
@@ -140,8 +159,19 @@ class DeviceManager final {
   }
 
  private:
+  struct RegisteredDevice {
+    std::shared_ptr<Device> device;
+    // Used to answer which executable formats the device supports.
+    std::shared_ptr<ExecutableCache> executable_cache;
+  };
+
+  // Returns true if |registered_device| satisfies |placement_spec|, ignoring
+  // PlacementSpec::device_ordinal.
+  static bool MatchesPlacementSpec(const RegisteredDevice& registered_device,
+                                   const PlacementSpec& placement_spec);
+
   mutable absl::Mutex device_mutex_;
-  std::vector<std::shared_ptr<Device>> devices_ ABSL_GUARDED_BY(device_mutex_);
+  std::vector<RegisteredDevice> devices_ ABSL_GUARDED_BY(device_mutex_);
 };
 
 }  // namespace hal
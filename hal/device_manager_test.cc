@@ -0,0 +1,119 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/hal/device_manager.h"
+
+#include <memory>
+#include <string>
+
+#include "testing/base/public/gunit.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/device_info.h"
+#include "third_party/mlir_edge/iree/hal/executable_format.h"
+#include "third_party/mlir_edge/iree/hal/interpreter/interpreter_device.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class DeviceManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    cpu0_ = CreateDevice("cpu0");
+    cpu1_ = CreateDevice("cpu1");
+    ASSERT_TRUE(device_manager_.RegisterDevice(cpu0_).ok());
+    ASSERT_TRUE(device_manager_.RegisterDevice(cpu1_).ok());
+  }
+
+  static std::shared_ptr<Device> CreateDevice(std::string name) {
+    InterpreterDevice::Options options;
+    options.worker_count = 0;
+    return std::make_shared<InterpreterDevice>(
+        DeviceInfo(std::move(name), DeviceFeature::kNone), options);
+  }
+
+  DeviceManager device_manager_;
+  std::shared_ptr<Device> cpu0_;
+  std::shared_ptr<Device> cpu1_;
+};
+
+TEST_F(DeviceManagerTest, ResolvesFirstDeviceByDefault) {
+  auto placement_or = device_manager_.ResolvePlacement({});
+  ASSERT_TRUE(placement_or.ok());
+  EXPECT_EQ(cpu0_, placement_or.ValueOrDie().device);
+}
+
+TEST_F(DeviceManagerTest, ResolvesAllDevicesInRegistrationOrder) {
+  auto placements_or = device_manager_.ResolvePlacements({});
+  ASSERT_TRUE(placements_or.ok());
+  const auto& placements = placements_or.ValueOrDie();
+  ASSERT_EQ(2u, placements.size());
+  EXPECT_EQ(cpu0_, placements[0].device);
+  EXPECT_EQ(cpu1_, placements[1].device);
+}
+
+TEST_F(DeviceManagerTest, ResolvesDeviceByName) {
+  PlacementSpec placement_spec;
+  placement_spec.device_name = "cpu1";
+  auto placement_or = device_manager_.ResolvePlacement(placement_spec);
+  ASSERT_TRUE(placement_or.ok());
+  EXPECT_EQ(cpu1_, placement_or.ValueOrDie().device);
+
+  placement_spec.device_name = "gpu0";
+  EXPECT_TRUE(
+      IsNotFound(device_manager_.ResolvePlacement(placement_spec).status()));
+}
+
+TEST_F(DeviceManagerTest, ResolvesDeviceByOrdinal) {
+  PlacementSpec placement_spec;
+  placement_spec.device_ordinal = 1;
+  auto placements_or = device_manager_.ResolvePlacements(placement_spec);
+  ASSERT_TRUE(placements_or.ok());
+  ASSERT_EQ(1u, placements_or.ValueOrDie().size());
+  EXPECT_EQ(cpu1_, placements_or.ValueOrDie()[0].device);
+
+  placement_spec.device_ordinal = 2;
+  EXPECT_TRUE(
+      IsOutOfRange(device_manager_.ResolvePlacement(placement_spec).status()));
+
+  // The ordinal indexes only the devices matching the rest of the spec.
+  placement_spec.device_name = "cpu1";
+  placement_spec.device_ordinal = 1;
+  EXPECT_TRUE(
+      IsOutOfRange(device_manager_.ResolvePlacement(placement_spec).status()));
+}
+
+TEST_F(DeviceManagerTest, FiltersDevicesByFormat) {
+  PlacementSpec placement_spec;
+  ExecutableFormat formats[] = {kExecutableFormatSpirV,
+                                kExecutableFormatIreeBytecode};
+  placement_spec.available_formats = formats;
+  auto placements_or = device_manager_.ResolvePlacements(placement_spec);
+  ASSERT_TRUE(placements_or.ok());
+  EXPECT_EQ(2u, placements_or.ValueOrDie().size());
+
+  ExecutableFormat spirv_formats[] = {kExecutableFormatSpirV};
+  placement_spec.available_formats = spirv_formats;
+  EXPECT_TRUE(
+      IsNotFound(device_manager_.ResolvePlacements(placement_spec).status()));
+}
+
+TEST_F(DeviceManagerTest, FailsWithoutDevices) {
+  DeviceManager device_manager;
+  EXPECT_TRUE(IsNotFound(device_manager.ResolvePlacement({}).status()));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -70,6 +70,20 @@ enum class ExecutableCachingMode : uint32_t {
   // must support the ExecutableFeature::kProfiling feature.
   kEnableProfiling = 1 << 5,
 
+  // Allows the executable to use approximate math routines (such as vectorized
+  // polynomial exp/log/tanh) with bounded error instead of exactly matching
+  // the standard library. Backends without fast variants ignore this.
+  //
+  // Executables must support the ExecutableFeature::kFastMath feature.
+  kAllowFastMath = 1 << 6,
+
+  // Uses compensated (Kahan) summation for floating-point reductions to bound
+  // rounding error at the cost of throughput. Ignored with kAllowFastMath.
+  //
+  // Executables must support the ExecutableFeature::kCompensatedSummation
+  // feature.
+  kCompensatedSummation = 1 << 7,
+
   // Default caching mode.
   kDefault = kAllowPersistentCaching | kAllowOptimization,
 };
@@ -15,7 +15,7 @@
 #include "third_party/mlir_edge/iree/hal/heap_buffer.h"
 
 #include <cstdint>
-#include <cstdlib>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -24,6 +24,7 @@
 #include "third_party/mlir_edge/iree/base/tracing.h"
 #include "third_party/mlir_edge/iree/hal/allocator.h"
 #include "third_party/mlir_edge/iree/hal/host/host_buffer.h"
+#include "third_party/mlir_edge/iree/hal/host/host_buffer_pool.h"
 
 namespace iree {
 namespace hal {
@@ -36,12 +37,11 @@ namespace {
 class HeapAllocator : public Allocator {
  public:
   // Returns a singleton heap allocator that can provide buffers that have
-  // MemoryType::kHostLocal and are allocated with malloc/free.
+  // MemoryType::kHostLocal and are allocated from a pool of host memory.
   // These buffers will not be usable by devices directly and may incur
   // additional copies.
   static Allocator* std_heap();
 
-  // TODO(benvanik): specify custom allocator (not malloc/free).
   HeapAllocator();
   ~HeapAllocator() override;
 
@@ -58,11 +58,23 @@ class HeapAllocator : public Allocator {
                                      BufferUsageBitfield buffer_usage,
                                      size_t allocation_size) override;
 
+  StatusOr<ref_ptr<Buffer>> AllocateUninitialized(
+      MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
+      size_t allocation_size) override;
+
   StatusOr<ref_ptr<Buffer>> WrapMutable(MemoryTypeBitfield memory_type,
                                         MemoryAccessBitfield allowed_access,
                                         BufferUsageBitfield buffer_usage,
                                         void* data,
                                         size_t data_length) override;
+
+ private:
+  StatusOr<ref_ptr<Buffer>> AllocateFromPool(MemoryTypeBitfield memory_type,
+                                             BufferUsageBitfield buffer_usage,
+                                             size_t allocation_size,
+                                             bool zero_initialize);
+
+  std::shared_ptr<HostBufferPool> pool_;
 };
 
 // static
@@ -71,7 +83,7 @@ Allocator* HeapAllocator::std_heap() {
   return std_heap_allocator;
 }
 
-HeapAllocator::HeapAllocator() = default;
+HeapAllocator::HeapAllocator() : pool_(std::make_shared<HostBufferPool>()) {}
 
 HeapAllocator::~HeapAllocator() = default;
 
@@ -106,7 +118,21 @@ StatusOr<ref_ptr<Buffer>> HeapAllocator::Allocate(
     MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
     size_t allocation_size) {
   IREE_TRACE_SCOPE0("HeapAllocator::Allocate");
+  return AllocateFromPool(memory_type, buffer_usage, allocation_size,
+                          /*zero_initialize=*/true);
+}
 
+StatusOr<ref_ptr<Buffer>> HeapAllocator::AllocateUninitialized(
+    MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
+    size_t allocation_size) {
+  IREE_TRACE_SCOPE0("HeapAllocator::AllocateUninitialized");
+  return AllocateFromPool(memory_type, buffer_usage, allocation_size,
+                          /*zero_initialize=*/false);
+}
+
+StatusOr<ref_ptr<Buffer>> HeapAllocator::AllocateFromPool(
+    MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
+    size_t allocation_size, bool zero_initialize) {
   if (!CanAllocate(memory_type, buffer_usage, allocation_size)) {
     return FailedPreconditionErrorBuilder(ABSL_LOC)
            << "Allocation not supported; memory_type="
@@ -115,16 +141,8 @@ StatusOr<ref_ptr<Buffer>> HeapAllocator::Allocate(
            << ", allocation_size=" << allocation_size;
   }
 
-  void* malloced_data = std::calloc(1, allocation_size);
-  if (!malloced_data) {
-    return ResourceExhaustedErrorBuilder(ABSL_LOC)
-           << "Failed to malloc " << allocation_size << " bytes";
-  }
-
-  auto buffer =
-      make_ref<HostBuffer>(this, memory_type, MemoryAccess::kAll, buffer_usage,
-                           allocation_size, malloced_data, true);
-  return buffer;
+  return pool_->Allocate(this, memory_type, buffer_usage, allocation_size,
+                         zero_initialize);
 }
 
 StatusOr<ref_ptr<Buffer>> HeapAllocator::WrapMutable(
@@ -146,6 +164,15 @@ ref_ptr<Buffer> HeapBuffer::Allocate(MemoryTypeBitfield memory_type,
   return std::move(buffer_or.ValueOrDie());
 }
 
+// static
+ref_ptr<Buffer> HeapBuffer::AllocateUninitialized(
+    MemoryTypeBitfield memory_type, BufferUsageBitfield usage,
+    size_t allocation_size) {
+  auto buffer_or = HeapAllocator::std_heap()->AllocateUninitialized(
+      memory_type, usage, allocation_size);
+  return std::move(buffer_or.ValueOrDie());
+}
+
 // static
 ref_ptr<Buffer> HeapBuffer::AllocateCopy(BufferUsageBitfield usage,
                                          const void* data, size_t data_length) {
@@ -159,8 +186,8 @@ ref_ptr<Buffer> HeapBuffer::AllocateCopy(BufferUsageBitfield usage,
   IREE_TRACE_SCOPE0("HeapBuffer::AllocateCopy");
   // Ensure we can map so that we can copy into it.
   usage |= BufferUsage::kMapping;
-  auto buffer_or = HeapAllocator::std_heap()->Allocate(MemoryType::kHostLocal,
-                                                       usage, data_length);
+  auto buffer_or = HeapAllocator::std_heap()->AllocateUninitialized(
+      MemoryType::kHostLocal, usage, data_length);
   auto buffer = std::move(buffer_or.ValueOrDie());
   buffer->WriteData(0, data, data_length).IgnoreError();
   buffer->set_allowed_access(allowed_access);
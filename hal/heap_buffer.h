@@ -23,14 +23,14 @@
 namespace iree {
 namespace hal {
 
-// Factory for buffers that are allocated from the host heap (malloc/free).
+// Factory for buffers that are allocated from the host heap.
 // These buffers cannot be used by devices and will incur copies/transfers when
 // used. Prefer device-specific allocators instead.
 class HeapBuffer {
  public:
   // Allocates a zeroed host heap buffer of the given size.
-  // Returns a buffer allocated with malloc and have MemoryType::kHostLocal
-  // and will not be usable by devices without copies.
+  // Returns a buffer allocated from the host heap and have
+  // MemoryType::kHostLocal and will not be usable by devices without copies.
   static ref_ptr<Buffer> Allocate(MemoryTypeBitfield memory_type,
                                   BufferUsageBitfield usage,
                                   size_t allocation_size);
@@ -39,6 +39,17 @@ class HeapBuffer {
     return Allocate(MemoryType::kHostLocal, usage, allocation_size);
   }
 
+  // Allocates a host heap buffer of the given size with undefined contents.
+  // Callers must fully overwrite the buffer before reading from it.
+  static ref_ptr<Buffer> AllocateUninitialized(MemoryTypeBitfield memory_type,
+                                               BufferUsageBitfield usage,
+                                               size_t allocation_size);
+  static ref_ptr<Buffer> AllocateUninitialized(BufferUsageBitfield usage,
+                                               size_t allocation_size) {
+    return AllocateUninitialized(MemoryType::kHostLocal, usage,
+                                 allocation_size);
+  }
+
   // Allocates a host heap buffer with a copy of the given data.
   // Returns a buffer allocated with malloc and have MemoryType::kHostLocal
   // and will not be usable by devices without copies.
@@ -0,0 +1,134 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/hal/host/concurrent_command_queue.h"
+
+#include <utility>
+
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+
+ConcurrentCommandQueue::ConcurrentCommandQueue(
+    std::unique_ptr<CommandQueue> target_queue, HostWorkerPool* worker_pool)
+    : CommandQueue(target_queue->name(), target_queue->supported_categories()),
+      target_queue_(std::move(target_queue)),
+      worker_pool_(worker_pool) {}
+
+ConcurrentCommandQueue::~ConcurrentCommandQueue() {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::dtor");
+  absl::MutexLock lock(&submission_mutex_);
+  submission_queue_.SignalShutdown();
+
+  // Wait for all in-flight batches to finish as they reference this queue.
+  submission_mutex_.Await(absl::Condition(
+      +[](int* in_flight_count) { return *in_flight_count == 0; },
+      &in_flight_count_));
+
+  CHECK(submission_queue_.empty())
+      << "Dirty shutdown of concurrent queue (batches still waiting?)";
+}
+
+void ConcurrentCommandQueue::TakeReadyBatches(ReadyBatchList* out_batches) {
+  while (true) {
+    HostSubmissionQueue::ReadyBatch batch;
+    auto ready_or = submission_queue_.TakeReadyBatch(&batch);
+    if (!ready_or.ok() || !ready_or.ValueOrDie()) {
+      // Either nothing is ready or the queue has failed; failures are sticky
+      // and reported through fences and permanent_error().
+      break;
+    }
+    ++in_flight_count_;
+    out_batches->push_back(std::move(batch));
+  }
+}
+
+void ConcurrentCommandQueue::ScheduleBatches(ReadyBatchList* batches) {
+  for (auto& batch : *batches) {
+    worker_pool_->Schedule([this, batch]() { ExecuteBatch(batch); });
+  }
+  batches->clear();
+}
+
+void ConcurrentCommandQueue::ExecuteBatch(
+    HostSubmissionQueue::ReadyBatch batch) {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::ExecuteBatch");
+
+  // Relay the command buffers to the target queue.
+  // Since we are taking care of all synchronization they don't need any
+  // waiters or fences.
+  auto status =
+      target_queue_->Submit({{}, batch.command_buffers(), {}}, {nullptr, 0u});
+
+  ReadyBatchList ready_batches;
+  {
+    absl::MutexLock lock(&submission_mutex_);
+    submission_queue_.CompleteBatch(&batch, std::move(status)).IgnoreError();
+    TakeReadyBatches(&ready_batches);
+  }
+
+  // We are still counted as in-flight here so the queue cannot be destroyed
+  // out from under us while scheduling the newly-ready batches.
+  ScheduleBatches(&ready_batches);
+
+  absl::MutexLock lock(&submission_mutex_);
+  --in_flight_count_;
+}
+
+Status ConcurrentCommandQueue::Submit(absl::Span<const SubmissionBatch> batches,
+                                      FenceValue fence) {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::Submit");
+  ReadyBatchList ready_batches;
+  {
+    absl::MutexLock lock(&submission_mutex_);
+    RETURN_IF_ERROR(submission_queue_.Enqueue(batches, fence));
+    TakeReadyBatches(&ready_batches);
+  }
+  ScheduleBatches(&ready_batches);
+  return OkStatus();
+}
+
+Status ConcurrentCommandQueue::Flush() {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::Flush");
+  // No-op (as we don't currently delay).
+  absl::MutexLock lock(&submission_mutex_);
+  return submission_queue_.permanent_error();
+}
+
+Status ConcurrentCommandQueue::WaitIdle(absl::Time deadline) {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::WaitIdle");
+
+  // Wait until the deadline or there are no more pending or in-flight
+  // submissions.
+  absl::MutexLock lock(&submission_mutex_);
+  if (!submission_mutex_.AwaitWithDeadline(
+          absl::Condition(
+              +[](ConcurrentCommandQueue* queue)
+                  ABSL_NO_THREAD_SAFETY_ANALYSIS {
+                    return queue->in_flight_count_ == 0 &&
+                           (queue->submission_queue_.empty() ||
+                            !queue->submission_queue_.permanent_error().ok());
+                  },
+              this),
+          deadline)) {
+    return DeadlineExceededErrorBuilder(ABSL_LOC)
+           << "Deadline exceeded waiting for concurrent queue to go idle";
+  }
+  return submission_queue_.permanent_error();
+}
+
+}  // namespace hal
+}  // namespace iree
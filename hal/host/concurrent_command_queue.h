@@ -0,0 +1,92 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_CONCURRENT_COMMAND_QUEUE_H_
+#define THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_CONCURRENT_COMMAND_QUEUE_H_
+
+#include <memory>
+
+#include "third_party/absl/base/thread_annotations.h"
+#include "third_party/absl/container/inlined_vector.h"
+#include "third_party/absl/synchronization/mutex.h"
+#include "third_party/mlir_edge/iree/hal/command_queue.h"
+#include "third_party/mlir_edge/iree/hal/fence.h"
+#include "third_party/mlir_edge/iree/hal/host/host_submission_queue.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
+
+namespace iree {
+namespace hal {
+
+// Concurrent command queue wrapper backed by a work-stealing HostWorkerPool.
+// Unlike AsyncCommandQueue, which processes every submission on a single
+// thread, each batch whose wait semaphores are satisfied is scheduled on the
+// pool as soon as it becomes ready and independent batches execute
+// concurrently against the provided |target_queue|.
+//
+// Target queues will receive submissions containing only command buffers as
+// all semaphore synchronization is handled by the wrapper and must support
+// concurrent Submit calls. Fences will also be omitted and code should safely
+// handle nullptr.
+//
+// Semaphores are only tracked within a single queue; a batch waiting on a
+// semaphore signaled from another queue will not be woken by that queue.
+//
+// ConcurrentCommandQueue (as with CommandQueue) is thread-safe.
+class ConcurrentCommandQueue final : public CommandQueue {
+ public:
+  // |worker_pool| must remain valid for the lifetime of the queue.
+  ConcurrentCommandQueue(std::unique_ptr<CommandQueue> target_queue,
+                         HostWorkerPool* worker_pool);
+  ~ConcurrentCommandQueue() override;
+
+  Status Submit(absl::Span<const SubmissionBatch> batches,
+                FenceValue fence) override;
+
+  Status Flush() override;
+  Status WaitIdle(absl::Time deadline) override;
+
+ private:
+  using ReadyBatchList =
+      absl::InlinedVector<HostSubmissionQueue::ReadyBatch, 4>;
+
+  // Takes all batches that are ready to run and marks them as in-flight.
+  void TakeReadyBatches(ReadyBatchList* out_batches)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(submission_mutex_);
+
+  // Schedules |batches| on the worker pool. Must be called without the lock
+  // held as the pool may run the batches inline.
+  void ScheduleBatches(ReadyBatchList* batches)
+      ABSL_LOCKS_EXCLUDED(submission_mutex_);
+
+  // Executes |batch| and hands it back to the submission queue, scheduling any
+  // batches that became ready as a result.
+  void ExecuteBatch(HostSubmissionQueue::ReadyBatch batch)
+      ABSL_LOCKS_EXCLUDED(submission_mutex_);
+
+  // CommandQueue that the concurrent queue relays submissions into.
+  std::unique_ptr<CommandQueue> target_queue_;
+
+  HostWorkerPool* worker_pool_;
+
+  // Queue that manages submission ordering.
+  mutable absl::Mutex submission_mutex_;
+  HostSubmissionQueue submission_queue_ ABSL_GUARDED_BY(submission_mutex_);
+  // Number of batches currently scheduled or executing on the pool.
+  int in_flight_count_ ABSL_GUARDED_BY(submission_mutex_) = 0;
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_CONCURRENT_COMMAND_QUEUE_H_
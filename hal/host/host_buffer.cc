@@ -34,7 +34,14 @@ HostBuffer::HostBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
     : Buffer(allocator, memory_type, allowed_access, usage, allocation_size, 0,
              allocation_size),
       data_(data),
-      owns_data_(owns_data) {}
+      owns_data_(owns_data) {
+  // Mapping host memory only offsets into |data| so the pointer can be handed
+  // out directly to callers allowed to map the buffer.
+  if (AnyBitSet(memory_type & MemoryType::kHostVisible) &&
+      AnyBitSet(usage & BufferUsage::kMapping)) {
+    set_host_data(data);
+  }
+}
 
 HostBuffer::~HostBuffer() {
   if (owns_data_ && data_) {
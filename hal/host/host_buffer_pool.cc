@@ -0,0 +1,243 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/hal/host/host_buffer_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "third_party/absl/strings/str_cat.h"
+#include "third_party/mlir_edge/iree/base/tracing.h"
+#include "third_party/mlir_edge/iree/hal/host/host_buffer.h"
+
+namespace iree {
+namespace hal {
+
+namespace {
+
+// Smallest block size; also the capacity of size class 0.
+constexpr size_t kMinBlockSize = 64;
+constexpr int kMinBlockSizeLog2 = 6;
+// Each power of two is split into this many size classes.
+constexpr int kSizeClassesPerDoubling = 4;
+constexpr int kMaxSizeClassBlockSizeLog2 = 20;
+constexpr int kSizeClassCount =
+    1 + (kMaxSizeClassBlockSizeLog2 - kMinBlockSizeLog2) *
+            kSizeClassesPerDoubling;
+
+// Returns floor(log2(value)) for value > 0.
+int FloorLog2(size_t value) {
+  int result = 0;
+  while (value >>= 1) ++result;
+  return result;
+}
+
+}  // namespace
+
+constexpr size_t HostBufferPool::kAlignment;
+constexpr size_t HostBufferPool::kMaxSizeClassBlockSize;
+constexpr size_t HostBufferPool::kLargeBlockGranularity;
+constexpr size_t HostBufferPool::kDefaultMaxCachedBytes;
+
+// A HostBuffer that returns its block to the pool when destroyed.
+class HostBufferPool::PooledBuffer final : public HostBuffer {
+ public:
+  PooledBuffer(std::shared_ptr<HostBufferPool> pool, Allocator* allocator,
+               MemoryTypeBitfield memory_type, BufferUsageBitfield usage,
+               device_size_t allocation_size, const Block& block)
+      : HostBuffer(allocator, memory_type, MemoryAccess::kAll, usage,
+                   allocation_size, block.data, /*owns_data=*/false),
+        pool_(std::move(pool)),
+        block_(block) {}
+
+  ~PooledBuffer() override { pool_->ReleaseBlock(block_); }
+
+ private:
+  std::shared_ptr<HostBufferPool> pool_;
+  Block block_;
+};
+
+std::string HostBufferPool::Statistics::DebugString() const {
+  return absl::StrCat("in use: ", bytes_in_use, "b (peak ", peak_bytes_in_use,
+                      "b), cached: ", bytes_cached, "b, reused: ", reuse_count,
+                      ", system allocations: ", system_allocation_count,
+                      ", uninitialized: ", uninitialized_count);
+}
+
+HostBufferPool::HostBufferPool(size_t max_cached_bytes)
+    : max_cached_bytes_(max_cached_bytes) {
+  absl::MutexLock lock(&mutex_);
+  size_class_free_lists_.resize(kSizeClassCount);
+}
+
+HostBufferPool::~HostBufferPool() { Trim(); }
+
+// static
+int HostBufferPool::SizeClassIndex(size_t size, size_t* out_capacity) {
+  if (size <= kMinBlockSize) {
+    *out_capacity = kMinBlockSize;
+    return 0;
+  }
+  // |size| is in (2^k, 2^(k+1)], which is split into kSizeClassesPerDoubling
+  // classes of 2^(k-2) bytes each.
+  int k = FloorLog2(size - 1);
+  size_t step = size_t{1} << (k - 2);
+  size_t capacity = (size + step - 1) & ~(step - 1);
+  int sub_class =
+      static_cast<int>(capacity >> (k - 2)) - kSizeClassesPerDoubling;
+  *out_capacity = capacity;
+  return (k - kMinBlockSizeLog2) * kSizeClassesPerDoubling + sub_class;
+}
+
+// static
+StatusOr<HostBufferPool::Block> HostBufferPool::AllocateSystemBlock(
+    size_t capacity, bool zeroed) {
+  IREE_TRACE_SCOPE0("HostBufferPool::AllocateSystemBlock");
+  // calloc can hand back fresh pages that are already zero without touching
+  // them so prefer that over malloc+memset.
+  void* allocation = zeroed ? std::calloc(1, capacity + kAlignment)
+                            : std::malloc(capacity + kAlignment);
+  if (!allocation) {
+    return ResourceExhaustedErrorBuilder(ABSL_LOC)
+           << "Failed to malloc " << capacity << " bytes";
+  }
+  Block block;
+  block.allocation = allocation;
+  block.data = reinterpret_cast<uint8_t*>(
+      (reinterpret_cast<uintptr_t>(allocation) + kAlignment - 1) &
+      ~(kAlignment - 1));
+  block.capacity = capacity;
+  return block;
+}
+
+// static
+void HostBufferPool::FreeSystemBlock(const Block& block) {
+  std::free(block.allocation);
+}
+
+StatusOr<ref_ptr<Buffer>> HostBufferPool::Allocate(
+    Allocator* allocator, MemoryTypeBitfield memory_type,
+    BufferUsageBitfield buffer_usage, size_t allocation_size,
+    bool zero_initialize) {
+  int size_class = -1;
+  size_t capacity = 0;
+  if (allocation_size <= kMaxSizeClassBlockSize) {
+    size_class = SizeClassIndex(allocation_size, &capacity);
+  } else {
+    capacity = (allocation_size + kLargeBlockGranularity - 1) /
+               kLargeBlockGranularity * kLargeBlockGranularity;
+  }
+
+  Block block;
+  bool reused = false;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (size_class >= 0) {
+      auto& free_list = size_class_free_lists_[size_class];
+      if (!free_list.empty()) {
+        block = free_list.back();
+        free_list.pop_back();
+        reused = true;
+      }
+    } else {
+      // Best fit, so long as it doesn't waste more than a size class would.
+      auto it = large_free_blocks_.lower_bound(capacity);
+      if (it != large_free_blocks_.end() &&
+          it->first <= capacity + capacity / 4) {
+        block = it->second;
+        large_free_blocks_.erase(it);
+        reused = true;
+      }
+    }
+    if (reused) {
+      statistics_.bytes_cached -= block.capacity;
+      ++statistics_.reuse_count;
+    } else {
+      ++statistics_.system_allocation_count;
+    }
+    if (!zero_initialize) ++statistics_.uninitialized_count;
+    statistics_.bytes_in_use += reused ? block.capacity : capacity;
+    statistics_.peak_bytes_in_use =
+        std::max(statistics_.peak_bytes_in_use, statistics_.bytes_in_use);
+  }
+
+  if (reused) {
+    if (zero_initialize) {
+      std::memset(block.data, 0, allocation_size);
+    }
+  } else {
+    auto block_or = AllocateSystemBlock(capacity, zero_initialize);
+    if (!block_or.ok()) {
+      absl::MutexLock lock(&mutex_);
+      statistics_.bytes_in_use -= capacity;
+      return block_or.status();
+    }
+    block = block_or.ValueOrDie();
+  }
+
+  return make_ref<PooledBuffer>(shared_from_this(), allocator, memory_type,
+                                buffer_usage, allocation_size, block);
+}
+
+void HostBufferPool::ReleaseBlock(const Block& block) {
+  {
+    absl::MutexLock lock(&mutex_);
+    statistics_.bytes_in_use -= block.capacity;
+    if (statistics_.bytes_cached + block.capacity <= max_cached_bytes_) {
+      if (block.capacity <= kMaxSizeClassBlockSize) {
+        size_t capacity = 0;
+        int size_class = SizeClassIndex(block.capacity, &capacity);
+        size_class_free_lists_[size_class].push_back(block);
+      } else {
+        large_free_blocks_.emplace(block.capacity, block);
+      }
+      statistics_.bytes_cached += block.capacity;
+      return;
+    }
+  }
+  FreeSystemBlock(block);
+}
+
+void HostBufferPool::Trim() {
+  IREE_TRACE_SCOPE0("HostBufferPool::Trim");
+  std::vector<std::vector<Block>> size_class_free_lists;
+  std::multimap<size_t, Block> large_free_blocks;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (auto& free_list : size_class_free_lists_) {
+      size_class_free_lists.push_back(std::move(free_list));
+      free_list.clear();
+    }
+    large_free_blocks.swap(large_free_blocks_);
+    statistics_.bytes_cached = 0;
+  }
+  for (const auto& free_list : size_class_free_lists) {
+    for (const auto& block : free_list) {
+      FreeSystemBlock(block);
+    }
+  }
+  for (const auto& entry : large_free_blocks) {
+    FreeSystemBlock(entry.second);
+  }
+}
+
+HostBufferPool::Statistics HostBufferPool::statistics() const {
+  absl::MutexLock lock(&mutex_);
+  return statistics_;
+}
+
+}  // namespace hal
+}  // namespace iree
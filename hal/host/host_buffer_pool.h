@@ -0,0 +1,132 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_HOST_BUFFER_POOL_H_
+#define THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_HOST_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "third_party/absl/base/thread_annotations.h"
+#include "third_party/absl/synchronization/mutex.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/buffer.h"
+
+namespace iree {
+namespace hal {
+
+class Allocator;
+
+// A caching pool of host memory blocks backing HostBuffers.
+//
+// Requests are rounded up to a size class (4 classes per power of two, so at
+// most 25% is wasted) and blocks released by buffers are kept on per-class
+// free lists for reuse. Blocks larger than the largest size class are rounded
+// to kLargeBlockGranularity and reused by any request they fit without wasting
+// more than 25%. Released blocks beyond |max_cached_bytes| are returned to the
+// system immediately.
+//
+// All blocks are aligned to kAlignment so they can be used with any SIMD width
+// and never share cache lines with other allocations.
+//
+// Pools must be owned by a std::shared_ptr; buffers retain a reference to the
+// pool so that they may safely outlive the allocator that created them.
+//
+// Thread-safe.
+class HostBufferPool : public std::enable_shared_from_this<HostBufferPool> {
+ public:
+  // Alignment of all blocks returned by the pool.
+  static constexpr size_t kAlignment = 64;
+  // Largest block size served from the size-class free lists.
+  static constexpr size_t kMaxSizeClassBlockSize = 1024 * 1024;
+  // Rounding applied to blocks larger than kMaxSizeClassBlockSize.
+  static constexpr size_t kLargeBlockGranularity = 64 * 1024;
+  // Default limit on the bytes retained in the free lists.
+  static constexpr size_t kDefaultMaxCachedBytes = 256 * 1024 * 1024;
+
+  struct Statistics {
+    // Bytes in blocks referenced by live buffers (including rounding).
+    size_t bytes_in_use = 0;
+    size_t peak_bytes_in_use = 0;
+    // Bytes in blocks retained in the free lists.
+    size_t bytes_cached = 0;
+    // Allocations served from the free lists.
+    int64_t reuse_count = 0;
+    // Allocations that required a new block from the system.
+    int64_t system_allocation_count = 0;
+    // Allocations that skipped zero-initialization.
+    int64_t uninitialized_count = 0;
+
+    std::string DebugString() const;
+  };
+
+  explicit HostBufferPool(size_t max_cached_bytes = kDefaultMaxCachedBytes);
+  ~HostBufferPool();
+
+  HostBufferPool(const HostBufferPool&) = delete;
+  HostBufferPool& operator=(const HostBufferPool&) = delete;
+
+  // Allocates a HostBuffer of |allocation_size| bytes backed by a pooled
+  // block. The buffer contents are zeroed if |zero_initialize| is true and
+  // otherwise undefined. |allocator| is reported as the owning allocator of
+  // the buffer.
+  StatusOr<ref_ptr<Buffer>> Allocate(Allocator* allocator,
+                                     MemoryTypeBitfield memory_type,
+                                     BufferUsageBitfield buffer_usage,
+                                     size_t allocation_size,
+                                     bool zero_initialize);
+
+  // Returns all cached blocks to the system.
+  void Trim();
+
+  Statistics statistics() const;
+
+ private:
+  class PooledBuffer;
+
+  struct Block {
+    // Pointer returned by the system allocator.
+    void* allocation = nullptr;
+    // |allocation| rounded up to kAlignment.
+    uint8_t* data = nullptr;
+    size_t capacity = 0;
+  };
+
+  // Returns the size-class index for |size| (<= kMaxSizeClassBlockSize) and
+  // the capacity of blocks in that class.
+  static int SizeClassIndex(size_t size, size_t* out_capacity);
+
+  static StatusOr<Block> AllocateSystemBlock(size_t capacity, bool zeroed);
+  static void FreeSystemBlock(const Block& block);
+
+  // Returns a block to the pool once the buffer referencing it is destroyed.
+  void ReleaseBlock(const Block& block);
+
+  const size_t max_cached_bytes_;
+
+  mutable absl::Mutex mutex_;
+  std::vector<std::vector<Block>> size_class_free_lists_
+      ABSL_GUARDED_BY(mutex_);
+  std::multimap<size_t, Block> large_free_blocks_ ABSL_GUARDED_BY(mutex_);
+  Statistics statistics_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_HOST_BUFFER_POOL_H_
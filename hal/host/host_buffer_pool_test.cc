@@ -0,0 +1,137 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/hal/host/host_buffer_pool.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "testing/base/public/gmock.h"
+#include "testing/base/public/gunit.h"
+#include "third_party/mlir_edge/iree/base/logging.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/host/host_local_allocator.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::testing::Each;
+
+constexpr size_t kLargeBlockSize = 2 * HostBufferPool::kMaxSizeClassBlockSize;
+
+ref_ptr<Buffer> AllocateFromPool(HostBufferPool* pool, size_t size) {
+  auto buffer_or = pool->Allocate(/*allocator=*/nullptr, MemoryType::kHostLocal,
+                                  BufferUsage::kAll, size,
+                                  /*zero_initialize=*/true);
+  CHECK(buffer_or.ok()) << buffer_or.status();
+  return std::move(buffer_or).ValueOrDie();
+}
+
+TEST(HostBufferPoolTest, ReusesBlocksWithinSizeClass) {
+  auto pool = std::make_shared<HostBufferPool>();
+  AllocateFromPool(pool.get(), 1000).reset();
+  EXPECT_EQ(1024u, pool->statistics().bytes_cached);
+
+  // 900 bytes rounds up to the same 1024 byte class as 1000 bytes.
+  auto buffer = AllocateFromPool(pool.get(), 900);
+  EXPECT_EQ(900u, buffer->allocation_size());
+  auto statistics = pool->statistics();
+  EXPECT_EQ(1, statistics.reuse_count);
+  EXPECT_EQ(1, statistics.system_allocation_count);
+  EXPECT_EQ(0u, statistics.bytes_cached);
+  EXPECT_EQ(1024u, statistics.bytes_in_use);
+
+  // 1500 bytes is in a larger class and cannot use the cached block.
+  buffer.reset();
+  auto larger_buffer = AllocateFromPool(pool.get(), 1500);
+  statistics = pool->statistics();
+  EXPECT_EQ(1, statistics.reuse_count);
+  EXPECT_EQ(2, statistics.system_allocation_count);
+}
+
+TEST(HostBufferPoolTest, ReusesBestFittingLargeBlock) {
+  auto pool = std::make_shared<HostBufferPool>();
+  auto small_block = AllocateFromPool(pool.get(), kLargeBlockSize);
+  auto large_block = AllocateFromPool(pool.get(), 2 * kLargeBlockSize);
+  small_block.reset();
+  large_block.reset();
+
+  // The smallest cached block that fits is chosen.
+  auto buffer = AllocateFromPool(pool.get(), kLargeBlockSize - 1);
+  auto statistics = pool->statistics();
+  EXPECT_EQ(1, statistics.reuse_count);
+  EXPECT_EQ(kLargeBlockSize, statistics.bytes_in_use);
+  EXPECT_EQ(2 * kLargeBlockSize, statistics.bytes_cached);
+
+  // The remaining block would waste more than 25% of a smaller request.
+  auto small_buffer =
+      AllocateFromPool(pool.get(), HostBufferPool::kMaxSizeClassBlockSize + 1);
+  statistics = pool->statistics();
+  EXPECT_EQ(1, statistics.reuse_count);
+  EXPECT_EQ(3, statistics.system_allocation_count);
+  EXPECT_EQ(2 * kLargeBlockSize, statistics.bytes_cached);
+}
+
+TEST(HostBufferPoolTest, TrimReleasesCachedBlocks) {
+  auto pool = std::make_shared<HostBufferPool>();
+  AllocateFromPool(pool.get(), 256).reset();
+  AllocateFromPool(pool.get(), kLargeBlockSize).reset();
+  EXPECT_EQ(256 + kLargeBlockSize, pool->statistics().bytes_cached);
+
+  pool->Trim();
+  EXPECT_EQ(0u, pool->statistics().bytes_cached);
+
+  auto buffer = AllocateFromPool(pool.get(), 256);
+  auto statistics = pool->statistics();
+  EXPECT_EQ(0, statistics.reuse_count);
+  EXPECT_EQ(3, statistics.system_allocation_count);
+}
+
+TEST(HostBufferPoolTest, ReleasesBlocksBeyondCacheLimit) {
+  auto pool = std::make_shared<HostBufferPool>(/*max_cached_bytes=*/1024);
+  auto buffer_0 = AllocateFromPool(pool.get(), 1024);
+  auto buffer_1 = AllocateFromPool(pool.get(), 1024);
+  buffer_0.reset();
+  buffer_1.reset();
+  EXPECT_EQ(1024u, pool->statistics().bytes_cached);
+}
+
+// Recycled blocks still hold the contents of their previous buffer. Allocate
+// must clear them while AllocateUninitialized may leave them as-is.
+TEST(HostBufferPoolTest, AllocateZeroesRecycledBlocks) {
+  HostLocalAllocator allocator;
+  auto memory_type = MemoryType::kHostLocal | MemoryType::kDeviceVisible;
+  auto dirty_buffer_or =
+      allocator.AllocateUninitialized(memory_type, BufferUsage::kAll, 256);
+  ASSERT_TRUE(dirty_buffer_or.ok());
+  auto dirty_buffer = std::move(dirty_buffer_or).ValueOrDie();
+  ASSERT_TRUE(dirty_buffer->Fill8(uint8_t{0xCD}).ok());
+  dirty_buffer.reset();
+
+  auto buffer_or = allocator.Allocate(memory_type, BufferUsage::kAll, 256);
+  ASSERT_TRUE(buffer_or.ok());
+  auto buffer = std::move(buffer_or).ValueOrDie();
+  EXPECT_EQ(1, allocator.pool_statistics().reuse_count);
+
+  std::array<uint8_t, 256> contents;
+  ASSERT_TRUE(buffer->ReadData(0, contents.data(), contents.size()).ok());
+  EXPECT_THAT(contents, Each(0));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -14,21 +14,23 @@
 
 #include "third_party/mlir_edge/iree/hal/host/host_local_allocator.h"
 
-#include <cstdlib>
 #include <string>
 #include <utility>
 
 #include "third_party/absl/types/source_location.h"
+#include "third_party/mlir_edge/iree/base/logging.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/base/tracing.h"
-#include "third_party/mlir_edge/iree/hal/host/host_buffer.h"
 
 namespace iree {
 namespace hal {
 
-HostLocalAllocator::HostLocalAllocator() = default;
+HostLocalAllocator::HostLocalAllocator()
+    : pool_(std::make_shared<HostBufferPool>()) {}
 
-HostLocalAllocator::~HostLocalAllocator() = default;
+HostLocalAllocator::~HostLocalAllocator() {
+  VLOG(1) << "HostLocalAllocator pool: " << pool_->statistics().DebugString();
+}
 
 bool HostLocalAllocator::CanUseBufferLike(
     Allocator* source_allocator, MemoryTypeBitfield memory_type,
@@ -83,7 +85,21 @@ StatusOr<ref_ptr<Buffer>> HostLocalAllocator::Allocate(
     MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
     size_t allocation_size) {
   IREE_TRACE_SCOPE0("HostLocalAllocator::Allocate");
+  return AllocateFromPool(memory_type, buffer_usage, allocation_size,
+                          /*zero_initialize=*/true);
+}
 
+StatusOr<ref_ptr<Buffer>> HostLocalAllocator::AllocateUninitialized(
+    MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
+    size_t allocation_size) {
+  IREE_TRACE_SCOPE0("HostLocalAllocator::AllocateUninitialized");
+  return AllocateFromPool(memory_type, buffer_usage, allocation_size,
+                          /*zero_initialize=*/false);
+}
+
+StatusOr<ref_ptr<Buffer>> HostLocalAllocator::AllocateFromPool(
+    MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
+    size_t allocation_size, bool zero_initialize) {
   if (!CanAllocate(memory_type, buffer_usage, allocation_size)) {
     return FailedPreconditionErrorBuilder(ABSL_LOC)
            << "Allocation not supported; memory_type="
@@ -95,16 +111,8 @@ StatusOr<ref_ptr<Buffer>> HostLocalAllocator::Allocate(
   // Make compatible with our requirements.
   RETURN_IF_ERROR(MakeCompatible(&memory_type, &buffer_usage));
 
-  void* malloced_data = std::calloc(1, allocation_size);
-  if (!malloced_data) {
-    return ResourceExhaustedErrorBuilder(ABSL_LOC)
-           << "Failed to malloc " << allocation_size << " bytes";
-  }
-
-  auto buffer =
-      make_ref<HostBuffer>(this, memory_type, MemoryAccess::kAll, buffer_usage,
-                           allocation_size, malloced_data, true);
-  return buffer;
+  return pool_->Allocate(this, memory_type, buffer_usage, allocation_size,
+                         zero_initialize);
 }
 
 }  // namespace hal
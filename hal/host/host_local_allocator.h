@@ -21,6 +21,7 @@
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/hal/allocator.h"
 #include "third_party/mlir_edge/iree/hal/buffer.h"
+#include "third_party/mlir_edge/iree/hal/host/host_buffer_pool.h"
 
 namespace iree {
 namespace hal {
@@ -32,6 +33,10 @@ namespace hal {
 // the 'device' in the case of a host-local queue *is* the host. To keep code
 // written initially for a host-local queue working when other queues are used
 // the allocator only works with buffers that are kDeviceVisible.
+//
+// Buffer storage is recycled through a HostBufferPool so that steady-state
+// execution does not need to go to the system allocator (and page in and zero
+// fresh memory) for every intermediate buffer.
 class HostLocalAllocator : public Allocator {
  public:
   HostLocalAllocator();
@@ -52,6 +57,25 @@ class HostLocalAllocator : public Allocator {
   StatusOr<ref_ptr<Buffer>> Allocate(MemoryTypeBitfield memory_type,
                                      BufferUsageBitfield buffer_usage,
                                      size_t allocation_size) override;
+
+  StatusOr<ref_ptr<Buffer>> AllocateUninitialized(
+      MemoryTypeBitfield memory_type, BufferUsageBitfield buffer_usage,
+      size_t allocation_size) override;
+
+  // Returns cached buffer storage to the system.
+  void Trim() { pool_->Trim(); }
+
+  HostBufferPool::Statistics pool_statistics() const {
+    return pool_->statistics();
+  }
+
+ private:
+  StatusOr<ref_ptr<Buffer>> AllocateFromPool(MemoryTypeBitfield memory_type,
+                                             BufferUsageBitfield buffer_usage,
+                                             size_t allocation_size,
+                                             bool zero_initialize);
+
+  std::shared_ptr<HostBufferPool> pool_;
 };
 
 }  // namespace hal
@@ -83,6 +83,28 @@ Status HostLocalCommandProcessor::FillBuffer(Buffer* target_buffer,
   return target_buffer->Fill(target_offset, length, pattern, pattern_length);
 }
 
+Status HostLocalCommandProcessor::FillBufferIndirect(Buffer* target_buffer,
+                                                     Buffer* value_buffer,
+                                                     Buffer* offset_buffer,
+                                                     Buffer* length_buffer) {
+  IREE_TRACE_SCOPE0("HostLocalCommandProcessor::FillBufferIndirect");
+  // Host memory is coherent so the parameters can be read in-order with the
+  // rest of the command stream instead of requiring a readback at recording.
+  int32_t value = 0;
+  int32_t target_offset = 0;
+  int32_t length = 0;
+  RETURN_IF_ERROR(value_buffer->ReadData(0, &value, sizeof(value)));
+  RETURN_IF_ERROR(
+      offset_buffer->ReadData(0, &target_offset, sizeof(target_offset)));
+  RETURN_IF_ERROR(length_buffer->ReadData(0, &length, sizeof(length)));
+  if (target_offset < 0 || length < 0) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Indirect fill range is negative (offset=" << target_offset
+           << ", length=" << length << ")";
+  }
+  return target_buffer->Fill(target_offset, length, &value, sizeof(value));
+}
+
 Status HostLocalCommandProcessor::DiscardBuffer(Buffer* buffer) {
   IREE_TRACE_SCOPE0("HostLocalCommandProcessor::DiscardBuffer");
   // No-op as we don't support lazily allocated buffers.
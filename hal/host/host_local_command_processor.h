@@ -63,6 +63,10 @@ class HostLocalCommandProcessor : public CommandBuffer {
                     device_size_t length, const void* pattern,
                     size_t pattern_length) override;
 
+  Status FillBufferIndirect(Buffer* target_buffer, Buffer* value_buffer,
+                            Buffer* offset_buffer,
+                            Buffer* length_buffer) override;
+
   Status DiscardBuffer(Buffer* buffer) override;
 
   Status UpdateBuffer(const void* source_buffer, device_size_t source_offset,
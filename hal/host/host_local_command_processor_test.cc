@@ -0,0 +1,119 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/hal/host/host_local_command_processor.h"
+
+#include <array>
+#include <cstdint>
+
+#include "testing/base/public/gmock.h"
+#include "testing/base/public/gunit.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/heap_buffer.h"
+#include "third_party/mlir_edge/iree/hal/host/host_local_allocator.h"
+#include "third_party/mlir_edge/iree/hal/host/inproc_command_buffer.h"
+#include "third_party/mlir_edge/iree/hal/testing/mock_command_buffer.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::testing::Field;
+using ::testing::Return;
+
+ref_ptr<Buffer> AllocateInt32(int32_t value) {
+  return HeapBuffer::AllocateCopy(BufferUsage::kAll,
+                                  absl::Span<const int32_t>(&value, 1));
+}
+
+class HostLocalCommandProcessorTest : public ::testing::Test {
+ protected:
+  HostLocalAllocator allocator_;
+};
+
+TEST_F(HostLocalCommandProcessorTest, FillBufferIndirect) {
+  auto target_buffer = HeapBuffer::Allocate(BufferUsage::kAll, 16);
+  auto value_buffer = AllocateInt32(0x01020304);
+  auto offset_buffer = AllocateInt32(4);
+  auto length_buffer = AllocateInt32(8);
+
+  HostLocalCommandProcessor processor(
+      &allocator_, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  ASSERT_TRUE(processor.Begin().ok());
+  ASSERT_TRUE(processor
+                  .FillBufferIndirect(target_buffer.get(), value_buffer.get(),
+                                      offset_buffer.get(), length_buffer.get())
+                  .ok());
+  ASSERT_TRUE(processor.End().ok());
+
+  std::array<int32_t, 4> contents;
+  ASSERT_TRUE(
+      target_buffer->ReadData(0, contents.data(), sizeof(contents)).ok());
+  EXPECT_THAT(contents, ::testing::ElementsAre(0, 0x01020304, 0x01020304, 0));
+}
+
+TEST_F(HostLocalCommandProcessorTest, FillBufferIndirectNegativeLength) {
+  auto target_buffer = HeapBuffer::Allocate(BufferUsage::kAll, 16);
+  auto value_buffer = AllocateInt32(1);
+  auto offset_buffer = AllocateInt32(0);
+  auto length_buffer = AllocateInt32(-4);
+
+  HostLocalCommandProcessor processor(
+      &allocator_, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  ASSERT_TRUE(processor.Begin().ok());
+  EXPECT_TRUE(IsInvalidArgument(processor.FillBufferIndirect(
+      target_buffer.get(), value_buffer.get(), offset_buffer.get(),
+      length_buffer.get())));
+}
+
+// Indirect parameters must be forwarded as buffers so that they are read when
+// the command executes and not when it is recorded.
+TEST_F(HostLocalCommandProcessorTest, InProcReplaysIndirectCommands) {
+  auto target_buffer = HeapBuffer::Allocate(BufferUsage::kAll, 16);
+  auto value_buffer = AllocateInt32(1);
+  auto offset_buffer = AllocateInt32(0);
+  auto length_buffer = AllocateInt32(16);
+  auto workload_buffer = HeapBuffer::Allocate(BufferUsage::kAll, 12);
+
+  InProcCommandBuffer command_buffer(
+      &allocator_, CommandBufferMode::kOneShot,
+      CommandCategory::kTransfer | CommandCategory::kDispatch);
+  ASSERT_TRUE(command_buffer.Begin().ok());
+  ASSERT_TRUE(command_buffer
+                  .FillBufferIndirect(target_buffer.get(), value_buffer.get(),
+                                      offset_buffer.get(), length_buffer.get())
+                  .ok());
+  DispatchRequest dispatch_request;
+  dispatch_request.workload_buffer = workload_buffer.get();
+  ASSERT_TRUE(command_buffer.Dispatch(dispatch_request).ok());
+  ASSERT_TRUE(command_buffer.End().ok());
+
+  testing::MockCommandBuffer processor(
+      &allocator_, CommandBufferMode::kOneShot,
+      CommandCategory::kTransfer | CommandCategory::kDispatch);
+  EXPECT_CALL(processor, Begin()).WillOnce(Return(OkStatus()));
+  EXPECT_CALL(processor,
+              FillBufferIndirect(target_buffer.get(), value_buffer.get(),
+                                 offset_buffer.get(), length_buffer.get()))
+      .WillOnce(Return(OkStatus()));
+  EXPECT_CALL(processor, Dispatch(Field(&DispatchRequest::workload_buffer,
+                                        workload_buffer.get())))
+      .WillOnce(Return(OkStatus()));
+  EXPECT_CALL(processor, End()).WillOnce(Return(OkStatus()));
+  EXPECT_TRUE(command_buffer.Process(&processor).ok());
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
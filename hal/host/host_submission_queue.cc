@@ -229,7 +229,19 @@ Status HostSubmissionQueue::ProcessBatch(const PendingBatch& batch,
   IREE_TRACE_SCOPE0("HostSubmissionQueue::ProcessBatch");
 
   // Complete the waits on all semaphores and reset them.
-  for (auto& semaphore_value : batch.wait_semaphores) {
+  RETURN_IF_ERROR(EndWaiting(batch.wait_semaphores));
+
+  // Let the caller handle execution of the command buffers.
+  RETURN_IF_ERROR(execute_fn(batch.command_buffers));
+
+  // Signal all semaphores to allow them to unblock waiters.
+  return EndSignaling(batch.signal_semaphores);
+}
+
+// static
+Status HostSubmissionQueue::EndWaiting(
+    absl::Span<const SemaphoreValue> wait_semaphores) {
+  for (auto& semaphore_value : wait_semaphores) {
     if (semaphore_value.index() == 0) {
       auto* binary_semaphore =
           reinterpret_cast<HostBinarySemaphore*>(absl::get<0>(semaphore_value));
@@ -239,12 +251,13 @@ Status HostSubmissionQueue::ProcessBatch(const PendingBatch& batch,
       return UnimplementedErrorBuilder(ABSL_LOC) << "Timeline semaphores NYI";
     }
   }
+  return OkStatus();
+}
 
-  // Let the caller handle execution of the command buffers.
-  RETURN_IF_ERROR(execute_fn(batch.command_buffers));
-
-  // Signal all semaphores to allow them to unblock waiters.
-  for (auto& semaphore_value : batch.signal_semaphores) {
+// static
+Status HostSubmissionQueue::EndSignaling(
+    absl::Span<const SemaphoreValue> signal_semaphores) {
+  for (auto& semaphore_value : signal_semaphores) {
     if (semaphore_value.index() == 0) {
       auto* binary_semaphore =
           reinterpret_cast<HostBinarySemaphore*>(absl::get<0>(semaphore_value));
@@ -254,7 +267,79 @@ Status HostSubmissionQueue::ProcessBatch(const PendingBatch& batch,
       return UnimplementedErrorBuilder(ABSL_LOC) << "Timeline semaphores NYI";
     }
   }
+  return OkStatus();
+}
 
+StatusOr<bool> HostSubmissionQueue::TakeReadyBatch(ReadyBatch* out_batch) {
+  IREE_TRACE_SCOPE0("HostSubmissionQueue::TakeReadyBatch");
+
+  if (!permanent_error_.ok()) {
+    // Sticky failure state.
+    return permanent_error_;
+  }
+
+  // Submissions are scanned in order so that earlier work is preferred, though
+  // any ready batch may be taken.
+  for (auto* submission : list_) {
+    for (int i = 0; i < submission->pending_batches.size(); ++i) {
+      auto& batch = submission->pending_batches[i];
+      if (!IsBatchReady(batch)) continue;
+
+      auto wait_status = EndWaiting(batch.wait_semaphores);
+      out_batch->submission_ = submission;
+      out_batch->command_buffers_ = std::move(batch.command_buffers);
+      out_batch->signal_semaphores_ = std::move(batch.signal_semaphores);
+      submission->pending_batches.erase(submission->pending_batches.begin() +
+                                        i);
+      if (!wait_status.ok()) {
+        // Abort everything just as if the batch had failed executing.
+        permanent_error_ = wait_status;
+        FailAllPending(permanent_error_);
+        return permanent_error_;
+      }
+
+      ++submission->in_flight_count;
+      return true;
+    }
+  }
+  return false;
+}
+
+Status HostSubmissionQueue::CompleteBatch(ReadyBatch* batch, Status status) {
+  IREE_TRACE_SCOPE0("HostSubmissionQueue::CompleteBatch");
+
+  auto* submission = batch->submission_;
+  DCHECK(submission);
+  DCHECK_GT(submission->in_flight_count, 0);
+  --submission->in_flight_count;
+  batch->submission_ = nullptr;
+
+  if (status.ok() && permanent_error_.ok()) {
+    status = EndSignaling(batch->signal_semaphores_);
+  }
+  if (!status.ok() && permanent_error_.ok()) {
+    // Batch failed; set the permanent error flag and abort all other work
+    // (simulating a device loss).
+    permanent_error_ = status;
+    FailAllPending(permanent_error_);
+    return permanent_error_;
+  } else if (!permanent_error_.ok()) {
+    // A prior failure already completed the submission; we were just keeping
+    // it alive for this batch.
+    if (submission->in_flight_count == 0) {
+      list_.take(submission).reset();
+    }
+    return permanent_error_;
+  }
+
+  if (submission->pending_batches.empty() &&
+      submission->in_flight_count == 0) {
+    // All work for this submission completed successfully. Signal the fence
+    // and remove the submission from the list.
+    auto complete_status = CompleteSubmission(submission, OkStatus());
+    list_.take(submission).reset();
+    return complete_status;
+  }
   return OkStatus();
 }
 
@@ -265,6 +350,8 @@ Status HostSubmissionQueue::CompleteSubmission(Submission* submission,
   // It's safe to drop any remaining batches - their semaphores will never be
   // signaled but that's fine as we should be the only thing relying on them.
   submission->pending_batches.clear();
+  if (submission->is_complete) return OkStatus();
+  submission->is_complete = true;
 
   // Signal the fence.
   auto* fence = static_cast<HostFence*>(submission->fence.first);
@@ -279,10 +366,14 @@ Status HostSubmissionQueue::CompleteSubmission(Submission* submission,
 
 void HostSubmissionQueue::FailAllPending(Status status) {
   IREE_TRACE_SCOPE0("HostSubmissionQueue::FailAllPending");
-  while (!list_.empty()) {
-    auto submission = list_.take(list_.front());
-    CompleteSubmission(submission.get(), status).IgnoreError();
-    submission.reset();
+  auto* submission = list_.front();
+  while (submission) {
+    auto* next_submission = list_.next(submission);
+    CompleteSubmission(submission, status).IgnoreError();
+    if (submission->in_flight_count == 0) {
+      list_.take(submission).reset();
+    }
+    submission = next_submission;
   }
 }
 
@@ -16,6 +16,7 @@
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_HOST_SUBMISSION_QUEUE_H_
 
 #include "third_party/absl/base/thread_annotations.h"
+#include "third_party/absl/container/inlined_vector.h"
 #include "third_party/absl/synchronization/mutex.h"
 #include "third_party/mlir_edge/iree/base/intrusive_list.h"
 #include "third_party/mlir_edge/iree/base/status.h"
@@ -82,16 +83,41 @@ class HostTimelineSemaphore final : public TimelineSemaphore {
 // avoid that as in device backends it may not be possible and we want to have
 // some kind of warning in the host implementation that TSAN can catch.
 //
+// Batches may either be processed synchronously with ProcessBatches or taken
+// one at a time with TakeReadyBatch, executed elsewhere (possibly concurrently
+// with other batches), and then handed back with CompleteBatch.
+//
 // Thread-compatible. Const methods may be called from any thread.
 class HostSubmissionQueue {
+ private:
+  struct Submission;
+
  public:
   using ExecuteFn =
       std::function<Status(absl::Span<CommandBuffer* const> command_buffers)>;
 
+  // A batch taken from the queue with TakeReadyBatch. Its wait semaphores have
+  // already been consumed and it must be passed to CompleteBatch once the
+  // command buffers have executed.
+  class ReadyBatch {
+   public:
+    absl::Span<CommandBuffer* const> command_buffers() const {
+      return command_buffers_;
+    }
+
+   private:
+    friend class HostSubmissionQueue;
+    Submission* submission_ = nullptr;
+    absl::InlinedVector<CommandBuffer*, 4> command_buffers_;
+    absl::InlinedVector<SemaphoreValue, 4> signal_semaphores_;
+  };
+
   HostSubmissionQueue();
   ~HostSubmissionQueue();
 
   // Returns true if the queue is currently empty.
+  // Submissions with batches taken by TakeReadyBatch remain in the queue until
+  // they are completed.
   bool empty() const { return list_.empty(); }
   // Returns true if SignalShutdown has been called.
   bool has_shutdown() const { return has_shutdown_; }
@@ -111,6 +137,22 @@ class HostSubmissionQueue {
   // aborted, the permanent_error() is set, and the queue is shutdown.
   Status ProcessBatches(ExecuteFn execute_fn);
 
+  // Takes the next batch whose wait semaphores are all signaled, consuming the
+  // waits. Returns false if no batch is currently ready.
+  //
+  // Returns an error (which will be the same as permanent_error()) if the
+  // semaphore waits could not be completed; the queue is then aborted as with
+  // ProcessBatches.
+  StatusOr<bool> TakeReadyBatch(ReadyBatch* out_batch);
+
+  // Completes a batch previously taken with TakeReadyBatch after its command
+  // buffers were executed with |status|. Signals the batch semaphores and, once
+  // all batches in the submission have completed, the submission fence.
+  // New batches may become ready as a result.
+  //
+  // Returns the permanent_error() if this or any prior batch has failed.
+  Status CompleteBatch(ReadyBatch* batch, Status status);
+
   // Marks the queue as having shutdown. All pending submissions will be allowed
   // to complete but future enqueues will fail.
   void SignalShutdown();
@@ -125,11 +167,22 @@ class HostSubmissionQueue {
   struct Submission : public IntrusiveLinkBase<void> {
     absl::InlinedVector<PendingBatch, 4> pending_batches;
     FenceValue fence;
+    // Batches taken with TakeReadyBatch that have not yet been completed.
+    int in_flight_count = 0;
+    // True once the fence has been signaled (or failed).
+    bool is_complete = false;
   };
 
   // Returns true if all wait semaphores in the |batch| are signaled.
   bool IsBatchReady(const PendingBatch& batch) const;
 
+  // Completes the waits on all |wait_semaphores| and resets them.
+  static Status EndWaiting(absl::Span<const SemaphoreValue> wait_semaphores);
+
+  // Signals all |signal_semaphores| to allow them to unblock waiters.
+  static Status EndSignaling(
+      absl::Span<const SemaphoreValue> signal_semaphores);
+
   // Processes a batch by resetting semaphores, dispatching the command buffers
   // to the specified |execute_fn|, and signaling semaphores.
   //
@@ -140,6 +193,8 @@ class HostSubmissionQueue {
   Status CompleteSubmission(Submission* submission, Status status);
 
   // Fails all pending submissions with the given status.
+  // Submissions with batches still in flight are failed immediately but remain
+  // in the list until their last batch is completed.
   // Errors that occur during this process are silently ignored.
   void FailAllPending(Status status);
 
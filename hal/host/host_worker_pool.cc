@@ -0,0 +1,268 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif  // __linux__
+
+#include "third_party/absl/memory/memory.h"
+#include "third_party/absl/strings/numbers.h"
+#include "third_party/absl/strings/str_split.h"
+#include "third_party/absl/synchronization/blocking_counter.h"
+#include "third_party/mlir_edge/iree/base/logging.h"
+#include "third_party/mlir_edge/iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+
+namespace {
+
+// Identifies the worker (if any) running on the current thread so that tasks
+// scheduled from within a task land on the local queue.
+thread_local const HostWorkerPool* current_pool = nullptr;
+thread_local int current_worker_index = -1;
+
+// Restricts the calling thread to the given logical CPUs.
+void SetCurrentThreadAffinity(absl::Span<const int> cpu_affinity) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpu_affinity) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &cpu_set);
+  }
+  if (CPU_COUNT(&cpu_set) == 0) return;
+  int result =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (result != 0) {
+    LOG(WARNING) << "Unable to set worker thread affinity: " << result;
+  }
+#endif  // __linux__
+}
+
+}  // namespace
+
+// static
+StatusOr<std::vector<int>> HostWorkerPool::ParseCpuSet(
+    absl::string_view cpu_set_string) {
+  std::vector<int> cpu_set;
+  for (absl::string_view part :
+       absl::StrSplit(cpu_set_string, ',', absl::SkipWhitespace())) {
+    std::vector<absl::string_view> range =
+        absl::StrSplit(part, absl::MaxSplits('-', 1));
+    int first_cpu = 0;
+    int last_cpu = 0;
+    if (!absl::SimpleAtoi(range.front(), &first_cpu) ||
+        !absl::SimpleAtoi(range.back(), &last_cpu) || first_cpu < 0 ||
+        last_cpu < first_cpu) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Invalid CPU set entry '" << part << "' in '"
+             << cpu_set_string << "'";
+    }
+    for (int cpu = first_cpu; cpu <= last_cpu; ++cpu) {
+      cpu_set.push_back(cpu);
+    }
+  }
+  return cpu_set;
+}
+
+// static
+int HostWorkerPool::DefaultWorkerCount() {
+  return std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+}
+
+HostWorkerPool::HostWorkerPool(int worker_count,
+                               absl::Span<const int> cpu_affinity)
+    : cpu_affinity_(cpu_affinity.begin(), cpu_affinity.end()) {
+  IREE_TRACE_SCOPE0("HostWorkerPool::ctor");
+  worker_queues_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    worker_queues_.push_back(absl::make_unique<WorkerQueue>());
+  }
+  threads_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    threads_.emplace_back([this, i]() { ThreadMain(i); });
+  }
+}
+
+HostWorkerPool::~HostWorkerPool() {
+  IREE_TRACE_SCOPE0("HostWorkerPool::dtor");
+  {
+    // Workers will drain any remaining tasks before exiting.
+    absl::MutexLock lock(&idle_mutex_);
+    exiting_ = true;
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+int HostWorkerPool::CurrentWorkerIndex() const {
+  return current_pool == this ? current_worker_index : -1;
+}
+
+void HostWorkerPool::Schedule(Task task) {
+  if (worker_queues_.empty()) {
+    task();
+    return;
+  }
+
+  int queue_index = CurrentWorkerIndex();
+  if (queue_index < 0) {
+    queue_index = next_queue_index_.fetch_add(1, std::memory_order_relaxed) %
+                  worker_queues_.size();
+  }
+  auto* worker_queue = worker_queues_[queue_index].get();
+  {
+    absl::MutexLock lock(&worker_queue->mutex);
+    worker_queue->tasks.push_back(std::move(task));
+  }
+  pending_task_count_.fetch_add(1, std::memory_order_release);
+
+  // Conditions are only re-evaluated when the mutex is released so we need to
+  // bounce it to wake any idle workers.
+  absl::MutexLock lock(&idle_mutex_);
+}
+
+bool HostWorkerPool::TryPopTask(int worker_index, Task* out_task) {
+  if (pending_task_count_.load(std::memory_order_acquire) <= 0) return false;
+
+  // Prefer the most recently scheduled local task as its data is likely still
+  // in cache.
+  if (worker_index >= 0) {
+    auto* worker_queue = worker_queues_[worker_index].get();
+    absl::MutexLock lock(&worker_queue->mutex);
+    if (!worker_queue->tasks.empty()) {
+      *out_task = std::move(worker_queue->tasks.back());
+      worker_queue->tasks.pop_back();
+      pending_task_count_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  // Steal the oldest task from another worker.
+  int queue_count = static_cast<int>(worker_queues_.size());
+  int start_index = worker_index >= 0
+                        ? worker_index + 1
+                        : next_queue_index_.load(std::memory_order_relaxed);
+  for (int i = 0; i < queue_count; ++i) {
+    int queue_index = (start_index + i) % queue_count;
+    if (queue_index == worker_index) continue;
+    auto* worker_queue = worker_queues_[queue_index].get();
+    absl::MutexLock lock(&worker_queue->mutex);
+    if (!worker_queue->tasks.empty()) {
+      *out_task = std::move(worker_queue->tasks.front());
+      worker_queue->tasks.pop_front();
+      pending_task_count_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void HostWorkerPool::ThreadMain(int worker_index) {
+  IREE_TRACE_THREAD_ENABLE("HostWorkerPool");
+  if (!cpu_affinity_.empty()) {
+    SetCurrentThreadAffinity(cpu_affinity_);
+  }
+  current_pool = this;
+  current_worker_index = worker_index;
+  while (true) {
+    Task task;
+    if (TryPopTask(worker_index, &task)) {
+      task();
+      continue;
+    }
+
+    // Block until there is more work to steal or we are asked to exit.
+    absl::MutexLock lock(&idle_mutex_);
+    idle_mutex_.Await(absl::Condition(
+        +[](HostWorkerPool* pool) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+          return pool->exiting_ ||
+                 pool->pending_task_count_.load(std::memory_order_acquire) > 0;
+        },
+        this));
+    if (exiting_ &&
+        pending_task_count_.load(std::memory_order_acquire) <= 0) {
+      // Exiting and no more work to do.
+      return;
+    }
+  }
+}
+
+bool HostWorkerPool::RunPendingTask() {
+  Task task;
+  if (!TryPopTask(CurrentWorkerIndex(), &task)) return false;
+  task();
+  return true;
+}
+
+Status HostWorkerPool::ParallelFor(
+    size_t count, size_t min_grain_size,
+    const std::function<Status(size_t begin, size_t end)>& fn) {
+  if (count == 0) return OkStatus();
+  min_grain_size = std::max<size_t>(1, min_grain_size);
+  size_t chunk_count = std::min<size_t>(
+      concurrency(), (count + min_grain_size - 1) / min_grain_size);
+  if (chunk_count <= 1) {
+    // Not worth the synchronization overhead; run inline.
+    return fn(0, count);
+  }
+
+  IREE_TRACE_SCOPE0("HostWorkerPool::ParallelFor");
+
+  auto run_chunk = [&](size_t chunk_index) {
+    size_t begin = count * chunk_index / chunk_count;
+    size_t end = count * (chunk_index + 1) / chunk_count;
+    return fn(begin, end);
+  };
+
+  // All state lives on our stack; we don't return until every task has
+  // decremented the counter (and BlockingCounter is safe to destroy then).
+  absl::BlockingCounter pending_counter(chunk_count - 1);
+  std::atomic<size_t> pending_chunk_count{chunk_count - 1};
+  absl::Mutex status_mutex;
+  Status worker_status;
+  for (size_t i = 1; i < chunk_count; ++i) {
+    Schedule([&, i]() {
+      auto status = run_chunk(i);
+      if (!status.ok()) {
+        absl::MutexLock status_lock(&status_mutex);
+        if (worker_status.ok()) worker_status = std::move(status);
+      }
+      pending_chunk_count.fetch_sub(1, std::memory_order_release);
+      pending_counter.DecrementCount();
+    });
+  }
+
+  // The first chunk always runs on the calling thread. Afterward we help with
+  // whatever is still queued (ours or otherwise) until our chunks are done.
+  auto status = run_chunk(0);
+  while (pending_chunk_count.load(std::memory_order_acquire) > 0 &&
+         RunPendingTask()) {
+  }
+  pending_counter.Wait();
+
+  RETURN_IF_ERROR(status);
+  absl::MutexLock status_lock(&status_mutex);
+  return worker_status;
+}
+
+}  // namespace hal
+}  // namespace iree
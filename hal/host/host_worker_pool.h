@@ -0,0 +1,129 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_HOST_WORKER_POOL_H_
+#define THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_HOST_WORKER_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "third_party/absl/base/thread_annotations.h"
+#include "third_party/absl/strings/string_view.h"
+#include "third_party/absl/synchronization/mutex.h"
+#include "third_party/absl/types/span.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+
+namespace iree {
+namespace hal {
+
+// A fixed-size work-stealing pool of worker threads used to run host work
+// across cores.
+//
+// Each worker owns a task queue. Tasks scheduled from a worker thread are
+// pushed onto its own queue and popped LIFO to keep related work on the same
+// core while idle workers steal FIFO from the other end of busy queues. Tasks
+// scheduled from non-worker threads are distributed round-robin.
+//
+// ParallelFor always runs one chunk on the calling thread. While waiting for
+// the remaining chunks the caller helps drain the pool so that nested or
+// concurrent ParallelFor calls cannot deadlock even when all workers are busy.
+//
+// HostWorkerPool is thread-safe and may be shared by multiple queues/fibers.
+class HostWorkerPool final {
+ public:
+  using Task = std::function<void()>;
+
+  // Returns the worker count to use to saturate the cores on the host.
+  // The calling thread participates in ParallelFor so this is one fewer than
+  // the hardware concurrency.
+  static int DefaultWorkerCount();
+
+  // Parses a comma-separated list of logical CPUs and inclusive CPU ranges
+  // such as '0,2,4-7' into a |cpu_affinity| list.
+  static StatusOr<std::vector<int>> ParseCpuSet(
+      absl::string_view cpu_set_string);
+
+  // Creates a pool with |worker_count| threads. A count of 0 yields a pool
+  // that runs all work inline on the calling thread.
+  //
+  // If |cpu_affinity| is non-empty the worker threads are restricted to the
+  // listed logical CPUs so that the pool (and the memory it first touches)
+  // stays local to a single socket/NUMA node. Ignored on platforms without
+  // thread affinity support.
+  explicit HostWorkerPool(int worker_count,
+                          absl::Span<const int> cpu_affinity = {});
+  ~HostWorkerPool();
+
+  HostWorkerPool(const HostWorkerPool&) = delete;
+  HostWorkerPool& operator=(const HostWorkerPool&) = delete;
+
+  // Total number of threads that may be working on a single ParallelFor,
+  // including the calling thread.
+  int concurrency() const { return static_cast<int>(threads_.size()) + 1; }
+
+  // Schedules |task| to run asynchronously on a worker thread.
+  // If the pool has no workers the task is run inline before returning.
+  void Schedule(Task task);
+
+  // Splits [0, |count|) into contiguous ranges of at least |min_grain_size|
+  // and invokes |fn| with each [begin, end) range, possibly concurrently.
+  // Blocks until all ranges have completed and returns the first failure.
+  Status ParallelFor(size_t count, size_t min_grain_size,
+                     const std::function<Status(size_t begin, size_t end)>& fn);
+
+ private:
+  struct WorkerQueue {
+    absl::Mutex mutex;
+    std::deque<Task> tasks ABSL_GUARDED_BY(mutex);
+  };
+
+  // Thread entry point for each worker thread.
+  void ThreadMain(int worker_index);
+
+  // Returns the index of the worker running on the current thread or -1 if
+  // the current thread is not one of our workers.
+  int CurrentWorkerIndex() const;
+
+  // Pops a task from the queue owned by |worker_index| (if any) or steals one
+  // from another worker. Returns false if all queues were empty.
+  bool TryPopTask(int worker_index, Task* out_task);
+
+  // Pops and runs a single queued task, if any. Returns false if the pool was
+  // empty.
+  bool RunPendingTask();
+
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  std::vector<std::thread> threads_;
+  // Logical CPUs the worker threads are pinned to, if any.
+  std::vector<int> cpu_affinity_;
+
+  // Total tasks queued across all worker queues. Used to wake idle workers.
+  std::atomic<int64_t> pending_task_count_{0};
+  // Round-robin cursor for tasks scheduled from non-worker threads.
+  std::atomic<uint32_t> next_queue_index_{0};
+
+  absl::Mutex idle_mutex_;
+  bool exiting_ ABSL_GUARDED_BY(idle_mutex_) = false;
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // THIRD_PARTY_MLIR_EDGE_IREE_HAL_HOST_HOST_WORKER_POOL_H_
@@ -0,0 +1,56 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
+
+#include "testing/base/public/gmock.h"
+#include "testing/base/public/gunit.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(HostWorkerPoolTest, ParsesCpuList) {
+  auto cpu_set_or = HostWorkerPool::ParseCpuSet("0,2,5");
+  ASSERT_TRUE(cpu_set_or.ok());
+  EXPECT_THAT(cpu_set_or.ValueOrDie(), ElementsAre(0, 2, 5));
+}
+
+TEST(HostWorkerPoolTest, ParsesCpuRanges) {
+  auto cpu_set_or = HostWorkerPool::ParseCpuSet("0,2,4-7,9-9");
+  ASSERT_TRUE(cpu_set_or.ok());
+  EXPECT_THAT(cpu_set_or.ValueOrDie(), ElementsAre(0, 2, 4, 5, 6, 7, 9));
+}
+
+TEST(HostWorkerPoolTest, ParsesEmptyCpuSet) {
+  auto cpu_set_or = HostWorkerPool::ParseCpuSet("");
+  ASSERT_TRUE(cpu_set_or.ok());
+  EXPECT_THAT(cpu_set_or.ValueOrDie(), IsEmpty());
+}
+
+TEST(HostWorkerPoolTest, RejectsInvalidCpuSets) {
+  EXPECT_TRUE(IsInvalidArgument(HostWorkerPool::ParseCpuSet("a").status()));
+  EXPECT_TRUE(IsInvalidArgument(HostWorkerPool::ParseCpuSet("-1").status()));
+  EXPECT_TRUE(IsInvalidArgument(HostWorkerPool::ParseCpuSet("4-2").status()));
+  EXPECT_TRUE(IsInvalidArgument(HostWorkerPool::ParseCpuSet("0-").status()));
+  EXPECT_TRUE(IsInvalidArgument(HostWorkerPool::ParseCpuSet("1,x-3").status()));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
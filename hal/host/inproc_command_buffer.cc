@@ -101,6 +101,19 @@ Status InProcCommandBuffer::FillBuffer(Buffer* target_buffer,
   return OkStatus();
 }
 
+Status InProcCommandBuffer::FillBufferIndirect(Buffer* target_buffer,
+                                               Buffer* value_buffer,
+                                               Buffer* offset_buffer,
+                                               Buffer* length_buffer) {
+  IREE_TRACE_SCOPE0("InProcCommandBuffer::FillBufferIndirect");
+  ASSIGN_OR_RETURN(auto* cmd, AppendCmd<FillBufferIndirectCmd>());
+  cmd->target_buffer = target_buffer;
+  cmd->value_buffer = value_buffer;
+  cmd->offset_buffer = offset_buffer;
+  cmd->length_buffer = length_buffer;
+  return OkStatus();
+}
+
 Status InProcCommandBuffer::DiscardBuffer(Buffer* buffer) {
   IREE_TRACE_SCOPE0("InProcCommandBuffer::DiscardBuffer");
   ASSIGN_OR_RETURN(auto* cmd, AppendCmd<DiscardBufferCmd>());
@@ -233,6 +246,12 @@ Status InProcCommandBuffer::ProcessCmd(CmdHeader* cmd_header,
                                            cmd->target_offset, cmd->length,
                                            cmd->pattern, cmd->pattern_length);
     }
+    case CmdType::kFillBufferIndirect: {
+      auto* cmd = reinterpret_cast<FillBufferIndirectCmd*>(cmd_header + 1);
+      return command_processor->FillBufferIndirect(
+          cmd->target_buffer, cmd->value_buffer, cmd->offset_buffer,
+          cmd->length_buffer);
+    }
     case CmdType::kDiscardBuffer: {
       auto* cmd = reinterpret_cast<DiscardBufferCmd*>(cmd_header + 1);
       return command_processor->DiscardBuffer(cmd->buffer);
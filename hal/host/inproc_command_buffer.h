@@ -63,6 +63,10 @@ class InProcCommandBuffer final : public CommandBuffer {
                     device_size_t length, const void* pattern,
                     size_t pattern_length) override;
 
+  Status FillBufferIndirect(Buffer* target_buffer, Buffer* value_buffer,
+                            Buffer* offset_buffer,
+                            Buffer* length_buffer) override;
+
   Status DiscardBuffer(Buffer* buffer) override;
 
   Status UpdateBuffer(const void* source_buffer, device_size_t source_offset,
@@ -87,6 +91,7 @@ class InProcCommandBuffer final : public CommandBuffer {
     kResetEvent,
     kWaitEvents,
     kFillBuffer,
+    kFillBufferIndirect,
     kDiscardBuffer,
     kUpdateBuffer,
     kCopyBuffer,
@@ -163,6 +168,15 @@ class InProcCommandBuffer final : public CommandBuffer {
     size_t pattern_length;
   };
 
+  // Fills the target buffer with parameters read from buffers at execution.
+  struct FillBufferIndirectCmd {
+    static constexpr CmdType kType = CmdType::kFillBufferIndirect;
+    Buffer* target_buffer;
+    Buffer* value_buffer;
+    Buffer* offset_buffer;
+    Buffer* length_buffer;
+  };
+
   // Hints to the device queue that the given buffer will not be used again.
   struct DiscardBufferCmd {
     static constexpr CmdType kType = CmdType::kDiscardBuffer;
@@ -23,8 +23,9 @@
 namespace iree {
 namespace hal {
 
-BytecodeCache::BytecodeCache(hal::Allocator* allocator)
-    : allocator_(allocator) {}
+BytecodeCache::BytecodeCache(hal::Allocator* allocator,
+                             HostWorkerPool* worker_pool)
+    : allocator_(allocator), worker_pool_(worker_pool) {}
 
 BytecodeCache::~BytecodeCache() = default;
 
@@ -43,9 +44,16 @@ StatusOr<ref_ptr<Executable>> BytecodeCache::PrepareExecutable(
   // Wrap the data (or copy it).
   bool allow_aliasing_data =
       AllBitsSet(mode, ExecutableCachingMode::kAliasProvidedData);
+  auto math_mode = kernels::MathMode::kExact;
+  if (AllBitsSet(mode, ExecutableCachingMode::kAllowFastMath)) {
+    math_mode = kernels::MathMode::kFast;
+  } else if (AllBitsSet(mode, ExecutableCachingMode::kCompensatedSummation)) {
+    math_mode = kernels::MathMode::kCompensated;
+  }
   ASSIGN_OR_RETURN(
       auto executable,
-      BytecodeExecutable::Load(allocator_, spec, !allow_aliasing_data));
+      BytecodeExecutable::Load(allocator_, worker_pool_, spec,
+                               !allow_aliasing_data, math_mode));
 
   return executable;
 }
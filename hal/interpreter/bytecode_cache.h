@@ -18,13 +18,14 @@
 #include "third_party/mlir_edge/iree/hal/allocator.h"
 #include "third_party/mlir_edge/iree/hal/executable.h"
 #include "third_party/mlir_edge/iree/hal/executable_cache.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
 
 namespace iree {
 namespace hal {
 
 class BytecodeCache final : public ExecutableCache {
  public:
-  explicit BytecodeCache(hal::Allocator* allocator);
+  BytecodeCache(hal::Allocator* allocator, HostWorkerPool* worker_pool);
   ~BytecodeCache() override;
 
   bool CanPrepareFormat(ExecutableFormat format) const override;
@@ -34,6 +35,7 @@ class BytecodeCache final : public ExecutableCache {
 
  private:
   hal::Allocator* allocator_;
+  HostWorkerPool* worker_pool_;
 };
 
 }  // namespace hal
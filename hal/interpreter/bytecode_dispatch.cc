@@ -81,10 +81,13 @@ Status Dispatch(hal::Allocator* allocator,
   // into different functions.
   BytecodeReader reader(stack);
   RETURN_IF_ERROR(reader.SwitchStackFrame(entry_stack_frame));
+  // ReadOpcode does not update the frame offset in optimized builds so write
+  // it back however we leave; otherwise errors report a stale offset.
+  auto sync_offset = MakeCleanup([&reader]() { reader.SyncOffset(); });
 
 #define DISPATCH_NEXT()                                                    \
   {                                                                        \
-    uint8_t opcode = *reader.AdvanceOffset().ValueOrDie();                 \
+    ASSIGN_OR_RETURN(uint8_t opcode, reader.ReadOpcode());                 \
     DVLOG(1)                                                               \
         << "Interpreter dispatching op code: "                             \
         << GetOpcodeInfo(vm::interpreter_opcode_table(), opcode).mnemonic; \
@@ -295,17 +298,172 @@ Status Dispatch(hal::Allocator* allocator,
     }
   });
 
+  DISPATCH_CORE_OPCODE(kCmpSelectI, {
+    ASSIGN_OR_RETURN(uint8_t predicate, reader.ReadUint8_t());
+    ASSIGN_OR_RETURN(auto* lhs_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* rhs_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* true_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* false_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+
+    switch (static_cast<CmpIPredicate>(predicate)) {
+      case CmpIPredicate::kEq:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIS<kernels::CompareEQ>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kNe:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIS<kernels::CompareNE>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kSlt:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIS<kernels::CompareLT>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kSle:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIS<kernels::CompareLE>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kSgt:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIS<kernels::CompareGT>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kSge:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIS<kernels::CompareGE>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kUlt:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIU<kernels::CompareLT>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kUle:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIU<kernels::CompareLE>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kUgt:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIU<kernels::CompareGT>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpIPredicate::kUge:
+        RETURN_IF_ERROR(ApplyCompareSelectOpIU<kernels::CompareGE>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+    }
+  });
+
+  DISPATCH_FLOAT_OPCODE(kCmpSelectF, {
+    ASSIGN_OR_RETURN(uint8_t p, reader.ReadUint8_t());
+    ASSIGN_OR_RETURN(auto* lhs_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* rhs_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* true_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* false_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+
+    auto predicate = static_cast<CmpFPredicate>(p);
+    switch (predicate) {
+      case CmpFPredicate::kOeq:
+        RETURN_IF_ERROR(ApplyCompareSelectOpF<kernels::CompareEQ>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpFPredicate::kUne:
+        RETURN_IF_ERROR(ApplyCompareSelectOpF<kernels::CompareNE>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpFPredicate::kOlt:
+        RETURN_IF_ERROR(ApplyCompareSelectOpF<kernels::CompareLT>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpFPredicate::kOle:
+        RETURN_IF_ERROR(ApplyCompareSelectOpF<kernels::CompareLE>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpFPredicate::kOgt:
+        RETURN_IF_ERROR(ApplyCompareSelectOpF<kernels::CompareGT>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpFPredicate::kOge:
+        RETURN_IF_ERROR(ApplyCompareSelectOpF<kernels::CompareGE>(
+            lhs_local, rhs_local, true_local, false_local, dst_local,
+            kernel_runtime_state));
+        break;
+      case CmpFPredicate::kFalse:
+      case CmpFPredicate::kOne:
+      case CmpFPredicate::kOrd:
+      case CmpFPredicate::kUeq:
+      case CmpFPredicate::kUgt:
+      case CmpFPredicate::kUge:
+      case CmpFPredicate::kUlt:
+      case CmpFPredicate::kUle:
+      case CmpFPredicate::kUno:
+      case CmpFPredicate::kTrue:
+        return UnimplementedErrorBuilder(ABSL_LOC)
+               << "Unsupported comparison predicate value "
+               << static_cast<int>(p) << " ("
+               << vm::PredicateToString(predicate) << ")";
+    }
+  });
+
   DISPATCH_CORE_OPCODE(kAllocStatic, {
-    return UnimplementedErrorBuilder(ABSL_LOC) << "Unimplemented alloc_static";
+    // The instruction offset identifies the static within the function.
+    int static_offset = reader.offset();
+    ASSIGN_OR_RETURN(auto shape_dims, reader.ReadIndexList());
+    ASSIGN_OR_RETURN(auto initial_value, reader.ReadConstant());
+    ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    const auto& function = stack->current_frame()->function();
+    ASSIGN_OR_RETURN(*dst_local, function.module().GetOrAllocateStatic(
+                                     function.def(), static_offset,
+                                     Shape(shape_dims), initial_value));
   });
 
   DISPATCH_CORE_OPCODE(kAllocStack, {
-    return UnimplementedErrorBuilder(ABSL_LOC) << "Unimplemented alloc_stack";
+    ASSIGN_OR_RETURN(auto heap_type, reader.ReadInt32());
+    ASSIGN_OR_RETURN(auto type, reader.ReadType());
+    size_t element_size = type.element_size();
+    size_t element_count = 0;
+    ASSIGN_OR_RETURN(auto shape, reader.ReadShapePieces(&element_count));
+    size_t allocation_size = element_size * element_count;
+    ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    dst_local->element_size = element_size;
+    dst_local->shape = shape;
+
+    // Frame storage is reclaimed in bulk when the current frame is popped.
+    CHECK_EQ(heap_type, 0);
+    ASSIGN_OR_RETURN(auto* storage,
+                     stack->AllocateFrameStorage(allocation_size));
+    dst_local->buffer = HeapBuffer::WrapMutable(
+        MemoryType::kHostLocal, MemoryAccess::kAll, BufferUsage::kAll, storage,
+        allocation_size);
   });
 
   DISPATCH_CORE_OPCODE(kAllocStackInit, {
-    return UnimplementedErrorBuilder(ABSL_LOC)
-           << "Unimplemented alloc_stack_init";
+    ASSIGN_OR_RETURN(auto type, reader.ReadType());
+    size_t element_size = type.element_size();
+    size_t element_count = 0;
+    ASSIGN_OR_RETURN(auto shape, reader.ReadShapePieces(&element_count));
+    size_t allocation_size = element_size * element_count;
+    ASSIGN_OR_RETURN(auto* storage,
+                     stack->AllocateFrameStorage(allocation_size));
+    RETURN_IF_ERROR(reader.ReadConstantInto(storage, allocation_size));
+    ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    dst_local->element_size = element_size;
+    dst_local->shape = shape;
+    dst_local->buffer = HeapBuffer::WrapMutable(
+        MemoryType::kHostLocal, MemoryAccess::kAll, BufferUsage::kAll, storage,
+        allocation_size);
   });
 
   DISPATCH_CORE_OPCODE(kAllocHeap, {
@@ -324,10 +482,10 @@ Status Dispatch(hal::Allocator* allocator,
 
     // TODO(benvanik): properly allocate with attributes from op.
     CHECK_EQ(heap_type, 0);
-    ASSIGN_OR_RETURN(
-        dst_local->buffer,
-        allocator->Allocate(MemoryType::kHostLocal | MemoryType::kDeviceVisible,
-                            BufferUsage::kAll, allocation_size));
+    ASSIGN_OR_RETURN(dst_local->buffer,
+                     allocator->AllocateUninitialized(
+                         MemoryType::kHostLocal | MemoryType::kDeviceVisible,
+                         BufferUsage::kAll, allocation_size));
   });
 
   DISPATCH_CORE_OPCODE(kDiscard, {
@@ -344,7 +502,7 @@ Status Dispatch(hal::Allocator* allocator,
   });
 
   DISPATCH_CORE_OPCODE(kDim, {
-    ASSIGN_OR_RETURN(int32_t axis, reader.ReadUint8_t());
+    ASSIGN_OR_RETURN(int32_t axis, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto* src_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(int32_t dim, src_local->shape.ResolveAxis(axis));
@@ -407,8 +565,8 @@ Status Dispatch(hal::Allocator* allocator,
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     dst_local->element_size = src_local->element_size;
     dst_local->shape = src_local->shape;
-    dst_local->buffer = HeapBuffer::Allocate(src_local->buffer->usage(),
-                                             src_local->buffer->byte_length());
+    dst_local->buffer = HeapBuffer::AllocateUninitialized(
+        src_local->buffer->usage(), src_local->buffer->byte_length());
     RETURN_IF_ERROR(dst_local->buffer->CopyData(0, src_local->buffer.get()));
   });
 
@@ -451,14 +609,14 @@ Status Dispatch(hal::Allocator* allocator,
     ASSIGN_OR_RETURN(auto* lhs_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto* rhs_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
-    ASSIGN_OR_RETURN(auto cond_buffer, cond_local->buffer->MapMemory<uint8_t>(
-                                           MemoryAccess::kRead));
-    ASSIGN_OR_RETURN(auto lhs_buffer, lhs_local->buffer->MapMemory<uint8_t>(
-                                          MemoryAccess::kRead));
-    ASSIGN_OR_RETURN(auto rhs_buffer, rhs_local->buffer->MapMemory<uint8_t>(
-                                          MemoryAccess::kRead));
-    ASSIGN_OR_RETURN(auto dst_buffer, dst_local->buffer->MapMemory<uint8_t>(
-                                          MemoryAccess::kDiscardWrite));
+    ASSIGN_OR_RETURN(auto cond_buffer,
+                     MapLocal<uint8_t>(cond_local, MemoryAccess::kRead));
+    ASSIGN_OR_RETURN(auto lhs_buffer,
+                     MapLocal<uint8_t>(lhs_local, MemoryAccess::kRead));
+    ASSIGN_OR_RETURN(auto rhs_buffer,
+                     MapLocal<uint8_t>(rhs_local, MemoryAccess::kRead));
+    ASSIGN_OR_RETURN(auto dst_buffer,
+                     MapLocal<uint8_t>(dst_local, MemoryAccess::kDiscardWrite));
     if (cond_local->element_size != 1) {
       return InvalidArgumentErrorBuilder(ABSL_LOC) << "Select cond must be i8";
     } else if (lhs_buffer.size() != rhs_buffer.size()) {
@@ -555,130 +713,177 @@ Status Dispatch(hal::Allocator* allocator,
   });
 
   DISPATCH_CORE_OPCODE(kNot, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpIU<kernels::Not>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseUnaryOpIU<kernels::Not>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kAnd, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::And>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::And>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kOr, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Or>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Or>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kXor, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Xor>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Xor>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kShiftLeft, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::ShiftLeft>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::ShiftLeft>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kShiftRightLogical, {
-    RETURN_IF_ERROR(
-        DispatchElementwiseBinaryOpIU<kernels::ShiftRight>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::ShiftRight>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kShiftRightArithmetic, {
-    RETURN_IF_ERROR(
-        DispatchElementwiseBinaryOpIS<kernels::ShiftRight>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIS<kernels::ShiftRight>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kAddI, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Add>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Add>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kAddF, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Add>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Add>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kSubI, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Sub>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Sub>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kSubF, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Sub>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Sub>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kAbsI, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpIS<kernels::Abs>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseUnaryOpIS<kernels::Abs>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kAbsF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Abs>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Abs>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kMulI, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Mul>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Mul>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kMulF, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Mul>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Mul>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kDivIS, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIS<kernels::Div>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIS<kernels::Div>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kDivIU, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Div>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Div>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kDivF, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Div>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Div>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kMulAddI, {
-    RETURN_IF_ERROR(DispatchElementwiseTernaryOpIU<kernels::MulAdd>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseTernaryOpIU<kernels::MulAdd>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kMulAddF, {
-    RETURN_IF_ERROR(DispatchElementwiseTernaryOpF<kernels::MulAdd>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseTernaryOpF<kernels::MulAdd>(
+        &reader, kernel_runtime_state));
+  });
+  DISPATCH_FLOAT_OPCODE(kAddMaxF, {
+    RETURN_IF_ERROR(DispatchElementwiseTernaryOpF<kernels::AddMax>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kExpF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Exp>(&reader));
+    RETURN_IF_ERROR(
+        DispatchElementwiseUnaryMathOpF<kernels::Exp, kernels::FastExp>(
+            &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kLogF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Log>(&reader));
+    RETURN_IF_ERROR(
+        DispatchElementwiseUnaryMathOpF<kernels::Log, kernels::FastLog>(
+            &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kRsqrtF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Rsqrt>(&reader));
+    RETURN_IF_ERROR(
+        DispatchElementwiseUnaryMathOpF<kernels::Rsqrt, kernels::FastRsqrt>(
+            &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kCosF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Cos>(&reader));
+    RETURN_IF_ERROR(
+        DispatchElementwiseUnaryMathOpF<kernels::Cos, kernels::FastCos>(
+            &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kSinF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Sin>(&reader));
+    RETURN_IF_ERROR(
+        DispatchElementwiseUnaryMathOpF<kernels::Sin, kernels::FastSin>(
+            &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kTanhF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Tanh>(&reader));
+    RETURN_IF_ERROR(
+        DispatchElementwiseUnaryMathOpF<kernels::Tanh, kernels::FastTanh>(
+            &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kAtan2F, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Atan2>(&reader));
+    RETURN_IF_ERROR(
+        DispatchElementwiseBinaryMathOpF<kernels::Atan2, kernels::FastAtan2>(
+            &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kMinIS, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIS<kernels::Min>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIS<kernels::Min>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kMinIU, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Min>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Min>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kMinF, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Min>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Min>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kMaxIS, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIS<kernels::Max>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIS<kernels::Max>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kMaxIU, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Max>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpIU<kernels::Max>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kMaxF, {
-    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Max>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseBinaryOpF<kernels::Max>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kClampIS, {
-    RETURN_IF_ERROR(DispatchElementwiseTernaryOpIS<kernels::Clamp>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseTernaryOpIS<kernels::Clamp>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_CORE_OPCODE(kClampIU, {
-    RETURN_IF_ERROR(DispatchElementwiseTernaryOpIS<kernels::Clamp>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseTernaryOpIS<kernels::Clamp>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kClampF, {
-    RETURN_IF_ERROR(DispatchElementwiseTernaryOpF<kernels::Clamp>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseTernaryOpF<kernels::Clamp>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_FLOAT_OPCODE(kFloorF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Floor>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Floor>(
+        &reader, kernel_runtime_state));
   });
   DISPATCH_FLOAT_OPCODE(kCeilF, {
-    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Ceil>(&reader));
+    RETURN_IF_ERROR(DispatchElementwiseUnaryOpF<kernels::Ceil>(
+        &reader, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kConvertSS, {
@@ -763,14 +968,43 @@ Status Dispatch(hal::Allocator* allocator,
     RETURN_IF_ERROR(
         ValidateMatMulOpF(lhs_local, rhs_local, bias_local, dst_local));
     auto* mat_mul_state = kernel_runtime_state->mat_mul_state.get();
+    switch (lhs_local->element_size) {
+      case 4:
+        RETURN_IF_ERROR(ApplyMatMulOpF<float>(mat_mul_state, lhs_local,
+                                              rhs_local, bias_local, nullptr,
+                                              nullptr, dst_local));
+        break;
+      case 8:
+        RETURN_IF_ERROR(ApplyMatMulOpF<double>(mat_mul_state, lhs_local,
+                                               rhs_local, bias_local, nullptr,
+                                               nullptr, dst_local));
+        break;
+      default:
+        return UnimplementedErrorBuilder(ABSL_LOC)
+               << "Unimplemented element size: " << lhs_local->element_size;
+    }
+  });
+
+  DISPATCH_FLOAT_OPCODE(kMatMulBiasF, {
+    ASSIGN_OR_RETURN(auto* lhs_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* rhs_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* bias_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* clamp_min_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* clamp_max_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    RETURN_IF_ERROR(
+        ValidateMatMulOpF(lhs_local, rhs_local, bias_local, dst_local));
+    auto* mat_mul_state = kernel_runtime_state->mat_mul_state.get();
     switch (lhs_local->element_size) {
       case 4:
         RETURN_IF_ERROR(ApplyMatMulOpF<float>(
-            mat_mul_state, lhs_local, rhs_local, bias_local, dst_local));
+            mat_mul_state, lhs_local, rhs_local, bias_local, clamp_min_local,
+            clamp_max_local, dst_local));
         break;
       case 8:
         RETURN_IF_ERROR(ApplyMatMulOpF<double>(
-            mat_mul_state, lhs_local, rhs_local, bias_local, dst_local));
+            mat_mul_state, lhs_local, rhs_local, bias_local, clamp_min_local,
+            clamp_max_local, dst_local));
         break;
       default:
         return UnimplementedErrorBuilder(ABSL_LOC)
@@ -784,9 +1018,10 @@ Status Dispatch(hal::Allocator* allocator,
     ASSIGN_OR_RETURN(auto dimension, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     // TODO(scotttodd): validate
-    RETURN_IF_ERROR(ApplyBinaryOpIS<kernels::ReduceSum>(
-        src_local, init_local, dst_local, dimension, src_local->shape,
-        dst_local->shape));
+    RETURN_IF_ERROR(
+        ApplyBinaryOpIS<kernels::ParallelReduce<kernels::ReduceSum>>(
+            src_local, init_local, dst_local, dimension, src_local->shape,
+            dst_local->shape, kernel_runtime_state));
   });
 
   DISPATCH_FLOAT_OPCODE(kReduceSumF, {
@@ -795,9 +1030,26 @@ Status Dispatch(hal::Allocator* allocator,
     ASSIGN_OR_RETURN(auto dimension, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     // TODO(scotttodd): validate
-    RETURN_IF_ERROR(ApplyBinaryOpF<kernels::ReduceSum>(
-        src_local, init_local, dst_local, dimension, src_local->shape,
-        dst_local->shape));
+    switch (kernel_runtime_state->math_mode) {
+      case kernels::MathMode::kExact:
+        RETURN_IF_ERROR(
+            ApplyBinaryOpF<kernels::ParallelReduce<kernels::ReduceSumOrdered>>(
+                src_local, init_local, dst_local, dimension, src_local->shape,
+                dst_local->shape, kernel_runtime_state));
+        break;
+      case kernels::MathMode::kCompensated:
+        RETURN_IF_ERROR(
+            ApplyBinaryOpF<kernels::ParallelReduce<kernels::ReduceSumKahan>>(
+                src_local, init_local, dst_local, dimension, src_local->shape,
+                dst_local->shape, kernel_runtime_state));
+        break;
+      case kernels::MathMode::kFast:
+        RETURN_IF_ERROR(
+            ApplyBinaryOpF<kernels::ParallelReduce<kernels::ReduceSum>>(
+                src_local, init_local, dst_local, dimension, src_local->shape,
+                dst_local->shape, kernel_runtime_state));
+        break;
+    }
   });
 
   DISPATCH_CORE_OPCODE(kReduceMinI, {
@@ -806,9 +1058,10 @@ Status Dispatch(hal::Allocator* allocator,
     ASSIGN_OR_RETURN(auto dimension, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     // TODO(scotttodd): validate
-    RETURN_IF_ERROR(ApplyBinaryOpIS<kernels::ReduceMin>(
-        src_local, init_local, dst_local, dimension, src_local->shape,
-        dst_local->shape));
+    RETURN_IF_ERROR(
+        ApplyBinaryOpIS<kernels::ParallelReduce<kernels::ReduceMin>>(
+            src_local, init_local, dst_local, dimension, src_local->shape,
+            dst_local->shape, kernel_runtime_state));
   });
 
   DISPATCH_FLOAT_OPCODE(kReduceMinF, {
@@ -817,9 +1070,10 @@ Status Dispatch(hal::Allocator* allocator,
     ASSIGN_OR_RETURN(auto dimension, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     // TODO(scotttodd): validate
-    RETURN_IF_ERROR(ApplyBinaryOpF<kernels::ReduceMin>(
-        src_local, init_local, dst_local, dimension, src_local->shape,
-        dst_local->shape));
+    RETURN_IF_ERROR(
+        ApplyBinaryOpF<kernels::ParallelReduce<kernels::ReduceMin>>(
+            src_local, init_local, dst_local, dimension, src_local->shape,
+            dst_local->shape, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kReduceMaxI, {
@@ -828,9 +1082,10 @@ Status Dispatch(hal::Allocator* allocator,
     ASSIGN_OR_RETURN(auto dimension, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     // TODO(scotttodd): validate
-    RETURN_IF_ERROR(ApplyBinaryOpIS<kernels::ReduceMax>(
-        src_local, init_local, dst_local, dimension, src_local->shape,
-        dst_local->shape));
+    RETURN_IF_ERROR(
+        ApplyBinaryOpIS<kernels::ParallelReduce<kernels::ReduceMax>>(
+            src_local, init_local, dst_local, dimension, src_local->shape,
+            dst_local->shape, kernel_runtime_state));
   });
 
   DISPATCH_FLOAT_OPCODE(kReduceMaxF, {
@@ -839,9 +1094,10 @@ Status Dispatch(hal::Allocator* allocator,
     ASSIGN_OR_RETURN(auto dimension, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     // TODO(scotttodd): validate
-    RETURN_IF_ERROR(ApplyBinaryOpF<kernels::ReduceMax>(
-        src_local, init_local, dst_local, dimension, src_local->shape,
-        dst_local->shape));
+    RETURN_IF_ERROR(
+        ApplyBinaryOpF<kernels::ParallelReduce<kernels::ReduceMax>>(
+            src_local, init_local, dst_local, dimension, src_local->shape,
+            dst_local->shape, kernel_runtime_state));
   });
 
   DISPATCH_CORE_OPCODE(kTrace, {
@@ -65,6 +65,21 @@ Status ValidateElementwiseTernaryOp(BufferView* a_local, BufferView* b_local,
   return OkStatus();
 }
 
+Status ValidateCompareSelectOp(BufferView* lhs_local, BufferView* rhs_local,
+                               BufferView* true_local, BufferView* false_local,
+                               BufferView* dst_local) {
+  // The fused kernel compares and selects in the same element type.
+  if (lhs_local->element_size != rhs_local->element_size ||
+      true_local->element_size != lhs_local->element_size ||
+      false_local->element_size != lhs_local->element_size ||
+      dst_local->element_size != lhs_local->element_size) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Compare-select operands must share an element size";
+  }
+  // TODO(benvanik): validate shapes.
+  return OkStatus();
+}
+
 Status ValidateMatMulOpI(BufferView* lhs_local, BufferView* rhs_local,
                          BufferView* bias_local,
                          BufferView* multiplier_mantissa_local,
@@ -77,17 +92,36 @@ Status ValidateMatMulOpI(BufferView* lhs_local, BufferView* rhs_local,
 Status ValidateMatMulOpF(BufferView* lhs_local, BufferView* rhs_local,
                          BufferView* bias_local, BufferView* dst_local) {
   // TODO(benvanik): validate shapes.
+  if (bias_local && !bias_local->shape.empty() &&
+      (dst_local->shape.size() != 2 ||
+       bias_local->shape.element_count() != dst_local->shape[1])) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Bias " << bias_local->shape
+           << " must have one element per column of the result "
+           << dst_local->shape;
+  }
   return OkStatus();
 }
 
+MemoryAccessBitfield DestinationAccess(
+    BufferView* dst_local, std::initializer_list<BufferView*> src_locals) {
+  for (auto* src_local : src_locals) {
+    if (Buffer::DoesOverlap(dst_local->buffer.get(), 0, kWholeBuffer,
+                            src_local->buffer.get(), 0, kWholeBuffer)) {
+      return MemoryAccess::kWrite;
+    }
+  }
+  return MemoryAccess::kDiscardWrite;
+}
+
 Status ApplyCopy(BufferView* src_local, absl::Span<const int32_t> src_indices,
                  BufferView* dst_local, absl::Span<const int32_t> dst_indices,
                  absl::Span<const int32_t> lengths) {
   ASSIGN_OR_RETURN(auto src_buffer,
-                   src_local->buffer->MapMemory<uint8_t>(MemoryAccess::kRead));
+                   MapLocal<uint8_t>(src_local, MemoryAccess::kRead));
   // TODO(benvanik): discard if overwriting the entire buffer.
   ASSIGN_OR_RETURN(auto dst_buffer,
-                   dst_local->buffer->MapMemory<uint8_t>(MemoryAccess::kWrite));
+                   MapLocal<uint8_t>(dst_local, MemoryAccess::kWrite));
   switch (src_local->element_size) {
     case 1:
       return kernels::Copy::Execute<1>(src_buffer.contents(), src_local->shape,
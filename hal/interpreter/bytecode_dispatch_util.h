@@ -18,6 +18,8 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_DISPATCH_UTIL_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_DISPATCH_UTIL_H_
 
+#include <initializer_list>
+
 #include "third_party/absl/base/attributes.h"
 #include "third_party/absl/container/inlined_vector.h"
 #include "third_party/mlir_edge/iree/base/status.h"
@@ -49,6 +51,9 @@ Status ValidateElementwiseBinaryOp(BufferView* lhs_local, BufferView* rhs_local,
                                    BufferView* dst_local);
 Status ValidateElementwiseTernaryOp(BufferView* a_local, BufferView* b_local,
                                     BufferView* c_local, BufferView* dst_local);
+Status ValidateCompareSelectOp(BufferView* lhs_local, BufferView* rhs_local,
+                               BufferView* true_local, BufferView* false_local,
+                               BufferView* dst_local);
 Status ValidateMatMulOpI(BufferView* lhs_local, BufferView* rhs_local,
                          BufferView* bias_local,
                          BufferView* multiplier_mantissa_local,
@@ -57,14 +62,76 @@ Status ValidateMatMulOpI(BufferView* lhs_local, BufferView* rhs_local,
 Status ValidateMatMulOpF(BufferView* lhs_local, BufferView* rhs_local,
                          BufferView* bias_local, BufferView* dst_local);
 
+// Contents of a local mapped for the duration of a kernel invocation.
+// Buffers with persistently mapped host memory are accessed directly through
+// Buffer::host_data(), skipping the validation, reference counting, and unmap
+// of MapMemory that otherwise dominate small kernels. Other buffers fall back
+// to a scoped MappedMemory.
+template <typename T>
+class LocalMapping {
+ public:
+  LocalMapping() = default;
+  LocalMapping(LocalMapping&& other) noexcept = default;
+  LocalMapping& operator=(LocalMapping&& other) noexcept = default;
+  LocalMapping(const LocalMapping&) = delete;
+  LocalMapping& operator=(const LocalMapping&) = delete;
+
+  static StatusOr<LocalMapping> Map(BufferView* local,
+                                    MemoryAccessBitfield memory_access) {
+    LocalMapping mapping;
+    Buffer* buffer = local->buffer.get();
+    if (buffer->host_data() &&
+        (buffer->allowed_access() & memory_access) == memory_access) {
+      mapping.data_ = reinterpret_cast<T*>(buffer->host_data());
+      mapping.size_ = buffer->byte_length() / sizeof(T);
+    } else {
+      ASSIGN_OR_RETURN(mapping.mapped_memory_,
+                       buffer->MapMemory<T>(memory_access));
+      mapping.data_ = mapping.mapped_memory_.mutable_data();
+      if (!mapping.data_) {
+        mapping.data_ = const_cast<T*>(mapping.mapped_memory_.data());
+      }
+      mapping.size_ = mapping.mapped_memory_.size();
+    }
+    return mapping;
+  }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_t size() const noexcept { return size_; }
+  const T* data() const noexcept { return data_; }
+  T* mutable_data() noexcept { return data_; }
+  absl::Span<const T> contents() const noexcept { return {data_, size_}; }
+  absl::Span<T> mutable_contents() noexcept { return {data_, size_}; }
+  const T& operator[](size_t i) const noexcept { return data_[i]; }
+
+ private:
+  T* data_ = nullptr;
+  size_t size_ = 0;
+  MappedMemory<T> mapped_memory_;
+};
+
+// Maps the buffer of |local| for use by a kernel.
+template <typename T>
+StatusOr<LocalMapping<T>> MapLocal(BufferView* local,
+                                   MemoryAccessBitfield memory_access) {
+  return LocalMapping<T>::Map(local, memory_access);
+}
+
+// Returns the access with which |dst_local| should be mapped when it is
+// produced from |src_locals|. The compiler may alias the destination of an
+// elementwise op with a source that dies at the op; in that case the contents
+// must be preserved instead of discarded.
+MemoryAccessBitfield DestinationAccess(
+    BufferView* dst_local, std::initializer_list<BufferView*> src_locals);
+
 template <typename KERNEL, typename T, typename... ARGS>
 Status ApplyUnaryOp(BufferView* src_local, BufferView* dst_local,
                     ARGS... args) {
   // TODO(benvanik): avoid mapping by changing buffer type?
   ASSIGN_OR_RETURN(auto src_buffer,
-                   src_local->buffer->MapMemory<T>(MemoryAccess::kRead));
-  ASSIGN_OR_RETURN(auto dst_buffer, dst_local->buffer->MapMemory<T>(
-                                        MemoryAccess::kDiscardWrite));
+                   MapLocal<T>(src_local, MemoryAccess::kRead));
+  auto dst_access = DestinationAccess(dst_local, {src_local});
+  ASSIGN_OR_RETURN(auto dst_buffer, MapLocal<T>(dst_local, dst_access));
   return KERNEL::Execute(src_buffer.contents(), dst_buffer.mutable_contents(),
                          args...);
 }
@@ -73,11 +140,11 @@ template <typename KERNEL, typename T, typename... ARGS>
 Status ApplyBinaryOp(BufferView* lhs_local, BufferView* rhs_local,
                      BufferView* dst_local, ARGS... args) {
   ASSIGN_OR_RETURN(auto lhs_buffer,
-                   lhs_local->buffer->MapMemory<T>(MemoryAccess::kRead));
+                   MapLocal<T>(lhs_local, MemoryAccess::kRead));
   ASSIGN_OR_RETURN(auto rhs_buffer,
-                   rhs_local->buffer->MapMemory<T>(MemoryAccess::kRead));
-  ASSIGN_OR_RETURN(auto dst_buffer, dst_local->buffer->MapMemory<T>(
-                                        MemoryAccess::kDiscardWrite));
+                   MapLocal<T>(rhs_local, MemoryAccess::kRead));
+  auto dst_access = DestinationAccess(dst_local, {lhs_local, rhs_local});
+  ASSIGN_OR_RETURN(auto dst_buffer, MapLocal<T>(dst_local, dst_access));
   return KERNEL::Execute(lhs_buffer.contents(), rhs_buffer.contents(),
                          dst_buffer.mutable_contents(), args...);
 }
@@ -86,14 +153,11 @@ template <typename KERNEL, typename T, typename... ARGS>
 Status ApplyTernaryOp(BufferView* a_local, BufferView* b_local,
                       BufferView* c_local, BufferView* dst_local,
                       ARGS... args) {
-  ASSIGN_OR_RETURN(auto a_buffer,
-                   a_local->buffer->MapMemory<T>(MemoryAccess::kRead));
-  ASSIGN_OR_RETURN(auto b_buffer,
-                   b_local->buffer->MapMemory<T>(MemoryAccess::kRead));
-  ASSIGN_OR_RETURN(auto c_buffer,
-                   c_local->buffer->MapMemory<T>(MemoryAccess::kRead));
-  ASSIGN_OR_RETURN(auto dst_buffer, dst_local->buffer->MapMemory<T>(
-                                        MemoryAccess::kDiscardWrite));
+  ASSIGN_OR_RETURN(auto a_buffer, MapLocal<T>(a_local, MemoryAccess::kRead));
+  ASSIGN_OR_RETURN(auto b_buffer, MapLocal<T>(b_local, MemoryAccess::kRead));
+  ASSIGN_OR_RETURN(auto c_buffer, MapLocal<T>(c_local, MemoryAccess::kRead));
+  auto dst_access = DestinationAccess(dst_local, {a_local, b_local, c_local});
+  ASSIGN_OR_RETURN(auto dst_buffer, MapLocal<T>(dst_local, dst_access));
   return KERNEL::Execute(a_buffer.contents(), b_buffer.contents(),
                          c_buffer.contents(), dst_buffer.mutable_contents(),
                          args...);
@@ -103,15 +167,35 @@ template <typename KERNEL, typename T>
 Status ApplyComparisonOp(BufferView* lhs_local, BufferView* rhs_local,
                          BufferView* dst_local) {
   ASSIGN_OR_RETURN(auto lhs_buffer,
-                   lhs_local->buffer->MapMemory<T>(MemoryAccess::kRead));
+                   MapLocal<T>(lhs_local, MemoryAccess::kRead));
   ASSIGN_OR_RETURN(auto rhs_buffer,
-                   rhs_local->buffer->MapMemory<T>(MemoryAccess::kRead));
-  ASSIGN_OR_RETURN(auto dst_buffer, dst_local->buffer->MapMemory<uint8_t>(
-                                        MemoryAccess::kDiscardWrite));
+                   MapLocal<T>(rhs_local, MemoryAccess::kRead));
+  ASSIGN_OR_RETURN(auto dst_buffer,
+                   MapLocal<uint8_t>(dst_local, MemoryAccess::kDiscardWrite));
   return KERNEL::Execute(lhs_buffer.contents(), rhs_buffer.contents(),
                          dst_buffer.mutable_contents());
 }
 
+template <typename KERNEL, typename T, typename... ARGS>
+Status ApplyCompareSelectOp(BufferView* lhs_local, BufferView* rhs_local,
+                            BufferView* true_local, BufferView* false_local,
+                            BufferView* dst_local, ARGS... args) {
+  ASSIGN_OR_RETURN(auto lhs_buffer,
+                   MapLocal<T>(lhs_local, MemoryAccess::kRead));
+  ASSIGN_OR_RETURN(auto rhs_buffer,
+                   MapLocal<T>(rhs_local, MemoryAccess::kRead));
+  ASSIGN_OR_RETURN(auto true_buffer,
+                   MapLocal<T>(true_local, MemoryAccess::kRead));
+  ASSIGN_OR_RETURN(auto false_buffer,
+                   MapLocal<T>(false_local, MemoryAccess::kRead));
+  auto dst_access = DestinationAccess(
+      dst_local, {lhs_local, rhs_local, true_local, false_local});
+  ASSIGN_OR_RETURN(auto dst_buffer, MapLocal<T>(dst_local, dst_access));
+  return KERNEL::Execute(lhs_buffer.contents(), rhs_buffer.contents(),
+                         true_buffer.contents(), false_buffer.contents(),
+                         dst_buffer.mutable_contents(), args...);
+}
+
 template <typename KERNEL, typename... ARGS>
 Status ApplyUnaryOpIS(BufferView* src_local, BufferView* dst_local,
                       ARGS... args) {
@@ -354,6 +438,102 @@ Status ApplyComparisonOpF(BufferView* lhs_local, BufferView* rhs_local,
   }
 }
 
+template <typename CMP>
+Status ApplyCompareSelectOpIS(BufferView* lhs_local, BufferView* rhs_local,
+                              BufferView* true_local, BufferView* false_local,
+                              BufferView* dst_local,
+                              kernels::RuntimeState* runtime_state) {
+  RETURN_IF_ERROR(ValidateCompareSelectOp(lhs_local, rhs_local, true_local,
+                                          false_local, dst_local));
+  switch (lhs_local->element_size) {
+    case 1:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, int8_t>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+    case 2:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, int16_t>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+    case 4:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, int32_t>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+    case 8:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, int64_t>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+    default:
+      return UnimplementedErrorBuilder(ABSL_LOC)
+             << "Unimplemented element size: " << lhs_local->element_size;
+  }
+}
+
+template <typename CMP>
+Status ApplyCompareSelectOpIU(BufferView* lhs_local, BufferView* rhs_local,
+                              BufferView* true_local, BufferView* false_local,
+                              BufferView* dst_local,
+                              kernels::RuntimeState* runtime_state) {
+  RETURN_IF_ERROR(ValidateCompareSelectOp(lhs_local, rhs_local, true_local,
+                                          false_local, dst_local));
+  switch (lhs_local->element_size) {
+    case 1:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, uint8_t>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+    case 2:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, uint16_t>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+    case 4:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, uint32_t>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+    case 8:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, uint64_t>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+    default:
+      return UnimplementedErrorBuilder(ABSL_LOC)
+             << "Unimplemented element size: " << lhs_local->element_size;
+  }
+}
+
+template <typename CMP>
+Status ApplyCompareSelectOpF(BufferView* lhs_local, BufferView* rhs_local,
+                             BufferView* true_local, BufferView* false_local,
+                             BufferView* dst_local,
+                             kernels::RuntimeState* runtime_state) {
+  RETURN_IF_ERROR(ValidateCompareSelectOp(lhs_local, rhs_local, true_local,
+                                          false_local, dst_local));
+  switch (lhs_local->element_size) {
+#if defined(IREE_SUPPORT_F32)
+    case 4:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, float>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+#endif  // IREE_SUPPORT_F32
+#if defined(IREE_SUPPORT_F64)
+    case 8:
+      return ApplyCompareSelectOp<
+          kernels::ParallelElementwise<kernels::CompareSelect<CMP>>, double>(
+          lhs_local, rhs_local, true_local, false_local, dst_local,
+          runtime_state, dst_local->shape);
+#endif  // IREE_SUPPORT_F64
+    default:
+      return UnimplementedErrorBuilder(ABSL_LOC)
+             << "Unimplemented element size: " << lhs_local->element_size;
+  }
+}
+
 template <typename T, typename ACC = int32_t>
 Status ApplyMatMulOpI(kernels::MatMul::RuntimeState* runtime_state,
                       BufferView* lhs_local, BufferView* rhs_local,
@@ -363,146 +543,215 @@ Status ApplyMatMulOpI(kernels::MatMul::RuntimeState* runtime_state,
                       BufferView* dst_local) {
   kernels::MatMul::Buffers<T, ACC> buffers;
   ASSIGN_OR_RETURN(auto lhs_buffer,
-                   lhs_local->buffer->MapMemory<T>(MemoryAccess::kRead));
+                   MapLocal<T>(lhs_local, MemoryAccess::kRead));
   buffers.lhs_buffer = lhs_buffer.contents();
   buffers.lhs_shape = lhs_local->shape;
   ASSIGN_OR_RETURN(auto rhs_buffer,
-                   rhs_local->buffer->MapMemory<T>(MemoryAccess::kRead));
+                   MapLocal<T>(rhs_local, MemoryAccess::kRead));
   buffers.rhs_buffer = rhs_buffer.contents();
   buffers.rhs_shape = rhs_local->shape;
-  MappedMemory<ACC> bias_buffer;
+  LocalMapping<ACC> bias_buffer;
   if (bias_local && bias_local->buffer && !bias_local->shape.empty()) {
     if (bias_local->element_size != sizeof(ACC)) {
       return UnimplementedErrorBuilder(ABSL_LOC)
              << "Only " << sizeof(ACC) << "b biases are supported right now";
     }
     ASSIGN_OR_RETURN(bias_buffer,
-                     bias_local->buffer->MapMemory<ACC>(MemoryAccess::kRead));
+                     MapLocal<ACC>(bias_local, MemoryAccess::kRead));
     buffers.bias_buffer = bias_buffer.contents();
   }
-  ASSIGN_OR_RETURN(
-      auto multiplier_mantissa_buffer,
-      multiplier_mantissa_local->buffer->MapMemory<ACC>(MemoryAccess::kRead));
+  ASSIGN_OR_RETURN(auto multiplier_mantissa_buffer,
+                   MapLocal<ACC>(multiplier_mantissa_local,
+                                 MemoryAccess::kRead));
   buffers.multiplier_mantissa_buffer = multiplier_mantissa_buffer.contents();
   ASSIGN_OR_RETURN(auto multiplier_exponent_buffer,
-                   multiplier_exponent_local->buffer->MapMemory<int32_t>(
-                       MemoryAccess::kRead));
+                   MapLocal<int32_t>(multiplier_exponent_local,
+                                     MemoryAccess::kRead));
   buffers.multiplier_exponent_buffer = multiplier_exponent_buffer.contents();
-  ASSIGN_OR_RETURN(auto dst_buffer, dst_local->buffer->MapMemory<T>(
-                                        MemoryAccess::kDiscardWrite));
+  ASSIGN_OR_RETURN(auto dst_buffer,
+                   MapLocal<T>(dst_local, MemoryAccess::kDiscardWrite));
   buffers.dst_buffer = dst_buffer.mutable_contents();
   buffers.dst_shape = dst_local->shape;
   return kernels::MatMul::Execute(runtime_state, buffers);
 }
 
+// |bias_local|, |clamp_min_local|, and |clamp_max_local| are optional. The
+// clamp bounds are read from the first element of their buffers.
 template <typename T>
 Status ApplyMatMulOpF(kernels::MatMul::RuntimeState* runtime_state,
                       BufferView* lhs_local, BufferView* rhs_local,
-                      BufferView* bias_local, BufferView* dst_local) {
+                      BufferView* bias_local, BufferView* clamp_min_local,
+                      BufferView* clamp_max_local, BufferView* dst_local) {
   kernels::MatMul::Buffers<T, T> buffers;
+  buffers.column_channels = true;
   ASSIGN_OR_RETURN(auto lhs_buffer,
-                   lhs_local->buffer->MapMemory<T>(MemoryAccess::kRead));
+                   MapLocal<T>(lhs_local, MemoryAccess::kRead));
   buffers.lhs_buffer = lhs_buffer.contents();
   buffers.lhs_shape = lhs_local->shape;
   ASSIGN_OR_RETURN(auto rhs_buffer,
-                   rhs_local->buffer->MapMemory<T>(MemoryAccess::kRead));
+                   MapLocal<T>(rhs_local, MemoryAccess::kRead));
   buffers.rhs_buffer = rhs_buffer.contents();
   buffers.rhs_shape = rhs_local->shape;
-  MappedMemory<T> bias_buffer;
+  LocalMapping<T> bias_buffer;
   if (bias_local && bias_local->buffer && !bias_local->shape.empty()) {
-    ASSIGN_OR_RETURN(bias_buffer,
-                     bias_local->buffer->MapMemory<T>(MemoryAccess::kRead));
+    ASSIGN_OR_RETURN(bias_buffer, MapLocal<T>(bias_local, MemoryAccess::kRead));
     buffers.bias_buffer = bias_buffer.contents();
   }
-  ASSIGN_OR_RETURN(auto dst_buffer, dst_local->buffer->MapMemory<T>(
-                                        MemoryAccess::kDiscardWrite));
+  if (clamp_min_local) {
+    ASSIGN_OR_RETURN(auto clamp_min_buffer,
+                     MapLocal<T>(clamp_min_local, MemoryAccess::kRead));
+    buffers.clamp_min = clamp_min_buffer[0];
+  }
+  if (clamp_max_local) {
+    ASSIGN_OR_RETURN(auto clamp_max_buffer,
+                     MapLocal<T>(clamp_max_local, MemoryAccess::kRead));
+    buffers.clamp_max = clamp_max_buffer[0];
+  }
+  ASSIGN_OR_RETURN(auto dst_buffer,
+                   MapLocal<T>(dst_local, MemoryAccess::kDiscardWrite));
   buffers.dst_buffer = dst_buffer.mutable_contents();
   buffers.dst_shape = dst_local->shape;
   return kernels::MatMul::Execute(runtime_state, buffers);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseUnaryOpIS(vm::BytecodeReader* reader) {
+Status DispatchElementwiseUnaryOpIS(vm::BytecodeReader* reader,
+                                    kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* src_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(ValidateElementwiseUnaryOp(src_local, dst_local));
-  return ApplyUnaryOpIS<KERNEL>(src_local, dst_local);
+  return ApplyUnaryOpIS<kernels::ParallelElementwise<KERNEL>>(
+      src_local, dst_local, runtime_state, dst_local->shape);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseUnaryOpIU(vm::BytecodeReader* reader) {
+Status DispatchElementwiseUnaryOpIU(vm::BytecodeReader* reader,
+                                    kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* src_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(ValidateElementwiseUnaryOp(src_local, dst_local));
-  return ApplyUnaryOpIU<KERNEL>(src_local, dst_local);
+  return ApplyUnaryOpIU<kernels::ParallelElementwise<KERNEL>>(
+      src_local, dst_local, runtime_state, dst_local->shape);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseUnaryOpF(vm::BytecodeReader* reader) {
+Status DispatchElementwiseUnaryOpF(vm::BytecodeReader* reader,
+                                   kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* src_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(ValidateElementwiseUnaryOp(src_local, dst_local));
-  return ApplyUnaryOpF<KERNEL>(src_local, dst_local);
+  return ApplyUnaryOpF<kernels::ParallelElementwise<KERNEL>>(
+      src_local, dst_local, runtime_state, dst_local->shape);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseBinaryOpIS(vm::BytecodeReader* reader) {
+Status DispatchElementwiseBinaryOpIS(vm::BytecodeReader* reader,
+                                     kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* lhs_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* rhs_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(ValidateElementwiseBinaryOp(lhs_local, rhs_local, dst_local));
-  return ApplyBinaryOpIS<KERNEL>(lhs_local, rhs_local, dst_local);
+  if (lhs_local->shape != dst_local->shape ||
+      rhs_local->shape != dst_local->shape) {
+    return ApplyBinaryOpIS<kernels::BroadcastElementwise<KERNEL>>(
+        lhs_local, rhs_local, dst_local, runtime_state, lhs_local->shape,
+        rhs_local->shape, dst_local->shape);
+  }
+  return ApplyBinaryOpIS<kernels::ParallelElementwise<KERNEL>>(
+      lhs_local, rhs_local, dst_local, runtime_state, dst_local->shape);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseBinaryOpIU(vm::BytecodeReader* reader) {
+Status DispatchElementwiseBinaryOpIU(vm::BytecodeReader* reader,
+                                     kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* lhs_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* rhs_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(ValidateElementwiseBinaryOp(lhs_local, rhs_local, dst_local));
-  return ApplyBinaryOpIU<KERNEL>(lhs_local, rhs_local, dst_local);
+  if (lhs_local->shape != dst_local->shape ||
+      rhs_local->shape != dst_local->shape) {
+    return ApplyBinaryOpIU<kernels::BroadcastElementwise<KERNEL>>(
+        lhs_local, rhs_local, dst_local, runtime_state, lhs_local->shape,
+        rhs_local->shape, dst_local->shape);
+  }
+  return ApplyBinaryOpIU<kernels::ParallelElementwise<KERNEL>>(
+      lhs_local, rhs_local, dst_local, runtime_state, dst_local->shape);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseBinaryOpF(vm::BytecodeReader* reader) {
+Status DispatchElementwiseBinaryOpF(vm::BytecodeReader* reader,
+                                    kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* lhs_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* rhs_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(ValidateElementwiseBinaryOp(lhs_local, rhs_local, dst_local));
-  return ApplyBinaryOpF<KERNEL>(lhs_local, rhs_local, dst_local);
+  if (lhs_local->shape != dst_local->shape ||
+      rhs_local->shape != dst_local->shape) {
+    return ApplyBinaryOpF<kernels::BroadcastElementwise<KERNEL>>(
+        lhs_local, rhs_local, dst_local, runtime_state, lhs_local->shape,
+        rhs_local->shape, dst_local->shape);
+  }
+  return ApplyBinaryOpF<kernels::ParallelElementwise<KERNEL>>(
+      lhs_local, rhs_local, dst_local, runtime_state, dst_local->shape);
+}
+
+// Dispatches to FAST_KERNEL if the executable allows fast math and otherwise
+// to the exact KERNEL.
+template <typename KERNEL, typename FAST_KERNEL>
+Status DispatchElementwiseUnaryMathOpF(vm::BytecodeReader* reader,
+                                       kernels::RuntimeState* runtime_state) {
+  if (runtime_state->math_mode == kernels::MathMode::kFast) {
+    return DispatchElementwiseUnaryOpF<FAST_KERNEL>(reader, runtime_state);
+  }
+  return DispatchElementwiseUnaryOpF<KERNEL>(reader, runtime_state);
+}
+
+template <typename KERNEL, typename FAST_KERNEL>
+Status DispatchElementwiseBinaryMathOpF(vm::BytecodeReader* reader,
+                                        kernels::RuntimeState* runtime_state) {
+  if (runtime_state->math_mode == kernels::MathMode::kFast) {
+    return DispatchElementwiseBinaryOpF<FAST_KERNEL>(reader, runtime_state);
+  }
+  return DispatchElementwiseBinaryOpF<KERNEL>(reader, runtime_state);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseTernaryOpIS(vm::BytecodeReader* reader) {
+Status DispatchElementwiseTernaryOpIS(vm::BytecodeReader* reader,
+                                      kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* a_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* b_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* c_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(
       ValidateElementwiseTernaryOp(a_local, b_local, c_local, dst_local));
-  return ApplyTernaryOpIS<KERNEL>(a_local, b_local, c_local, dst_local);
+  return ApplyTernaryOpIS<kernels::ParallelElementwise<KERNEL>>(
+      a_local, b_local, c_local, dst_local, runtime_state, dst_local->shape);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseTernaryOpIU(vm::BytecodeReader* reader) {
+Status DispatchElementwiseTernaryOpIU(vm::BytecodeReader* reader,
+                                      kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* a_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* b_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* c_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(
       ValidateElementwiseTernaryOp(a_local, b_local, c_local, dst_local));
-  return ApplyTernaryOpIU<KERNEL>(a_local, b_local, c_local, dst_local);
+  return ApplyTernaryOpIU<kernels::ParallelElementwise<KERNEL>>(
+      a_local, b_local, c_local, dst_local, runtime_state, dst_local->shape);
 }
 
 template <typename KERNEL>
-Status DispatchElementwiseTernaryOpF(vm::BytecodeReader* reader) {
+Status DispatchElementwiseTernaryOpF(vm::BytecodeReader* reader,
+                                     kernels::RuntimeState* runtime_state) {
   ASSIGN_OR_RETURN(auto* a_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* b_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* c_local, reader->ReadLocal());
   ASSIGN_OR_RETURN(auto* dst_local, reader->ReadLocal());
   RETURN_IF_ERROR(
       ValidateElementwiseTernaryOp(a_local, b_local, c_local, dst_local));
-  return ApplyTernaryOpF<KERNEL>(a_local, b_local, c_local, dst_local);
+  return ApplyTernaryOpF<kernels::ParallelElementwise<KERNEL>>(
+      a_local, b_local, c_local, dst_local, runtime_state, dst_local->shape);
 }
 
 Status ApplyCopy(BufferView* src_local, absl::Span<const int32_t> src_indices,
@@ -29,12 +29,13 @@ const bool kEnableExecutablePrinting = false;
 
 // static
 StatusOr<ref_ptr<BytecodeExecutable>> BytecodeExecutable::Load(
-    hal::Allocator* allocator, ExecutableSpec spec, bool allow_aliasing_data) {
+    hal::Allocator* allocator, HostWorkerPool* worker_pool, ExecutableSpec spec,
+    bool allow_aliasing_data, kernels::MathMode math_mode) {
   // Allocate the executable now.
   // We do this here so that if we need to clone the data we are passing that
   // to the VM loader instead of the data we may not have access to later.
-  auto executable =
-      make_ref<BytecodeExecutable>(allocator, spec, allow_aliasing_data);
+  auto executable = make_ref<BytecodeExecutable>(
+      allocator, worker_pool, spec, allow_aliasing_data, math_mode);
   auto* context = executable->mutable_context();
 
   // Create the executable module.
@@ -48,11 +49,8 @@ StatusOr<ref_ptr<BytecodeExecutable>> BytecodeExecutable::Load(
   // We do this here so that we get a good stack immediately when the bytecode
   // is provided instead of when we go to run it. This more closely mirrors how
   // a backend that performed compilation (such as SPIR-V) would fail.
-  for (auto* function_def :
-       *executable->module().function_table().def().functions()) {
-    RETURN_IF_ERROR(vm::BytecodeValidator::Validate(
-        *context, executable->module(), *function_def->bytecode()));
-  }
+  RETURN_IF_ERROR(vm::BytecodeValidator::ValidateModule(
+      *context, executable->module_, vm::interpreter_opcode_table()));
 
   // Print the bytecode.
   // TODO(benvanik): remove when debugger is wired up to the HAL.
@@ -68,9 +66,11 @@ StatusOr<ref_ptr<BytecodeExecutable>> BytecodeExecutable::Load(
 }
 
 BytecodeExecutable::BytecodeExecutable(hal::Allocator* allocator,
+                                       HostWorkerPool* worker_pool,
                                        ExecutableSpec spec,
-                                       bool allow_aliasing_data)
-    : spec_(spec), context_(allocator) {
+                                       bool allow_aliasing_data,
+                                       kernels::MathMode math_mode)
+    : spec_(spec), context_(allocator, worker_pool, math_mode) {
   if (!allow_aliasing_data) {
     // Clone data.
     cloned_executable_data_ = {spec.executable_data.begin(),
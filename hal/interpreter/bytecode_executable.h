@@ -22,6 +22,8 @@
 #include "third_party/mlir_edge/iree/hal/allocator.h"
 #include "third_party/mlir_edge/iree/hal/executable.h"
 #include "third_party/mlir_edge/iree/hal/executable_spec.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels.h"
 #include "third_party/mlir_edge/iree/hal/interpreter/interpreter_context.h"
 #include "third_party/mlir_edge/iree/vm/context.h"
 
@@ -30,12 +32,14 @@ namespace hal {
 
 class BytecodeExecutable final : public Executable {
  public:
-  static StatusOr<ref_ptr<BytecodeExecutable>> Load(hal::Allocator* allocator,
-                                                    ExecutableSpec spec,
-                                                    bool allow_aliasing_data);
+  static StatusOr<ref_ptr<BytecodeExecutable>> Load(
+      hal::Allocator* allocator, HostWorkerPool* worker_pool,
+      ExecutableSpec spec, bool allow_aliasing_data,
+      kernels::MathMode math_mode);
 
-  BytecodeExecutable(hal::Allocator* allocator, ExecutableSpec spec,
-                     bool allow_aliasing_data);
+  BytecodeExecutable(hal::Allocator* allocator, HostWorkerPool* worker_pool,
+                     ExecutableSpec spec, bool allow_aliasing_data,
+                     kernels::MathMode math_mode);
   ~BytecodeExecutable() override;
 
   bool supports_debugging() const override { return false; }
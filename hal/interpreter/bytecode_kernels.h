@@ -35,10 +35,12 @@
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_H_
 
 #include <cstdint>
+#include <limits>
 
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/base/shape.h"
 #include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
 
 namespace iree {
 namespace hal {
@@ -99,6 +101,18 @@ struct Select {
                         absl::Span<T> dst_buffer);
 };
 
+// CMP(lhs, rhs) ? true : false
+// Fused compare and select that never materializes the full condition mask.
+template <typename CMP>
+struct CompareSelect {
+  template <typename T>
+  static Status Execute(absl::Span<const T> lhs_buffer,
+                        absl::Span<const T> rhs_buffer,
+                        absl::Span<const T> true_buffer,
+                        absl::Span<const T> false_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
 struct Transpose {
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
@@ -220,6 +234,15 @@ struct MulAdd {
                         absl::Span<const T> c_buffer, absl::Span<T> dst_buffer);
 };
 
+// max(a + b, c)
+// Fused bias add and lower bound (such as relu when c is zero).
+struct AddMax {
+  template <typename T>
+  static Status Execute(absl::Span<const T> a_buffer,
+                        absl::Span<const T> b_buffer,
+                        absl::Span<const T> c_buffer, absl::Span<T> dst_buffer);
+};
+
 struct Exp {
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
@@ -263,6 +286,63 @@ struct Atan2 {
                         absl::Span<T> dst_buffer);
 };
 
+// Approximate versions of the transcendental kernels above, used when an
+// executable opts in to fast math (MathMode::kFast). The generic versions
+// forward to the exact kernels; vectorized float versions are provided by
+// bytecode_kernels_simd.h with the following maximum errors relative to the
+// correctly rounded result (identical on all instruction sets):
+//   FastExp:   1 ulp
+//   FastLog:   1 ulp
+//   FastTanh:  1.5 ulp
+//   FastRsqrt: 1.5 ulp
+//   FastSin:   2.5 ulp (|x| <= 8192; larger arguments match Sin)
+//   FastCos:   2.5 ulp (|x| <= 8192; larger arguments match Cos)
+//   FastAtan2: 1 ulp
+// Special values (infinities, NaNs, signed zeros) match the exact kernels
+// except that the sign of NaN results is unspecified.
+struct FastExp {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
+struct FastLog {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
+struct FastRsqrt {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
+struct FastCos {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
+struct FastSin {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
+struct FastTanh {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
+struct FastAtan2 {
+  template <typename T>
+  static Status Execute(absl::Span<const T> lhs_buffer,
+                        absl::Span<const T> rhs_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
 struct Min {
   template <typename T>
   static Status Execute(absl::Span<const T> lhs_buffer,
@@ -317,12 +397,26 @@ struct MatMul {
     Shape dst_shape;
     absl::Span<T> dst_buffer;
 
-    // Optional bias buffer.
+    // Whether the channels of the bias and per-channel multipliers are the
+    // columns of the destination matrix (as in dense layers) instead of its
+    // rows.
+    bool column_channels = false;
+
+    // Optional bias buffer with one element per channel.
     absl::Span<const ACC> bias_buffer;
 
+    // Range the destination values are clamped to after the bias is added.
+    // Used to fuse activations such as relu. Floating-point values are
+    // unbounded by default so that infinities pass through unchanged.
+    T clamp_min = std::numeric_limits<T>::has_infinity
+                      ? -std::numeric_limits<T>::infinity()
+                      : std::numeric_limits<T>::lowest();
+    T clamp_max = std::numeric_limits<T>::has_infinity
+                      ? std::numeric_limits<T>::infinity()
+                      : std::numeric_limits<T>::max();
+
     // Fixed-point multiplier mantissa/exponent. May be a single value (for
-    // uniform quantization) or one element per row of the destination matrix
-    // for per-channel.
+    // uniform quantization) or one element per channel for per-channel.
     absl::Span<const ACC> multiplier_mantissa_buffer;
     absl::Span<const int32_t> multiplier_exponent_buffer;
   };
@@ -332,9 +426,30 @@ struct MatMul {
                         const Buffers<T, ACC>& buffers);
 };
 
+// Controls which transcendental and floating-point sum kernels are used by an
+// executable.
+enum class MathMode {
+  // Exact kernels matching the C++ standard library and ordered summation for
+  // ReduceSum.
+  kExact,
+  // Exact kernels with compensated (Kahan) summation for ReduceSum. Slower
+  // than kExact but bounds the rounding error of long sums.
+  kCompensated,
+  // Approximate vectorized kernels (FastExp/etc) with bounded error and
+  // pairwise summation for ReduceSum.
+  kFast,
+};
+
 struct RuntimeState {
   std::unique_ptr<MatMul::RuntimeState> mat_mul_state =
       MatMul::CreateRuntimeState();
+
+  // Selects between the exact and fast transcendental kernels.
+  MathMode math_mode = MathMode::kExact;
+
+  // Worker pool used to split large kernels across cores. Not owned and may be
+  // nullptr, in which case all kernels run on the calling thread.
+  HostWorkerPool* worker_pool = nullptr;
 };
 
 struct ReduceSum {
@@ -345,6 +460,25 @@ struct ReduceSum {
                         const Shape& src_shape, const Shape& dst_shape);
 };
 
+// ReduceSum adding each element in order, exactly matching a sequential loop.
+struct ReduceSumOrdered {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<const T> init_buffer,
+                        absl::Span<T> dst_buffer, int32_t dimension,
+                        const Shape& src_shape, const Shape& dst_shape);
+};
+
+// ReduceSum using Kahan summation to bound rounding error independent of the
+// number of elements reduced. Only meaningful for floating-point types.
+struct ReduceSumKahan {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<const T> init_buffer,
+                        absl::Span<T> dst_buffer, int32_t dimension,
+                        const Shape& src_shape, const Shape& dst_shape);
+};
+
 struct ReduceMin {
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
@@ -361,11 +495,70 @@ struct ReduceMax {
                         const Shape& src_shape, const Shape& dst_shape);
 };
 
+// Splits an elementwise KERNEL along the outermost dimension of |shape| across
+// the runtime worker pool. Each worker invokes KERNEL on the same range of rows
+// of every buffer.
+template <typename KERNEL>
+struct ParallelElementwise {
+  template <typename T, typename DST>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<DST> dst_buffer,
+                        RuntimeState* runtime_state, const Shape& shape);
+  template <typename T, typename DST>
+  static Status Execute(absl::Span<const T> lhs_buffer,
+                        absl::Span<const T> rhs_buffer,
+                        absl::Span<DST> dst_buffer,
+                        RuntimeState* runtime_state, const Shape& shape);
+  template <typename T, typename DST>
+  static Status Execute(absl::Span<const T> a_buffer,
+                        absl::Span<const T> b_buffer,
+                        absl::Span<const T> c_buffer,
+                        absl::Span<DST> dst_buffer,
+                        RuntimeState* runtime_state, const Shape& shape);
+  template <typename T, typename DST>
+  static Status Execute(absl::Span<const T> a_buffer,
+                        absl::Span<const T> b_buffer,
+                        absl::Span<const T> c_buffer,
+                        absl::Span<const T> d_buffer,
+                        absl::Span<DST> dst_buffer,
+                        RuntimeState* runtime_state, const Shape& shape);
+};
+
+// Runs a binary elementwise KERNEL on operands whose shapes broadcast to
+// |dst_shape| without materializing the broadcast operand. Operand shapes are
+// aligned to the trailing dimensions of |dst_shape| and any dimension of size 1
+// is read with a stride of 0. Work is split across the runtime worker pool like
+// ParallelElementwise.
+template <typename KERNEL>
+struct BroadcastElementwise {
+  template <typename T, typename DST>
+  static Status Execute(absl::Span<const T> lhs_buffer,
+                        absl::Span<const T> rhs_buffer,
+                        absl::Span<DST> dst_buffer,
+                        RuntimeState* runtime_state, const Shape& lhs_shape,
+                        const Shape& rhs_shape, const Shape& dst_shape);
+};
+
+// Splits a reduction KERNEL along the outermost dimension of the source when
+// that dimension is not being reduced (and so is also the outermost dimension
+// of the destination). Otherwise runs KERNEL on the calling thread.
+template <typename KERNEL>
+struct ParallelReduce {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<const T> init_buffer,
+                        absl::Span<T> dst_buffer, int32_t dimension,
+                        const Shape& src_shape, const Shape& dst_shape,
+                        RuntimeState* runtime_state);
+};
+
 }  // namespace kernels
 }  // namespace hal
 }  // namespace iree
 
 #include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_generic.h"  // IWYU pragma: export
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_parallel.h"  // IWYU pragma: export
 #include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_ruy.h"  // IWYU pragma: export
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_simd.h"  // IWYU pragma: export
 
 #endif  // THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_H_
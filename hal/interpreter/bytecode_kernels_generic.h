@@ -15,7 +15,8 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_GENERIC_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_GENERIC_H_
 
-#include "third_party/absl/container/flat_hash_set.h"
+#include <algorithm>
+
 #include "third_party/absl/container/inlined_vector.h"
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/base/status.h"
@@ -154,59 +155,208 @@ Status Select::Execute(absl::Span<const uint8_t> cond_buffer,
   return OkStatus();
 }
 
+namespace impl {
+// Number of elements fused kernels process per step. Intermediate values are
+// kept in a stack buffer of this many elements so that they stay in L1 between
+// the component kernels (which keep their vectorized specializations).
+constexpr size_t kFusedChunkElementCount = 256;
+}  // namespace impl
+
+template <typename CMP>
+template <typename T>
+Status CompareSelect<CMP>::Execute(absl::Span<const T> lhs_buffer,
+                                   absl::Span<const T> rhs_buffer,
+                                   absl::Span<const T> true_buffer,
+                                   absl::Span<const T> false_buffer,
+                                   absl::Span<T> dst_buffer) {
+  uint8_t cond[impl::kFusedChunkElementCount];
+  for (size_t offset = 0; offset < dst_buffer.size();
+       offset += impl::kFusedChunkElementCount) {
+    size_t length =
+        std::min(impl::kFusedChunkElementCount, dst_buffer.size() - offset);
+    auto cond_chunk = absl::MakeSpan(cond, length);
+    RETURN_IF_ERROR(CMP::template Execute<T>(lhs_buffer.subspan(offset, length),
+                                             rhs_buffer.subspan(offset, length),
+                                             cond_chunk));
+    RETURN_IF_ERROR(Select::Execute<T>(
+        cond_chunk, true_buffer.subspan(offset, length),
+        false_buffer.subspan(offset, length),
+        dst_buffer.subspan(offset, length)));
+  }
+  return OkStatus();
+}
+
+namespace impl {
+
+// A dimension of a transpose in destination order with strides in elements.
+struct TransposeDim {
+  size_t size;
+  size_t src_stride;
+  size_t dst_stride;
+};
+
+// Reduces the transpose of |src_shape| by |perm| to the fewest dimensions
+// (in destination order) by dropping unit dimensions and merging dimensions
+// that are adjacent in both the source and destination.
+inline absl::InlinedVector<TransposeDim, 8> SimplifyTranspose(
+    const Shape& src_shape, absl::Span<const int32_t> perm) {
+  int rank = src_shape.size();
+  absl::InlinedVector<size_t, 8> src_strides(rank);
+  size_t stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    src_strides[i] = stride;
+    stride *= src_shape[i];
+  }
+  absl::InlinedVector<TransposeDim, 8> dims;
+  for (int i = 0; i < rank; ++i) {
+    size_t size = src_shape[perm[i]];
+    size_t src_stride = src_strides[perm[i]];
+    if (size == 1) continue;
+    if (!dims.empty() && dims.back().src_stride == size * src_stride) {
+      dims.back().size *= size;
+      dims.back().src_stride = src_stride;
+    } else {
+      dims.push_back({size, src_stride, 0});
+    }
+  }
+  stride = 1;
+  for (int i = dims.size() - 1; i >= 0; --i) {
+    dims[i].dst_stride = stride;
+    stride *= dims[i].size;
+  }
+  return dims;
+}
+
+// Transposes a |rows| x |cols| row-major matrix such that
+// dst[c * dst_stride + r] = src[r * src_stride + c], walking it in blocks
+// small enough that both the source and destination stay in cache.
+// Specialized for 32-bit types in bytecode_kernels_simd.h.
+template <typename T>
+void TransposeMatrix(const T* src, size_t src_stride, T* dst,
+                     size_t dst_stride, size_t rows, size_t cols) {
+  constexpr size_t kBlockSize = 16;
+  for (size_t r0 = 0; r0 < rows; r0 += kBlockSize) {
+    size_t r1 = std::min(rows, r0 + kBlockSize);
+    for (size_t c0 = 0; c0 < cols; c0 += kBlockSize) {
+      size_t c1 = std::min(cols, c0 + kBlockSize);
+      for (size_t c = c0; c < c1; ++c) {
+        for (size_t r = r0; r < r1; ++r) {
+          dst[c * dst_stride + r] = src[r * src_stride + c];
+        }
+      }
+    }
+  }
+}
+
+// Invokes |fn| with the source and destination offsets of every index in
+// |dims|, advancing the offsets incrementally instead of decomposing each
+// index.
+template <typename FN>
+void ForEachTransposeIndex(absl::Span<const TransposeDim> dims, FN fn) {
+  size_t count = 1;
+  for (const auto& dim : dims) count *= dim.size;
+  absl::InlinedVector<size_t, 8> indices(dims.size(), 0);
+  size_t src_offset = 0;
+  size_t dst_offset = 0;
+  for (size_t i = 0; i < count; ++i) {
+    fn(src_offset, dst_offset);
+    for (int d = dims.size() - 1; d >= 0; --d) {
+      src_offset += dims[d].src_stride;
+      dst_offset += dims[d].dst_stride;
+      if (++indices[d] < dims[d].size) break;
+      src_offset -= dims[d].size * dims[d].src_stride;
+      dst_offset -= dims[d].size * dims[d].dst_stride;
+      indices[d] = 0;
+    }
+  }
+}
+
+}  // namespace impl
+
 template <typename T>
 Status Transpose::Execute(absl::Span<const T> src_buffer,
                           absl::Span<T> dst_buffer, const Shape& src_shape,
                           absl::Span<const int32_t> perm) {
-  // This implementation is .... not fast.
-  int rank = src_shape.size();
-  absl::InlinedVector<int, 8> src_strides(rank);
-  absl::InlinedVector<int, 8> dst_strides(rank);
-  size_t src_stride = 1;
-  size_t dst_stride = 1;
-  for (int dim_i = rank - 1; dim_i >= 0; --dim_i) {
-    src_strides[dim_i] = src_stride;
-    dst_strides[dim_i] = dst_stride;
-    src_stride *= src_shape[dim_i];
-    dst_stride *= src_shape[perm[dim_i]];
-  }
-  for (size_t dst_i = 0; dst_i < dst_buffer.size(); ++dst_i) {
-    size_t src_i = 0;
-    size_t t = dst_i;
-    for (int dim_i = 0; dim_i < rank; ++dim_i) {
-      size_t ratio = t / dst_strides[dim_i];
-      t -= ratio * dst_strides[dim_i];
-      src_i += ratio * src_strides[perm[dim_i]];
+  if (dst_buffer.empty()) return OkStatus();
+  auto dims = impl::SimplifyTranspose(src_shape, perm);
+
+  // Identity permutations (after dropping unit dimensions) are a plain copy.
+  if (dims.empty() || (dims.size() == 1 && dims[0].src_stride == 1)) {
+    std::memcpy(dst_buffer.data(), src_buffer.data(),
+                dst_buffer.size() * sizeof(T));
+    return OkStatus();
+  }
+
+  // If the innermost dimension is unmoved each row is a contiguous copy.
+  const auto& inner_dim = dims.back();
+  if (inner_dim.src_stride == 1) {
+    size_t row_length = inner_dim.size;
+    impl::ForEachTransposeIndex(
+        absl::MakeConstSpan(dims).first(dims.size() - 1),
+        [&](size_t src_offset, size_t dst_offset) {
+          std::memcpy(dst_buffer.data() + dst_offset,
+                      src_buffer.data() + src_offset, row_length * sizeof(T));
+        });
+    return OkStatus();
+  }
+
+  // Otherwise the source innermost dimension moved to |src_inner_index| and
+  // each pair of it and the destination innermost dimension is a 2D
+  // transpose. All remaining dimensions are iterated around it.
+  int src_inner_index = 0;
+  absl::InlinedVector<impl::TransposeDim, 8> outer_dims;
+  for (int i = 0; i + 1 < dims.size(); ++i) {
+    if (dims[i].src_stride == 1) {
+      src_inner_index = i;
+    } else {
+      outer_dims.push_back(dims[i]);
     }
-    dst_buffer[dst_i] = src_buffer[src_i];
   }
+  const auto& src_inner_dim = dims[src_inner_index];
+  impl::ForEachTransposeIndex(
+      absl::MakeConstSpan(outer_dims),
+      [&](size_t src_offset, size_t dst_offset) {
+        impl::TransposeMatrix<T>(
+            src_buffer.data() + src_offset, inner_dim.src_stride,
+            dst_buffer.data() + dst_offset, src_inner_dim.dst_stride,
+            inner_dim.size, src_inner_dim.size);
+      });
   return OkStatus();
 }
 
 namespace impl {
-inline void IncrementShapeIndex(absl::Span<int32_t> indices,
-                                const Shape& shape) {
-  for (int i = indices.size() - 1; i >= 0; --i) {
-    if (++indices[i] < shape[i]) return;
-    indices[i] = 0;
-  }
-}
-
-inline bool IsPadding(absl::Span<const int32_t> indices, const Shape& shape,
-                      absl::Span<const int32_t> edge_padding_low,
-                      absl::Span<const int32_t> edge_padding_high,
-                      absl::Span<const int32_t> interior_padding) {
-  for (int i = 0; i < indices.size(); ++i) {
-    auto index = indices[i];
-    if (index < edge_padding_low[i] ||
-        index >= shape[i] - edge_padding_high[i] ||
-        (index - edge_padding_low[i]) % (interior_padding[i] + 1) != 0) {
-      return true;
+
+// A dimension of the source region copied by Pad. Offsets and strides are in
+// elements; |dst_stride| includes any interior padding.
+struct PadDim {
+  size_t src_offset;
+  size_t dst_offset;
+  size_t count;
+  size_t src_stride;
+  size_t dst_stride;
+};
+
+// Copies the source elements that land within the destination, recursing
+// over |dims| from outermost to innermost.
+template <typename T>
+void CopyPaddedRegion(const T* src, T* dst, absl::Span<const PadDim> dims) {
+  const auto& dim = dims.front();
+  src += dim.src_offset;
+  dst += dim.dst_offset;
+  if (dims.size() > 1) {
+    for (size_t i = 0; i < dim.count; ++i) {
+      CopyPaddedRegion(src + i * dim.src_stride, dst + i * dim.dst_stride,
+                       dims.subspan(1));
+    }
+  } else if (dim.dst_stride == 1) {
+    std::memcpy(dst, src, dim.count * sizeof(T));
+  } else {
+    for (size_t i = 0; i < dim.count; ++i) {
+      dst[i * dim.dst_stride] = src[i];
     }
   }
-
-  return false;
 }
+
 }  // namespace impl
 
 template <typename T>
@@ -217,65 +367,142 @@ Status Pad::Execute(absl::Span<const T> src_buffer,
                     absl::Span<const int32_t> edge_padding_low,
                     absl::Span<const int32_t> edge_padding_high,
                     absl::Span<const int32_t> interior_padding) {
-  // This implementation is not at all fast, as it iterates every index in the
-  // destination buffer individually. Potential improvements:
-  // 1. Fill the dst buffer with padded value initially. Only need to iterate
-  //    through source buffer and can exit early.
-  // 2. Use striding to advance through larger swaths of the buffer with a
-  //    memcpy from src and filling (or skipping) padded incides. Especially
-  //    useful when e.g. entire rows are padded.
-
-  // TODO(b/140836672) support negative padding
-
   if (padding_value_buffer.size() != 1) {
     return InvalidArgumentErrorBuilder(ABSL_LOC)
            << "Padding value buffer is larger than one element.";
   }
-  auto padding_value = padding_value_buffer.front();
+  if (dst_buffer.empty()) return OkStatus();
 
-  absl::InlinedVector<int, 8> dst_indices(src_shape.size(), 0);
+  // Compute the range of each source dimension that lands within the
+  // destination. Negative edge padding crops the source.
+  int rank = src_shape.size();
+  absl::InlinedVector<impl::PadDim, 8> dims(rank);
+  bool fully_covered = true;
+  bool any_copied = true;
+  size_t src_stride = 1;
+  size_t dst_stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    int64_t low = edge_padding_low[i];
+    int64_t step = interior_padding[i] + 1;
+    int64_t src_begin = low < 0 ? (-low + step - 1) / step : 0;
+    int64_t src_end =
+        std::min<int64_t>(src_shape[i], (dst_shape[i] - low + step - 1) / step);
+    auto& dim = dims[i];
+    dim.count = src_end > src_begin ? src_end - src_begin : 0;
+    dim.src_offset = src_begin * src_stride;
+    dim.dst_offset = (low + src_begin * step) * dst_stride;
+    dim.src_stride = src_stride;
+    dim.dst_stride = step * dst_stride;
+    any_copied = any_copied && dim.count > 0;
+    fully_covered = fully_covered && low <= 0 && edge_padding_high[i] <= 0 &&
+                    interior_padding[i] == 0;
+    src_stride *= src_shape[i];
+    dst_stride *= dst_shape[i];
+  }
 
-  const T* src_ptr = src_buffer.begin();
-  T* dst_ptr = dst_buffer.begin();
-  while (dst_ptr != dst_buffer.end()) {
-    if (impl::IsPadding(dst_indices, dst_shape, edge_padding_low,
-                        edge_padding_high, interior_padding)) {
-      *dst_ptr++ = padding_value;
-    } else {
-      DCHECK(src_ptr != src_buffer.end());
-      *dst_ptr++ = *src_ptr++;
+  // Fill first so that the source rows can be copied over with memcpy.
+  if (!fully_covered || !any_copied) {
+    std::fill(dst_buffer.begin(), dst_buffer.end(),
+              padding_value_buffer.front());
+  }
+  if (!any_copied) return OkStatus();
+  if (dims.empty()) {
+    dst_buffer[0] = src_buffer[0];
+    return OkStatus();
+  }
+
+  // Merge inner dimensions that are copied in their entirety into the rows of
+  // their parent so that each memcpy is as large as possible.
+  while (dims.size() > 1) {
+    const auto& inner = dims.back();
+    auto& outer = dims[dims.size() - 2];
+    if (inner.src_offset != 0 || inner.dst_offset != 0 ||
+        inner.src_stride != 1 || inner.dst_stride != 1 ||
+        outer.src_stride != inner.count || outer.dst_stride != inner.count) {
+      break;
     }
-    impl::IncrementShapeIndex(absl::MakeSpan(dst_indices), dst_shape);
+    outer.count *= inner.count;
+    outer.src_stride = 1;
+    outer.dst_stride = 1;
+    dims.pop_back();
   }
 
+  impl::CopyPaddedRegion(src_buffer.data(), dst_buffer.data(),
+                         absl::MakeConstSpan(dims));
   return OkStatus();
 }
 
+namespace impl {
+
+// A dimension of a Reverse after merging neighbors with the same flag.
+struct ReverseDim {
+  size_t size;
+  size_t stride;
+  bool reverse;
+};
+
+// Copies the region of |dims| reversing along flagged dimensions, recursing
+// from outermost to innermost.
+template <typename T>
+void ReverseRegion(const T* src, T* dst, absl::Span<const ReverseDim> dims) {
+  const auto& dim = dims.front();
+  if (dims.size() == 1) {
+    if (dim.reverse) {
+      std::reverse_copy(src, src + dim.size, dst);
+    } else {
+      std::memcpy(dst, src, dim.size * sizeof(T));
+    }
+    return;
+  }
+  for (size_t i = 0; i < dim.size; ++i) {
+    size_t src_i = dim.reverse ? dim.size - 1 - i : i;
+    ReverseRegion(src + src_i * dim.stride, dst + i * dim.stride,
+                  dims.subspan(1));
+  }
+}
+
+}  // namespace impl
+
 template <typename T>
 Status Reverse::Execute(absl::Span<const T> src_buffer,
                         absl::Span<T> dst_buffer, const Shape& src_shape,
                         absl::Span<const int32_t> dimensions) {
-  // This implementation is not fast either
   int rank = src_shape.size();
-  absl::InlinedVector<int, 8> strides(rank);
-  size_t stride = 1;
-  for (int dim_i = rank - 1; dim_i >= 0; --dim_i) {
-    strides[dim_i] = stride;
-    stride *= src_shape[dim_i];
-  }
-  absl::flat_hash_set<int32_t> dims_set(dimensions.begin(), dimensions.end());
-  for (size_t dst_i = 0; dst_i < dst_buffer.size(); ++dst_i) {
-    size_t src_i = 0;
-    size_t t = dst_i;
-    for (int dim_i = 0; dim_i < rank; ++dim_i) {
-      size_t ratio = t / strides[dim_i];
-      t -= ratio * strides[dim_i];
-      bool do_reverse = dims_set.contains(dim_i);
-      src_i += (do_reverse ? (src_shape[dim_i] - 1 - ratio) : ratio) *
-               strides[dim_i];
+  absl::InlinedVector<bool, 8> reverse_dims(rank, false);
+  for (int32_t dimension : dimensions) {
+    if (dimension < 0 || dimension >= rank) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Reverse dimension " << dimension << " out of range for rank "
+             << rank;
+    }
+    reverse_dims[dimension] = true;
+  }
+  if (dst_buffer.empty()) return OkStatus();
+
+  // Drop unit dimensions and merge neighbors that are both reversed or both
+  // not reversed; reversing a merged dimension reverses each of its parts.
+  absl::InlinedVector<impl::ReverseDim, 8> dims;
+  for (int i = 0; i < rank; ++i) {
+    size_t size = src_shape[i];
+    if (size == 1) continue;
+    if (!dims.empty() && dims.back().reverse == reverse_dims[i]) {
+      dims.back().size *= size;
+    } else {
+      dims.push_back({size, 0, reverse_dims[i]});
     }
-    dst_buffer[dst_i] = src_buffer[src_i];
   }
+  if (dims.empty()) {
+    dst_buffer[0] = src_buffer[0];
+    return OkStatus();
+  }
+  size_t stride = 1;
+  for (int i = dims.size() - 1; i >= 0; --i) {
+    dims[i].stride = stride;
+    stride *= dims[i].size;
+  }
+
+  impl::ReverseRegion(src_buffer.data(), dst_buffer.data(),
+                      absl::MakeConstSpan(dims));
   return OkStatus();
 }
 
@@ -288,30 +515,80 @@ Status Broadcast::Execute(absl::Span<const T> src_buffer,
   return OkStatus();
 }
 
+namespace impl {
+
+// A dimension of a Tile with strides in elements.
+struct TileDim {
+  size_t src_size;
+  size_t dst_size;
+  size_t src_stride;
+  size_t dst_stride;
+};
+
+// Fills the destination region of |dims| by copying each source row once and
+// then repeatedly doubling the filled portion of the destination.
+template <typename T>
+void TileRegion(const T* src, T* dst, absl::Span<const TileDim> dims) {
+  const auto& dim = dims.front();
+  size_t src_count = std::min(dim.src_size, dim.dst_size);
+  if (dims.size() == 1) {
+    std::memcpy(dst, src, src_count * sizeof(T));
+  } else {
+    for (size_t i = 0; i < src_count; ++i) {
+      TileRegion(src + i * dim.src_stride, dst + i * dim.dst_stride,
+                 dims.subspan(1));
+    }
+  }
+
+  // The filled portion is always a whole number of source periods so copying
+  // it forward preserves the tiling.
+  size_t filled = src_count * dim.dst_stride;
+  size_t total = dim.dst_size * dim.dst_stride;
+  while (filled < total) {
+    size_t count = std::min(filled, total - filled);
+    std::memcpy(dst + filled, dst, count * sizeof(T));
+    filled += count;
+  }
+}
+
+}  // namespace impl
+
 template <typename T>
 Status Tile::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer,
                      const Shape& src_shape, const Shape& dst_shape) {
-  // This implementation is .... not fast.
+  if (dst_buffer.empty()) return OkStatus();
   int rank = dst_shape.size();
-  absl::InlinedVector<int, 8> src_strides(rank);
-  absl::InlinedVector<int, 8> dst_strides(rank);
+  absl::InlinedVector<impl::TileDim, 8> dims;
+  for (int i = 0; i < rank; ++i) {
+    dims.push_back({static_cast<size_t>(src_shape[i]),
+                    static_cast<size_t>(dst_shape[i]), 0, 0});
+  }
+
+  // Merge untiled trailing dimensions into their parent; tiling the merged
+  // dimension by the parent's tile count is equivalent and yields longer rows.
+  while (dims.size() > 1) {
+    const auto& inner = dims.back();
+    auto& outer = dims[dims.size() - 2];
+    if (inner.src_size != inner.dst_size) break;
+    outer.src_size *= inner.src_size;
+    outer.dst_size *= inner.dst_size;
+    dims.pop_back();
+  }
+  if (dims.empty()) {
+    dst_buffer[0] = src_buffer[0];
+    return OkStatus();
+  }
   size_t src_stride = 1;
   size_t dst_stride = 1;
-  for (int dim_i = rank - 1; dim_i >= 0; --dim_i) {
-    src_strides[dim_i] = src_stride;
-    dst_strides[dim_i] = dst_stride;
-    src_stride *= src_shape[dim_i];
-    dst_stride *= dst_shape[dim_i];
-  }
-  for (size_t dst_i = 0; dst_i < dst_buffer.size(); ++dst_i) {
-    size_t src_i = 0;
-    size_t t = dst_i;
-    for (int dim_i = 0; dim_i < rank; ++dim_i) {
-      src_i += t / dst_strides[dim_i] % src_shape[dim_i] * src_strides[dim_i];
-      t %= dst_strides[dim_i];
-    }
-    dst_buffer[dst_i] = src_buffer[src_i];
+  for (int i = dims.size() - 1; i >= 0; --i) {
+    dims[i].src_stride = src_stride;
+    dims[i].dst_stride = dst_stride;
+    src_stride *= dims[i].src_size;
+    dst_stride *= dims[i].dst_size;
   }
+
+  impl::TileRegion(src_buffer.data(), dst_buffer.data(),
+                   absl::MakeConstSpan(dims));
   return OkStatus();
 }
 
@@ -424,6 +701,27 @@ Status MulAdd::Execute(absl::Span<const T> a_buffer,
   return OkStatus();
 }
 
+template <typename T>
+Status AddMax::Execute(absl::Span<const T> a_buffer,
+                       absl::Span<const T> b_buffer,
+                       absl::Span<const T> c_buffer, absl::Span<T> dst_buffer) {
+  // The sum goes through a temporary as dst may alias c.
+  T sum[impl::kFusedChunkElementCount];
+  for (size_t offset = 0; offset < dst_buffer.size();
+       offset += impl::kFusedChunkElementCount) {
+    size_t length =
+        std::min(impl::kFusedChunkElementCount, dst_buffer.size() - offset);
+    auto sum_chunk = absl::MakeSpan(sum, length);
+    RETURN_IF_ERROR(Add::Execute<T>(a_buffer.subspan(offset, length),
+                                    b_buffer.subspan(offset, length),
+                                    sum_chunk));
+    RETURN_IF_ERROR(Max::Execute<T>(sum_chunk,
+                                    c_buffer.subspan(offset, length),
+                                    dst_buffer.subspan(offset, length)));
+  }
+  return OkStatus();
+}
+
 template <typename T>
 Status Exp::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer) {
   for (size_t i = 0; i < dst_buffer.size(); ++i) {
@@ -483,6 +781,49 @@ Status Atan2::Execute(absl::Span<const T> lhs_buffer,
   return OkStatus();
 }
 
+template <typename T>
+Status FastExp::Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer) {
+  return Exp::Execute<T>(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status FastLog::Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer) {
+  return Log::Execute<T>(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status FastRsqrt::Execute(absl::Span<const T> src_buffer,
+                          absl::Span<T> dst_buffer) {
+  return Rsqrt::Execute<T>(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status FastCos::Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer) {
+  return Cos::Execute<T>(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status FastSin::Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer) {
+  return Sin::Execute<T>(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status FastTanh::Execute(absl::Span<const T> src_buffer,
+                         absl::Span<T> dst_buffer) {
+  return Tanh::Execute<T>(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status FastAtan2::Execute(absl::Span<const T> lhs_buffer,
+                          absl::Span<const T> rhs_buffer,
+                          absl::Span<T> dst_buffer) {
+  return Atan2::Execute<T>(lhs_buffer, rhs_buffer, dst_buffer);
+}
+
 template <typename T>
 Status Min::Execute(absl::Span<const T> lhs_buffer,
                     absl::Span<const T> rhs_buffer, absl::Span<T> dst_buffer) {
@@ -544,119 +885,246 @@ Status Convert::Execute(absl::Span<const SRC> src_buffer,
 
 namespace impl {
 
+// Number of elements summed directly by PairwiseSum before it stops splitting.
+// Rounding error grows linearly within a block and logarithmically across
+// blocks.
+constexpr size_t kPairwiseSumBlockSize = 256;
+
+// Returns the sum of the |count| values at |src| by recursively summing each
+// half. The blocks at the leaves are summed with independent accumulators so
+// the loop can be vectorized.
+template <typename T>
+T PairwiseSum(const T* src, size_t count) {
+  if (count > kPairwiseSumBlockSize) {
+    size_t half = (count / 2 + kPairwiseSumBlockSize - 1) /
+                  kPairwiseSumBlockSize * kPairwiseSumBlockSize;
+    return PairwiseSum(src, half) + PairwiseSum(src + half, count - half);
+  }
+  T sums[4] = {T(0), T(0), T(0), T(0)};
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sums[0] += src[i + 0];
+    sums[1] += src[i + 1];
+    sums[2] += src[i + 2];
+    sums[3] += src[i + 3];
+  }
+  for (; i < count; ++i) {
+    sums[0] += src[i];
+  }
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// Adds |value| to |*sum| while carrying the low-order bits lost to rounding in
+// |*compensation| (Kahan summation). The true sum is |*sum| - |*compensation|.
+template <typename T>
+inline void KahanAdd(T* sum, T* compensation, T value) {
+  T y = value - *compensation;
+  T t = *sum + y;
+  *compensation = (t - *sum) - y;
+  *sum = t;
+}
+
+// Combines each of the |row_count| contiguous rows of |row_length| values at
+// |src| into |dst| with the ELEMENTWISE kernel (such as Add for sums).
+//
+// The rows are walked in column tiles so that the tile of |dst| being updated
+// stays in cache while all of the rows are streamed through it. Short rows
+// are combined with |combine| directly as they are not worth a kernel call.
+template <typename T, typename ELEMENTWISE, typename CombineFn>
+void ReduceRows(const T* src, size_t row_count, size_t row_length, T* dst,
+                CombineFn combine) {
+  constexpr size_t kMinKernelLength = 16;
+  if (row_length < kMinKernelLength) {
+    for (size_t row = 0; row < row_count; ++row) {
+      const T* src_row = src + row * row_length;
+      for (size_t i = 0; i < row_length; ++i) {
+        dst[i] = combine(dst[i], src_row[i]);
+      }
+    }
+    return;
+  }
+  constexpr size_t kTileSize = 8192 / sizeof(T);
+  for (size_t tile_offset = 0; tile_offset < row_length;
+       tile_offset += kTileSize) {
+    size_t tile_length = std::min(kTileSize, row_length - tile_offset);
+    auto dst_tile = absl::MakeSpan(dst + tile_offset, tile_length);
+    for (size_t row = 0; row < row_count; ++row) {
+      auto src_tile = absl::MakeConstSpan(
+          src + row * row_length + tile_offset, tile_length);
+      ELEMENTWISE::Execute(absl::Span<const T>(dst_tile), src_tile, dst_tile)
+          .IgnoreError();
+    }
+  }
+}
+
+// Reduction kernels used by GenericReduce. Each provides:
+//   Reduce: combines |count| contiguous values with |init| and returns the
+//       result.
+//   ReduceRows: combines each of |row_count| contiguous rows into the
+//       |row_length| values at |dst|, which are already initialized.
+// Reduce is specialized with vectorized loops for the 32-bit types in
+// bytecode_kernels_simd.h.
+
+// Sums using pairwise summation within a row and sequential accumulation
+// across rows.
 struct SumKernel {
   template <typename T>
-  inline void operator()(T* value0, const T value1) {
-    *value0 += value1;
+  static T Reduce(const T* src, size_t count, T init) {
+    return init + PairwiseSum(src, count);
+  }
+  template <typename T>
+  static void ReduceRows(const T* src, size_t row_count, size_t row_length,
+                         T* dst) {
+    impl::ReduceRows<T, Add>(src, row_count, row_length, dst,
+                            [](T a, T b) -> T { return a + b; });
   }
 };
 
-struct MinKernel {
+// Sums each value in order starting from |init|, matching a sequential loop
+// exactly. Not specialized in bytecode_kernels_simd.h as vectorizing would
+// reorder the additions.
+struct OrderedSumKernel {
   template <typename T>
-  inline void operator()(T* value0, const T value1) {
-    *value0 = std::min(*value0, value1);
+  static T Reduce(const T* src, size_t count, T init) {
+    T sum = init;
+    for (size_t i = 0; i < count; ++i) {
+      sum += src[i];
+    }
+    return sum;
+  }
+  template <typename T>
+  static void ReduceRows(const T* src, size_t row_count, size_t row_length,
+                         T* dst) {
+    impl::ReduceRows<T, Add>(src, row_count, row_length, dst,
+                            [](T a, T b) -> T { return a + b; });
   }
 };
 
-struct MaxKernel {
+// Sums using Kahan summation both within and across rows.
+struct KahanSumKernel {
   template <typename T>
-  inline void operator()(T* value0, const T value1) {
-    *value0 = std::max(*value0, value1);
+  static T Reduce(const T* src, size_t count, T init) {
+    T sum = init;
+    T compensation = T(0);
+    for (size_t i = 0; i < count; ++i) {
+      KahanAdd(&sum, &compensation, src[i]);
+    }
+    return sum;
+  }
+  template <typename T>
+  static void ReduceRows(const T* src, size_t row_count, size_t row_length,
+                         T* dst) {
+    constexpr size_t kTileSize = 4096 / sizeof(T);
+    T compensation[kTileSize];
+    for (size_t tile_offset = 0; tile_offset < row_length;
+         tile_offset += kTileSize) {
+      size_t tile_length = std::min(kTileSize, row_length - tile_offset);
+      T* dst_tile = dst + tile_offset;
+      std::fill_n(compensation, tile_length, T(0));
+      for (size_t row = 0; row < row_count; ++row) {
+        const T* src_tile = src + row * row_length + tile_offset;
+        for (size_t i = 0; i < tile_length; ++i) {
+          KahanAdd(&dst_tile[i], &compensation[i], src_tile[i]);
+        }
+      }
+    }
   }
 };
 
-template <typename T, typename KernelImpl>
-inline void ReduceDimension(absl::Span<const T> src_buffer,
-                            absl::Span<T> dst_buffer, const Shape& src_shape,
-                            absl::Span<const int32_t> reduce_dims,
-                            absl::Span<const int> dst_strides, int dim,
-                            absl::Span<int> src_indices, size_t flat_src_i,
-                            size_t src_stride) {
-  if (dim < 0) {
-    // Base case of the recursion - figure out which elements should be acted
-    // upon and apply the reduction kernel to them.
-
-    // Derive destination indices from source indices.
-    // For example,
-    //     reduce_dims: [1, 2]
-    //     src_indices: [2, 1, 3, 0]
-    //                      ^  ^
-    //                      |  |
-    //                      |----- remove these dimensions
-    //     dst_indices: [2, 0]
-    //
-    // TODO(scotttodd): Clean this up somehow, share across recursion levels?
-    size_t dst_size = src_shape.size() - reduce_dims.size();
-    absl::InlinedVector<int, 8> dst_indices;
-    for (size_t i = 0; i < src_indices.size(); ++i) {
-      if (std::find(std::begin(reduce_dims), std::end(reduce_dims), i) ==
-          std::end(reduce_dims)) {
-        dst_indices.push_back(src_indices[i]);
-      }
+struct MinKernel {
+  template <typename T>
+  static T Reduce(const T* src, size_t count, T init) {
+    T mins[4] = {init, init, init, init};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      mins[0] = std::min(mins[0], src[i + 0]);
+      mins[1] = std::min(mins[1], src[i + 1]);
+      mins[2] = std::min(mins[2], src[i + 2]);
+      mins[3] = std::min(mins[3], src[i + 3]);
     }
-    // Compute the flattened index into dst_buffer at [dst_indices].
-    size_t dst_i = 0;
-    for (size_t i = 0; i < dst_indices.size(); ++i) {
-      dst_i += dst_indices[i] * dst_strides[dst_size - 1 - i];
+    for (; i < count; ++i) {
+      mins[0] = std::min(mins[0], src[i]);
     }
-
-    // Flattened src and dst indices have been computed, invoke the kernel.
-    KernelImpl()(&dst_buffer[dst_i], src_buffer[flat_src_i]);
-    return;
+    return std::min(std::min(mins[0], mins[1]), std::min(mins[2], mins[3]));
   }
+  template <typename T>
+  static void ReduceRows(const T* src, size_t row_count, size_t row_length,
+                         T* dst) {
+    impl::ReduceRows<T, Min>(src, row_count, row_length, dst,
+                            [](T a, T b) { return std::min(a, b); });
+  }
+};
 
-  // Iterate through the current dimension in the source shape, recursing
-  // down one dimension at a time.
-  //
-  // This touches each element in the source buffer once, tracking complete
-  // dimensions within the shaped source buffer and using them to compute
-  // the corresponding indices (shaped and flattened) within the destination
-  // buffer. Each element in the destination buffer will be touched multiple
-  // times.
-  //
-  // Note that cache coherency isn't considered here, and some computations
-  // are redundant, so this could be optimized substantially.
-  for (size_t dim_i = 0; dim_i < src_shape[dim]; ++dim_i) {
-    src_indices[dim] = dim_i;
-
-    // Recurse down to the next dimension (e.g. 2 -> 1 -> 0 -> base case)
-    //   * Add the current stride to flat_src_i
-    //   * Multiply src_stride by this dimension's shape
-    ReduceDimension<T, KernelImpl>(src_buffer, dst_buffer, src_shape,
-                                   reduce_dims, dst_strides, dim - 1,
-                                   src_indices, flat_src_i + dim_i * src_stride,
-                                   src_stride * src_shape[dim]);
+struct MaxKernel {
+  template <typename T>
+  static T Reduce(const T* src, size_t count, T init) {
+    T maxs[4] = {init, init, init, init};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      maxs[0] = std::max(maxs[0], src[i + 0]);
+      maxs[1] = std::max(maxs[1], src[i + 1]);
+      maxs[2] = std::max(maxs[2], src[i + 2]);
+      maxs[3] = std::max(maxs[3], src[i + 3]);
+    }
+    for (; i < count; ++i) {
+      maxs[0] = std::max(maxs[0], src[i]);
+    }
+    return std::max(std::max(maxs[0], maxs[1]), std::max(maxs[2], maxs[3]));
   }
-}
+  template <typename T>
+  static void ReduceRows(const T* src, size_t row_count, size_t row_length,
+                         T* dst) {
+    impl::ReduceRows<T, Max>(src, row_count, row_length, dst,
+                            [](T a, T b) { return std::max(a, b); });
+  }
+};
 
+// Reduces |dimension| of |src_shape| by viewing the source as
+// [outer, reduce, inner] where outer and inner are the products of the
+// dimensions before and after |dimension|:
+//   inner == 1: each destination element is a contiguous run of the source
+//       and is reduced in a single pass (vectorized across the run).
+//   otherwise: each source row of |inner| values is combined into the
+//       matching destination row with elementwise ops. This covers both
+//       reductions over the outermost dimension (outer == 1) and over middle
+//       dimensions, tiled so that destination rows stay in cache.
 template <typename T, typename KernelImpl>
 Status GenericReduce(absl::Span<const T> src_buffer,
                      absl::Span<const T> init_buffer, absl::Span<T> dst_buffer,
                      int32_t dimension, const Shape& src_shape,
                      const Shape& dst_shape) {
-  // Initialize using init_buffer, which is expected to be a scalar.
-  std::fill_n(dst_buffer.data(), dst_buffer.size(), init_buffer[0]);
-
-  // Precompute destination strides.
-  int dst_rank = dst_shape.size();
-  absl::InlinedVector<int, 8> dst_strides;
-  size_t dst_stride = 1;
-  for (int dim_i = dst_rank - 1; dim_i >= 0; --dim_i) {
-    dst_strides.push_back(dst_stride);
-    dst_stride *= dst_shape[dim_i];
+  if (dimension < 0 || dimension >= src_shape.size()) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Reduction dimension " << dimension << " out of range for rank "
+           << src_shape.size();
+  }
+  size_t outer_size = 1;
+  for (int i = 0; i < dimension; ++i) {
+    outer_size *= src_shape[i];
+  }
+  size_t reduce_size = src_shape[dimension];
+  size_t inner_size = 1;
+  for (int i = dimension + 1; i < src_shape.size(); ++i) {
+    inner_size *= src_shape[i];
   }
+  DCHECK_EQ(dst_buffer.size(), outer_size * inner_size);
 
-  // Call the helper (recursive) function, starting with:
-  //   * source index [0, 0, ..., 0]
-  //   * the innermost dimension (last in the shape)
-  //   * flat_src_i of 0 (corresponds to [0, 0, ..., 0] above)
-  //   * source stride 1
-  absl::InlinedVector<int, 8> src_indices(src_shape.size(), 0);
-  ReduceDimension<T, KernelImpl>(src_buffer, dst_buffer, src_shape, {dimension},
-                                 absl::MakeSpan(dst_strides),
-                                 src_shape.size() - 1,
-                                 absl::MakeSpan(src_indices), 0, 1);
+  // Initialize using init_buffer, which is expected to be a scalar.
+  const T init = init_buffer[0];
+  if (inner_size == 1) {
+    for (size_t i = 0; i < outer_size; ++i) {
+      dst_buffer[i] = KernelImpl::Reduce(src_buffer.data() + i * reduce_size,
+                                         reduce_size, init);
+    }
+    return OkStatus();
+  }
 
+  std::fill_n(dst_buffer.data(), dst_buffer.size(), init);
+  for (size_t i = 0; i < outer_size; ++i) {
+    KernelImpl::ReduceRows(src_buffer.data() + i * reduce_size * inner_size,
+                           reduce_size, inner_size,
+                           dst_buffer.data() + i * inner_size);
+  }
   return OkStatus();
 }
 
@@ -671,6 +1139,25 @@ Status ReduceSum::Execute(absl::Span<const T> src_buffer,
       src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
 }
 
+template <typename T>
+Status ReduceSumOrdered::Execute(absl::Span<const T> src_buffer,
+                                 absl::Span<const T> init_buffer,
+                                 absl::Span<T> dst_buffer, int32_t dimension,
+                                 const Shape& src_shape,
+                                 const Shape& dst_shape) {
+  return impl::GenericReduce<T, impl::OrderedSumKernel>(
+      src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
+}
+
+template <typename T>
+Status ReduceSumKahan::Execute(absl::Span<const T> src_buffer,
+                               absl::Span<const T> init_buffer,
+                               absl::Span<T> dst_buffer, int32_t dimension,
+                               const Shape& src_shape, const Shape& dst_shape) {
+  return impl::GenericReduce<T, impl::KahanSumKernel>(
+      src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
+}
+
 template <typename T>
 Status ReduceMin::Execute(absl::Span<const T> src_buffer,
                           absl::Span<const T> init_buffer,
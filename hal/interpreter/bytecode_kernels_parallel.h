@@ -0,0 +1,305 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_PARALLEL_H_
+#define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_PARALLEL_H_
+
+#include <algorithm>
+#include <cstddef>
+
+#include "third_party/absl/container/inlined_vector.h"
+#include "third_party/absl/types/span.h"
+#include "third_party/mlir_edge/iree/base/shape.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
+
+namespace iree {
+namespace hal {
+namespace kernels {
+
+namespace impl {
+
+// Minimum number of elements each worker should process. Below this the cost
+// of waking workers dominates the kernel itself.
+constexpr size_t kMinParallelElementCount = 16 * 1024;
+
+// Invokes |fn| with (offset, length) element ranges covering |element_count|
+// elements laid out as |shape|. Ranges always start and end on a row of the
+// outermost dimension. Runs inline when there is no worker pool or when the
+// work is too small to be worth splitting.
+template <typename FN>
+Status ParallelForRows(RuntimeState* runtime_state, const Shape& shape,
+                       size_t element_count, FN fn) {
+  size_t row_count = shape.empty() ? 1 : std::max(0, shape[0]);
+  if (!runtime_state || !runtime_state->worker_pool || row_count <= 1 ||
+      element_count % row_count != 0 ||
+      element_count < 2 * kMinParallelElementCount) {
+    return fn(0, element_count);
+  }
+  size_t row_length = element_count / row_count;
+  size_t min_row_count =
+      (kMinParallelElementCount + row_length - 1) / row_length;
+  return runtime_state->worker_pool->ParallelFor(
+      row_count, min_row_count, [&](size_t begin, size_t end) {
+        return fn(begin * row_length, (end - begin) * row_length);
+      });
+}
+
+// A dimension of the iteration space of a broadcasting elementwise op. Strides
+// are in elements and are 0 along dimensions an operand is broadcast over.
+struct BroadcastDim {
+  size_t size;
+  size_t lhs_stride;
+  size_t rhs_stride;
+};
+
+using BroadcastDims = absl::InlinedVector<BroadcastDim, 6>;
+
+// Computes the strided iteration space of |dst_shape| for operands of
+// |lhs_shape| and |rhs_shape|. Adjacent dimensions that both operands read
+// contiguously are merged so that the innermost dimension is as long as
+// possible; its strides are always either 1 or 0.
+inline StatusOr<BroadcastDims> GetBroadcastDims(const Shape& lhs_shape,
+                                                const Shape& rhs_shape,
+                                                const Shape& dst_shape) {
+  int rank = dst_shape.size();
+  int lhs_rank_offset = rank - lhs_shape.size();
+  int rhs_rank_offset = rank - rhs_shape.size();
+  if (lhs_rank_offset < 0 || rhs_rank_offset < 0) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Operand shapes " << lhs_shape << " and " << rhs_shape
+           << " have a higher rank than the result shape " << dst_shape;
+  }
+  BroadcastDims dims(rank);
+  size_t lhs_stride = 1;
+  size_t rhs_stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    int lhs_dim = i >= lhs_rank_offset ? lhs_shape[i - lhs_rank_offset] : 1;
+    int rhs_dim = i >= rhs_rank_offset ? rhs_shape[i - rhs_rank_offset] : 1;
+    if ((lhs_dim != dst_shape[i] && lhs_dim != 1) ||
+        (rhs_dim != dst_shape[i] && rhs_dim != 1)) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Operand shapes " << lhs_shape << " and " << rhs_shape
+             << " do not broadcast to the result shape " << dst_shape;
+    }
+    dims[i].size = dst_shape[i];
+    dims[i].lhs_stride = lhs_dim == 1 ? 0 : lhs_stride;
+    dims[i].rhs_stride = rhs_dim == 1 ? 0 : rhs_stride;
+    lhs_stride *= lhs_dim;
+    rhs_stride *= rhs_dim;
+  }
+
+  BroadcastDims merged_dims;
+  for (const auto& dim : dims) {
+    if (dim.size == 1) continue;
+    if (!merged_dims.empty()) {
+      auto& outer_dim = merged_dims.back();
+      if (outer_dim.lhs_stride == dim.size * dim.lhs_stride &&
+          outer_dim.rhs_stride == dim.size * dim.rhs_stride) {
+        outer_dim = {outer_dim.size * dim.size, dim.lhs_stride,
+                     dim.rhs_stride};
+        continue;
+      }
+    }
+    merged_dims.push_back(dim);
+  }
+  if (merged_dims.empty()) {
+    merged_dims.push_back({1, 0, 0});
+  }
+  return merged_dims;
+}
+
+// Runs the binary KERNEL over the destination elements [offset, offset +
+// length) of the iteration space |dims| one run of the innermost dimension at a
+// time. Broadcast runs are splatted into a small chunk on the stack so that
+// KERNEL only ever sees dense spans.
+template <typename KERNEL, typename T, typename DST>
+Status BroadcastElementwiseRange(const BroadcastDims& dims,
+                                 absl::Span<const T> lhs_buffer,
+                                 absl::Span<const T> rhs_buffer,
+                                 absl::Span<DST> dst_buffer, size_t offset,
+                                 size_t length) {
+  const auto& inner_dim = dims.back();
+  T lhs_splat[kFusedChunkElementCount];
+  T rhs_splat[kFusedChunkElementCount];
+  size_t end = offset + length;
+  while (offset < end) {
+    size_t index = offset;
+    size_t lhs_offset = 0;
+    size_t rhs_offset = 0;
+    for (int i = dims.size() - 1; i >= 0; --i) {
+      size_t coord = index % dims[i].size;
+      index /= dims[i].size;
+      lhs_offset += coord * dims[i].lhs_stride;
+      rhs_offset += coord * dims[i].rhs_stride;
+    }
+    size_t run_length =
+        std::min(inner_dim.size - offset % inner_dim.size, end - offset);
+    if (inner_dim.lhs_stride && inner_dim.rhs_stride) {
+      RETURN_IF_ERROR(
+          KERNEL::Execute(lhs_buffer.subspan(lhs_offset, run_length),
+                          rhs_buffer.subspan(rhs_offset, run_length),
+                          dst_buffer.subspan(offset, run_length)));
+      offset += run_length;
+      continue;
+    }
+    size_t splat_length = std::min(kFusedChunkElementCount, run_length);
+    if (!inner_dim.lhs_stride) {
+      std::fill_n(lhs_splat, splat_length, lhs_buffer[lhs_offset]);
+    }
+    if (!inner_dim.rhs_stride) {
+      std::fill_n(rhs_splat, splat_length, rhs_buffer[rhs_offset]);
+    }
+    for (size_t i = 0; i < run_length; i += kFusedChunkElementCount) {
+      size_t chunk_length = std::min(kFusedChunkElementCount, run_length - i);
+      auto lhs_chunk = inner_dim.lhs_stride
+                           ? lhs_buffer.subspan(lhs_offset + i, chunk_length)
+                           : absl::MakeConstSpan(lhs_splat, chunk_length);
+      auto rhs_chunk = inner_dim.rhs_stride
+                           ? rhs_buffer.subspan(rhs_offset + i, chunk_length)
+                           : absl::MakeConstSpan(rhs_splat, chunk_length);
+      RETURN_IF_ERROR(KERNEL::Execute(
+          lhs_chunk, rhs_chunk, dst_buffer.subspan(offset + i, chunk_length)));
+    }
+    offset += run_length;
+  }
+  return OkStatus();
+}
+
+}  // namespace impl
+
+template <typename KERNEL>
+template <typename T, typename DST>
+Status ParallelElementwise<KERNEL>::Execute(absl::Span<const T> src_buffer,
+                                            absl::Span<DST> dst_buffer,
+                                            RuntimeState* runtime_state,
+                                            const Shape& shape) {
+  return impl::ParallelForRows(
+      runtime_state, shape, dst_buffer.size(),
+      [&](size_t offset, size_t length) {
+        return KERNEL::Execute(src_buffer.subspan(offset, length),
+                               dst_buffer.subspan(offset, length));
+      });
+}
+
+template <typename KERNEL>
+template <typename T, typename DST>
+Status ParallelElementwise<KERNEL>::Execute(absl::Span<const T> lhs_buffer,
+                                            absl::Span<const T> rhs_buffer,
+                                            absl::Span<DST> dst_buffer,
+                                            RuntimeState* runtime_state,
+                                            const Shape& shape) {
+  return impl::ParallelForRows(
+      runtime_state, shape, dst_buffer.size(),
+      [&](size_t offset, size_t length) {
+        return KERNEL::Execute(lhs_buffer.subspan(offset, length),
+                               rhs_buffer.subspan(offset, length),
+                               dst_buffer.subspan(offset, length));
+      });
+}
+
+template <typename KERNEL>
+template <typename T, typename DST>
+Status ParallelElementwise<KERNEL>::Execute(absl::Span<const T> a_buffer,
+                                            absl::Span<const T> b_buffer,
+                                            absl::Span<const T> c_buffer,
+                                            absl::Span<DST> dst_buffer,
+                                            RuntimeState* runtime_state,
+                                            const Shape& shape) {
+  return impl::ParallelForRows(
+      runtime_state, shape, dst_buffer.size(),
+      [&](size_t offset, size_t length) {
+        return KERNEL::Execute(a_buffer.subspan(offset, length),
+                               b_buffer.subspan(offset, length),
+                               c_buffer.subspan(offset, length),
+                               dst_buffer.subspan(offset, length));
+      });
+}
+
+template <typename KERNEL>
+template <typename T, typename DST>
+Status ParallelElementwise<KERNEL>::Execute(absl::Span<const T> a_buffer,
+                                            absl::Span<const T> b_buffer,
+                                            absl::Span<const T> c_buffer,
+                                            absl::Span<const T> d_buffer,
+                                            absl::Span<DST> dst_buffer,
+                                            RuntimeState* runtime_state,
+                                            const Shape& shape) {
+  return impl::ParallelForRows(
+      runtime_state, shape, dst_buffer.size(),
+      [&](size_t offset, size_t length) {
+        return KERNEL::Execute(a_buffer.subspan(offset, length),
+                               b_buffer.subspan(offset, length),
+                               c_buffer.subspan(offset, length),
+                               d_buffer.subspan(offset, length),
+                               dst_buffer.subspan(offset, length));
+      });
+}
+
+template <typename KERNEL>
+template <typename T, typename DST>
+Status BroadcastElementwise<KERNEL>::Execute(
+    absl::Span<const T> lhs_buffer, absl::Span<const T> rhs_buffer,
+    absl::Span<DST> dst_buffer, RuntimeState* runtime_state,
+    const Shape& lhs_shape, const Shape& rhs_shape, const Shape& dst_shape) {
+  ASSIGN_OR_RETURN(auto dims,
+                   impl::GetBroadcastDims(lhs_shape, rhs_shape, dst_shape));
+  if (dst_buffer.empty()) {
+    return OkStatus();
+  }
+  return impl::ParallelForRows(
+      runtime_state, dst_shape, dst_buffer.size(),
+      [&](size_t offset, size_t length) {
+        return impl::BroadcastElementwiseRange<KERNEL>(
+            dims, lhs_buffer, rhs_buffer, dst_buffer, offset, length);
+      });
+}
+
+template <typename KERNEL>
+template <typename T>
+Status ParallelReduce<KERNEL>::Execute(
+    absl::Span<const T> src_buffer, absl::Span<const T> init_buffer,
+    absl::Span<T> dst_buffer, int32_t dimension, const Shape& src_shape,
+    const Shape& dst_shape, RuntimeState* runtime_state) {
+  if (dimension <= 0 || src_shape.size() < 2 || dst_shape.empty() ||
+      dst_shape[0] != src_shape[0] || src_shape.element_count() == 0) {
+    // Reducing over the outermost dimension; each destination element depends
+    // on every row so there is nothing independent to split.
+    return KERNEL::Execute(src_buffer, init_buffer, dst_buffer, dimension,
+                           src_shape, dst_shape);
+  }
+  size_t src_row_length = src_shape.element_count() / src_shape[0];
+  size_t dst_row_length = dst_shape.element_count() / dst_shape[0];
+  return impl::ParallelForRows(
+      runtime_state, src_shape, src_shape.element_count(),
+      [&](size_t src_offset, size_t src_length) {
+        size_t row_offset = src_offset / src_row_length;
+        size_t row_count = src_length / src_row_length;
+        Shape src_chunk_shape = src_shape;
+        src_chunk_shape[0] = row_count;
+        Shape dst_chunk_shape = dst_shape;
+        dst_chunk_shape[0] = row_count;
+        return KERNEL::Execute(
+            src_buffer.subspan(src_offset, src_length), init_buffer,
+            dst_buffer.subspan(row_offset * dst_row_length,
+                               row_count * dst_row_length),
+            dimension, src_chunk_shape, dst_chunk_shape);
+      });
+}
+
+}  // namespace kernels
+}  // namespace hal
+}  // namespace iree
+
+#endif  // THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_PARALLEL_H_
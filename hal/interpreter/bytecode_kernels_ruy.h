@@ -41,22 +41,36 @@ template <typename T, typename ACC>
 Status MatMul::Execute(RuntimeState* runtime_state,
                        const Buffers<T, ACC>& buffers) {
   ruy::Matrix<T> lhs_matrix;
-  ruy::MakeSimpleLayout(buffers.lhs_shape[0], buffers.lhs_shape[1],
-                        ruy::Order::kRowMajor, &lhs_matrix.layout);
-  lhs_matrix.data.set(buffers.lhs_buffer.data());
-
   ruy::Matrix<T> rhs_matrix;
-  ruy::MakeSimpleLayout(buffers.rhs_shape[0], buffers.rhs_shape[1],
-                        ruy::Order::kRowMajor, &rhs_matrix.layout);
-  rhs_matrix.data.set(buffers.rhs_buffer.data());
-
   ruy::Matrix<T> dst_matrix;
-  ruy::MakeSimpleLayout(buffers.dst_shape[0], buffers.dst_shape[1],
-                        ruy::Order::kRowMajor, &dst_matrix.layout);
+  if (buffers.column_channels) {
+    // ruy applies the bias and per-channel multipliers along the rows of its
+    // destination. Computing dst^T = rhs^T * lhs^T on column-major views of
+    // the row-major buffers applies them along the columns of dst instead.
+    ruy::MakeSimpleLayout(buffers.rhs_shape[1], buffers.rhs_shape[0],
+                          ruy::Order::kColMajor, &lhs_matrix.layout);
+    lhs_matrix.data.set(buffers.rhs_buffer.data());
+    ruy::MakeSimpleLayout(buffers.lhs_shape[1], buffers.lhs_shape[0],
+                          ruy::Order::kColMajor, &rhs_matrix.layout);
+    rhs_matrix.data.set(buffers.lhs_buffer.data());
+    ruy::MakeSimpleLayout(buffers.dst_shape[1], buffers.dst_shape[0],
+                          ruy::Order::kColMajor, &dst_matrix.layout);
+  } else {
+    ruy::MakeSimpleLayout(buffers.lhs_shape[0], buffers.lhs_shape[1],
+                          ruy::Order::kRowMajor, &lhs_matrix.layout);
+    lhs_matrix.data.set(buffers.lhs_buffer.data());
+    ruy::MakeSimpleLayout(buffers.rhs_shape[0], buffers.rhs_shape[1],
+                          ruy::Order::kRowMajor, &rhs_matrix.layout);
+    rhs_matrix.data.set(buffers.rhs_buffer.data());
+    ruy::MakeSimpleLayout(buffers.dst_shape[0], buffers.dst_shape[1],
+                          ruy::Order::kRowMajor, &dst_matrix.layout);
+  }
   dst_matrix.data.set(buffers.dst_buffer.data());
 
   ruy::BasicSpec<ACC, T> spec;
   spec.bias = buffers.bias_buffer.data();
+  spec.clamp_min = buffers.clamp_min;
+  spec.clamp_max = buffers.clamp_max;
 
   if (buffers.multiplier_mantissa_buffer.size() == 1) {
     spec.multiplier_fixedpoint = buffers.multiplier_mantissa_buffer[0];
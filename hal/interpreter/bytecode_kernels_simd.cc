@@ -0,0 +1,975 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "third_party/mlir_edge/iree/base/logging.h"
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels.h"
+
+// x86 variants are compiled with per-function target attributes so that the
+// rest of the binary can keep targeting the baseline ISA.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define IREE_SIMD_X86 1
+#include <immintrin.h>
+#endif  // x86 && (gcc || clang)
+
+// NEON is part of the aarch64 baseline and needs no runtime detection.
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define IREE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif  // __aarch64__ && __ARM_NEON
+
+namespace iree {
+namespace hal {
+namespace kernels {
+namespace simd {
+
+namespace {
+
+// libm entry points used for lanes outside of the range of an approximation.
+// Defined out of line so they can be called from any target.
+float ExactSin(float value) { return std::sin(value); }
+float ExactCos(float value) { return std::cos(value); }
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// Portable scalar fallback
+//===----------------------------------------------------------------------===//
+
+namespace generic {
+
+#define IREE_SIMD_TARGET
+#define IREE_SIMD_INLINE inline
+
+// Treats each scalar as a single-lane vector. Values are carried as raw bits
+// so that the shared loops can be written once for all 32-bit types.
+struct Vector {
+  using Reg = uint32_t;
+  using Mask = bool;
+  static constexpr size_t kWidth = 1;
+
+  static inline Reg Load(const void* ptr) {
+    Reg value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+  }
+  static inline void Store(void* ptr, Reg value) {
+    std::memcpy(ptr, &value, sizeof(value));
+  }
+
+  static inline float F(Reg value) {
+    float f;
+    std::memcpy(&f, &value, sizeof(f));
+    return f;
+  }
+  static inline Reg R(float value) {
+    Reg r;
+    std::memcpy(&r, &value, sizeof(r));
+    return r;
+  }
+  static inline int32_t S(Reg value) { return static_cast<int32_t>(value); }
+
+  static inline Reg AddF(Reg a, Reg b) { return R(F(a) + F(b)); }
+  static inline Reg SubF(Reg a, Reg b) { return R(F(a) - F(b)); }
+  static inline Reg MulF(Reg a, Reg b) { return R(F(a) * F(b)); }
+  static inline Reg DivF(Reg a, Reg b) { return R(F(a) / F(b)); }
+  static inline Reg MinF(Reg a, Reg b) { return R(std::min(F(a), F(b))); }
+  static inline Reg MaxF(Reg a, Reg b) { return R(std::max(F(a), F(b))); }
+  static inline Mask CmpEqF(Reg a, Reg b) { return F(a) == F(b); }
+  static inline Mask CmpNeF(Reg a, Reg b) { return F(a) != F(b); }
+  static inline Mask CmpLtF(Reg a, Reg b) { return F(a) < F(b); }
+  static inline Mask CmpLeF(Reg a, Reg b) { return F(a) <= F(b); }
+
+  static inline Reg AddI(Reg a, Reg b) { return a + b; }
+  static inline Reg SubI(Reg a, Reg b) { return a - b; }
+  static inline Reg MulI(Reg a, Reg b) { return a * b; }
+  static inline Reg MinS(Reg a, Reg b) { return std::min(S(a), S(b)); }
+  static inline Reg MaxS(Reg a, Reg b) { return std::max(S(a), S(b)); }
+  static inline Reg MinU(Reg a, Reg b) { return std::min(a, b); }
+  static inline Reg MaxU(Reg a, Reg b) { return std::max(a, b); }
+  static inline Reg And(Reg a, Reg b) { return a & b; }
+  static inline Reg Or(Reg a, Reg b) { return a | b; }
+  static inline Reg Xor(Reg a, Reg b) { return a ^ b; }
+  static inline Reg Shl(Reg a, Reg b) { return a << b; }
+  static inline Reg Sra(Reg a, Reg b) { return S(a) >> S(b); }
+  static inline Reg Srl(Reg a, Reg b) { return a >> b; }
+  static inline Mask CmpEqI(Reg a, Reg b) { return a == b; }
+  static inline Mask CmpLtS(Reg a, Reg b) { return S(a) < S(b); }
+  static inline Mask CmpLtU(Reg a, Reg b) { return a < b; }
+
+  static inline Reg SplatF(float value) { return R(value); }
+  static inline Reg SplatI(uint32_t value) { return value; }
+  static inline Reg SqrtF(Reg a) { return R(std::sqrt(F(a))); }
+  static inline Reg RoundF(Reg a) { return R(std::nearbyint(F(a))); }
+  // Out of range values produce INT32_MIN like cvttps2dq instead of being UB.
+  static inline Reg TruncFToI(Reg a) {
+    float value = F(a);
+    return value > -2147483648.0f && value < 2147483648.0f
+               ? static_cast<int32_t>(value)
+               : INT32_MIN;
+  }
+  static inline Reg CvtIToF(Reg a) { return R(static_cast<float>(S(a))); }
+  template <int kBits>
+  static inline Reg ShlImm(Reg a) {
+    return a << kBits;
+  }
+  template <int kBits>
+  static inline Reg SraImm(Reg a) {
+    return S(a) >> kBits;
+  }
+  template <int kBits>
+  static inline Reg SrlImm(Reg a) {
+    return a >> kBits;
+  }
+
+  static inline Mask MaskNot(Mask mask) { return !mask; }
+  static inline Mask MaskOr(Mask a, Mask b) { return a || b; }
+  static inline bool MaskAny(Mask mask) { return mask; }
+  static inline Reg Blend(Mask mask, Reg a, Reg b) { return mask ? a : b; }
+  static inline void StoreMaskBytes(Mask mask, uint8_t* dst) { *dst = mask; }
+  static inline Mask LoadMaskBytes(const uint8_t* src) { return *src != 0; }
+
+  // Transposes the kWidth x kWidth tile held in |rows| in place.
+  static inline void Transpose(Reg* rows) {}
+};
+
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_simd.inc"
+
+#undef IREE_SIMD_INLINE
+#undef IREE_SIMD_TARGET
+
+}  // namespace generic
+
+#if defined(IREE_SIMD_X86)
+
+//===----------------------------------------------------------------------===//
+// SSE4.1
+//===----------------------------------------------------------------------===//
+
+namespace sse41 {
+
+#define IREE_SIMD_TARGET __attribute__((target("sse4.1")))
+#define IREE_SIMD_INLINE inline __attribute__((always_inline, target("sse4.1")))
+
+struct Vector {
+  using Reg = __m128i;
+  using Mask = __m128i;
+  static constexpr size_t kWidth = 4;
+
+  static IREE_SIMD_INLINE Reg Load(const void* ptr) {
+    return _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+  }
+  static IREE_SIMD_INLINE void Store(void* ptr, Reg value) {
+    _mm_storeu_si128(static_cast<__m128i*>(ptr), value);
+  }
+
+  static IREE_SIMD_INLINE __m128 F(Reg value) {
+    return _mm_castsi128_ps(value);
+  }
+  static IREE_SIMD_INLINE Reg R(__m128 value) {
+    return _mm_castps_si128(value);
+  }
+
+  static IREE_SIMD_INLINE Reg AddF(Reg a, Reg b) {
+    return R(_mm_add_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg SubF(Reg a, Reg b) {
+    return R(_mm_sub_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg MulF(Reg a, Reg b) {
+    return R(_mm_mul_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg DivF(Reg a, Reg b) {
+    return R(_mm_div_ps(F(a), F(b)));
+  }
+  // minps/maxps return the second operand when unordered, so swapping the
+  // operands gives exactly std::min/std::max semantics.
+  static IREE_SIMD_INLINE Reg MinF(Reg a, Reg b) {
+    return R(_mm_min_ps(F(b), F(a)));
+  }
+  static IREE_SIMD_INLINE Reg MaxF(Reg a, Reg b) {
+    return R(_mm_max_ps(F(b), F(a)));
+  }
+  static IREE_SIMD_INLINE Mask CmpEqF(Reg a, Reg b) {
+    return R(_mm_cmpeq_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Mask CmpNeF(Reg a, Reg b) {
+    return R(_mm_cmpneq_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Mask CmpLtF(Reg a, Reg b) {
+    return R(_mm_cmplt_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Mask CmpLeF(Reg a, Reg b) {
+    return R(_mm_cmple_ps(F(a), F(b)));
+  }
+
+  static IREE_SIMD_INLINE Reg AddI(Reg a, Reg b) { return _mm_add_epi32(a, b); }
+  static IREE_SIMD_INLINE Reg SubI(Reg a, Reg b) { return _mm_sub_epi32(a, b); }
+  static IREE_SIMD_INLINE Reg MulI(Reg a, Reg b) {
+    return _mm_mullo_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MinS(Reg a, Reg b) { return _mm_min_epi32(a, b); }
+  static IREE_SIMD_INLINE Reg MaxS(Reg a, Reg b) { return _mm_max_epi32(a, b); }
+  static IREE_SIMD_INLINE Reg MinU(Reg a, Reg b) { return _mm_min_epu32(a, b); }
+  static IREE_SIMD_INLINE Reg MaxU(Reg a, Reg b) { return _mm_max_epu32(a, b); }
+  static IREE_SIMD_INLINE Reg And(Reg a, Reg b) { return _mm_and_si128(a, b); }
+  static IREE_SIMD_INLINE Reg Or(Reg a, Reg b) { return _mm_or_si128(a, b); }
+  static IREE_SIMD_INLINE Reg Xor(Reg a, Reg b) { return _mm_xor_si128(a, b); }
+
+  // SSE has no per-lane variable shifts so they are done one lane at a time.
+  template <typename FN>
+  static IREE_SIMD_INLINE Reg ShiftLanes(Reg a, Reg b, FN fn) {
+    uint32_t a_lanes[kWidth];
+    uint32_t b_lanes[kWidth];
+    Store(a_lanes, a);
+    Store(b_lanes, b);
+    for (size_t i = 0; i < kWidth; ++i) {
+      a_lanes[i] = fn(a_lanes[i], b_lanes[i]);
+    }
+    return Load(a_lanes);
+  }
+  static IREE_SIMD_INLINE Reg Shl(Reg a, Reg b) {
+    return ShiftLanes(a, b, [](uint32_t x, uint32_t y) { return x << y; });
+  }
+  static IREE_SIMD_INLINE Reg Sra(Reg a, Reg b) {
+    return ShiftLanes(a, b, [](uint32_t x, uint32_t y) -> uint32_t {
+      return static_cast<int32_t>(x) >> static_cast<int32_t>(y);
+    });
+  }
+  static IREE_SIMD_INLINE Reg Srl(Reg a, Reg b) {
+    return ShiftLanes(a, b, [](uint32_t x, uint32_t y) { return x >> y; });
+  }
+
+  static IREE_SIMD_INLINE Mask CmpEqI(Reg a, Reg b) {
+    return _mm_cmpeq_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Mask CmpLtS(Reg a, Reg b) {
+    return _mm_cmplt_epi32(a, b);
+  }
+  // There are no unsigned compares; bias both sides into the signed range.
+  static IREE_SIMD_INLINE Mask CmpLtU(Reg a, Reg b) {
+    Reg bias = _mm_set1_epi32(INT32_MIN);
+    return _mm_cmplt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+  }
+
+  static IREE_SIMD_INLINE Reg SplatF(float value) {
+    return R(_mm_set1_ps(value));
+  }
+  static IREE_SIMD_INLINE Reg SplatI(uint32_t value) {
+    return _mm_set1_epi32(static_cast<int32_t>(value));
+  }
+  static IREE_SIMD_INLINE Reg SqrtF(Reg a) { return R(_mm_sqrt_ps(F(a))); }
+  static IREE_SIMD_INLINE Reg RoundF(Reg a) {
+    return R(_mm_round_ps(F(a), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  static IREE_SIMD_INLINE Reg TruncFToI(Reg a) {
+    return _mm_cvttps_epi32(F(a));
+  }
+  static IREE_SIMD_INLINE Reg CvtIToF(Reg a) { return R(_mm_cvtepi32_ps(a)); }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg ShlImm(Reg a) {
+    return _mm_slli_epi32(a, kBits);
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg SraImm(Reg a) {
+    return _mm_srai_epi32(a, kBits);
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg SrlImm(Reg a) {
+    return _mm_srli_epi32(a, kBits);
+  }
+
+  static IREE_SIMD_INLINE Mask MaskNot(Mask mask) {
+    return _mm_xor_si128(mask, _mm_set1_epi32(-1));
+  }
+  static IREE_SIMD_INLINE Mask MaskOr(Mask a, Mask b) {
+    return _mm_or_si128(a, b);
+  }
+  static IREE_SIMD_INLINE bool MaskAny(Mask mask) {
+    return _mm_movemask_ps(F(mask)) != 0;
+  }
+  static IREE_SIMD_INLINE Reg Blend(Mask mask, Reg a, Reg b) {
+    return _mm_blendv_epi8(b, a, mask);
+  }
+  static IREE_SIMD_INLINE void StoreMaskBytes(Mask mask, uint8_t* dst) {
+    __m128i words = _mm_packs_epi32(mask, mask);
+    __m128i bytes = _mm_packs_epi16(words, words);
+    bytes = _mm_and_si128(bytes, _mm_set1_epi8(1));
+    int32_t value = _mm_cvtsi128_si32(bytes);
+    std::memcpy(dst, &value, sizeof(value));
+  }
+  static IREE_SIMD_INLINE Mask LoadMaskBytes(const uint8_t* src) {
+    int32_t value;
+    std::memcpy(&value, src, sizeof(value));
+    __m128i lanes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(value));
+    return MaskNot(_mm_cmpeq_epi32(lanes, _mm_setzero_si128()));
+  }
+  static IREE_SIMD_INLINE void Transpose(Reg* rows) {
+    __m128i t0 = _mm_unpacklo_epi32(rows[0], rows[1]);
+    __m128i t1 = _mm_unpacklo_epi32(rows[2], rows[3]);
+    __m128i t2 = _mm_unpackhi_epi32(rows[0], rows[1]);
+    __m128i t3 = _mm_unpackhi_epi32(rows[2], rows[3]);
+    rows[0] = _mm_unpacklo_epi64(t0, t1);
+    rows[1] = _mm_unpackhi_epi64(t0, t1);
+    rows[2] = _mm_unpacklo_epi64(t2, t3);
+    rows[3] = _mm_unpackhi_epi64(t2, t3);
+  }
+};
+
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_simd.inc"
+
+#undef IREE_SIMD_INLINE
+#undef IREE_SIMD_TARGET
+
+}  // namespace sse41
+
+//===----------------------------------------------------------------------===//
+// AVX2
+//===----------------------------------------------------------------------===//
+
+namespace avx2 {
+
+#define IREE_SIMD_TARGET __attribute__((target("avx2")))
+#define IREE_SIMD_INLINE inline __attribute__((always_inline, target("avx2")))
+
+struct Vector {
+  using Reg = __m256i;
+  using Mask = __m256i;
+  static constexpr size_t kWidth = 8;
+
+  static IREE_SIMD_INLINE Reg Load(const void* ptr) {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+  }
+  static IREE_SIMD_INLINE void Store(void* ptr, Reg value) {
+    _mm256_storeu_si256(static_cast<__m256i*>(ptr), value);
+  }
+
+  static IREE_SIMD_INLINE __m256 F(Reg value) {
+    return _mm256_castsi256_ps(value);
+  }
+  static IREE_SIMD_INLINE Reg R(__m256 value) {
+    return _mm256_castps_si256(value);
+  }
+
+  static IREE_SIMD_INLINE Reg AddF(Reg a, Reg b) {
+    return R(_mm256_add_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg SubF(Reg a, Reg b) {
+    return R(_mm256_sub_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg MulF(Reg a, Reg b) {
+    return R(_mm256_mul_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg DivF(Reg a, Reg b) {
+    return R(_mm256_div_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg MinF(Reg a, Reg b) {
+    return R(_mm256_min_ps(F(b), F(a)));
+  }
+  static IREE_SIMD_INLINE Reg MaxF(Reg a, Reg b) {
+    return R(_mm256_max_ps(F(b), F(a)));
+  }
+  static IREE_SIMD_INLINE Mask CmpEqF(Reg a, Reg b) {
+    return R(_mm256_cmp_ps(F(a), F(b), _CMP_EQ_OQ));
+  }
+  static IREE_SIMD_INLINE Mask CmpNeF(Reg a, Reg b) {
+    return R(_mm256_cmp_ps(F(a), F(b), _CMP_NEQ_UQ));
+  }
+  static IREE_SIMD_INLINE Mask CmpLtF(Reg a, Reg b) {
+    return R(_mm256_cmp_ps(F(a), F(b), _CMP_LT_OQ));
+  }
+  static IREE_SIMD_INLINE Mask CmpLeF(Reg a, Reg b) {
+    return R(_mm256_cmp_ps(F(a), F(b), _CMP_LE_OQ));
+  }
+
+  static IREE_SIMD_INLINE Reg AddI(Reg a, Reg b) {
+    return _mm256_add_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg SubI(Reg a, Reg b) {
+    return _mm256_sub_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MulI(Reg a, Reg b) {
+    return _mm256_mullo_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MinS(Reg a, Reg b) {
+    return _mm256_min_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MaxS(Reg a, Reg b) {
+    return _mm256_max_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MinU(Reg a, Reg b) {
+    return _mm256_min_epu32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MaxU(Reg a, Reg b) {
+    return _mm256_max_epu32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg And(Reg a, Reg b) {
+    return _mm256_and_si256(a, b);
+  }
+  static IREE_SIMD_INLINE Reg Or(Reg a, Reg b) { return _mm256_or_si256(a, b); }
+  static IREE_SIMD_INLINE Reg Xor(Reg a, Reg b) {
+    return _mm256_xor_si256(a, b);
+  }
+  static IREE_SIMD_INLINE Reg Shl(Reg a, Reg b) {
+    return _mm256_sllv_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg Sra(Reg a, Reg b) {
+    return _mm256_srav_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg Srl(Reg a, Reg b) {
+    return _mm256_srlv_epi32(a, b);
+  }
+
+  static IREE_SIMD_INLINE Mask CmpEqI(Reg a, Reg b) {
+    return _mm256_cmpeq_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Mask CmpLtS(Reg a, Reg b) {
+    return _mm256_cmpgt_epi32(b, a);
+  }
+  static IREE_SIMD_INLINE Mask CmpLtU(Reg a, Reg b) {
+    Reg bias = _mm256_set1_epi32(INT32_MIN);
+    return _mm256_cmpgt_epi32(_mm256_xor_si256(b, bias),
+                              _mm256_xor_si256(a, bias));
+  }
+
+  static IREE_SIMD_INLINE Reg SplatF(float value) {
+    return R(_mm256_set1_ps(value));
+  }
+  static IREE_SIMD_INLINE Reg SplatI(uint32_t value) {
+    return _mm256_set1_epi32(static_cast<int32_t>(value));
+  }
+  static IREE_SIMD_INLINE Reg SqrtF(Reg a) { return R(_mm256_sqrt_ps(F(a))); }
+  static IREE_SIMD_INLINE Reg RoundF(Reg a) {
+    return R(_mm256_round_ps(F(a),
+                             _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  static IREE_SIMD_INLINE Reg TruncFToI(Reg a) {
+    return _mm256_cvttps_epi32(F(a));
+  }
+  static IREE_SIMD_INLINE Reg CvtIToF(Reg a) {
+    return R(_mm256_cvtepi32_ps(a));
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg ShlImm(Reg a) {
+    return _mm256_slli_epi32(a, kBits);
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg SraImm(Reg a) {
+    return _mm256_srai_epi32(a, kBits);
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg SrlImm(Reg a) {
+    return _mm256_srli_epi32(a, kBits);
+  }
+
+  static IREE_SIMD_INLINE Mask MaskNot(Mask mask) {
+    return _mm256_xor_si256(mask, _mm256_set1_epi32(-1));
+  }
+  static IREE_SIMD_INLINE Mask MaskOr(Mask a, Mask b) {
+    return _mm256_or_si256(a, b);
+  }
+  static IREE_SIMD_INLINE bool MaskAny(Mask mask) {
+    return _mm256_movemask_ps(F(mask)) != 0;
+  }
+  static IREE_SIMD_INLINE Reg Blend(Mask mask, Reg a, Reg b) {
+    return _mm256_blendv_epi8(b, a, mask);
+  }
+  static IREE_SIMD_INLINE void StoreMaskBytes(Mask mask, uint8_t* dst) {
+    __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(mask),
+                                    _mm256_extracti128_si256(mask, 1));
+    __m128i bytes = _mm_packs_epi16(words, words);
+    bytes = _mm_and_si128(bytes, _mm_set1_epi8(1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), bytes);
+  }
+  static IREE_SIMD_INLINE Mask LoadMaskBytes(const uint8_t* src) {
+    __m256i lanes = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+    return MaskNot(_mm256_cmpeq_epi32(lanes, _mm256_setzero_si256()));
+  }
+  static IREE_SIMD_INLINE void Transpose(Reg* rows) {
+    // 4x4 transposes within each 128-bit half and then swap the halves.
+    Reg t[8];
+    for (int i = 0; i < 8; i += 2) {
+      t[i + 0] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+      t[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+    }
+    Reg u[8];
+    for (int i = 0; i < 8; i += 4) {
+      u[i + 0] = _mm256_unpacklo_epi64(t[i + 0], t[i + 2]);
+      u[i + 1] = _mm256_unpackhi_epi64(t[i + 0], t[i + 2]);
+      u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+      u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+      rows[i + 0] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+      rows[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+  }
+};
+
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_simd.inc"
+
+#undef IREE_SIMD_INLINE
+#undef IREE_SIMD_TARGET
+
+}  // namespace avx2
+
+//===----------------------------------------------------------------------===//
+// AVX-512
+//===----------------------------------------------------------------------===//
+
+namespace avx512 {
+
+// Only AVX-512F is required; comparisons produce k-register masks.
+#define IREE_SIMD_TARGET __attribute__((target("avx512f")))
+#define IREE_SIMD_INLINE \
+  inline __attribute__((always_inline, target("avx512f")))
+
+struct Vector {
+  using Reg = __m512i;
+  using Mask = __mmask16;
+  static constexpr size_t kWidth = 16;
+
+  static IREE_SIMD_INLINE Reg Load(const void* ptr) {
+    return _mm512_loadu_si512(ptr);
+  }
+  static IREE_SIMD_INLINE void Store(void* ptr, Reg value) {
+    _mm512_storeu_si512(ptr, value);
+  }
+
+  static IREE_SIMD_INLINE __m512 F(Reg value) {
+    return _mm512_castsi512_ps(value);
+  }
+  static IREE_SIMD_INLINE Reg R(__m512 value) {
+    return _mm512_castps_si512(value);
+  }
+
+  static IREE_SIMD_INLINE Reg AddF(Reg a, Reg b) {
+    return R(_mm512_add_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg SubF(Reg a, Reg b) {
+    return R(_mm512_sub_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg MulF(Reg a, Reg b) {
+    return R(_mm512_mul_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg DivF(Reg a, Reg b) {
+    return R(_mm512_div_ps(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg MinF(Reg a, Reg b) {
+    return R(_mm512_min_ps(F(b), F(a)));
+  }
+  static IREE_SIMD_INLINE Reg MaxF(Reg a, Reg b) {
+    return R(_mm512_max_ps(F(b), F(a)));
+  }
+  static IREE_SIMD_INLINE Mask CmpEqF(Reg a, Reg b) {
+    return _mm512_cmp_ps_mask(F(a), F(b), _CMP_EQ_OQ);
+  }
+  static IREE_SIMD_INLINE Mask CmpNeF(Reg a, Reg b) {
+    return _mm512_cmp_ps_mask(F(a), F(b), _CMP_NEQ_UQ);
+  }
+  static IREE_SIMD_INLINE Mask CmpLtF(Reg a, Reg b) {
+    return _mm512_cmp_ps_mask(F(a), F(b), _CMP_LT_OQ);
+  }
+  static IREE_SIMD_INLINE Mask CmpLeF(Reg a, Reg b) {
+    return _mm512_cmp_ps_mask(F(a), F(b), _CMP_LE_OQ);
+  }
+
+  static IREE_SIMD_INLINE Reg AddI(Reg a, Reg b) {
+    return _mm512_add_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg SubI(Reg a, Reg b) {
+    return _mm512_sub_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MulI(Reg a, Reg b) {
+    return _mm512_mullo_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MinS(Reg a, Reg b) {
+    return _mm512_min_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MaxS(Reg a, Reg b) {
+    return _mm512_max_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MinU(Reg a, Reg b) {
+    return _mm512_min_epu32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg MaxU(Reg a, Reg b) {
+    return _mm512_max_epu32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg And(Reg a, Reg b) {
+    return _mm512_and_si512(a, b);
+  }
+  static IREE_SIMD_INLINE Reg Or(Reg a, Reg b) { return _mm512_or_si512(a, b); }
+  static IREE_SIMD_INLINE Reg Xor(Reg a, Reg b) {
+    return _mm512_xor_si512(a, b);
+  }
+  static IREE_SIMD_INLINE Reg Shl(Reg a, Reg b) {
+    return _mm512_sllv_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg Sra(Reg a, Reg b) {
+    return _mm512_srav_epi32(a, b);
+  }
+  static IREE_SIMD_INLINE Reg Srl(Reg a, Reg b) {
+    return _mm512_srlv_epi32(a, b);
+  }
+
+  static IREE_SIMD_INLINE Mask CmpEqI(Reg a, Reg b) {
+    return _mm512_cmpeq_epi32_mask(a, b);
+  }
+  static IREE_SIMD_INLINE Mask CmpLtS(Reg a, Reg b) {
+    return _mm512_cmplt_epi32_mask(a, b);
+  }
+  static IREE_SIMD_INLINE Mask CmpLtU(Reg a, Reg b) {
+    return _mm512_cmplt_epu32_mask(a, b);
+  }
+
+  static IREE_SIMD_INLINE Reg SplatF(float value) {
+    return R(_mm512_set1_ps(value));
+  }
+  static IREE_SIMD_INLINE Reg SplatI(uint32_t value) {
+    return _mm512_set1_epi32(static_cast<int32_t>(value));
+  }
+  static IREE_SIMD_INLINE Reg SqrtF(Reg a) { return R(_mm512_sqrt_ps(F(a))); }
+  static IREE_SIMD_INLINE Reg RoundF(Reg a) {
+    return R(_mm512_roundscale_ps(
+        F(a), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  static IREE_SIMD_INLINE Reg TruncFToI(Reg a) {
+    return _mm512_cvttps_epi32(F(a));
+  }
+  static IREE_SIMD_INLINE Reg CvtIToF(Reg a) {
+    return R(_mm512_cvtepi32_ps(a));
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg ShlImm(Reg a) {
+    return _mm512_slli_epi32(a, kBits);
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg SraImm(Reg a) {
+    return _mm512_srai_epi32(a, kBits);
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg SrlImm(Reg a) {
+    return _mm512_srli_epi32(a, kBits);
+  }
+
+  static IREE_SIMD_INLINE Mask MaskNot(Mask mask) { return _mm512_knot(mask); }
+  static IREE_SIMD_INLINE Mask MaskOr(Mask a, Mask b) {
+    return _mm512_kor(a, b);
+  }
+  static IREE_SIMD_INLINE bool MaskAny(Mask mask) { return mask != 0; }
+  static IREE_SIMD_INLINE Reg Blend(Mask mask, Reg a, Reg b) {
+    return _mm512_mask_blend_epi32(mask, b, a);
+  }
+  static IREE_SIMD_INLINE void StoreMaskBytes(Mask mask, uint8_t* dst) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm512_cvtepi32_epi8(_mm512_maskz_set1_epi32(mask, 1)));
+  }
+  static IREE_SIMD_INLINE Mask LoadMaskBytes(const uint8_t* src) {
+    __m512i lanes = _mm512_cvtepu8_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    return _mm512_test_epi32_mask(lanes, lanes);
+  }
+  static IREE_SIMD_INLINE void Transpose(Reg* rows) {
+    // 4x4 transposes within each 128-bit lane and then two rounds of lane
+    // shuffles to gather each column.
+    Reg t[16];
+    for (int i = 0; i < 16; i += 2) {
+      t[i + 0] = _mm512_unpacklo_epi32(rows[i], rows[i + 1]);
+      t[i + 1] = _mm512_unpackhi_epi32(rows[i], rows[i + 1]);
+    }
+    Reg u[16];
+    for (int i = 0; i < 16; i += 4) {
+      u[i + 0] = _mm512_unpacklo_epi64(t[i + 0], t[i + 2]);
+      u[i + 1] = _mm512_unpackhi_epi64(t[i + 0], t[i + 2]);
+      u[i + 2] = _mm512_unpacklo_epi64(t[i + 1], t[i + 3]);
+      u[i + 3] = _mm512_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int j = 0; j < 4; ++j) {
+      Reg even_lo = _mm512_shuffle_i32x4(u[j], u[j + 4], 0x88);
+      Reg odd_lo = _mm512_shuffle_i32x4(u[j], u[j + 4], 0xDD);
+      Reg even_hi = _mm512_shuffle_i32x4(u[j + 8], u[j + 12], 0x88);
+      Reg odd_hi = _mm512_shuffle_i32x4(u[j + 8], u[j + 12], 0xDD);
+      rows[j + 0] = _mm512_shuffle_i32x4(even_lo, even_hi, 0x88);
+      rows[j + 4] = _mm512_shuffle_i32x4(odd_lo, odd_hi, 0x88);
+      rows[j + 8] = _mm512_shuffle_i32x4(even_lo, even_hi, 0xDD);
+      rows[j + 12] = _mm512_shuffle_i32x4(odd_lo, odd_hi, 0xDD);
+    }
+  }
+};
+
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_simd.inc"
+
+#undef IREE_SIMD_INLINE
+#undef IREE_SIMD_TARGET
+
+}  // namespace avx512
+
+#endif  // IREE_SIMD_X86
+
+#if defined(IREE_SIMD_NEON)
+
+//===----------------------------------------------------------------------===//
+// NEON (aarch64)
+//===----------------------------------------------------------------------===//
+
+namespace neon {
+
+#define IREE_SIMD_TARGET
+#define IREE_SIMD_INLINE inline __attribute__((always_inline))
+
+struct Vector {
+  using Reg = uint32x4_t;
+  using Mask = uint32x4_t;
+  static constexpr size_t kWidth = 4;
+
+  static IREE_SIMD_INLINE Reg Load(const void* ptr) {
+    return vld1q_u32(static_cast<const uint32_t*>(ptr));
+  }
+  static IREE_SIMD_INLINE void Store(void* ptr, Reg value) {
+    vst1q_u32(static_cast<uint32_t*>(ptr), value);
+  }
+
+  static IREE_SIMD_INLINE float32x4_t F(Reg value) {
+    return vreinterpretq_f32_u32(value);
+  }
+  static IREE_SIMD_INLINE Reg R(float32x4_t value) {
+    return vreinterpretq_u32_f32(value);
+  }
+  static IREE_SIMD_INLINE int32x4_t S(Reg value) {
+    return vreinterpretq_s32_u32(value);
+  }
+  static IREE_SIMD_INLINE Reg RS(int32x4_t value) {
+    return vreinterpretq_u32_s32(value);
+  }
+
+  static IREE_SIMD_INLINE Reg AddF(Reg a, Reg b) {
+    return R(vaddq_f32(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg SubF(Reg a, Reg b) {
+    return R(vsubq_f32(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg MulF(Reg a, Reg b) {
+    return R(vmulq_f32(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Reg DivF(Reg a, Reg b) {
+    return R(vdivq_f32(F(a), F(b)));
+  }
+  // vminq/vmaxq propagate NaNs differently than std::min/std::max so select
+  // explicitly.
+  static IREE_SIMD_INLINE Reg MinF(Reg a, Reg b) {
+    return vbslq_u32(vcltq_f32(F(b), F(a)), b, a);
+  }
+  static IREE_SIMD_INLINE Reg MaxF(Reg a, Reg b) {
+    return vbslq_u32(vcltq_f32(F(a), F(b)), b, a);
+  }
+  static IREE_SIMD_INLINE Mask CmpEqF(Reg a, Reg b) {
+    return vceqq_f32(F(a), F(b));
+  }
+  static IREE_SIMD_INLINE Mask CmpNeF(Reg a, Reg b) {
+    return vmvnq_u32(vceqq_f32(F(a), F(b)));
+  }
+  static IREE_SIMD_INLINE Mask CmpLtF(Reg a, Reg b) {
+    return vcltq_f32(F(a), F(b));
+  }
+  static IREE_SIMD_INLINE Mask CmpLeF(Reg a, Reg b) {
+    return vcleq_f32(F(a), F(b));
+  }
+
+  static IREE_SIMD_INLINE Reg AddI(Reg a, Reg b) { return vaddq_u32(a, b); }
+  static IREE_SIMD_INLINE Reg SubI(Reg a, Reg b) { return vsubq_u32(a, b); }
+  static IREE_SIMD_INLINE Reg MulI(Reg a, Reg b) { return vmulq_u32(a, b); }
+  static IREE_SIMD_INLINE Reg MinS(Reg a, Reg b) {
+    return RS(vminq_s32(S(a), S(b)));
+  }
+  static IREE_SIMD_INLINE Reg MaxS(Reg a, Reg b) {
+    return RS(vmaxq_s32(S(a), S(b)));
+  }
+  static IREE_SIMD_INLINE Reg MinU(Reg a, Reg b) { return vminq_u32(a, b); }
+  static IREE_SIMD_INLINE Reg MaxU(Reg a, Reg b) { return vmaxq_u32(a, b); }
+  static IREE_SIMD_INLINE Reg And(Reg a, Reg b) { return vandq_u32(a, b); }
+  static IREE_SIMD_INLINE Reg Or(Reg a, Reg b) { return vorrq_u32(a, b); }
+  static IREE_SIMD_INLINE Reg Xor(Reg a, Reg b) { return veorq_u32(a, b); }
+  // NEON shifts right by shifting left by a negative amount.
+  static IREE_SIMD_INLINE Reg Shl(Reg a, Reg b) { return vshlq_u32(a, S(b)); }
+  static IREE_SIMD_INLINE Reg Sra(Reg a, Reg b) {
+    return RS(vshlq_s32(S(a), vnegq_s32(S(b))));
+  }
+  static IREE_SIMD_INLINE Reg Srl(Reg a, Reg b) {
+    return vshlq_u32(a, vnegq_s32(S(b)));
+  }
+
+  static IREE_SIMD_INLINE Mask CmpEqI(Reg a, Reg b) { return vceqq_u32(a, b); }
+  static IREE_SIMD_INLINE Mask CmpLtS(Reg a, Reg b) {
+    return vcltq_s32(S(a), S(b));
+  }
+  static IREE_SIMD_INLINE Mask CmpLtU(Reg a, Reg b) { return vcltq_u32(a, b); }
+
+  static IREE_SIMD_INLINE Reg SplatF(float value) {
+    return R(vdupq_n_f32(value));
+  }
+  static IREE_SIMD_INLINE Reg SplatI(uint32_t value) {
+    return vdupq_n_u32(value);
+  }
+  static IREE_SIMD_INLINE Reg SqrtF(Reg a) { return R(vsqrtq_f32(F(a))); }
+  static IREE_SIMD_INLINE Reg RoundF(Reg a) { return R(vrndnq_f32(F(a))); }
+  static IREE_SIMD_INLINE Reg TruncFToI(Reg a) {
+    return RS(vcvtq_s32_f32(F(a)));
+  }
+  static IREE_SIMD_INLINE Reg CvtIToF(Reg a) {
+    return R(vcvtq_f32_s32(S(a)));
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg ShlImm(Reg a) {
+    return vshlq_n_u32(a, kBits);
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg SraImm(Reg a) {
+    return RS(vshrq_n_s32(S(a), kBits));
+  }
+  template <int kBits>
+  static IREE_SIMD_INLINE Reg SrlImm(Reg a) {
+    return vshrq_n_u32(a, kBits);
+  }
+
+  static IREE_SIMD_INLINE Mask MaskNot(Mask mask) { return vmvnq_u32(mask); }
+  static IREE_SIMD_INLINE Mask MaskOr(Mask a, Mask b) {
+    return vorrq_u32(a, b);
+  }
+  static IREE_SIMD_INLINE bool MaskAny(Mask mask) {
+    return vmaxvq_u32(mask) != 0;
+  }
+  static IREE_SIMD_INLINE Reg Blend(Mask mask, Reg a, Reg b) {
+    return vbslq_u32(mask, a, b);
+  }
+  static IREE_SIMD_INLINE void StoreMaskBytes(Mask mask, uint8_t* dst) {
+    uint16x4_t words = vmovn_u32(mask);
+    uint8x8_t bytes = vmovn_u16(vcombine_u16(words, words));
+    bytes = vand_u8(bytes, vdup_n_u8(1));
+    uint32_t value = vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+    std::memcpy(dst, &value, sizeof(value));
+  }
+  static IREE_SIMD_INLINE Mask LoadMaskBytes(const uint8_t* src) {
+    uint32_t value;
+    std::memcpy(&value, src, sizeof(value));
+    uint8x8_t bytes = vreinterpret_u8_u32(vdup_n_u32(value));
+    uint32x4_t lanes = vmovl_u16(vget_low_u16(vmovl_u8(bytes)));
+    return vtstq_u32(lanes, lanes);
+  }
+  static IREE_SIMD_INLINE void Transpose(Reg* rows) {
+    uint32x4x2_t t01 = vtrnq_u32(rows[0], rows[1]);
+    uint32x4x2_t t23 = vtrnq_u32(rows[2], rows[3]);
+    rows[0] = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+    rows[1] = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+    rows[2] =
+        vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+    rows[3] =
+        vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+  }
+};
+
+#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels_simd.inc"
+
+#undef IREE_SIMD_INLINE
+#undef IREE_SIMD_TARGET
+
+}  // namespace neon
+
+#endif  // IREE_SIMD_NEON
+
+//===----------------------------------------------------------------------===//
+// Runtime selection
+//===----------------------------------------------------------------------===//
+
+const char* IsaName(Isa isa) {
+  switch (isa) {
+    case Isa::kGeneric:
+      return "generic";
+    case Isa::kSse41:
+      return "sse4.1";
+    case Isa::kAvx2:
+      return "avx2";
+    case Isa::kAvx512:
+      return "avx512f";
+    case Isa::kNeon:
+      return "neon";
+  }
+  return "unknown";
+}
+
+Isa DetectIsa() {
+#if defined(IREE_SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return Isa::kAvx512;
+  if (__builtin_cpu_supports("avx2")) return Isa::kAvx2;
+  if (__builtin_cpu_supports("sse4.1")) return Isa::kSse41;
+#elif defined(IREE_SIMD_NEON)
+  return Isa::kNeon;
+#endif
+  return Isa::kGeneric;
+}
+
+const ElementwiseTable* GetElementwiseTable(Isa isa) {
+  switch (isa) {
+    case Isa::kGeneric: {
+      static const ElementwiseTable table =
+          generic::MakeElementwiseTable(Isa::kGeneric);
+      return &table;
+    }
+#if defined(IREE_SIMD_X86)
+    case Isa::kSse41: {
+      static const ElementwiseTable table =
+          sse41::MakeElementwiseTable(Isa::kSse41);
+      return &table;
+    }
+    case Isa::kAvx2: {
+      static const ElementwiseTable table =
+          avx2::MakeElementwiseTable(Isa::kAvx2);
+      return &table;
+    }
+    case Isa::kAvx512: {
+      static const ElementwiseTable table =
+          avx512::MakeElementwiseTable(Isa::kAvx512);
+      return &table;
+    }
+#endif  // IREE_SIMD_X86
+#if defined(IREE_SIMD_NEON)
+    case Isa::kNeon: {
+      static const ElementwiseTable table =
+          neon::MakeElementwiseTable(Isa::kNeon);
+      return &table;
+    }
+#endif  // IREE_SIMD_NEON
+    default:
+      return nullptr;
+  }
+}
+
+const ElementwiseTable& GetElementwiseTable() {
+  static const ElementwiseTable* table = [] {
+    Isa isa = DetectIsa();
+    VLOG(1) << "Using " << IsaName(isa) << " elementwise kernels";
+    return GetElementwiseTable(isa);
+  }();
+  return *table;
+}
+
+}  // namespace simd
+}  // namespace kernels
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,275 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Vectorized specializations of the elementwise kernels for 32-bit types.
+//
+// The loops are compiled once per instruction set in bytecode_kernels_simd.cc
+// and the best variant supported by the CPU is selected at runtime the first
+// time a kernel is executed. Other types fall back to the generic kernels.
+
+#ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_SIMD_H_
+#define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "third_party/absl/types/span.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+
+namespace iree {
+namespace hal {
+namespace kernels {
+namespace simd {
+
+// Instruction sets that may have vectorized kernel implementations.
+enum class Isa {
+  kGeneric,
+  kSse41,
+  kAvx2,
+  kAvx512,
+  kNeon,
+};
+
+// Returns a human-readable name for |isa| (such as 'avx2').
+const char* IsaName(Isa isa);
+
+// Returns the best instruction set supported by both the build and the CPU.
+Isa DetectIsa();
+
+template <typename T>
+using UnaryFn = void (*)(const T* src, T* dst, size_t count);
+template <typename T>
+using BinaryFn = void (*)(const T* lhs, const T* rhs, T* dst, size_t count);
+template <typename T>
+using TernaryFn = void (*)(const T* a, const T* b, const T* c, T* dst,
+                           size_t count);
+template <typename T>
+using CompareFn = void (*)(const T* lhs, const T* rhs, uint8_t* dst,
+                           size_t count);
+template <typename T>
+using SelectFn = void (*)(const uint8_t* cond, const T* lhs, const T* rhs,
+                          T* dst, size_t count);
+template <typename T>
+using ReduceFn = T (*)(const T* src, size_t count, T init);
+template <typename T>
+using TransposeFn = void (*)(const T* src, size_t src_stride, T* dst,
+                             size_t dst_stride, size_t rows, size_t cols);
+
+// Elementwise loops for a single element type.
+// Entries that are not meaningful for the type (such as bitwise ops on floats)
+// are nullptr.
+template <typename T>
+struct ElementwiseFns {
+  BinaryFn<T> add = nullptr;
+  BinaryFn<T> sub = nullptr;
+  BinaryFn<T> mul = nullptr;
+  BinaryFn<T> div = nullptr;
+  BinaryFn<T> min = nullptr;
+  BinaryFn<T> max = nullptr;
+  BinaryFn<T> bitwise_and = nullptr;
+  BinaryFn<T> bitwise_or = nullptr;
+  BinaryFn<T> bitwise_xor = nullptr;
+  BinaryFn<T> shift_left = nullptr;
+  BinaryFn<T> shift_right = nullptr;
+  TernaryFn<T> mul_add = nullptr;
+  TernaryFn<T> clamp = nullptr;
+  CompareFn<T> compare_eq = nullptr;
+  CompareFn<T> compare_ne = nullptr;
+  CompareFn<T> compare_lt = nullptr;
+  CompareFn<T> compare_le = nullptr;
+  CompareFn<T> compare_gt = nullptr;
+  CompareFn<T> compare_ge = nullptr;
+  SelectFn<T> select = nullptr;
+  UnaryFn<T> fast_exp = nullptr;
+  UnaryFn<T> fast_log = nullptr;
+  UnaryFn<T> fast_tanh = nullptr;
+  UnaryFn<T> fast_rsqrt = nullptr;
+  UnaryFn<T> fast_sin = nullptr;
+  UnaryFn<T> fast_cos = nullptr;
+  BinaryFn<T> fast_atan2 = nullptr;
+  // See impl::SumKernel::Reduce and friends.
+  ReduceFn<T> reduce_sum = nullptr;
+  ReduceFn<T> reduce_sum_kahan = nullptr;
+  ReduceFn<T> reduce_min = nullptr;
+  ReduceFn<T> reduce_max = nullptr;
+  // See impl::TransposeMatrix.
+  TransposeFn<T> transpose = nullptr;
+};
+
+// Elementwise loops compiled for a particular instruction set.
+struct ElementwiseTable {
+  Isa isa = Isa::kGeneric;
+  ElementwiseFns<float> f32;
+  ElementwiseFns<int32_t> i32;
+  ElementwiseFns<uint32_t> u32;
+};
+
+// Returns the table for |isa| or nullptr if support for |isa| was not compiled
+// into this binary. The caller must ensure the CPU supports |isa|.
+const ElementwiseTable* GetElementwiseTable(Isa isa);
+
+// Returns the table for the instruction set chosen by DetectIsa.
+const ElementwiseTable& GetElementwiseTable();
+
+template <typename T>
+const ElementwiseFns<T>& GetElementwiseFns();
+template <>
+inline const ElementwiseFns<float>& GetElementwiseFns<float>() {
+  return GetElementwiseTable().f32;
+}
+template <>
+inline const ElementwiseFns<int32_t>& GetElementwiseFns<int32_t>() {
+  return GetElementwiseTable().i32;
+}
+template <>
+inline const ElementwiseFns<uint32_t>& GetElementwiseFns<uint32_t>() {
+  return GetElementwiseTable().u32;
+}
+
+}  // namespace simd
+
+namespace impl {
+template <>
+inline void TransposeMatrix<uint32_t>(const uint32_t* src, size_t src_stride,
+                                      uint32_t* dst, size_t dst_stride,
+                                      size_t rows, size_t cols) {
+  simd::GetElementwiseFns<uint32_t>().transpose(src, src_stride, dst,
+                                                dst_stride, rows, cols);
+}
+
+#define IREE_SIMD_REDUCE_KERNEL(KERNEL, T, FN)                     \
+  template <>                                                      \
+  inline T KERNEL::Reduce<T>(const T* src, size_t count, T init) { \
+    return simd::GetElementwiseFns<T>().FN(src, count, init);      \
+  }
+
+#define IREE_SIMD_REDUCE_KERNELS(T)                   \
+  IREE_SIMD_REDUCE_KERNEL(SumKernel, T, reduce_sum)   \
+  IREE_SIMD_REDUCE_KERNEL(MinKernel, T, reduce_min)   \
+  IREE_SIMD_REDUCE_KERNEL(MaxKernel, T, reduce_max)
+
+IREE_SIMD_REDUCE_KERNELS(float)
+IREE_SIMD_REDUCE_KERNEL(KahanSumKernel, float, reduce_sum_kahan)
+IREE_SIMD_REDUCE_KERNELS(int32_t)
+IREE_SIMD_REDUCE_KERNELS(uint32_t)
+
+#undef IREE_SIMD_REDUCE_KERNELS
+#undef IREE_SIMD_REDUCE_KERNEL
+}  // namespace impl
+
+#define IREE_SIMD_UNARY_KERNEL(KERNEL, T, FN)                              \
+  template <>                                                              \
+  inline Status KERNEL::Execute<T>(absl::Span<const T> src_buffer,         \
+                                   absl::Span<T> dst_buffer) {             \
+    simd::GetElementwiseFns<T>().FN(src_buffer.data(), dst_buffer.data(),  \
+                                    dst_buffer.size());                    \
+    return OkStatus();                                                     \
+  }
+
+#define IREE_SIMD_BINARY_KERNEL(KERNEL, T, FN)                             \
+  template <>                                                              \
+  inline Status KERNEL::Execute<T>(absl::Span<const T> lhs_buffer,         \
+                                   absl::Span<const T> rhs_buffer,         \
+                                   absl::Span<T> dst_buffer) {             \
+    simd::GetElementwiseFns<T>().FN(lhs_buffer.data(), rhs_buffer.data(),  \
+                                    dst_buffer.data(), dst_buffer.size()); \
+    return OkStatus();                                                     \
+  }
+
+#define IREE_SIMD_TERNARY_KERNEL(KERNEL, T, FN)                              \
+  template <>                                                                \
+  inline Status KERNEL::Execute<T>(                                          \
+      absl::Span<const T> a_buffer, absl::Span<const T> b_buffer,            \
+      absl::Span<const T> c_buffer, absl::Span<T> dst_buffer) {              \
+    simd::GetElementwiseFns<T>().FN(a_buffer.data(), b_buffer.data(),        \
+                                    c_buffer.data(), dst_buffer.data(),      \
+                                    dst_buffer.size());                      \
+    return OkStatus();                                                       \
+  }
+
+#define IREE_SIMD_COMPARE_KERNEL(KERNEL, T, FN)                            \
+  template <>                                                              \
+  inline Status KERNEL::Execute<T>(absl::Span<const T> lhs_buffer,         \
+                                   absl::Span<const T> rhs_buffer,         \
+                                   absl::Span<uint8_t> dst_buffer) {       \
+    simd::GetElementwiseFns<T>().FN(lhs_buffer.data(), rhs_buffer.data(),  \
+                                    dst_buffer.data(), dst_buffer.size()); \
+    return OkStatus();                                                     \
+  }
+
+#define IREE_SIMD_SELECT_KERNEL(T)                                          \
+  template <>                                                               \
+  inline Status Select::Execute<T>(                                         \
+      absl::Span<const uint8_t> cond_buffer, absl::Span<const T> lhs_buffer, \
+      absl::Span<const T> rhs_buffer, absl::Span<T> dst_buffer) {           \
+    simd::GetElementwiseFns<T>().select(                                    \
+        cond_buffer.data(), lhs_buffer.data(), rhs_buffer.data(),           \
+        dst_buffer.data(), dst_buffer.size());                              \
+    return OkStatus();                                                      \
+  }
+
+// Kernels shared by all 32-bit types.
+#define IREE_SIMD_COMMON_KERNELS(T)                    \
+  IREE_SIMD_BINARY_KERNEL(Add, T, add)                 \
+  IREE_SIMD_BINARY_KERNEL(Sub, T, sub)                 \
+  IREE_SIMD_BINARY_KERNEL(Mul, T, mul)                 \
+  IREE_SIMD_BINARY_KERNEL(Min, T, min)                 \
+  IREE_SIMD_BINARY_KERNEL(Max, T, max)                 \
+  IREE_SIMD_TERNARY_KERNEL(MulAdd, T, mul_add)         \
+  IREE_SIMD_TERNARY_KERNEL(Clamp, T, clamp)            \
+  IREE_SIMD_COMPARE_KERNEL(CompareEQ, T, compare_eq)   \
+  IREE_SIMD_COMPARE_KERNEL(CompareNE, T, compare_ne)   \
+  IREE_SIMD_COMPARE_KERNEL(CompareLT, T, compare_lt)   \
+  IREE_SIMD_COMPARE_KERNEL(CompareLE, T, compare_le)   \
+  IREE_SIMD_COMPARE_KERNEL(CompareGT, T, compare_gt)   \
+  IREE_SIMD_COMPARE_KERNEL(CompareGE, T, compare_ge)   \
+  IREE_SIMD_SELECT_KERNEL(T)
+
+// Kernels only defined for integer types.
+#define IREE_SIMD_INTEGER_KERNELS(T)                   \
+  IREE_SIMD_BINARY_KERNEL(And, T, bitwise_and)         \
+  IREE_SIMD_BINARY_KERNEL(Or, T, bitwise_or)           \
+  IREE_SIMD_BINARY_KERNEL(Xor, T, bitwise_xor)         \
+  IREE_SIMD_BINARY_KERNEL(ShiftLeft, T, shift_left)    \
+  IREE_SIMD_BINARY_KERNEL(ShiftRight, T, shift_right)
+
+IREE_SIMD_COMMON_KERNELS(float)
+IREE_SIMD_BINARY_KERNEL(Div, float, div)
+IREE_SIMD_UNARY_KERNEL(FastExp, float, fast_exp)
+IREE_SIMD_UNARY_KERNEL(FastLog, float, fast_log)
+IREE_SIMD_UNARY_KERNEL(FastTanh, float, fast_tanh)
+IREE_SIMD_UNARY_KERNEL(FastRsqrt, float, fast_rsqrt)
+IREE_SIMD_UNARY_KERNEL(FastSin, float, fast_sin)
+IREE_SIMD_UNARY_KERNEL(FastCos, float, fast_cos)
+IREE_SIMD_BINARY_KERNEL(FastAtan2, float, fast_atan2)
+
+IREE_SIMD_COMMON_KERNELS(int32_t)
+IREE_SIMD_INTEGER_KERNELS(int32_t)
+
+IREE_SIMD_COMMON_KERNELS(uint32_t)
+IREE_SIMD_INTEGER_KERNELS(uint32_t)
+
+#undef IREE_SIMD_INTEGER_KERNELS
+#undef IREE_SIMD_COMMON_KERNELS
+#undef IREE_SIMD_SELECT_KERNEL
+#undef IREE_SIMD_COMPARE_KERNEL
+#undef IREE_SIMD_TERNARY_KERNEL
+#undef IREE_SIMD_BINARY_KERNEL
+#undef IREE_SIMD_UNARY_KERNEL
+
+}  // namespace kernels
+}  // namespace hal
+}  // namespace iree
+
+#endif  // THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_BYTECODE_KERNELS_SIMD_H_
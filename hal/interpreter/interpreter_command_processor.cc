@@ -14,7 +14,10 @@
 
 #include "third_party/mlir_edge/iree/hal/interpreter/interpreter_command_processor.h"
 
+#include <array>
+
 #include "third_party/absl/container/inlined_vector.h"
+#include "third_party/absl/memory/memory.h"
 #include "third_party/absl/types/source_location.h"
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/base/status.h"
@@ -27,14 +30,108 @@ namespace hal {
 
 InterpreterCommandProcessor::InterpreterCommandProcessor(
     Allocator* allocator, CommandBufferModeBitfield mode,
-    CommandCategoryBitfield command_categories)
-    : HostLocalCommandProcessor(allocator, mode, command_categories) {}
+    CommandCategoryBitfield command_categories, HostWorkerPool* worker_pool)
+    : HostLocalCommandProcessor(allocator, mode, command_categories),
+      worker_pool_(worker_pool) {}
 
 InterpreterCommandProcessor::~InterpreterCommandProcessor() = default;
 
+Status InterpreterCommandProcessor::End() {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::End();
+}
+
+Status InterpreterCommandProcessor::ExecutionBarrier(
+    ExecutionStageBitfield source_stage_mask,
+    ExecutionStageBitfield target_stage_mask,
+    absl::Span<const MemoryBarrier> memory_barriers,
+    absl::Span<const BufferBarrier> buffer_barriers) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::ExecutionBarrier(
+      source_stage_mask, target_stage_mask, memory_barriers, buffer_barriers);
+}
+
+Status InterpreterCommandProcessor::SignalEvent(
+    Event* event, ExecutionStageBitfield source_stage_mask) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::SignalEvent(event, source_stage_mask);
+}
+
+Status InterpreterCommandProcessor::ResetEvent(
+    Event* event, ExecutionStageBitfield source_stage_mask) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::ResetEvent(event, source_stage_mask);
+}
+
+Status InterpreterCommandProcessor::WaitEvents(
+    absl::Span<Event*> events, ExecutionStageBitfield source_stage_mask,
+    ExecutionStageBitfield target_stage_mask,
+    absl::Span<const MemoryBarrier> memory_barriers,
+    absl::Span<const BufferBarrier> buffer_barriers) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::WaitEvents(
+      events, source_stage_mask, target_stage_mask, memory_barriers,
+      buffer_barriers);
+}
+
 Status InterpreterCommandProcessor::Dispatch(
     const DispatchRequest& dispatch_request) {
-  IREE_TRACE_SCOPE0("InterpreterCommandProcessor::Dispatch");
+  PendingDispatch pending_dispatch;
+  pending_dispatch.request = dispatch_request;
+  pending_dispatch.request.bindings = {};
+  pending_dispatch.bindings.assign(dispatch_request.bindings.begin(),
+                                   dispatch_request.bindings.end());
+  pending_dispatches_.push_back(std::move(pending_dispatch));
+  return OkStatus();
+}
+
+Status InterpreterCommandProcessor::FlushDispatches() {
+  if (pending_dispatches_.empty()) return OkStatus();
+  IREE_TRACE_SCOPE0("InterpreterCommandProcessor::FlushDispatches");
+
+  Status status;
+  if (pending_dispatches_.size() == 1 || !worker_pool_) {
+    if (stacks_.empty()) stacks_.push_back(absl::make_unique<vm::Stack>());
+    for (const auto& pending_dispatch : pending_dispatches_) {
+      status = ExecuteDispatch(pending_dispatch, stacks_.front().get());
+      if (!status.ok()) break;
+    }
+  } else {
+    while (stacks_.size() < pending_dispatches_.size()) {
+      stacks_.push_back(absl::make_unique<vm::Stack>());
+    }
+    // ParallelFor runs part of the work on this thread and helps drain the
+    // pool while waiting so this is safe to call from a worker thread.
+    status = worker_pool_->ParallelFor(
+        pending_dispatches_.size(), /*min_grain_size=*/1,
+        [this](size_t begin, size_t end) -> Status {
+          for (size_t i = begin; i < end; ++i) {
+            RETURN_IF_ERROR(
+                ExecuteDispatch(pending_dispatches_[i], stacks_[i].get()));
+          }
+          return OkStatus();
+        });
+  }
+  pending_dispatches_.clear();
+  return status;
+}
+
+Status InterpreterCommandProcessor::ExecuteDispatch(
+    const PendingDispatch& pending_dispatch, vm::Stack* stack) {
+  IREE_TRACE_SCOPE0("InterpreterCommandProcessor::ExecuteDispatch");
+  const auto& dispatch_request = pending_dispatch.request;
+
+  // Dynamic workloads are resolved here as the command executes. The
+  // interpreter processes whole buffers per invocation so the workload only
+  // determines whether the dispatch runs at all.
+  if (dispatch_request.workload_buffer) {
+    std::array<int32_t, 3> workload;
+    RETURN_IF_ERROR(dispatch_request.workload_buffer->ReadData(
+        0, workload.data(), sizeof(workload)));
+    if (workload[0] <= 0 || workload[1] <= 0 || workload[2] <= 0) {
+      return OkStatus();
+    }
+  }
 
   // Lookup the exported function.
   auto* executable =
@@ -43,12 +140,10 @@ Status InterpreterCommandProcessor::Dispatch(
   ASSIGN_OR_RETURN(auto entry_function, module.function_table().LookupExport(
                                             dispatch_request.entry_point));
 
-  vm::Stack stack;
-
   // TODO(benvanik): avoid this by directly referencing the bindings.
   absl::InlinedVector<BufferView, 8> args;
-  args.reserve(dispatch_request.bindings.size());
-  for (auto& binding : dispatch_request.bindings) {
+  args.reserve(pending_dispatch.bindings.size());
+  for (auto& binding : pending_dispatch.bindings) {
     args.push_back(BufferView{add_ref(binding.buffer), binding.shape,
                               binding.element_size});
   }
@@ -58,10 +153,16 @@ Status InterpreterCommandProcessor::Dispatch(
            << "Executable export results are not yet implemented";
   }
 
-  RETURN_IF_ERROR(executable->context().Invoke(
-      &stack, entry_function, absl::MakeSpan(args), absl::MakeSpan(results)));
-
-  return OkStatus();
+  auto status = executable->context().Invoke(
+      stack, entry_function, absl::MakeSpan(args), absl::MakeSpan(results));
+  if (!status.ok()) {
+    // Unwind any frames left by the failed invocation so the stack is clean if
+    // we are asked to dispatch again.
+    while (stack->current_frame()) {
+      stack->PopFrame().IgnoreError();
+    }
+  }
+  return status;
 }
 
 }  // namespace hal
@@ -15,19 +15,75 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_INTERPRETER_COMMAND_PROCESSOR_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_INTERPRETER_COMMAND_PROCESSOR_H_
 
+#include <memory>
+#include <vector>
+
+#include "third_party/absl/container/inlined_vector.h"
 #include "third_party/mlir_edge/iree/hal/host/host_local_command_processor.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
+#include "third_party/mlir_edge/iree/vm/stack.h"
 
 namespace iree {
 namespace hal {
 
+// Processes commands on the host by invoking bytecode executables.
+//
+// Commands recorded between two execution barriers (or event operations) have
+// no dependencies on each other. Dispatches are collected until the next
+// barrier and then executed concurrently on |worker_pool| while transfer
+// commands run immediately on the calling thread.
 class InterpreterCommandProcessor final : public HostLocalCommandProcessor {
  public:
   InterpreterCommandProcessor(Allocator* allocator,
                               CommandBufferModeBitfield mode,
-                              CommandCategoryBitfield command_categories);
+                              CommandCategoryBitfield command_categories,
+                              HostWorkerPool* worker_pool);
   ~InterpreterCommandProcessor() override;
 
+  Status End() override;
+
+  Status ExecutionBarrier(
+      ExecutionStageBitfield source_stage_mask,
+      ExecutionStageBitfield target_stage_mask,
+      absl::Span<const MemoryBarrier> memory_barriers,
+      absl::Span<const BufferBarrier> buffer_barriers) override;
+
+  Status SignalEvent(Event* event,
+                     ExecutionStageBitfield source_stage_mask) override;
+
+  Status ResetEvent(Event* event,
+                    ExecutionStageBitfield source_stage_mask) override;
+
+  Status WaitEvents(absl::Span<Event*> events,
+                    ExecutionStageBitfield source_stage_mask,
+                    ExecutionStageBitfield target_stage_mask,
+                    absl::Span<const MemoryBarrier> memory_barriers,
+                    absl::Span<const BufferBarrier> buffer_barriers) override;
+
   Status Dispatch(const DispatchRequest& dispatch_request) override;
+
+ private:
+  // A dispatch waiting for the next barrier. The request bindings are set to
+  // |bindings| when the dispatch executes.
+  struct PendingDispatch {
+    DispatchRequest request;
+    absl::InlinedVector<BufferBinding, 8> bindings;
+  };
+
+  // Executes all dispatches recorded since the last barrier.
+  Status FlushDispatches();
+
+  // Executes a single dispatch using |stack| for the invocation.
+  Status ExecuteDispatch(const PendingDispatch& pending_dispatch,
+                         vm::Stack* stack);
+
+  HostWorkerPool* worker_pool_;
+  std::vector<PendingDispatch> pending_dispatches_;
+
+  // One stack per concurrent dispatch. Reused across barriers so that frame
+  // storage blocks are only allocated by the first dispatches recorded into
+  // the command buffer.
+  std::vector<std::unique_ptr<vm::Stack>> stacks_;
 };
 
 }  // namespace hal
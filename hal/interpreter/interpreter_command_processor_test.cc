@@ -0,0 +1,71 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/hal/interpreter/interpreter_command_processor.h"
+
+#include <array>
+#include <cstdint>
+
+#include "testing/base/public/gunit.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/heap_buffer.h"
+#include "third_party/mlir_edge/iree/hal/host/host_local_allocator.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// A dynamic dispatch whose workload is produced by an earlier fill must read
+// the workload as the command executes. An empty workload skips the dispatch
+// entirely so no executable is required.
+TEST(InterpreterCommandProcessorTest, DynamicDispatchEmptyWorkload) {
+  HostLocalAllocator allocator;
+  std::array<int32_t, 3> initial_workload = {4, 4, 4};
+  auto workload_buffer = HeapBuffer::AllocateCopy(
+      BufferUsage::kAll, absl::Span<const int32_t>(initial_workload));
+  std::array<int32_t, 1> zero = {0};
+  auto value_buffer = HeapBuffer::AllocateCopy(BufferUsage::kAll,
+                                               absl::Span<const int32_t>(zero));
+  std::array<int32_t, 1> length = {sizeof(initial_workload)};
+  auto offset_buffer = HeapBuffer::AllocateCopy(
+      BufferUsage::kAll, absl::Span<const int32_t>(zero));
+  auto length_buffer = HeapBuffer::AllocateCopy(
+      BufferUsage::kAll, absl::Span<const int32_t>(length));
+
+  InterpreterCommandProcessor processor(
+      &allocator, CommandBufferMode::kOneShot,
+      CommandCategory::kTransfer | CommandCategory::kDispatch,
+      /*worker_pool=*/nullptr);
+  ASSERT_TRUE(processor.Begin().ok());
+  ASSERT_TRUE(processor
+                  .FillBufferIndirect(workload_buffer.get(), value_buffer.get(),
+                                      offset_buffer.get(), length_buffer.get())
+                  .ok());
+  DispatchRequest dispatch_request;
+  dispatch_request.executable = nullptr;
+  dispatch_request.workload_buffer = workload_buffer.get();
+  ASSERT_TRUE(processor.Dispatch(dispatch_request).ok());
+  EXPECT_TRUE(processor.End().ok());
+
+  std::array<int32_t, 3> workload;
+  ASSERT_TRUE(
+      workload_buffer->ReadData(0, workload.data(), sizeof(workload)).ok());
+  EXPECT_EQ(0, workload[0]);
+  EXPECT_EQ(0, workload[1]);
+  EXPECT_EQ(0, workload[2]);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
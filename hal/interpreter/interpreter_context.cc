@@ -14,6 +14,7 @@
 
 #include "third_party/mlir_edge/iree/hal/interpreter/interpreter_context.h"
 
+#include "third_party/absl/memory/memory.h"
 #include "third_party/mlir_edge/iree/base/flatbuffer_util.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/hal/interpreter/bytecode_dispatch.h"
@@ -53,8 +54,11 @@ Status InterpreterContext::Invoke(vm::Stack* stack, Function function,
   }
 
   // Run main dispatch loop until it exits (or errors).
-  RETURN_IF_ERROR(Dispatch(allocator_, &kernel_runtime_state_, stack,
-                           callee_stack_frame, results));
+  auto kernel_runtime_state = AcquireKernelRuntimeState();
+  auto dispatch_status = Dispatch(allocator_, kernel_runtime_state.get(), stack,
+                                  callee_stack_frame, results);
+  ReleaseKernelRuntimeState(std::move(kernel_runtime_state));
+  RETURN_IF_ERROR(dispatch_status);
 
   // Pop the callee frame to balance out the stack.
   RETURN_IF_ERROR(stack->PopFrame());
@@ -62,5 +66,27 @@ Status InterpreterContext::Invoke(vm::Stack* stack, Function function,
   return OkStatus();
 }
 
+std::unique_ptr<kernels::RuntimeState>
+InterpreterContext::AcquireKernelRuntimeState() const {
+  {
+    absl::MutexLock lock(&kernel_runtime_state_mutex_);
+    if (!free_kernel_runtime_states_.empty()) {
+      auto kernel_runtime_state = std::move(free_kernel_runtime_states_.back());
+      free_kernel_runtime_states_.pop_back();
+      return kernel_runtime_state;
+    }
+  }
+  auto kernel_runtime_state = absl::make_unique<kernels::RuntimeState>();
+  kernel_runtime_state->worker_pool = worker_pool_;
+  kernel_runtime_state->math_mode = math_mode_;
+  return kernel_runtime_state;
+}
+
+void InterpreterContext::ReleaseKernelRuntimeState(
+    std::unique_ptr<kernels::RuntimeState> kernel_runtime_state) const {
+  absl::MutexLock lock(&kernel_runtime_state_mutex_);
+  free_kernel_runtime_states_.push_back(std::move(kernel_runtime_state));
+}
+
 }  // namespace hal
 }  // namespace iree
@@ -16,11 +16,15 @@
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_INTERPRETER_CONTEXT_H_
 
 #include <memory>
+#include <vector>
 
+#include "third_party/absl/base/thread_annotations.h"
+#include "third_party/absl/synchronization/mutex.h"
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/hal/allocator.h"
 #include "third_party/mlir_edge/iree/hal/buffer_view.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
 #include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels.h"
 #include "third_party/mlir_edge/iree/vm/context.h"
 #include "third_party/mlir_edge/iree/vm/function.h"
@@ -31,17 +35,38 @@ namespace hal {
 
 class InterpreterContext final : public vm::Context {
  public:
-  explicit InterpreterContext(hal::Allocator* allocator)
-      : allocator_(allocator) {}
+  // |worker_pool| is used to split large kernels across cores and may be
+  // nullptr to run everything on the invoking thread. |math_mode| selects the
+  // transcendental kernels used by all invocations.
+  InterpreterContext(hal::Allocator* allocator, HostWorkerPool* worker_pool,
+                     kernels::MathMode math_mode = kernels::MathMode::kExact)
+      : allocator_(allocator),
+        worker_pool_(worker_pool),
+        math_mode_(math_mode) {}
 
+  // Thread-safe; concurrent invocations each receive their own kernel state.
+  //
   // TODO(benvanik): helpers to make passing args easier
   Status Invoke(vm::Stack* stack, vm::Function function,
                 absl::Span<BufferView> args,
                 absl::Span<BufferView> results) const;
 
  private:
+  // Acquires kernel runtime state for exclusive use by a single invocation.
+  std::unique_ptr<kernels::RuntimeState> AcquireKernelRuntimeState() const;
+  // Returns kernel runtime state to the pool for reuse.
+  void ReleaseKernelRuntimeState(
+      std::unique_ptr<kernels::RuntimeState> kernel_runtime_state) const;
+
   hal::Allocator* allocator_;
-  mutable kernels::RuntimeState kernel_runtime_state_;
+  HostWorkerPool* worker_pool_;
+  kernels::MathMode math_mode_;
+
+  // Kernel state (such as the matmul context) is not thread-safe, so each
+  // in-flight invocation takes one from this list and returns it when done.
+  mutable absl::Mutex kernel_runtime_state_mutex_;
+  mutable std::vector<std::unique_ptr<kernels::RuntimeState>>
+      free_kernel_runtime_states_ ABSL_GUARDED_BY(kernel_runtime_state_mutex_);
 };
 
 }  // namespace hal
@@ -14,15 +14,17 @@
 
 #include "third_party/mlir_edge/iree/hal/interpreter/interpreter_device.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "third_party/absl/memory/memory.h"
+#include "third_party/absl/strings/str_cat.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/base/tracing.h"
 #include "third_party/mlir_edge/iree/hal/command_buffer_validation.h"
 #include "third_party/mlir_edge/iree/hal/command_queue.h"
 #include "third_party/mlir_edge/iree/hal/fence.h"
-#include "third_party/mlir_edge/iree/hal/host/async_command_queue.h"
+#include "third_party/mlir_edge/iree/hal/host/concurrent_command_queue.h"
 #include "third_party/mlir_edge/iree/hal/host/host_event.h"
 #include "third_party/mlir_edge/iree/hal/host/host_submission_queue.h"
 #include "third_party/mlir_edge/iree/hal/host/inproc_command_buffer.h"
@@ -37,18 +39,22 @@ namespace {
 // A CommandQueue that performs no synchronization (semaphores/fences) and just
 // directly executes command buffers inline.
 //
-// This is meant to be wrapped by SyncCommandQueue or AsyncCommandQueue that
-// themselves perform the synchronization/threading/etc. As such we ignore
+// This is meant to be wrapped by SyncCommandQueue, AsyncCommandQueue, or
+// ConcurrentCommandQueue that themselves perform the
+// synchronization/threading/etc. Submit may be called concurrently as each
+// command buffer is processed with its own processor. As such we ignore
 // all semaphores in the provided batches under the assumption that if Submit is
 // being called then all dependencies are valid. The wrapping queue is also
 // responsible for signaling the fence as well as propagating errors in a way
 // that is dependent on how it is performing its synchronization.
 class UnsynchronizedCommandQueue final : public CommandQueue {
  public:
-  UnsynchronizedCommandQueue(Allocator* allocator, std::string name,
+  UnsynchronizedCommandQueue(Allocator* allocator, HostWorkerPool* worker_pool,
+                             std::string name,
                              CommandCategoryBitfield supported_categories)
       : CommandQueue(std::move(name), supported_categories),
-        allocator_(allocator) {}
+        allocator_(allocator),
+        worker_pool_(worker_pool) {}
   ~UnsynchronizedCommandQueue() override = default;
 
   Status Submit(absl::Span<const SubmissionBatch> batches,
@@ -90,34 +96,50 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
       auto* inproc_command_buffer =
           static_cast<InProcCommandBuffer*>(command_buffer->impl());
       InterpreterCommandProcessor command_processor(
-          allocator_, command_buffer->mode(), supported_categories());
+          allocator_, command_buffer->mode(), supported_categories(),
+          worker_pool_);
       RETURN_IF_ERROR(inproc_command_buffer->Process(&command_processor));
     }
     return OkStatus();
   }
 
   Allocator* const allocator_;
+  // Used to run independent dispatches within a command buffer concurrently.
+  HostWorkerPool* const worker_pool_;
 };
 
+// Returns the worker count to use for the device worker pool.
+int ResolveWorkerCount(const InterpreterDevice::Options& options) {
+  if (options.worker_count >= 0) return options.worker_count;
+  if (options.cpu_affinity.empty()) return HostWorkerPool::DefaultWorkerCount();
+  // The calling thread participates in ParallelFor so one CPU is left for it.
+  return std::max(0, static_cast<int>(options.cpu_affinity.size()) - 1);
+}
+
 }  // namespace
 
-InterpreterDevice::InterpreterDevice(DeviceInfo device_info)
-    : Device(std::move(device_info)) {
-  // We currently only expose a single command queue.
-  auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
-      &allocator_, "cpu0",
-      CommandCategory::kTransfer | CommandCategory::kDispatch);
-  // TODO(benvanik): allow injection of the wrapper type to support
-  // SyncCommandQueue without always linking in both.
-  auto async_command_queue =
-      absl::make_unique<AsyncCommandQueue>(std::move(command_queue));
-  command_queues_.push_back(std::move(async_command_queue));
+InterpreterDevice::InterpreterDevice(DeviceInfo device_info, Options options)
+    : Device(std::move(device_info)),
+      worker_pool_(ResolveWorkerCount(options), options.cpu_affinity),
+      host_task_pool_(/*worker_count=*/1, options.cpu_affinity) {
+  // All queues share the worker pool so that independent submissions from
+  // any queue can run concurrently.
+  for (int i = 0; i < std::max(1, options.dispatch_queue_count); ++i) {
+    auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
+        &allocator_, &worker_pool_, absl::StrCat("cpu", i),
+        CommandCategory::kTransfer | CommandCategory::kDispatch);
+    // TODO(benvanik): allow injection of the wrapper type to support
+    // SyncCommandQueue without always linking in both.
+    auto concurrent_command_queue = absl::make_unique<ConcurrentCommandQueue>(
+        std::move(command_queue), &worker_pool_);
+    command_queues_.push_back(std::move(concurrent_command_queue));
+  }
 }
 
 InterpreterDevice::~InterpreterDevice() = default;
 
 std::shared_ptr<ExecutableCache> InterpreterDevice::CreateExecutableCache() {
-  return std::make_shared<BytecodeCache>(&allocator_);
+  return std::make_shared<BytecodeCache>(&allocator_, &worker_pool_);
 }
 
 StatusOr<ref_ptr<CommandBuffer>> InterpreterDevice::CreateCommandBuffer(
@@ -173,5 +195,10 @@ Status InterpreterDevice::WaitIdle(absl::Time deadline) {
   return OkStatus();
 }
 
+Status InterpreterDevice::ScheduleHostTask(std::function<void()> task) {
+  host_task_pool_.Schedule(std::move(task));
+  return OkStatus();
+}
+
 }  // namespace hal
 }  // namespace iree
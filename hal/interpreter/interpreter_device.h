@@ -15,25 +15,42 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_INTERPRETER_DEVICE_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_INTERPRETER_DEVICE_H_
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include "third_party/absl/container/inlined_vector.h"
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/base/memory.h"
 #include "third_party/mlir_edge/iree/hal/device.h"
 #include "third_party/mlir_edge/iree/hal/host/host_local_allocator.h"
-#include "third_party/mlir_edge/iree/hal/interpreter/bytecode_kernels.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
 
 namespace iree {
 namespace hal {
 
 class InterpreterDevice final : public Device {
  public:
-  explicit InterpreterDevice(DeviceInfo device_info);
+  struct Options {
+    // Number of command queues exposed via dispatch_queues(). Each queue
+    // executes ready submission batches concurrently on the shared worker
+    // pool.
+    int dispatch_queue_count = 1;
+
+    // Number of worker threads used for queue execution and kernel splitting
+    // or -1 to use one per hardware thread (or one per CPU in |cpu_affinity|).
+    int worker_count = -1;
+
+    // Logical CPUs the device worker threads are pinned to. Multiple devices
+    // with disjoint sets (such as one per socket/NUMA node) can be registered
+    // with a DeviceManager to keep each placement's work and memory local.
+    // Empty allows the workers to run on any CPU.
+    std::vector<int> cpu_affinity;
+  };
+
+  InterpreterDevice(DeviceInfo device_info, Options options);
   ~InterpreterDevice() override;
 
-  kernels::RuntimeState* kernel_runtime_state() {
-    return &kernel_runtime_state_;
-  }
-
   Allocator* allocator() const override { return &allocator_; }
 
   absl::Span<CommandQueue*> dispatch_queues() const override {
@@ -65,10 +82,18 @@ class InterpreterDevice final : public Device {
 
   Status WaitIdle(absl::Time deadline) override;
 
+  Status ScheduleHostTask(std::function<void()> task) override;
+
  private:
-  kernels::RuntimeState kernel_runtime_state_;
   mutable HostLocalAllocator allocator_;
+  // Shared by all queues and executables created on this device.
+  HostWorkerPool worker_pool_;
   mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 1> command_queues_;
+  // A single thread pinned like the workers that runs host tasks. Kept apart
+  // from |worker_pool_| so that host tasks blocking on queue submissions never
+  // occupy the workers those submissions execute on. Declared last so that
+  // pending host tasks drain while the queues are still alive.
+  HostWorkerPool host_task_pool_;
 };
 
 }  // namespace hal
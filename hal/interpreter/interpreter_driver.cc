@@ -14,8 +14,11 @@
 
 #include "third_party/mlir_edge/iree/hal/interpreter/interpreter_driver.h"
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 
+#include "third_party/absl/strings/str_cat.h"
 #include "third_party/mlir_edge/iree/hal/device_info.h"
 #include "third_party/mlir_edge/iree/hal/interpreter/interpreter_device.h"
 
@@ -24,37 +27,68 @@ namespace hal {
 
 namespace {
 
-DeviceInfo GetDefaultDeviceInfo() {
-  DeviceFeatureBitfield supported_features = DeviceFeature::kNone;
+DeviceInfo GetDeviceInfo(int device_ordinal, int device_count) {
+  // Commands are processed from the recorded command list on submission so
+  // buffers are only resolved as each command executes.
+  DeviceFeatureBitfield supported_features = DeviceFeature::kDeferredBinding;
   // TODO(benvanik): implement debugging/profiling features.
   // supported_features |= DeviceFeature::kDebugging;
   // supported_features |= DeviceFeature::kCoverage;
   // supported_features |= DeviceFeature::kProfiling;
-  DeviceInfo device_info("interpreter", supported_features);
+  // The ordinal is stashed in the driver handle so that CreateDevice can find
+  // the options for the device. Names are only suffixed when there are
+  // multiple devices to allow placements to select them by name.
+  DeviceInfo device_info(
+      device_count == 1 ? std::string("interpreter")
+                        : absl::StrCat("interpreter:", device_ordinal),
+      supported_features,
+      reinterpret_cast<void*>(static_cast<intptr_t>(device_ordinal)));
   // TODO(benvanik): device info.
   return device_info;
 }
 
 }  // namespace
 
-InterpreterDriver::InterpreterDriver() : Driver("interpreter") {}
+InterpreterDriver::InterpreterDriver(InterpreterDevice::Options device_options)
+    : Driver("interpreter") {
+  device_options_.push_back(std::move(device_options));
+}
+
+InterpreterDriver::InterpreterDriver(
+    std::vector<InterpreterDevice::Options> device_options)
+    : Driver("interpreter"), device_options_(std::move(device_options)) {
+  if (device_options_.empty()) {
+    device_options_.emplace_back();
+  }
+}
 
 InterpreterDriver::~InterpreterDriver() = default;
 
 StatusOr<std::vector<DeviceInfo>>
 InterpreterDriver::EnumerateAvailableDevices() {
   std::vector<DeviceInfo> device_infos;
-  device_infos.push_back(GetDefaultDeviceInfo());
+  int device_count = static_cast<int>(device_options_.size());
+  for (int i = 0; i < device_count; ++i) {
+    device_infos.push_back(GetDeviceInfo(i, device_count));
+  }
   return device_infos;
 }
 
 StatusOr<std::shared_ptr<Device>> InterpreterDriver::CreateDefaultDevice() {
-  return CreateDevice(GetDefaultDeviceInfo());
+  return CreateDevice(GetDeviceInfo(0, device_options_.size()));
 }
 
 StatusOr<std::shared_ptr<Device>> InterpreterDriver::CreateDevice(
     const DeviceInfo& device_info) {
-  auto device = std::make_shared<InterpreterDevice>(device_info);
+  auto device_ordinal =
+      static_cast<int>(reinterpret_cast<intptr_t>(device_info.driver_handle()));
+  if (device_ordinal < 0 || device_ordinal >= device_options_.size()) {
+    return NotFoundErrorBuilder(ABSL_LOC)
+           << "Device " << device_info.name()
+           << " was not enumerated by this driver";
+  }
+  auto device = std::make_shared<InterpreterDevice>(
+      device_info, device_options_[device_ordinal]);
   return device;
 }
 
@@ -15,14 +15,21 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_INTERPRETER_DRIVER_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_HAL_INTERPRETER_INTERPRETER_DRIVER_H_
 
+#include <vector>
+
 #include "third_party/mlir_edge/iree/hal/driver.h"
+#include "third_party/mlir_edge/iree/hal/interpreter/interpreter_device.h"
 
 namespace iree {
 namespace hal {
 
 class InterpreterDriver final : public Driver {
  public:
-  InterpreterDriver();
+  explicit InterpreterDriver(InterpreterDevice::Options device_options);
+  // Exposes one device per entry in |device_options|, such as one per socket
+  // with distinct InterpreterDevice::Options::cpu_affinity sets.
+  explicit InterpreterDriver(
+      std::vector<InterpreterDevice::Options> device_options);
   ~InterpreterDriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -31,6 +38,9 @@ class InterpreterDriver final : public Driver {
 
   StatusOr<std::shared_ptr<Device>> CreateDevice(
       const DeviceInfo& device_info) override;
+
+ private:
+  std::vector<InterpreterDevice::Options> device_options_;
 };
 
 }  // namespace hal
@@ -13,17 +13,54 @@
 // limitations under the License.
 
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "third_party/absl/flags/flag.h"
+#include "third_party/absl/strings/str_split.h"
 #include "third_party/mlir_edge/iree/base/init.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/hal/driver_registry.h"
+#include "third_party/mlir_edge/iree/hal/host/host_worker_pool.h"
 #include "third_party/mlir_edge/iree/hal/interpreter/interpreter_driver.h"
 
+ABSL_FLAG(int32_t, interpreter_dispatch_queue_count, 1,
+          "Number of dispatch queues exposed by each interpreter device.");
+ABSL_FLAG(int32_t, interpreter_worker_count, -1,
+          "Number of worker threads used by each interpreter device to run "
+          "submissions and split kernels; -1 uses one per hardware thread.");
+ABSL_FLAG(std::string, interpreter_device_cpu_sets, "",
+          "Semicolon-separated CPU sets with one interpreter device created "
+          "per set and its workers pinned to those CPUs, such as "
+          "'0-15;16-31' for one device per socket. Empty creates a single "
+          "unpinned device.");
+
 namespace iree {
 namespace hal {
 
 StatusOr<std::shared_ptr<Driver>> CreateInterpreterDriver() {
-  return std::make_shared<InterpreterDriver>();
+  // Setup device options from flags. We do this here as we want to enable
+  // other consumers that may not be using modules/command line flags to be able
+  // to set their options however they want.
+  InterpreterDevice::Options device_options;
+  device_options.dispatch_queue_count =
+      absl::GetFlag(FLAGS_interpreter_dispatch_queue_count);
+  device_options.worker_count = absl::GetFlag(FLAGS_interpreter_worker_count);
+
+  // One device per CPU set, if any are specified.
+  std::vector<InterpreterDevice::Options> per_device_options;
+  for (absl::string_view cpu_set_string :
+       absl::StrSplit(absl::GetFlag(FLAGS_interpreter_device_cpu_sets), ';',
+                      absl::SkipWhitespace())) {
+    per_device_options.push_back(device_options);
+    ASSIGN_OR_RETURN(per_device_options.back().cpu_affinity,
+                     HostWorkerPool::ParseCpuSet(cpu_set_string));
+  }
+  if (per_device_options.empty()) {
+    per_device_options.push_back(device_options);
+  }
+  return std::make_shared<InterpreterDriver>(std::move(per_device_options));
 }
 
 }  // namespace hal
@@ -58,6 +58,10 @@ class MockCommandBuffer : public ::testing::StrictMock<CommandBuffer> {
                       device_size_t length, const void* pattern,
                       size_t pattern_length));
 
+  MOCK_METHOD4(FillBufferIndirect,
+               Status(Buffer* target_buffer, Buffer* value_buffer,
+                      Buffer* offset_buffer, Buffer* length_buffer));
+
   MOCK_METHOD1(DiscardBuffer, Status(Buffer* buffer));
 
   MOCK_METHOD5(UpdateBuffer,
@@ -295,6 +295,16 @@ Status DirectCommandBuffer::FillBuffer(Buffer* target_buffer,
   return OkStatus();
 }
 
+Status DirectCommandBuffer::FillBufferIndirect(Buffer* target_buffer,
+                                               Buffer* value_buffer,
+                                               Buffer* offset_buffer,
+                                               Buffer* length_buffer) {
+  // vkCmdFillBuffer takes its parameters from the host and there is no
+  // builtin fill shader to source them from device memory.
+  return UnimplementedErrorBuilder(ABSL_LOC)
+         << "Indirect fills are not supported by the Vulkan backend";
+}
+
 Status DirectCommandBuffer::DiscardBuffer(Buffer* buffer) {
   IREE_TRACE_SCOPE0("DirectCommandBuffer::DiscardBuffer");
   // NOTE: we could use this to prevent queue family transitions.
@@ -446,8 +456,17 @@ Status DirectCommandBuffer::Dispatch(const DispatchRequest& dispatch_request) {
   // TODO(benvanik): divide workload by caps and issue multiple dispatches.
   // TODO(benvanik): track local workgroup/subgroup size and divide into groups.
   if (dispatch_request.workload_buffer) {
-    return UnimplementedErrorBuilder(ABSL_LOC)
-           << "Dynamic dispatches not yet implemented";
+    // The workload buffer layout matches VkDispatchIndirectCommand.
+    if (executable->is_matmul()) {
+      return UnimplementedErrorBuilder(ABSL_LOC)
+             << "Dynamic matmul dispatches not yet implemented";
+    }
+    ASSIGN_OR_RETURN(auto* workload_device_buffer,
+                     CastBuffer(dispatch_request.workload_buffer));
+    syms()->vkCmdDispatchIndirect(
+        command_buffer_, workload_device_buffer->handle(),
+        dispatch_request.workload_buffer->byte_offset());
+    return OkStatus();
   }
   uint32_t group_count_x = dispatch_request.workload[0];
   uint32_t group_count_y = dispatch_request.workload[1];
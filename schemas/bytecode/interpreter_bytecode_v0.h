@@ -47,8 +47,8 @@ namespace iree {
   OPC(0x07, kCmpI, "cmp_i", FLAG(kDefault), "psso", FF)                       \
   OPC(0x08, kCmpF, "cmp_f", FLAG(kDefault), "Psso", FF)                       \
                                                                               \
-  RSV(0x09, RESERVED_OPC)                                                     \
-  RSV(0x0A, RESERVED_OPC)                                                     \
+  OPC(0x09, kCmpSelectI, "cmp_select_i", FLAG(kDefault), "psssso", FF)        \
+  OPC(0x0A, kCmpSelectF, "cmp_select_f", FLAG(kDefault), "Psssso", FF)        \
   RSV(0x0B, RESERVED_OPC)                                                     \
   RSV(0x0C, RESERVED_OPC)                                                     \
   RSV(0x0D, RESERVED_OPC)                                                     \
@@ -179,7 +179,7 @@ namespace iree {
   OPC(0x82, kLogF, "log_f", FLAG(kDefault), "so", FF)                         \
   OPC(0x83, kRsqrtF, "rsqrt_f", FLAG(kDefault), "so", FF)                     \
                                                                               \
-  RSV(0x84, RESERVED_OPC)                                                     \
+  OPC(0x84, kAddMaxF, "add_max_f", FLAG(kDefault), "ssso", FF)                \
   RSV(0x85, RESERVED_OPC)                                                     \
   RSV(0x86, RESERVED_OPC)                                                     \
   RSV(0x87, RESERVED_OPC)                                                     \
@@ -224,7 +224,7 @@ namespace iree {
   OPC(0xA5, kReduceMinF, "reduce_min_f", FLAG(kDefault), "ssio", FF)          \
   OPC(0xA6, kReduceMaxI, "reduce_max_i", FLAG(kDefault), "ssio", FF)          \
   OPC(0xA7, kReduceMaxF, "reduce_max_f", FLAG(kDefault), "ssio", FF)          \
-  RSV(0xA8, RESERVED_OPC)                                                     \
+  OPC(0xA8, kMatMulBiasF, "matmul_bias_f", FLAG(kDefault), "ssssso", FF)      \
   RSV(0xA9, RESERVED_OPC)                                                     \
   RSV(0xAA, RESERVED_OPC)                                                     \
   RSV(0xAB, RESERVED_OPC)                                                     \
@@ -0,0 +1,17 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --input_values="2x4xf32=[1 2 3 4 5 6 7 8]" --output_types=f | FileCheck %s --dump-input=fail
+
+// The intermediate add and reduce results are transient and are packed into a
+// slab and serialized as static_slice views of it.
+// CHECK-LABEL: EXEC @transient_buffers
+func @transient_buffers(%arg0 : tensor<2x4xf32>) -> tensor<2xf32> {
+  %0 = "xla_hlo.add"(%arg0, %arg0) : (tensor<2x4xf32>, tensor<2x4xf32>) -> tensor<2x4xf32>
+  %1 = constant dense<0.0> : tensor<f32>
+  %2 = "xla_hlo.reduce"(%0, %1) ( {
+  ^bb0(%arg1: tensor<f32>, %arg2: tensor<f32>):   // no predecessors
+    %4 = "xla_hlo.add"(%arg1, %arg2) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+    "xla_hlo.return"(%4) : (tensor<f32>) -> ()
+  }) {dimensions = dense<1> : tensor<1xi64>} : (tensor<2x4xf32>, tensor<f32>) -> tensor<2xf32>
+  %3 = "xla_hlo.mul"(%2, %2) : (tensor<2xf32>, tensor<2xf32>) -> tensor<2xf32>
+  return %3 : tensor<2xf32>
+}
+// CHECK: 2xf32=400 2704
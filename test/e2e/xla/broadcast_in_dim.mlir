@@ -0,0 +1,63 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --output_types=i | FileCheck %s --dump-input=fail
+
+// Broadcasts of non-scalar values are lowered to a reshape followed by a tile.
+
+// Repeats the whole source.
+// CHECK-LABEL: EXEC @broadcast_rows
+func @broadcast_rows() -> tensor<2x3xi32> {
+  %input = constant dense<[1, 2, 3]> : tensor<3xi32>
+  %result = "xla_hlo.broadcast_in_dim"(%input) {broadcast_dimensions = dense<[1]> : tensor<1xi64>} : (tensor<3xi32>) -> tensor<2x3xi32>
+  return %result : tensor<2x3xi32>
+}
+// CHECK: 2x3xi32=[1 2 3][1 2 3]
+
+// -----
+
+// Repeats each element along the innermost dimension.
+// CHECK-LABEL: EXEC @broadcast_columns
+func @broadcast_columns() -> tensor<3x4xi32> {
+  %input = constant dense<[1, 2, 3]> : tensor<3xi32>
+  %result = "xla_hlo.broadcast_in_dim"(%input) {broadcast_dimensions = dense<[0]> : tensor<1xi64>} : (tensor<3xi32>) -> tensor<3x4xi32>
+  return %result : tensor<3x4xi32>
+}
+// CHECK: 3x4xi32=[1 1 1 1][2 2 2 2][3 3 3 3]
+
+// -----
+
+// CHECK-LABEL: EXEC @broadcast_3d_outer
+func @broadcast_3d_outer() -> tensor<4x2x3xi32> {
+  %input = constant dense<[[1, 2, 3], [4, 5, 6]]> : tensor<2x3xi32>
+  %result = "xla_hlo.broadcast_in_dim"(%input) {broadcast_dimensions = dense<[1, 2]> : tensor<2xi64>} : (tensor<2x3xi32>) -> tensor<4x2x3xi32>
+  return %result : tensor<4x2x3xi32>
+}
+// CHECK: 4x2x3xi32=[[1 2 3][4 5 6]][[1 2 3][4 5 6]][[1 2 3][4 5 6]][[1 2 3][4 5 6]]
+
+// -----
+
+// CHECK-LABEL: EXEC @broadcast_3d_middle
+func @broadcast_3d_middle() -> tensor<2x4x3xi32> {
+  %input = constant dense<[[1, 2, 3], [4, 5, 6]]> : tensor<2x3xi32>
+  %result = "xla_hlo.broadcast_in_dim"(%input) {broadcast_dimensions = dense<[0, 2]> : tensor<2xi64>} : (tensor<2x3xi32>) -> tensor<2x4x3xi32>
+  return %result : tensor<2x4x3xi32>
+}
+// CHECK: 2x4x3xi32=[[1 2 3][1 2 3][1 2 3][1 2 3]][[4 5 6][4 5 6][4 5 6][4 5 6]]
+
+// -----
+
+// CHECK-LABEL: EXEC @broadcast_3d_inner
+func @broadcast_3d_inner() -> tensor<2x3x2xi32> {
+  %input = constant dense<[[1, 2, 3], [4, 5, 6]]> : tensor<2x3xi32>
+  %result = "xla_hlo.broadcast_in_dim"(%input) {broadcast_dimensions = dense<[0, 1]> : tensor<2xi64>} : (tensor<2x3xi32>) -> tensor<2x3x2xi32>
+  return %result : tensor<2x3x2xi32>
+}
+// CHECK: 2x3x2xi32=[[1 1][2 2][3 3]][[4 4][5 5][6 6]]
+
+// -----
+
+// CHECK-LABEL: EXEC @broadcast_3d_outer_and_inner
+func @broadcast_3d_outer_and_inner() -> tensor<2x3x2xi32> {
+  %input = constant dense<[1, 2, 3]> : tensor<3xi32>
+  %result = "xla_hlo.broadcast_in_dim"(%input) {broadcast_dimensions = dense<[1]> : tensor<1xi64>} : (tensor<3xi32>) -> tensor<2x3x2xi32>
+  return %result : tensor<2x3x2xi32>
+}
+// CHECK: 2x3x2xi32=[[1 1][2 2][3 3]][[1 1][2 2][3 3]]
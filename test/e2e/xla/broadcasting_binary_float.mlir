@@ -0,0 +1,57 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --input_values="2x3xf32=[1 2 3][4 5 6]" --output_types=f | FileCheck %s --dump-input=fail
+
+// Binary ops with a broadcast_in_dim operand read the broadcast source with a
+// stride of 0 instead of materializing the broadcast.
+
+// CHECK-LABEL: EXEC @add_row
+func @add_row(%arg : tensor<2x3xf32>) -> tensor<2x3xf32> {
+  %row = constant dense<[10.0, 20.0, 30.0]> : tensor<3xf32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%row) {broadcast_dimensions = dense<[1]> : tensor<1xi64>} : (tensor<3xf32>) -> tensor<2x3xf32>
+  %result = "xla_hlo.add"(%arg, %broadcast) : (tensor<2x3xf32>, tensor<2x3xf32>) -> tensor<2x3xf32>
+  return %result : tensor<2x3xf32>
+}
+// CHECK: 2x3xf32=[11 22 33][14 25 36]
+
+// -----
+
+// CHECK-LABEL: EXEC @sub_column
+func @sub_column(%arg : tensor<2x3xf32>) -> tensor<2x3xf32> {
+  %column = constant dense<[10.0, 20.0]> : tensor<2xf32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%column) {broadcast_dimensions = dense<[0]> : tensor<1xi64>} : (tensor<2xf32>) -> tensor<2x3xf32>
+  %result = "xla_hlo.sub"(%broadcast, %arg) : (tensor<2x3xf32>, tensor<2x3xf32>) -> tensor<2x3xf32>
+  return %result : tensor<2x3xf32>
+}
+// CHECK: 2x3xf32=[9 8 7][16 15 14]
+
+// -----
+
+// CHECK-LABEL: EXEC @mul_scalar
+func @mul_scalar(%arg : tensor<2x3xf32>) -> tensor<2x3xf32> {
+  %scalar = constant dense<2.5> : tensor<f32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%scalar) : (tensor<f32>) -> tensor<2x3xf32>
+  %result = "xla_hlo.mul"(%arg, %broadcast) : (tensor<2x3xf32>, tensor<2x3xf32>) -> tensor<2x3xf32>
+  return %result : tensor<2x3xf32>
+}
+// CHECK: 2x3xf32=[2.5 5 7.5][10 12.5 15]
+
+// -----
+
+// CHECK-LABEL: EXEC @div_row
+func @div_row(%arg : tensor<2x3xf32>) -> tensor<2x3xf32> {
+  %row = constant dense<[2.0, 4.0, 8.0]> : tensor<3xf32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%row) {broadcast_dimensions = dense<[1]> : tensor<1xi64>} : (tensor<3xf32>) -> tensor<2x3xf32>
+  %result = "xla_hlo.div"(%arg, %broadcast) : (tensor<2x3xf32>, tensor<2x3xf32>) -> tensor<2x3xf32>
+  return %result : tensor<2x3xf32>
+}
+// CHECK: 2x3xf32=[0.5 0.5 0.375][2 1.25 0.75]
+
+// -----
+
+// CHECK-LABEL: EXEC @max_column
+func @max_column(%arg : tensor<2x3xf32>) -> tensor<2x3xf32> {
+  %column = constant dense<[2.0, 5.0]> : tensor<2xf32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%column) {broadcast_dimensions = dense<[0]> : tensor<1xi64>} : (tensor<2xf32>) -> tensor<2x3xf32>
+  %result = "xla_hlo.max"(%arg, %broadcast) : (tensor<2x3xf32>, tensor<2x3xf32>) -> tensor<2x3xf32>
+  return %result : tensor<2x3xf32>
+}
+// CHECK: 2x3xf32=[2 2 3][5 5 6]
@@ -0,0 +1,56 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --input_values="2x3xi32=[7 -8 9][10 11 -12]" --output_types=i | FileCheck %s --dump-input=fail
+
+// Integer division truncates toward zero for every broadcast element.
+
+// CHECK-LABEL: EXEC @div_row
+func @div_row(%arg : tensor<2x3xi32>) -> tensor<2x3xi32> {
+  %row = constant dense<[2, 3, -4]> : tensor<3xi32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%row) {broadcast_dimensions = dense<[1]> : tensor<1xi64>} : (tensor<3xi32>) -> tensor<2x3xi32>
+  %result = "xla_hlo.div"(%arg, %broadcast) : (tensor<2x3xi32>, tensor<2x3xi32>) -> tensor<2x3xi32>
+  return %result : tensor<2x3xi32>
+}
+// CHECK: 2x3xi32=[3 -2 -2][5 3 3]
+
+// -----
+
+// CHECK-LABEL: EXEC @div_column
+func @div_column(%arg : tensor<2x3xi32>) -> tensor<2x3xi32> {
+  %column = constant dense<[100, -60]> : tensor<2xi32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%column) {broadcast_dimensions = dense<[0]> : tensor<1xi64>} : (tensor<2xi32>) -> tensor<2x3xi32>
+  %result = "xla_hlo.div"(%broadcast, %arg) : (tensor<2x3xi32>, tensor<2x3xi32>) -> tensor<2x3xi32>
+  return %result : tensor<2x3xi32>
+}
+// CHECK: 2x3xi32=[14 -12 11][-6 -5 5]
+
+// -----
+
+// CHECK-LABEL: EXEC @div_scalar
+func @div_scalar(%arg : tensor<2x3xi32>) -> tensor<2x3xi32> {
+  %scalar = constant dense<-3> : tensor<i32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%scalar) : (tensor<i32>) -> tensor<2x3xi32>
+  %result = "xla_hlo.div"(%arg, %broadcast) : (tensor<2x3xi32>, tensor<2x3xi32>) -> tensor<2x3xi32>
+  return %result : tensor<2x3xi32>
+}
+// CHECK: 2x3xi32=[-2 2 -3][-3 -3 4]
+
+// -----
+
+// CHECK-LABEL: EXEC @add_scalar
+func @add_scalar(%arg : tensor<2x3xi32>) -> tensor<2x3xi32> {
+  %scalar = constant dense<5> : tensor<i32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%scalar) : (tensor<i32>) -> tensor<2x3xi32>
+  %result = "xla_hlo.add"(%broadcast, %arg) : (tensor<2x3xi32>, tensor<2x3xi32>) -> tensor<2x3xi32>
+  return %result : tensor<2x3xi32>
+}
+// CHECK: 2x3xi32=[12 -3 14][15 16 -7]
+
+// -----
+
+// CHECK-LABEL: EXEC @mul_row
+func @mul_row(%arg : tensor<2x3xi32>) -> tensor<2x3xi32> {
+  %row = constant dense<[1, 2, 3]> : tensor<3xi32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%row) {broadcast_dimensions = dense<[1]> : tensor<1xi64>} : (tensor<3xi32>) -> tensor<2x3xi32>
+  %result = "xla_hlo.mul"(%arg, %broadcast) : (tensor<2x3xi32>, tensor<2x3xi32>) -> tensor<2x3xi32>
+  return %result : tensor<2x3xi32>
+}
+// CHECK: 2x3xi32=[7 -16 27][10 22 -36]
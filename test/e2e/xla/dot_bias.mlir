@@ -0,0 +1,31 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --input_values="4x2xf32=[inf 1][-inf 1][3e+38 1][1 2]" --output_types=f | FileCheck %s --dump-input=fail
+
+// A dot followed by a bias add (and relu) is fused into matmul_bias_f. The
+// bias applies per column and infinities, including ones produced by
+// overflow, pass through the unbounded clamp.
+
+// CHECK-LABEL: EXEC @dot_bias
+func @dot_bias(%arg : tensor<4x2xf32>) -> tensor<4x2xf32> {
+  %weights = constant dense<[[2.0, 1.0], [1.0, 2.0]]> : tensor<2x2xf32>
+  %bias = constant dense<[1.0, 2.0]> : tensor<2xf32>
+  %dot = "xla_hlo.dot"(%arg, %weights) : (tensor<4x2xf32>, tensor<2x2xf32>) -> tensor<4x2xf32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%bias) {broadcast_dimensions = dense<[1]> : tensor<1xi64>} : (tensor<2xf32>) -> tensor<4x2xf32>
+  %result = "xla_hlo.add"(%dot, %broadcast) : (tensor<4x2xf32>, tensor<4x2xf32>) -> tensor<4x2xf32>
+  return %result : tensor<4x2xf32>
+}
+// CHECK: 4x2xf32=[inf inf][-inf -inf][inf 3e+38][5 7]
+
+// -----
+
+// CHECK-LABEL: EXEC @dot_bias_relu
+func @dot_bias_relu(%arg : tensor<4x2xf32>) -> tensor<4x2xf32> {
+  %weights = constant dense<[[2.0, 1.0], [1.0, 2.0]]> : tensor<2x2xf32>
+  %bias = constant dense<[1.0, 2.0]> : tensor<2xf32>
+  %zero = constant dense<0.0> : tensor<4x2xf32>
+  %dot = "xla_hlo.dot"(%arg, %weights) : (tensor<4x2xf32>, tensor<2x2xf32>) -> tensor<4x2xf32>
+  %broadcast = "xla_hlo.broadcast_in_dim"(%bias) {broadcast_dimensions = dense<[1]> : tensor<1xi64>} : (tensor<2xf32>) -> tensor<4x2xf32>
+  %biased = "xla_hlo.add"(%dot, %broadcast) : (tensor<4x2xf32>, tensor<4x2xf32>) -> tensor<4x2xf32>
+  %result = "xla_hlo.max"(%biased, %zero) : (tensor<4x2xf32>, tensor<4x2xf32>) -> tensor<4x2xf32>
+  return %result : tensor<4x2xf32>
+}
+// CHECK: 4x2xf32=[inf inf][0 0][inf 3e+38][5 7]
@@ -0,0 +1,92 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --output_types=f | FileCheck %s --dump-input=fail
+
+// Lengths are chosen so that every vector width (4, 8 and 16 lanes) leaves a
+// partial tail that must be handled without touching neighboring elements.
+
+// CHECK-LABEL: EXEC @add_19xf32
+func @add_19xf32() -> tensor<19xf32> {
+  %lhs = constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0]> : tensor<19xf32>
+  %rhs = constant dense<[19.0, 18.0, 17.0, 16.0, 15.0, 14.0, 13.0, 12.0, 11.0, 10.0, 9.0, 8.0, 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0]> : tensor<19xf32>
+  %result = "xla_hlo.add"(%lhs, %rhs) : (tensor<19xf32>, tensor<19xf32>) -> tensor<19xf32>
+  return %result : tensor<19xf32>
+}
+// CHECK: 19xf32=20 20 20 20 20 20 20 20 20 20 20 20 20 20 20 20 20 20 20
+
+// -----
+
+// CHECK-LABEL: EXEC @sub_19xf32
+func @sub_19xf32() -> tensor<19xf32> {
+  %lhs = constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0]> : tensor<19xf32>
+  %rhs = constant dense<[19.0, 18.0, 17.0, 16.0, 15.0, 14.0, 13.0, 12.0, 11.0, 10.0, 9.0, 8.0, 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0]> : tensor<19xf32>
+  %result = "xla_hlo.sub"(%lhs, %rhs) : (tensor<19xf32>, tensor<19xf32>) -> tensor<19xf32>
+  return %result : tensor<19xf32>
+}
+// CHECK: 19xf32=-18 -16 -14 -12 -10 -8 -6 -4 -2 0 2 4 6 8 10 12 14 16 18
+
+// -----
+
+// CHECK-LABEL: EXEC @mul_19xf32
+func @mul_19xf32() -> tensor<19xf32> {
+  %lhs = constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0]> : tensor<19xf32>
+  %rhs = constant dense<[19.0, 18.0, 17.0, 16.0, 15.0, 14.0, 13.0, 12.0, 11.0, 10.0, 9.0, 8.0, 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0]> : tensor<19xf32>
+  %result = "xla_hlo.mul"(%lhs, %rhs) : (tensor<19xf32>, tensor<19xf32>) -> tensor<19xf32>
+  return %result : tensor<19xf32>
+}
+// CHECK: 19xf32=19 36 51 64 75 84 91 96 99 100 99 96 91 84 75 64 51 36 19
+
+// -----
+
+// CHECK-LABEL: EXEC @div_19xf32
+func @div_19xf32() -> tensor<19xf32> {
+  %lhs = constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0]> : tensor<19xf32>
+  %rhs = constant dense<2.0> : tensor<19xf32>
+  %result = "xla_hlo.div"(%lhs, %rhs) : (tensor<19xf32>, tensor<19xf32>) -> tensor<19xf32>
+  return %result : tensor<19xf32>
+}
+// CHECK: 19xf32=0.5 1 1.5 2 2.5 3 3.5 4 4.5 5 5.5 6 6.5 7 7.5 8 8.5 9 9.5
+
+// -----
+
+// CHECK-LABEL: EXEC @max_19xf32
+func @max_19xf32() -> tensor<19xf32> {
+  %lhs = constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0]> : tensor<19xf32>
+  %rhs = constant dense<[19.0, 18.0, 17.0, 16.0, 15.0, 14.0, 13.0, 12.0, 11.0, 10.0, 9.0, 8.0, 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0]> : tensor<19xf32>
+  %result = "xla_hlo.max"(%lhs, %rhs) : (tensor<19xf32>, tensor<19xf32>) -> tensor<19xf32>
+  return %result : tensor<19xf32>
+}
+// CHECK: 19xf32=19 18 17 16 15 14 13 12 11 10 11 12 13 14 15 16 17 18 19
+
+// -----
+
+// CHECK-LABEL: EXEC @min_19xf32
+func @min_19xf32() -> tensor<19xf32> {
+  %lhs = constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0]> : tensor<19xf32>
+  %rhs = constant dense<[19.0, 18.0, 17.0, 16.0, 15.0, 14.0, 13.0, 12.0, 11.0, 10.0, 9.0, 8.0, 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0]> : tensor<19xf32>
+  %result = "xla_hlo.min"(%lhs, %rhs) : (tensor<19xf32>, tensor<19xf32>) -> tensor<19xf32>
+  return %result : tensor<19xf32>
+}
+// CHECK: 19xf32=1 2 3 4 5 6 7 8 9 10 9 8 7 6 5 4 3 2 1
+
+// -----
+
+// CHECK-LABEL: EXEC @select_19xf32
+func @select_19xf32() -> tensor<19xf32> {
+  %lhs = constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0]> : tensor<19xf32>
+  %rhs = constant dense<[19.0, 18.0, 17.0, 16.0, 15.0, 14.0, 13.0, 12.0, 11.0, 10.0, 9.0, 8.0, 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0]> : tensor<19xf32>
+  %cond = "xla_hlo.compare"(%lhs, %rhs) {comparison_direction = "LT"} : (tensor<19xf32>, tensor<19xf32>) -> tensor<19xi1>
+  %result = "xla_hlo.select"(%cond, %lhs, %rhs) : (tensor<19xi1>, tensor<19xf32>, tensor<19xf32>) -> tensor<19xf32>
+  return %result : tensor<19xf32>
+}
+// CHECK: 19xf32=1 2 3 4 5 6 7 8 9 10 9 8 7 6 5 4 3 2 1
+
+// -----
+
+// Shorter than any vector width.
+// CHECK-LABEL: EXEC @add_3xf32
+func @add_3xf32() -> tensor<3xf32> {
+  %lhs = constant dense<[1.0, 2.0, 3.0]> : tensor<3xf32>
+  %rhs = constant dense<[10.0, 20.0, 30.0]> : tensor<3xf32>
+  %result = "xla_hlo.add"(%lhs, %rhs) : (tensor<3xf32>, tensor<3xf32>) -> tensor<3xf32>
+  return %result : tensor<3xf32>
+}
+// CHECK: 3xf32=11 22 33
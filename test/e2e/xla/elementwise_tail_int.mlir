@@ -0,0 +1,57 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --output_types=i | FileCheck %s --dump-input=fail
+
+// Lengths are chosen so that every vector width (4, 8 and 16 lanes) leaves a
+// partial tail that must be handled without touching neighboring elements.
+
+// CHECK-LABEL: EXEC @add_19xi32
+func @add_19xi32() -> tensor<19xi32> {
+  %lhs = constant dense<[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19]> : tensor<19xi32>
+  %rhs = constant dense<[19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1]> : tensor<19xi32>
+  %result = "xla_hlo.add"(%lhs, %rhs) : (tensor<19xi32>, tensor<19xi32>) -> tensor<19xi32>
+  return %result : tensor<19xi32>
+}
+// CHECK: 19xi32=20 20 20 20 20 20 20 20 20 20 20 20 20 20 20 20 20 20 20
+
+// -----
+
+// CHECK-LABEL: EXEC @sub_19xi32
+func @sub_19xi32() -> tensor<19xi32> {
+  %lhs = constant dense<[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19]> : tensor<19xi32>
+  %rhs = constant dense<[19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1]> : tensor<19xi32>
+  %result = "xla_hlo.sub"(%lhs, %rhs) : (tensor<19xi32>, tensor<19xi32>) -> tensor<19xi32>
+  return %result : tensor<19xi32>
+}
+// CHECK: 19xi32=-18 -16 -14 -12 -10 -8 -6 -4 -2 0 2 4 6 8 10 12 14 16 18
+
+// -----
+
+// CHECK-LABEL: EXEC @mul_19xi32
+func @mul_19xi32() -> tensor<19xi32> {
+  %lhs = constant dense<[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19]> : tensor<19xi32>
+  %rhs = constant dense<[19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1]> : tensor<19xi32>
+  %result = "xla_hlo.mul"(%lhs, %rhs) : (tensor<19xi32>, tensor<19xi32>) -> tensor<19xi32>
+  return %result : tensor<19xi32>
+}
+// CHECK: 19xi32=19 36 51 64 75 84 91 96 99 100 99 96 91 84 75 64 51 36 19
+
+// -----
+
+// CHECK-LABEL: EXEC @max_19xi32
+func @max_19xi32() -> tensor<19xi32> {
+  %lhs = constant dense<[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19]> : tensor<19xi32>
+  %rhs = constant dense<[19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1]> : tensor<19xi32>
+  %result = "xla_hlo.max"(%lhs, %rhs) : (tensor<19xi32>, tensor<19xi32>) -> tensor<19xi32>
+  return %result : tensor<19xi32>
+}
+// CHECK: 19xi32=19 18 17 16 15 14 13 12 11 10 11 12 13 14 15 16 17 18 19
+
+// -----
+
+// CHECK-LABEL: EXEC @min_19xi32
+func @min_19xi32() -> tensor<19xi32> {
+  %lhs = constant dense<[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19]> : tensor<19xi32>
+  %rhs = constant dense<[19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1]> : tensor<19xi32>
+  %result = "xla_hlo.min"(%lhs, %rhs) : (tensor<19xi32>, tensor<19xi32>) -> tensor<19xi32>
+  return %result : tensor<19xi32>
+}
+// CHECK: 19xi32=1 2 3 4 5 6 7 8 9 10 9 8 7 6 5 4 3 2 1
@@ -0,0 +1,41 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --output_types=f -- -iree-interpreter-fast-math | FileCheck %s --dump-input=fail
+
+// Fast-math kernels are approximations, so only the leading digits are checked.
+
+// CHECK-LABEL: EXEC @exp
+func @exp() -> tensor<5xf32> {
+  %input = constant dense<[0.5, 1.0, 2.0, -1.0, 4.0]> : tensor<5xf32>
+  %result = "xla_hlo.exp"(%input) : (tensor<5xf32>) -> tensor<5xf32>
+  return %result : tensor<5xf32>
+}
+// CHECK: 5xf32=1.6487{{[0-9]}} 2.7182{{[0-9]}} 7.3890{{[0-9]}} 0.36787{{[0-9]}} 54.598{{[0-9]}}
+
+// -----
+
+// CHECK-LABEL: EXEC @log
+func @log() -> tensor<4xf32> {
+  %input = constant dense<[0.5, 2.0, 10.0, 100.0]> : tensor<4xf32>
+  %result = "xla_hlo.log"(%input) : (tensor<4xf32>) -> tensor<4xf32>
+  return %result : tensor<4xf32>
+}
+// CHECK: 4xf32=-0.69314{{[0-9]}} 0.69314{{[0-9]}} 2.3025{{[0-9]}} 4.6051{{[0-9]}}
+
+// -----
+
+// CHECK-LABEL: EXEC @tanh
+func @tanh() -> tensor<5xf32> {
+  %input = constant dense<[-2.0, -0.5, 0.25, 1.0, 3.0]> : tensor<5xf32>
+  %result = "xla_hlo.tanh"(%input) : (tensor<5xf32>) -> tensor<5xf32>
+  return %result : tensor<5xf32>
+}
+// CHECK: 5xf32=-0.96402{{[0-9]}} -0.46211{{[0-9]}} 0.24491{{[0-9]}} 0.76159{{[0-9]}} 0.99505{{[0-9]}}
+
+// -----
+
+// CHECK-LABEL: EXEC @rsqrt
+func @rsqrt() -> tensor<4xf32> {
+  %input = constant dense<[2.0, 3.0, 10.0, 0.25]> : tensor<4xf32>
+  %result = "xla_hlo.rsqrt"(%input) : (tensor<4xf32>) -> tensor<4xf32>
+  return %result : tensor<4xf32>
+}
+// CHECK: 4xf32=0.70710{{[0-9]}} 0.57735{{[0-9]?}} 0.31622{{[0-9]}} 2
@@ -10,3 +10,57 @@ func @pad(%arg : tensor<2x3xi32>) -> tensor<3x6xi32> {
 // CHECK-SAME:     [0 1 2 3 0 0]
 // CHECK-SAME:     [0 4 5 6 0 0]
 // CHECK-SAME:     [0 0 0 0 0 0]
+
+// -----
+
+// Negative edge padding crops the source.
+// CHECK-LABEL: EXEC @pad_negative_edges
+func @pad_negative_edges(%arg : tensor<2x3xi32>) -> tensor<2x1xi32> {
+  %pad_val = constant dense<0> : tensor<i32>
+  %result = "xla_hlo.pad"(%arg, %pad_val) {interior_padding = dense<[0, 0]> : tensor<2xi64>, edge_padding_low = dense<[0, -1]> : tensor<2xi64>, edge_padding_high = dense<[0, -1]> : tensor<2xi64>} : (tensor<2x3xi32>, tensor<i32>) -> tensor<2x1xi32>
+  return %result : tensor<2x1xi32>
+}
+// CHECK-NEXT: 2x1xi32=[2][5]
+
+// -----
+
+// CHECK-LABEL: EXEC @pad_negative_low_positive_high
+func @pad_negative_low_positive_high(%arg : tensor<2x3xi32>) -> tensor<2x3xi32> {
+  %pad_val = constant dense<0> : tensor<i32>
+  %result = "xla_hlo.pad"(%arg, %pad_val) {interior_padding = dense<[0, 0]> : tensor<2xi64>, edge_padding_low = dense<[-1, -2]> : tensor<2xi64>, edge_padding_high = dense<[1, 2]> : tensor<2xi64>} : (tensor<2x3xi32>, tensor<i32>) -> tensor<2x3xi32>
+  return %result : tensor<2x3xi32>
+}
+// CHECK-NEXT: 2x3xi32=[6 0 0][0 0 0]
+
+// -----
+
+// Interior padding inserts padding between elements.
+// CHECK-LABEL: EXEC @pad_interior
+func @pad_interior(%arg : tensor<2x3xi32>) -> tensor<3x7xi32> {
+  %pad_val = constant dense<0> : tensor<i32>
+  %result = "xla_hlo.pad"(%arg, %pad_val) {interior_padding = dense<[1, 2]> : tensor<2xi64>, edge_padding_low = dense<[0, 0]> : tensor<2xi64>, edge_padding_high = dense<[0, 0]> : tensor<2xi64>} : (tensor<2x3xi32>, tensor<i32>) -> tensor<3x7xi32>
+  return %result : tensor<3x7xi32>
+}
+// CHECK-NEXT: 3x7xi32=[1 0 0 2 0 0 3][0 0 0 0 0 0 0][4 0 0 5 0 0 6]
+
+// -----
+
+// CHECK-LABEL: EXEC @pad_interior_and_edges
+func @pad_interior_and_edges(%arg : tensor<2x3xi32>) -> tensor<5x6xi32> {
+  %pad_val = constant dense<0> : tensor<i32>
+  %result = "xla_hlo.pad"(%arg, %pad_val) {interior_padding = dense<[1, 1]> : tensor<2xi64>, edge_padding_low = dense<[1, 1]> : tensor<2xi64>, edge_padding_high = dense<[1, 0]> : tensor<2xi64>} : (tensor<2x3xi32>, tensor<i32>) -> tensor<5x6xi32>
+  return %result : tensor<5x6xi32>
+}
+// CHECK-NEXT: 5x6xi32=[0 0 0 0 0 0][0 1 0 2 0 3][0 0 0 0 0 0][0 4 0 5 0 6][0 0 0 0 0 0]
+
+// -----
+
+// Negative edges crop the interior-padded source, including padding elements.
+// CHECK-LABEL: EXEC @pad_interior_and_negative_edges
+func @pad_interior_and_negative_edges(%arg : tensor<2x3xi32>) -> tensor<3x6xi32> {
+  %input = constant dense<[[1, 2, 3, 4], [5, 6, 7, 8], [9, 10, 11, 12]]> : tensor<3x4xi32>
+  %pad_val = constant dense<0> : tensor<i32>
+  %result = "xla_hlo.pad"(%input, %pad_val) {interior_padding = dense<[1, 1]> : tensor<2xi64>, edge_padding_low = dense<[-1, -2]> : tensor<2xi64>, edge_padding_high = dense<[-1, 1]> : tensor<2xi64>} : (tensor<3x4xi32>, tensor<i32>) -> tensor<3x6xi32>
+  return %result : tensor<3x6xi32>
+}
+// CHECK-NEXT: 3x6xi32=[0 0 0 0 0 0][6 0 7 0 8 0][0 0 0 0 0 0]
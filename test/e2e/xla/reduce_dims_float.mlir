@@ -0,0 +1,99 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --output_types=f | FileCheck %s --dump-input=fail
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --output_types=f -- -iree-interpreter-compensated-summation | FileCheck %s --dump-input=fail
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --output_types=f -- -iree-interpreter-fast-math | FileCheck %s --dump-input=fail
+
+// Reductions along outer, middle and inner dimensions, run with ordered
+// (default), compensated and pairwise (fast-math) summation. All sums are
+// exactly representable so every mode produces the same result.
+
+// Middle dimension.
+// CHECK-LABEL: EXEC @reduce_sum_3x19x5xf32_dim1
+func @reduce_sum_3x19x5xf32_dim1() -> tensor<3x5xf32> {
+  %0 = constant dense<[[[0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0], [17.0, 1.0, 8.0, 15.0, 22.0], [6.0, 13.0, 20.0, 4.0, 11.0], [18.0, 2.0, 9.0, 16.0, 0.0], [7.0, 14.0, 21.0, 5.0, 12.0], [19.0, 3.0, 10.0, 17.0, 1.0], [8.0, 15.0, 22.0, 6.0, 13.0], [20.0, 4.0, 11.0, 18.0, 2.0], [9.0, 16.0, 0.0, 7.0, 14.0]], [[21.0, 5.0, 12.0, 19.0, 3.0], [10.0, 17.0, 1.0, 8.0, 15.0], [22.0, 6.0, 13.0, 20.0, 4.0], [11.0, 18.0, 2.0, 9.0, 16.0], [0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0], [17.0, 1.0, 8.0, 15.0, 22.0], [6.0, 13.0, 20.0, 4.0, 11.0], [18.0, 2.0, 9.0, 16.0, 0.0], [7.0, 14.0, 21.0, 5.0, 12.0]], [[19.0, 3.0, 10.0, 17.0, 1.0], [8.0, 15.0, 22.0, 6.0, 13.0], [20.0, 4.0, 11.0, 18.0, 2.0], [9.0, 16.0, 0.0, 7.0, 14.0], [21.0, 5.0, 12.0, 19.0, 3.0], [10.0, 17.0, 1.0, 8.0, 15.0], [22.0, 6.0, 13.0, 20.0, 4.0], [11.0, 18.0, 2.0, 9.0, 16.0], [0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0]]]> : tensor<3x19x5xf32>
+  %1 = constant dense<0.0> : tensor<f32>
+  %2 = "xla_hlo.reduce"(%0, %1) ( {
+  ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):   // no predecessors
+    %3 = "xla_hlo.add"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+    "xla_hlo.return"(%3) : (tensor<f32>) -> ()
+  }) {dimensions = dense<[1]> : tensor<1xi64>} : (tensor<3x19x5xf32>, tensor<f32>) -> tensor<3x5xf32>
+  return %2 : tensor<3x5xf32>
+}
+// CHECK: 3x5xf32=[189 207 225 197 215][197 215 210 205 223][205 223 195 213 208]
+
+// -----
+
+// Outer dimension.
+// CHECK-LABEL: EXEC @reduce_sum_19x3x5xf32_dim0
+func @reduce_sum_19x3x5xf32_dim0() -> tensor<3x5xf32> {
+  %0 = constant dense<[[[0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0]], [[13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0]], [[3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0]], [[16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0], [17.0, 1.0, 8.0, 15.0, 22.0]], [[6.0, 13.0, 20.0, 4.0, 11.0], [18.0, 2.0, 9.0, 16.0, 0.0], [7.0, 14.0, 21.0, 5.0, 12.0]], [[19.0, 3.0, 10.0, 17.0, 1.0], [8.0, 15.0, 22.0, 6.0, 13.0], [20.0, 4.0, 11.0, 18.0, 2.0]], [[9.0, 16.0, 0.0, 7.0, 14.0], [21.0, 5.0, 12.0, 19.0, 3.0], [10.0, 17.0, 1.0, 8.0, 15.0]], [[22.0, 6.0, 13.0, 20.0, 4.0], [11.0, 18.0, 2.0, 9.0, 16.0], [0.0, 7.0, 14.0, 21.0, 5.0]], [[12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0]], [[2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0]], [[15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0]], [[5.0, 12.0, 19.0, 3.0, 10.0], [17.0, 1.0, 8.0, 15.0, 22.0], [6.0, 13.0, 20.0, 4.0, 11.0]], [[18.0, 2.0, 9.0, 16.0, 0.0], [7.0, 14.0, 21.0, 5.0, 12.0], [19.0, 3.0, 10.0, 17.0, 1.0]], [[8.0, 15.0, 22.0, 6.0, 13.0], [20.0, 4.0, 11.0, 18.0, 2.0], [9.0, 16.0, 0.0, 7.0, 14.0]], [[21.0, 5.0, 12.0, 19.0, 3.0], [10.0, 17.0, 1.0, 8.0, 15.0], [22.0, 6.0, 13.0, 20.0, 4.0]], [[11.0, 18.0, 2.0, 9.0, 16.0], [0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0]], [[1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0]], [[14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0]], [[4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0]]]> : tensor<19x3x5xf32>
+  %1 = constant dense<0.0> : tensor<f32>
+  %2 = "xla_hlo.reduce"(%0, %1) ( {
+  ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):   // no predecessors
+    %3 = "xla_hlo.add"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+    "xla_hlo.return"(%3) : (tensor<f32>) -> ()
+  }) {dimensions = dense<[0]> : tensor<1xi64>} : (tensor<19x3x5xf32>, tensor<f32>) -> tensor<3x5xf32>
+  return %2 : tensor<3x5xf32>
+}
+// CHECK: 3x5xf32=[199 217 212 207 202][197 215 210 205 223][195 213 208 203 221]
+
+// -----
+
+// Inner dimension with a partial vector tail.
+// CHECK-LABEL: EXEC @reduce_sum_3x5x19xf32_dim2
+func @reduce_sum_3x5x19xf32_dim2() -> tensor<3x5xf32> {
+  %0 = constant dense<[[[0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0, 6.0, 13.0, 20.0, 4.0, 11.0], [18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0], [8.0, 15.0, 22.0, 6.0, 13.0, 20.0, 4.0, 11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0, 6.0, 13.0, 20.0, 4.0, 11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0]], [[21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0, 6.0, 13.0, 20.0, 4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0, 6.0, 13.0, 20.0, 4.0], [11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0], [6.0, 13.0, 20.0, 4.0, 11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0, 13.0, 20.0, 4.0, 11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0]], [[19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0, 6.0, 13.0, 20.0, 4.0, 11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0, 6.0, 13.0, 20.0, 4.0, 11.0, 18.0, 2.0], [9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0, 17.0, 1.0, 8.0, 15.0], [22.0, 6.0, 13.0, 20.0, 4.0, 11.0, 18.0, 2.0, 9.0, 16.0, 0.0, 7.0, 14.0, 21.0, 5.0, 12.0, 19.0, 3.0, 10.0]]]> : tensor<3x5x19xf32>
+  %1 = constant dense<0.0> : tensor<f32>
+  %2 = "xla_hlo.reduce"(%0, %1) ( {
+  ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):   // no predecessors
+    %3 = "xla_hlo.add"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+    "xla_hlo.return"(%3) : (tensor<f32>) -> ()
+  }) {dimensions = dense<[2]> : tensor<1xi64>} : (tensor<3x5x19xf32>, tensor<f32>) -> tensor<3x5xf32>
+  return %2 : tensor<3x5xf32>
+}
+// CHECK: 3x5xf32=[208 205 202 222 196][216 213 210 207 204][201 221 218 192 212]
+
+// -----
+
+// Middle dimension of a rank-4 input with a non-zero init value.
+// CHECK-LABEL: EXEC @reduce_sum_2x19x3x2xf32_dim1
+func @reduce_sum_2x19x3x2xf32_dim1() -> tensor<2x3x2xf32> {
+  %0 = constant dense<[[[[0.0, 7.0], [14.0, 21.0], [5.0, 12.0]], [[19.0, 3.0], [10.0, 17.0], [1.0, 8.0]], [[15.0, 22.0], [6.0, 13.0], [20.0, 4.0]], [[11.0, 18.0], [2.0, 9.0], [16.0, 0.0]], [[7.0, 14.0], [21.0, 5.0], [12.0, 19.0]], [[3.0, 10.0], [17.0, 1.0], [8.0, 15.0]], [[22.0, 6.0], [13.0, 20.0], [4.0, 11.0]], [[18.0, 2.0], [9.0, 16.0], [0.0, 7.0]], [[14.0, 21.0], [5.0, 12.0], [19.0, 3.0]], [[10.0, 17.0], [1.0, 8.0], [15.0, 22.0]], [[6.0, 13.0], [20.0, 4.0], [11.0, 18.0]], [[2.0, 9.0], [16.0, 0.0], [7.0, 14.0]], [[21.0, 5.0], [12.0, 19.0], [3.0, 10.0]], [[17.0, 1.0], [8.0, 15.0], [22.0, 6.0]], [[13.0, 20.0], [4.0, 11.0], [18.0, 2.0]], [[9.0, 16.0], [0.0, 7.0], [14.0, 21.0]], [[5.0, 12.0], [19.0, 3.0], [10.0, 17.0]], [[1.0, 8.0], [15.0, 22.0], [6.0, 13.0]], [[20.0, 4.0], [11.0, 18.0], [2.0, 9.0]]], [[[16.0, 0.0], [7.0, 14.0], [21.0, 5.0]], [[12.0, 19.0], [3.0, 10.0], [17.0, 1.0]], [[8.0, 15.0], [22.0, 6.0], [13.0, 20.0]], [[4.0, 11.0], [18.0, 2.0], [9.0, 16.0]], [[0.0, 7.0], [14.0, 21.0], [5.0, 12.0]], [[19.0, 3.0], [10.0, 17.0], [1.0, 8.0]], [[15.0, 22.0], [6.0, 13.0], [20.0, 4.0]], [[11.0, 18.0], [2.0, 9.0], [16.0, 0.0]], [[7.0, 14.0], [21.0, 5.0], [12.0, 19.0]], [[3.0, 10.0], [17.0, 1.0], [8.0, 15.0]], [[22.0, 6.0], [13.0, 20.0], [4.0, 11.0]], [[18.0, 2.0], [9.0, 16.0], [0.0, 7.0]], [[14.0, 21.0], [5.0, 12.0], [19.0, 3.0]], [[10.0, 17.0], [1.0, 8.0], [15.0, 22.0]], [[6.0, 13.0], [20.0, 4.0], [11.0, 18.0]], [[2.0, 9.0], [16.0, 0.0], [7.0, 14.0]], [[21.0, 5.0], [12.0, 19.0], [3.0, 10.0]], [[17.0, 1.0], [8.0, 15.0], [22.0, 6.0]], [[13.0, 20.0], [4.0, 11.0], [18.0, 2.0]]]]> : tensor<2x19x3x2xf32>
+  %1 = constant dense<10.0> : tensor<f32>
+  %2 = "xla_hlo.reduce"(%0, %1) ( {
+  ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):   // no predecessors
+    %3 = "xla_hlo.add"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+    "xla_hlo.return"(%3) : (tensor<f32>) -> ()
+  }) {dimensions = dense<[1]> : tensor<1xi64>} : (tensor<2x19x3x2xf32>, tensor<f32>) -> tensor<2x3x2xf32>
+  return %2 : tensor<2x3x2xf32>
+}
+// CHECK: 2x3x2xf32=[[223 218][213 231][203 221]][[228 223][218 213][231 203]]
+
+// -----
+
+// CHECK-LABEL: EXEC @reduce_max_3x19x5xf32_dim1
+func @reduce_max_3x19x5xf32_dim1() -> tensor<3x5xf32> {
+  %0 = constant dense<[[[0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0], [17.0, 1.0, 8.0, 15.0, 22.0], [6.0, 13.0, 20.0, 4.0, 11.0], [18.0, 2.0, 9.0, 16.0, 0.0], [7.0, 14.0, 21.0, 5.0, 12.0], [19.0, 3.0, 10.0, 17.0, 1.0], [8.0, 15.0, 22.0, 6.0, 13.0], [20.0, 4.0, 11.0, 18.0, 2.0], [9.0, 16.0, 0.0, 7.0, 14.0]], [[21.0, 5.0, 12.0, 19.0, 3.0], [10.0, 17.0, 1.0, 8.0, 15.0], [22.0, 6.0, 13.0, 20.0, 4.0], [11.0, 18.0, 2.0, 9.0, 16.0], [0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0], [17.0, 1.0, 8.0, 15.0, 22.0], [6.0, 13.0, 20.0, 4.0, 11.0], [18.0, 2.0, 9.0, 16.0, 0.0], [7.0, 14.0, 21.0, 5.0, 12.0]], [[19.0, 3.0, 10.0, 17.0, 1.0], [8.0, 15.0, 22.0, 6.0, 13.0], [20.0, 4.0, 11.0, 18.0, 2.0], [9.0, 16.0, 0.0, 7.0, 14.0], [21.0, 5.0, 12.0, 19.0, 3.0], [10.0, 17.0, 1.0, 8.0, 15.0], [22.0, 6.0, 13.0, 20.0, 4.0], [11.0, 18.0, 2.0, 9.0, 16.0], [0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0]]]> : tensor<3x19x5xf32>
+  %1 = constant dense<-1.0> : tensor<f32>
+  %2 = "xla_hlo.reduce"(%0, %1) ( {
+  ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):   // no predecessors
+    %3 = "xla_hlo.max"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+    "xla_hlo.return"(%3) : (tensor<f32>) -> ()
+  }) {dimensions = dense<[1]> : tensor<1xi64>} : (tensor<3x19x5xf32>, tensor<f32>) -> tensor<3x5xf32>
+  return %2 : tensor<3x5xf32>
+}
+// CHECK: 3x5xf32=[20 22 22 22 22][22 22 21 22 22][22 22 22 22 21]
+
+// -----
+
+// CHECK-LABEL: EXEC @reduce_min_19x3x5xf32_dim0
+func @reduce_min_19x3x5xf32_dim0() -> tensor<3x5xf32> {
+  %0 = constant dense<[[[0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0]], [[13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0]], [[3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0]], [[16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0], [17.0, 1.0, 8.0, 15.0, 22.0]], [[6.0, 13.0, 20.0, 4.0, 11.0], [18.0, 2.0, 9.0, 16.0, 0.0], [7.0, 14.0, 21.0, 5.0, 12.0]], [[19.0, 3.0, 10.0, 17.0, 1.0], [8.0, 15.0, 22.0, 6.0, 13.0], [20.0, 4.0, 11.0, 18.0, 2.0]], [[9.0, 16.0, 0.0, 7.0, 14.0], [21.0, 5.0, 12.0, 19.0, 3.0], [10.0, 17.0, 1.0, 8.0, 15.0]], [[22.0, 6.0, 13.0, 20.0, 4.0], [11.0, 18.0, 2.0, 9.0, 16.0], [0.0, 7.0, 14.0, 21.0, 5.0]], [[12.0, 19.0, 3.0, 10.0, 17.0], [1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0]], [[2.0, 9.0, 16.0, 0.0, 7.0], [14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0]], [[15.0, 22.0, 6.0, 13.0, 20.0], [4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0]], [[5.0, 12.0, 19.0, 3.0, 10.0], [17.0, 1.0, 8.0, 15.0, 22.0], [6.0, 13.0, 20.0, 4.0, 11.0]], [[18.0, 2.0, 9.0, 16.0, 0.0], [7.0, 14.0, 21.0, 5.0, 12.0], [19.0, 3.0, 10.0, 17.0, 1.0]], [[8.0, 15.0, 22.0, 6.0, 13.0], [20.0, 4.0, 11.0, 18.0, 2.0], [9.0, 16.0, 0.0, 7.0, 14.0]], [[21.0, 5.0, 12.0, 19.0, 3.0], [10.0, 17.0, 1.0, 8.0, 15.0], [22.0, 6.0, 13.0, 20.0, 4.0]], [[11.0, 18.0, 2.0, 9.0, 16.0], [0.0, 7.0, 14.0, 21.0, 5.0], [12.0, 19.0, 3.0, 10.0, 17.0]], [[1.0, 8.0, 15.0, 22.0, 6.0], [13.0, 20.0, 4.0, 11.0, 18.0], [2.0, 9.0, 16.0, 0.0, 7.0]], [[14.0, 21.0, 5.0, 12.0, 19.0], [3.0, 10.0, 17.0, 1.0, 8.0], [15.0, 22.0, 6.0, 13.0, 20.0]], [[4.0, 11.0, 18.0, 2.0, 9.0], [16.0, 0.0, 7.0, 14.0, 21.0], [5.0, 12.0, 19.0, 3.0, 10.0]]]> : tensor<19x3x5xf32>
+  %1 = constant dense<999.0> : tensor<f32>
+  %2 = "xla_hlo.reduce"(%0, %1) ( {
+  ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):   // no predecessors
+    %3 = "xla_hlo.min"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+    "xla_hlo.return"(%3) : (tensor<f32>) -> ()
+  }) {dimensions = dense<[0]> : tensor<1xi64>} : (tensor<19x3x5xf32>, tensor<f32>) -> tensor<3x5xf32>
+  return %2 : tensor<3x5xf32>
+}
+// CHECK: 3x5xf32=[0 0 0 0 0][0 0 1 0 0][0 0 0 0 1]
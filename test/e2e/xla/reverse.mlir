@@ -12,4 +12,56 @@ func @xla_reverse () -> (tensor<2x3xf32>, tensor <2x3xf32>, tensor <2x3xf32>) {
 }
 // CHECK: 2x3xf32=[4 5 6][1 2 3]
 // CHECK-NEXT: 2x3xf32=[3 2 1][6 5 4]
-// CHECK_NEXT: 2x3xf32=[6 5 4][3 2 1]
+// CHECK-NEXT: 2x3xf32=[6 5 4][3 2 1]
+
+// -----
+
+// Reversing the innermost dimension reverses each row element by element.
+// CHECK-LABEL: EXEC @reverse_inner
+func @reverse_inner() -> tensor<2x3x4xf32> {
+  %input = constant dense<[[[1.0, 2.0, 3.0, 4.0], [5.0, 6.0, 7.0, 8.0], [9.0, 10.0, 11.0, 12.0]], [[13.0, 14.0, 15.0, 16.0], [17.0, 18.0, 19.0, 20.0], [21.0, 22.0, 23.0, 24.0]]]> : tensor<2x3x4xf32>
+  %result = "xla_hlo.reverse"(%input) {dimensions = dense<[2]> : tensor<1xi64>} : (tensor<2x3x4xf32>) -> tensor<2x3x4xf32>
+  return %result : tensor<2x3x4xf32>
+}
+// CHECK: 2x3x4xf32=[[4 3 2 1][8 7 6 5][12 11 10 9]][[16 15 14 13][20 19 18 17][24 23 22 21]]
+
+// -----
+
+// Reversing an outer dimension copies whole contiguous runs.
+// CHECK-LABEL: EXEC @reverse_middle
+func @reverse_middle() -> tensor<2x3x4xf32> {
+  %input = constant dense<[[[1.0, 2.0, 3.0, 4.0], [5.0, 6.0, 7.0, 8.0], [9.0, 10.0, 11.0, 12.0]], [[13.0, 14.0, 15.0, 16.0], [17.0, 18.0, 19.0, 20.0], [21.0, 22.0, 23.0, 24.0]]]> : tensor<2x3x4xf32>
+  %result = "xla_hlo.reverse"(%input) {dimensions = dense<[1]> : tensor<1xi64>} : (tensor<2x3x4xf32>) -> tensor<2x3x4xf32>
+  return %result : tensor<2x3x4xf32>
+}
+// CHECK: 2x3x4xf32=[[9 10 11 12][5 6 7 8][1 2 3 4]][[21 22 23 24][17 18 19 20][13 14 15 16]]
+
+// -----
+
+// CHECK-LABEL: EXEC @reverse_outer
+func @reverse_outer() -> tensor<2x3x4xf32> {
+  %input = constant dense<[[[1.0, 2.0, 3.0, 4.0], [5.0, 6.0, 7.0, 8.0], [9.0, 10.0, 11.0, 12.0]], [[13.0, 14.0, 15.0, 16.0], [17.0, 18.0, 19.0, 20.0], [21.0, 22.0, 23.0, 24.0]]]> : tensor<2x3x4xf32>
+  %result = "xla_hlo.reverse"(%input) {dimensions = dense<[0]> : tensor<1xi64>} : (tensor<2x3x4xf32>) -> tensor<2x3x4xf32>
+  return %result : tensor<2x3x4xf32>
+}
+// CHECK: 2x3x4xf32=[[13 14 15 16][17 18 19 20][21 22 23 24]][[1 2 3 4][5 6 7 8][9 10 11 12]]
+
+// -----
+
+// CHECK-LABEL: EXEC @reverse_inner_and_outer
+func @reverse_inner_and_outer() -> tensor<2x3x4xf32> {
+  %input = constant dense<[[[1.0, 2.0, 3.0, 4.0], [5.0, 6.0, 7.0, 8.0], [9.0, 10.0, 11.0, 12.0]], [[13.0, 14.0, 15.0, 16.0], [17.0, 18.0, 19.0, 20.0], [21.0, 22.0, 23.0, 24.0]]]> : tensor<2x3x4xf32>
+  %result = "xla_hlo.reverse"(%input) {dimensions = dense<[0, 2]> : tensor<2xi64>} : (tensor<2x3x4xf32>) -> tensor<2x3x4xf32>
+  return %result : tensor<2x3x4xf32>
+}
+// CHECK: 2x3x4xf32=[[16 15 14 13][20 19 18 17][24 23 22 21]][[4 3 2 1][8 7 6 5][12 11 10 9]]
+
+// -----
+
+// CHECK-LABEL: EXEC @reverse_all
+func @reverse_all() -> tensor<2x3x4xf32> {
+  %input = constant dense<[[[1.0, 2.0, 3.0, 4.0], [5.0, 6.0, 7.0, 8.0], [9.0, 10.0, 11.0, 12.0]], [[13.0, 14.0, 15.0, 16.0], [17.0, 18.0, 19.0, 20.0], [21.0, 22.0, 23.0, 24.0]]]> : tensor<2x3x4xf32>
+  %result = "xla_hlo.reverse"(%input) {dimensions = dense<[0, 1, 2]> : tensor<3xi64>} : (tensor<2x3x4xf32>) -> tensor<2x3x4xf32>
+  return %result : tensor<2x3x4xf32>
+}
+// CHECK: 2x3x4xf32=[[24 23 22 21][20 19 18 17][16 15 14 13]][[12 11 10 9][8 7 6 5][4 3 2 1]]
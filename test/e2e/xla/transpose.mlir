@@ -0,0 +1,73 @@
+// RUN: iree-run-mlir --target_backends=interpreter-bytecode %s --output_types=i | FileCheck %s --dump-input=fail
+
+// Neither dimension is a multiple of the tile size.
+// CHECK-LABEL: EXEC @transpose_17x5
+func @transpose_17x5() -> tensor<5x17xi32> {
+  %input = constant dense<[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14], [15, 16, 17, 18, 19], [20, 21, 22, 23, 24], [25, 26, 27, 28, 29], [30, 31, 32, 33, 34], [35, 36, 37, 38, 39], [40, 41, 42, 43, 44], [45, 46, 47, 48, 49], [50, 51, 52, 53, 54], [55, 56, 57, 58, 59], [60, 61, 62, 63, 64], [65, 66, 67, 68, 69], [70, 71, 72, 73, 74], [75, 76, 77, 78, 79], [80, 81, 82, 83, 84]]> : tensor<17x5xi32>
+  %result = "xla_hlo.transpose"(%input) {permutation = dense<[1, 0]> : tensor<2xi64>} : (tensor<17x5xi32>) -> tensor<5x17xi32>
+  return %result : tensor<5x17xi32>
+}
+// CHECK: 5x17xi32=[0 5 10 15 20 25 30 35 40 45 50 55 60 65 70 75 80][1 6 11 16 21 26 31 36 41 46 51 56 61 66 71 76 81][2 7 12 17 22 27 32 37 42 47 52 57 62 67 72 77 82][3 8 13 18 23 28 33 38 43 48 53 58 63 68 73 78 83][4 9 14 19 24 29 34 39 44 49 54 59 64 69 74 79 84]
+
+// -----
+
+// CHECK-LABEL: EXEC @transpose_2x3x5_last_two
+func @transpose_2x3x5_last_two() -> tensor<2x5x3xi32> {
+  %input = constant dense<[[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14]], [[15, 16, 17, 18, 19], [20, 21, 22, 23, 24], [25, 26, 27, 28, 29]]]> : tensor<2x3x5xi32>
+  %result = "xla_hlo.transpose"(%input) {permutation = dense<[0, 2, 1]> : tensor<3xi64>} : (tensor<2x3x5xi32>) -> tensor<2x5x3xi32>
+  return %result : tensor<2x5x3xi32>
+}
+// CHECK: 2x5x3xi32=[[0 5 10][1 6 11][2 7 12][3 8 13][4 9 14]][[15 20 25][16 21 26][17 22 27][18 23 28][19 24 29]]
+
+// -----
+
+// CHECK-LABEL: EXEC @transpose_2x3x5_rotate
+func @transpose_2x3x5_rotate() -> tensor<5x2x3xi32> {
+  %input = constant dense<[[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14]], [[15, 16, 17, 18, 19], [20, 21, 22, 23, 24], [25, 26, 27, 28, 29]]]> : tensor<2x3x5xi32>
+  %result = "xla_hlo.transpose"(%input) {permutation = dense<[2, 0, 1]> : tensor<3xi64>} : (tensor<2x3x5xi32>) -> tensor<5x2x3xi32>
+  return %result : tensor<5x2x3xi32>
+}
+// CHECK: 5x2x3xi32=[[0 5 10][15 20 25]][[1 6 11][16 21 26]][[2 7 12][17 22 27]][[3 8 13][18 23 28]][[4 9 14][19 24 29]]
+
+// -----
+
+// The innermost dimension is unmoved, so rows are copied whole.
+// CHECK-LABEL: EXEC @transpose_3x5x7_outer_two
+func @transpose_3x5x7_outer_two() -> tensor<5x3x7xi32> {
+  %input = constant dense<[[[0, 1, 2, 3, 4, 5, 6], [7, 8, 9, 10, 11, 12, 13], [14, 15, 16, 17, 18, 19, 20], [21, 22, 23, 24, 25, 26, 27], [28, 29, 30, 31, 32, 33, 34]], [[35, 36, 37, 38, 39, 40, 41], [42, 43, 44, 45, 46, 47, 48], [49, 50, 51, 52, 53, 54, 55], [56, 57, 58, 59, 60, 61, 62], [63, 64, 65, 66, 67, 68, 69]], [[70, 71, 72, 73, 74, 75, 76], [77, 78, 79, 80, 81, 82, 83], [84, 85, 86, 87, 88, 89, 90], [91, 92, 93, 94, 95, 96, 97], [98, 99, 100, 101, 102, 103, 104]]]> : tensor<3x5x7xi32>
+  %result = "xla_hlo.transpose"(%input) {permutation = dense<[1, 0, 2]> : tensor<3xi64>} : (tensor<3x5x7xi32>) -> tensor<5x3x7xi32>
+  return %result : tensor<5x3x7xi32>
+}
+// CHECK: 5x3x7xi32=[[0 1 2 3 4 5 6][35 36 37 38 39 40 41][70 71 72 73 74 75 76]][[7 8 9 10 11 12 13][42 43 44 45 46 47 48][77 78 79 80 81 82 83]][[14 15 16 17 18 19 20][49 50 51 52 53 54 55][84 85 86 87 88 89 90]][[21 22 23 24 25 26 27][56 57 58 59 60 61 62][91 92 93 94 95 96 97]][[28 29 30 31 32 33 34][63 64 65 66 67 68 69][98 99 100 101 102 103 104]]
+
+// -----
+
+// CHECK-LABEL: EXEC @transpose_2x3x4x5
+func @transpose_2x3x4x5() -> tensor<5x3x2x4xi32> {
+  %input = constant dense<[[[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14], [15, 16, 17, 18, 19]], [[20, 21, 22, 23, 24], [25, 26, 27, 28, 29], [30, 31, 32, 33, 34], [35, 36, 37, 38, 39]], [[40, 41, 42, 43, 44], [45, 46, 47, 48, 49], [50, 51, 52, 53, 54], [55, 56, 57, 58, 59]]], [[[60, 61, 62, 63, 64], [65, 66, 67, 68, 69], [70, 71, 72, 73, 74], [75, 76, 77, 78, 79]], [[80, 81, 82, 83, 84], [85, 86, 87, 88, 89], [90, 91, 92, 93, 94], [95, 96, 97, 98, 99]], [[100, 101, 102, 103, 104], [105, 106, 107, 108, 109], [110, 111, 112, 113, 114], [115, 116, 117, 118, 119]]]]> : tensor<2x3x4x5xi32>
+  %result = "xla_hlo.transpose"(%input) {permutation = dense<[3, 1, 0, 2]> : tensor<4xi64>} : (tensor<2x3x4x5xi32>) -> tensor<5x3x2x4xi32>
+  return %result : tensor<5x3x2x4xi32>
+}
+// CHECK: 5x3x2x4xi32=[[[0 5 10 15][60 65 70 75]][[20 25 30 35][80 85 90 95]][[40 45 50 55][100 105 110 115]]][[[1 6 11 16][61 66 71 76]][[21 26 31 36][81 86 91 96]][[41 46 51 56][101 106 111 116]]][[[2 7 12 17][62 67 72 77]][[22 27 32 37][82 87 92 97]][[42 47 52 57][102 107 112 117]]][[[3 8 13 18][63 68 73 78]][[23 28 33 38][83 88 93 98]][[43 48 53 58][103 108 113 118]]][[[4 9 14 19][64 69 74 79]][[24 29 34 39][84 89 94 99]][[44 49 54 59][104 109 114 119]]]
+
+// -----
+
+// Dimensions 0-1 and 2-3 stay adjacent and are merged into a 2D transpose.
+// CHECK-LABEL: EXEC @transpose_2x3x4x5_merged
+func @transpose_2x3x4x5_merged() -> tensor<4x5x2x3xi32> {
+  %input = constant dense<[[[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14], [15, 16, 17, 18, 19]], [[20, 21, 22, 23, 24], [25, 26, 27, 28, 29], [30, 31, 32, 33, 34], [35, 36, 37, 38, 39]], [[40, 41, 42, 43, 44], [45, 46, 47, 48, 49], [50, 51, 52, 53, 54], [55, 56, 57, 58, 59]]], [[[60, 61, 62, 63, 64], [65, 66, 67, 68, 69], [70, 71, 72, 73, 74], [75, 76, 77, 78, 79]], [[80, 81, 82, 83, 84], [85, 86, 87, 88, 89], [90, 91, 92, 93, 94], [95, 96, 97, 98, 99]], [[100, 101, 102, 103, 104], [105, 106, 107, 108, 109], [110, 111, 112, 113, 114], [115, 116, 117, 118, 119]]]]> : tensor<2x3x4x5xi32>
+  %result = "xla_hlo.transpose"(%input) {permutation = dense<[2, 3, 0, 1]> : tensor<4xi64>} : (tensor<2x3x4x5xi32>) -> tensor<4x5x2x3xi32>
+  return %result : tensor<4x5x2x3xi32>
+}
+// CHECK: 4x5x2x3xi32=[[[0 20 40][60 80 100]][[1 21 41][61 81 101]][[2 22 42][62 82 102]][[3 23 43][63 83 103]][[4 24 44][64 84 104]]][[[5 25 45][65 85 105]][[6 26 46][66 86 106]][[7 27 47][67 87 107]][[8 28 48][68 88 108]][[9 29 49][69 89 109]]][[[10 30 50][70 90 110]][[11 31 51][71 91 111]][[12 32 52][72 92 112]][[13 33 53][73 93 113]][[14 34 54][74 94 114]]][[[15 35 55][75 95 115]][[16 36 56][76 96 116]][[17 37 57][77 97 117]][[18 38 58][78 98 118]][[19 39 59][79 99 119]]]
+
+// -----
+
+// The unit dimension is dropped before transposing.
+// CHECK-LABEL: EXEC @transpose_2x1x3x5_unit
+func @transpose_2x1x3x5_unit() -> tensor<5x2x3x1xi32> {
+  %input = constant dense<[[[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14]]], [[[15, 16, 17, 18, 19], [20, 21, 22, 23, 24], [25, 26, 27, 28, 29]]]]> : tensor<2x1x3x5xi32>
+  %result = "xla_hlo.transpose"(%input) {permutation = dense<[3, 0, 2, 1]> : tensor<4xi64>} : (tensor<2x1x3x5xi32>) -> tensor<5x2x3x1xi32>
+  return %result : tensor<5x2x3x1xi32>
+}
+// CHECK: 5x2x3x1xi32=[[[0][5][10]][[15][20][25]]][[[1][6][11]][[16][21][26]]][[[2][7][12]][[17][22][27]]][[[3][8][13]][[18][23][28]]][[[4][9][14]][[19][24][29]]]
@@ -23,7 +23,8 @@
 // functions (this means all input signatures must match). Results from the
 // executed functions will be printed to stdout for checking.
 // Use -output_types to set the function output data types, which like args will
-// be used for all functions executed.
+// be used for all functions executed. Arguments following `--` are passed to
+// the compiler as LLVM options (such as -iree-interpreter-fast-math).
 //
 // Example input:
 // // RUN: iree-run %s | FileCheck %s
@@ -41,6 +42,7 @@
 #include "third_party/absl/strings/string_view.h"
 #include "third_party/absl/types/source_location.h"
 #include "third_party/llvm/llvm/include/llvm/ADT/StringRef.h"
+#include "third_party/llvm/llvm/include/llvm/Support/CommandLine.h"
 #include "third_party/llvm/llvm/include/llvm/Support/SourceMgr.h"
 #include "third_party/llvm/llvm/projects/google_mlir/include/mlir/IR/Attributes.h"
 #include "third_party/llvm/llvm/projects/google_mlir/include/mlir/IR/Function.h"
@@ -331,7 +333,20 @@ Status RunFile(std::string mlir_filename) {
 }  // namespace
 
 extern "C" int main(int argc, char** argv) {
+  // Split off the compiler options following `--` so that flag parsing does
+  // not reject them.
+  int argc_flags = argc;
+  std::vector<char*> argv_llvm = {argv[0]};
+  for (int i = 1; i < argc; ++i) {
+    if (absl::string_view(argv[i]) == "--") {
+      argc_flags = i;
+      argv_llvm.insert(argv_llvm.end(), argv + i + 1, argv + argc);
+      break;
+    }
+  }
+  argc = argc_flags;
   InitializeEnvironment(&argc, &argv);
+  llvm::cl::ParseCommandLineOptions(argv_llvm.size(), argv_llvm.data());
   if (argc < 2) {
     LOG(ERROR) << "Must supply an input .mlir file.";
     return 1;
@@ -47,6 +47,10 @@ ABSL_FLAG(std::string, input_values, "", "Input shapes and optional values.");
 ABSL_FLAG(std::string, input_file, "",
           "Input shapes and optional values serialized in a file.");
 
+ABSL_FLAG(bool, shard_across_devices, false,
+          "Splits the inputs along their outermost dimension and runs one "
+          "shard on each device exposed by the driver.");
+
 ABSL_FLAG(std::string, output_types, "",
           "Output data types (comma delimited list of b/i/u/f for "
           "binary/signed int/unsigned int/float).");
@@ -90,8 +94,19 @@ Status Run() {
   auto instance = std::make_shared<Instance>(std::move(debug_server));
   ASSIGN_OR_RETURN(auto driver, hal::DriverRegistry::shared_registry()->Create(
                                     "interpreter"));
-  ASSIGN_OR_RETURN(auto device, driver->CreateDefaultDevice());
-  RETURN_IF_ERROR(instance->device_manager()->RegisterDevice(device));
+  // Register all devices (such as one per socket) so that they can be used
+  // for placement. The first device is the default.
+  ASSIGN_OR_RETURN(auto device_infos, driver->EnumerateAvailableDevices());
+  if (device_infos.empty()) {
+    return NotFoundErrorBuilder(ABSL_LOC) << "No interpreter devices available";
+  }
+  std::vector<std::shared_ptr<hal::Device>> devices;
+  for (const auto& device_info : device_infos) {
+    ASSIGN_OR_RETURN(auto device, driver->CreateDevice(device_info));
+    RETURN_IF_ERROR(instance->device_manager()->RegisterDevice(device));
+    devices.push_back(std::move(device));
+  }
+  const auto& device = devices.front();
   SequencerContext context(instance);
 
   // Load main module.
@@ -159,9 +174,19 @@ Status Run() {
   results.resize(main_function.result_count());
 
   // Call into the main function.
-  RETURN_IF_ERROR(context.Invoke(&fiber_state, main_function,
-                                 absl::MakeSpan(args),
-                                 absl::MakeSpan(results)));
+  if (absl::GetFlag(FLAGS_shard_across_devices)) {
+    std::vector<hal::PlacementSpec> placement_specs(devices.size());
+    for (int i = 0; i < placement_specs.size(); ++i) {
+      placement_specs[i].device_ordinal = i;
+    }
+    RETURN_IF_ERROR(context.InvokeSharded(
+        &fiber_state, main_function, absl::MakeSpan(args),
+        absl::MakeSpan(results), placement_specs));
+  } else {
+    RETURN_IF_ERROR(context.Invoke(&fiber_state, main_function,
+                                   absl::MakeSpan(args),
+                                   absl::MakeSpan(results)));
+  }
 
   // Dump all results to stdout.
   std::vector<std::string> output_types =
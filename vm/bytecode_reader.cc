@@ -14,6 +14,9 @@
 
 #include "third_party/mlir_edge/iree/vm/bytecode_reader.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "third_party/mlir_edge/iree/base/shape.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/hal/heap_buffer.h"
@@ -47,9 +50,7 @@ StatusOr<const uint8_t*> BytecodeReader::AdvanceOffset() {
 
 Status BytecodeReader::SkipLocals(int count) {
   size_t stride = sizeof(uint16_t) * count;
-  if (bytecode_pc_ + stride >= bytecode_limit_) {
-    return OutOfRangeErrorBuilder(ABSL_LOC) << "Bytecode underflow";
-  }
+  DCHECK_LE(bytecode_pc_ + stride, bytecode_limit_);
   bytecode_pc_ += stride;
   return OkStatus();
 }
@@ -106,9 +107,7 @@ StatusOr<Shape> BytecodeReader::ReadShapePieces(size_t* out_element_count) {
 StatusOr<absl::Span<const int32_t>> BytecodeReader::ReadIndexList() {
   ASSIGN_OR_RETURN(int count, ReadCount());
   int stride = count * sizeof(int32_t);
-  if (bytecode_pc_ + stride >= bytecode_limit_) {
-    return OutOfRangeErrorBuilder(ABSL_LOC) << "Bytecode underflow";
-  }
+  DCHECK_LE(bytecode_pc_ + stride, bytecode_limit_);
   auto list = absl::Span<const int32_t>(
       reinterpret_cast<const int32_t*>(bytecode_pc_), count);
   bytecode_pc_ += stride;
@@ -128,19 +127,27 @@ Status BytecodeReader::SwitchStackFrame(StackFrame* new_stack_frame) {
 
   // Setup state pointers for faster dereferencing.
   const auto& function = new_stack_frame->function();
+  if (!function.module().bytecode_validated()) {
+    return FailedPreconditionErrorBuilder(ABSL_LOC)
+           << "Module " << function.module().name()
+           << " must be validated before its bytecode can be executed";
+  }
   const auto& bytecode = *function.def().bytecode();
   bytecode_base_ = bytecode.contents()->Data();
   bytecode_limit_ = bytecode_base_ + bytecode.contents()->size();
   bytecode_pc_ = bytecode_base_ + new_stack_frame->offset();
   locals_ = new_stack_frame->mutable_locals();
   // TODO(benvanik): reimplement breakpoints as bytecode rewriting.
-  int function_ordinal = function.module()
-                             .function_table()
-                             .LookupFunctionOrdinal(function)
-                             .ValueOrDie();
-  breakpoint_table_ =
-      function.module().function_table().GetFunctionBreakpointTable(
-          function_ordinal);
+  // Resolving the function ordinal is a linear scan so skip it on calls and
+  // returns unless a debugger has registered breakpoints.
+  const auto& function_table = function.module().function_table();
+  breakpoint_table_ = nullptr;
+  if (function_table.has_breakpoints()) {
+    ASSIGN_OR_RETURN(int function_ordinal,
+                     function_table.LookupFunctionOrdinal(function));
+    breakpoint_table_ =
+        function_table.GetFunctionBreakpointTable(function_ordinal);
+  }
   return OkStatus();
 }
 
@@ -192,15 +199,10 @@ Status BytecodeReader::CopySlots() {
 }
 
 Status BytecodeReader::BranchToOffset(int32_t offset) {
-  const uint8_t* new_bytecode_pc = bytecode_base_ + offset;
-  if (new_bytecode_pc < bytecode_base_ || new_bytecode_pc > bytecode_limit_) {
-    return OutOfRangeErrorBuilder(ABSL_LOC)
-           << "Branch target " << offset
-           << " is out of bounds of the function bytecode ("
-           << static_cast<size_t>(bytecode_limit_ - bytecode_base_)
-           << "b total)";
-  }
-  bytecode_pc_ = new_bytecode_pc;
+  // Branch targets are verified to be instruction offsets by the validator.
+  DCHECK_GE(offset, 0);
+  DCHECK_LT(bytecode_base_ + offset, bytecode_limit_);
+  bytecode_pc_ = bytecode_base_ + offset;
   return OkStatus();
 }
 
@@ -221,12 +223,8 @@ StatusOr<BufferView> BytecodeReader::ReadConstant() {
   // Get buffer for the constant data.
   switch (encoding) {
     case ConstantEncoding::kDense: {
-      // Validate we have all constant data present.
       device_size_t serialized_length = buffer_view.byte_length();
-      if (bytecode_pc_ + serialized_length >= bytecode_limit_) {
-        return OutOfRangeErrorBuilder(ABSL_LOC)
-               << "Constant data out of bounds";
-      }
+      DCHECK_LE(bytecode_pc_ + serialized_length, bytecode_limit_);
 
       buffer_view.buffer = hal::HeapBuffer::Wrap(
           hal::MemoryType::kHostLocal, hal::BufferUsage::kAll, bytecode_pc_,
@@ -235,16 +233,12 @@ StatusOr<BufferView> BytecodeReader::ReadConstant() {
       break;
     }
     case ConstantEncoding::kSplat: {
-      // Validate we have at least one element worth of data in the buffer.
-      if (bytecode_pc_ + buffer_view.element_size >= bytecode_limit_) {
-        return OutOfRangeErrorBuilder(ABSL_LOC)
-               << "Constant data out of bounds";
-      }
+      DCHECK_LE(bytecode_pc_ + buffer_view.element_size, bytecode_limit_);
 
       // TODO(benvanik): replace with fancy constant pool and such.
       // NOTE: this is not much different than if a alloc_heap+broadcast pair
       // had been in the IR.
-      buffer_view.buffer = hal::HeapBuffer::Allocate(
+      buffer_view.buffer = hal::HeapBuffer::AllocateUninitialized(
           hal::MemoryType::kHostLocal, hal::BufferUsage::kAll,
           buffer_view.byte_length());
       switch (buffer_view.element_size) {
@@ -292,5 +286,50 @@ StatusOr<BufferView> BytecodeReader::ReadConstant() {
   return buffer_view;
 }
 
+Status BytecodeReader::ReadConstantInto(void* data, size_t data_length) {
+  ASSIGN_OR_RETURN(auto element_type, ReadType());
+  size_t element_size = element_type.element_size();
+  Shape shape;
+  RETURN_IF_ERROR(ReadShape(&shape));
+  size_t byte_length = element_size * shape.element_count();
+  if (byte_length != data_length) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Constant " << shape.DebugString() << " of " << element_size
+           << "b elements does not match destination size " << data_length;
+  }
+
+  ASSIGN_OR_RETURN(auto encoding, ReadValue<ConstantEncoding>());
+  auto* dst = static_cast<uint8_t*>(data);
+  switch (encoding) {
+    case ConstantEncoding::kDense: {
+      DCHECK_LE(bytecode_pc_ + byte_length, bytecode_limit_);
+      std::memcpy(dst, bytecode_pc_, byte_length);
+      bytecode_pc_ += byte_length;
+      break;
+    }
+    case ConstantEncoding::kSplat: {
+      DCHECK_LE(bytecode_pc_ + element_size, bytecode_limit_);
+      if (byte_length > 0) {
+        // Seed the first element and then keep doubling the filled prefix.
+        std::memcpy(dst, bytecode_pc_, element_size);
+        size_t filled_length = element_size;
+        while (filled_length < byte_length) {
+          size_t copy_length =
+              std::min(filled_length, byte_length - filled_length);
+          std::memcpy(dst + filled_length, dst, copy_length);
+          filled_length += copy_length;
+        }
+      }
+      bytecode_pc_ += element_size;
+      break;
+    }
+    default:
+      return UnimplementedErrorBuilder(ABSL_LOC)
+             << "Unimplemented constant encoding "
+             << static_cast<int>(encoding);
+  }
+  return OkStatus();
+}
+
 }  // namespace vm
 }  // namespace iree
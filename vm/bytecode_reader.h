@@ -15,7 +15,10 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_VM_BYTECODE_READER_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_VM_BYTECODE_READER_H_
 
+#include <functional>
+
 #include "third_party/absl/base/attributes.h"
+#include "third_party/absl/base/optimization.h"
 #include "third_party/absl/container/inlined_vector.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/hal/buffer_view.h"
@@ -30,12 +33,44 @@ namespace vm {
 
 class BytecodeReader {
  public:
+  // Called prior to the host reading the contents of a local buffer (such as
+  // with ReadSlotElements). Dispatchers that record work asynchronously can use
+  // this to ensure pending writes to the buffer have completed.
+  using HostReadFn = std::function<Status(hal::Buffer* buffer)>;
+
   explicit BytecodeReader(Stack* stack) : stack_(stack) {}
 
+  void set_host_read_fn(HostReadFn host_read_fn) {
+    host_read_fn_ = std::move(host_read_fn);
+  }
+
   int offset() const { return static_cast<int>(bytecode_pc_ - bytecode_base_); }
 
   StatusOr<const uint8_t*> AdvanceOffset();
 
+  // Returns the opcode of the next instruction and advances past it.
+  //
+  // In optimized builds this is a single load unless the function has
+  // breakpoints registered. The stack frame offset is then only synchronized
+  // when switching frames (which covers calls and returns) and by SyncOffset,
+  // which dispatch loops must call before returning. Debug builds always take
+  // the AdvanceOffset path so that instructions are traced.
+  ABSL_ATTRIBUTE_ALWAYS_INLINE StatusOr<uint8_t> ReadOpcode() {
+#ifdef NDEBUG
+    if (ABSL_PREDICT_TRUE(!breakpoint_table_)) {
+      return *bytecode_pc_++;
+    }
+#endif  // NDEBUG
+    ASSIGN_OR_RETURN(const uint8_t* opcode_ptr, AdvanceOffset());
+    return *opcode_ptr;
+  }
+
+  // Writes the current offset back to the current stack frame so that errors
+  // and stack dumps report the instruction being executed.
+  void SyncOffset() {
+    if (stack_frame_) *stack_frame_->mutable_offset() = offset();
+  }
+
   Status SwitchStackFrame(StackFrame* new_stack_frame);
   Status BranchToOffset(int32_t offset);
 
@@ -47,6 +82,11 @@ class BytecodeReader {
 
   StatusOr<hal::BufferView> ReadConstant();
 
+  // Reads a constant and writes its contents to |data|, which must be exactly
+  // the byte length of the constant. Splat constants are expanded in place
+  // instead of through an intermediate buffer.
+  Status ReadConstantInto(void* data, size_t data_length);
+
   ABSL_ATTRIBUTE_ALWAYS_INLINE StatusOr<int> ReadCount() {
     return ReadValue<uint8_t>();
   }
@@ -72,11 +112,7 @@ class BytecodeReader {
   ABSL_ATTRIBUTE_ALWAYS_INLINE StatusOr<hal::BufferView*> ReadLocal(
       absl::Span<hal::BufferView> locals) {
     ASSIGN_OR_RETURN(auto value, ReadValue<uint16_t>());
-    if (value > locals.size()) {
-      return OutOfRangeErrorBuilder(ABSL_LOC)
-             << "Out of bounds local access " << value << " of "
-             << locals.size();
-    }
+    DCHECK_LT(value, locals.size()) << "Out of bounds local access";
     return &locals[value];
   }
 
@@ -106,6 +142,9 @@ class BytecodeReader {
   ABSL_ATTRIBUTE_ALWAYS_INLINE StatusOr<absl::InlinedVector<T, N>>
   ReadSlotElements() {
     ASSIGN_OR_RETURN(auto* local, ReadLocal(locals_));
+    if (host_read_fn_) {
+      RETURN_IF_ERROR(host_read_fn_(local->buffer.get()));
+    }
     absl::InlinedVector<T, N> result(local->shape.element_count());
     if (sizeof(T) == local->element_size) {
       // Fast(ish) path: requested element size matches the actual element size.
@@ -146,9 +185,11 @@ class BytecodeReader {
   StatusOr<absl::Span<const int32_t>> ReadIndexList();
 
  private:
+  // Operands are not bounds checked as the BytecodeValidator has already
+  // verified that every instruction is fully contained within the function.
   template <typename T>
   ABSL_ATTRIBUTE_ALWAYS_INLINE StatusOr<T> ReadValue() {
-    // TODO(benvanik): validate bounds.
+    DCHECK_LE(bytecode_pc_ + sizeof(T), bytecode_limit_);
     T value = *reinterpret_cast<const T*>(bytecode_pc_);
     bytecode_pc_ += sizeof(T);
     return value;
@@ -161,6 +202,7 @@ class BytecodeReader {
   const uint8_t* bytecode_pc_ = nullptr;
   absl::Span<hal::BufferView> locals_;
   FunctionTable::BreakpointTable* breakpoint_table_ = nullptr;
+  HostReadFn host_read_fn_;
 };
 
 }  // namespace vm
@@ -14,13 +14,280 @@
 
 #include "third_party/mlir_edge/iree/vm/bytecode_validator.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "third_party/absl/base/macros.h"
+#include "third_party/absl/container/inlined_vector.h"
+#include "third_party/absl/strings/match.h"
+#include "third_party/absl/types/optional.h"
+#include "third_party/absl/types/span.h"
+#include "third_party/mlir_edge/iree/schemas/bytecode/bytecode_v0.h"
+#include "third_party/mlir_edge/iree/vm/type.h"
+
 namespace iree {
 namespace vm {
 
+namespace {
+
+// Walks the instructions of a single function and verifies every operand
+// against the bytecode contents and the owning module.
+class FunctionBytecodeValidator {
+ public:
+  FunctionBytecodeValidator(const Module& module, OpcodeTable opcode_table,
+                            const BytecodeDef& bytecode_def)
+      : module_(module),
+        opcode_table_(opcode_table),
+        local_count_(bytecode_def.local_count()),
+        data_(reinterpret_cast<const uint8_t*>(
+                  bytecode_def.contents()->data()),
+              bytecode_def.contents()->size()) {}
+
+  Status Validate() {
+    std::vector<bool> instruction_starts(data_.size(), false);
+    const OpcodeInfo* last_opcode_info = nullptr;
+    while (offset_ < data_.size()) {
+      instruction_offset_ = offset_;
+      instruction_starts[offset_] = true;
+      uint8_t opcode = data_[offset_++];
+      const auto& opcode_info = GetOpcodeInfo(opcode_table_, opcode);
+      if (!opcode_info.mnemonic ||
+          absl::StartsWith(opcode_info.mnemonic, "rsv.")) {
+        return InvalidArgumentErrorBuilder(ABSL_LOC)
+               << "Invalid opcode " << static_cast<int>(opcode)
+               << " at offset " << instruction_offset_;
+      }
+      RETURN_IF_ERROR(ValidateOperands(opcode_info));
+      last_opcode_info = &opcode_info;
+    }
+
+    // Execution must never run off the end of the function.
+    if (last_opcode_info) {
+      absl::string_view mnemonic = last_opcode_info->mnemonic;
+      if (mnemonic != "return" && mnemonic != "br" && mnemonic != "cond_br") {
+        return InvalidArgumentErrorBuilder(ABSL_LOC)
+               << "Function bytecode must end with a terminator but ends "
+                  "with "
+               << mnemonic;
+      }
+    }
+
+    // Branches must land on an instruction.
+    for (uint32_t block_offset : block_offsets_) {
+      if (block_offset >= data_.size() || !instruction_starts[block_offset]) {
+        return InvalidArgumentErrorBuilder(ABSL_LOC)
+               << "Branch target " << block_offset
+               << " is not the start of an instruction";
+      }
+    }
+
+    return OkStatus();
+  }
+
+ private:
+  template <typename T>
+  StatusOr<T> ReadValue() {
+    if (offset_ + sizeof(T) > data_.size()) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Bytecode underrun reading operand of instruction at offset "
+             << instruction_offset_;
+    }
+    T value = *reinterpret_cast<const T*>(&data_[offset_]);
+    offset_ += sizeof(T);
+    return value;
+  }
+
+  Status Skip(uint64_t length) {
+    if (offset_ + length > data_.size()) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Bytecode underrun reading operand of instruction at offset "
+             << instruction_offset_;
+    }
+    offset_ += length;
+    return OkStatus();
+  }
+
+  Status ValidateSlot() {
+    ASSIGN_OR_RETURN(uint16_t slot_ordinal, ReadValue<uint16_t>());
+    if (slot_ordinal >= local_count_) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Local " << slot_ordinal << " of instruction at offset "
+             << instruction_offset_ << " is out of range of "
+             << local_count_ << " locals";
+    }
+    return OkStatus();
+  }
+
+  StatusOr<int> ValidateSlots(int slots_per_entry) {
+    ASSIGN_OR_RETURN(uint8_t count, ReadValue<uint8_t>());
+    for (int i = 0; i < count * slots_per_entry; ++i) {
+      RETURN_IF_ERROR(ValidateSlot());
+    }
+    return count;
+  }
+
+  StatusOr<const Type> ValidateType() {
+    ASSIGN_OR_RETURN(uint8_t type_index, ReadValue<uint8_t>());
+    return Type::FromTypeIndex(type_index);
+  }
+
+  Status ValidateConstant() {
+    ASSIGN_OR_RETURN(auto type, ValidateType());
+    ASSIGN_OR_RETURN(uint8_t rank, ReadValue<uint8_t>());
+    // Clamped so that bogus shapes cannot overflow; anything larger than the
+    // bytecode fails the data bounds check below anyway.
+    uint64_t element_count = 1;
+    for (int i = 0; i < rank; ++i) {
+      ASSIGN_OR_RETURN(int32_t dim, ReadValue<int32_t>());
+      if (dim < 0) {
+        return InvalidArgumentErrorBuilder(ABSL_LOC)
+               << "Constant of instruction at offset " << instruction_offset_
+               << " has dynamic dimension " << i;
+      }
+      element_count = std::min<uint64_t>(element_count * dim,
+                                         data_.size() + 1);
+    }
+    ASSIGN_OR_RETURN(auto encoding, ReadValue<ConstantEncoding>());
+    switch (encoding) {
+      case ConstantEncoding::kDense:
+        return Skip(element_count * type.element_size());
+      case ConstantEncoding::kSplat:
+        return Skip(type.element_size());
+      default:
+        return InvalidArgumentErrorBuilder(ABSL_LOC)
+               << "Unknown constant encoding " << static_cast<int>(encoding)
+               << " of instruction at offset " << instruction_offset_;
+    }
+  }
+
+  Status ValidateOperands(const OpcodeInfo& opcode_info) {
+    // Callee arity is checked against the following variadic slot counts.
+    absl::optional<Function> callee;
+    int variadic_slot_lists = 0;
+    for (int i = 0; i < ABSL_ARRAYSIZE(opcode_info.operands); ++i) {
+      switch (opcode_info.operands[i]) {
+        case OperandEncoding::kNone:
+          return OkStatus();
+        case OperandEncoding::kInputSlot:
+        case OperandEncoding::kOutputSlot:
+        case OperandEncoding::kResultSlot:
+          RETURN_IF_ERROR(ValidateSlot());
+          break;
+        case OperandEncoding::kVariadicInputSlots:
+        case OperandEncoding::kVariadicOutputSlots:
+        case OperandEncoding::kVariadicResultSlots: {
+          ASSIGN_OR_RETURN(int count, ValidateSlots(1));
+          if (callee.has_value()) {
+            int expected_count = variadic_slot_lists++ == 0
+                                     ? callee->input_count()
+                                     : callee->result_count();
+            if (count != expected_count) {
+              return InvalidArgumentErrorBuilder(ABSL_LOC)
+                     << "Call at offset " << instruction_offset_ << " to "
+                     << callee->name() << " passes " << count
+                     << " values but " << expected_count << " are expected";
+            }
+          }
+          break;
+        }
+        case OperandEncoding::kVariadicTransferSlots:
+          RETURN_IF_ERROR(ValidateSlots(2).status());
+          break;
+        case OperandEncoding::kConstant:
+          RETURN_IF_ERROR(ValidateConstant());
+          break;
+        case OperandEncoding::kFunctionOrdinal: {
+          ASSIGN_OR_RETURN(uint32_t function_ordinal, ReadValue<uint32_t>());
+          ASSIGN_OR_RETURN(callee, module_.function_table().LookupFunction(
+                                       function_ordinal));
+          break;
+        }
+        case OperandEncoding::kImportOrdinal: {
+          ASSIGN_OR_RETURN(uint32_t import_ordinal, ReadValue<uint32_t>());
+          ASSIGN_OR_RETURN(
+              const auto* import_function,
+              module_.function_table().LookupImport(import_ordinal));
+          callee = *import_function;
+          break;
+        }
+        case OperandEncoding::kDispatchOrdinal:
+          // Executables are resolved when the dispatch is recorded.
+          RETURN_IF_ERROR(Skip(sizeof(uint32_t) + sizeof(uint16_t)));
+          break;
+        case OperandEncoding::kBlockOffset: {
+          ASSIGN_OR_RETURN(uint32_t block_offset, ReadValue<uint32_t>());
+          block_offsets_.push_back(block_offset);
+          break;
+        }
+        case OperandEncoding::kTypeIndex:
+          RETURN_IF_ERROR(ValidateType().status());
+          break;
+        case OperandEncoding::kIndex:
+          RETURN_IF_ERROR(Skip(sizeof(int32_t)));
+          break;
+        case OperandEncoding::kIndexList: {
+          ASSIGN_OR_RETURN(uint8_t count, ReadValue<uint8_t>());
+          RETURN_IF_ERROR(Skip(count * sizeof(int32_t)));
+          break;
+        }
+        case OperandEncoding::kCmpIPredicate:
+        case OperandEncoding::kCmpFPredicate:
+          RETURN_IF_ERROR(Skip(sizeof(uint8_t)));
+          break;
+        default:
+          return UnimplementedErrorBuilder(ABSL_LOC)
+                 << "Unhandled operand encoding "
+                 << static_cast<int>(opcode_info.operands[i])
+                 << " of instruction at offset " << instruction_offset_;
+      }
+    }
+    return OkStatus();
+  }
+
+  const Module& module_;
+  OpcodeTable opcode_table_;
+  int local_count_;
+  absl::Span<const uint8_t> data_;
+  size_t offset_ = 0;
+  size_t instruction_offset_ = 0;
+  absl::InlinedVector<uint32_t, 16> block_offsets_;
+};
+
+}  // namespace
+
 // static
 Status BytecodeValidator::Validate(const Context& context, const Module& module,
+                                   OpcodeTable opcode_table,
                                    const BytecodeDef& bytecode_def) {
-  // TODO(benvanik): validate bytecode.
+  // A function that declares bytecode must at least contain a terminator.
+  if (!bytecode_def.contents() || bytecode_def.contents()->size() == 0) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Function bytecode is empty and must end with a terminator";
+  }
+  FunctionBytecodeValidator validator(module, opcode_table, bytecode_def);
+  return validator.Validate();
+}
+
+// static
+Status BytecodeValidator::ValidateModule(const Context& context,
+                                         Module* module,
+                                         OpcodeTable opcode_table) {
+  const auto& functions = *module->function_table().def().functions();
+  for (int i = 0; i < functions.size(); ++i) {
+    const auto* bytecode_def = functions[i]->bytecode();
+    if (!bytecode_def) continue;
+    // Arguments are marshaled directly into the leading locals.
+    Function function(*module, *functions[i]);
+    if (bytecode_def->local_count() < function.input_count()) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Function " << function.name() << " has "
+             << bytecode_def->local_count() << " locals but takes "
+             << function.input_count() << " inputs";
+    }
+    RETURN_IF_ERROR(Validate(context, *module, opcode_table, *bytecode_def))
+        << "Invalid bytecode in function " << function.name();
+  }
+  module->set_bytecode_validated();
   return OkStatus();
 }
 
@@ -19,6 +19,7 @@
 #include "third_party/mlir_edge/iree/schemas/bytecode_def_generated.h"
 #include "third_party/mlir_edge/iree/vm/context.h"
 #include "third_party/mlir_edge/iree/vm/module.h"
+#include "third_party/mlir_edge/iree/vm/opcode_info.h"
 
 namespace iree {
 namespace vm {
@@ -26,10 +27,25 @@ namespace vm {
 // Validates bytecode such that success indicates the bytecode does not
 // reference undefined types, functions, or required imports and all imports can
 // be resolved with matching signatures.
+//
+// Validation checks every instruction against |opcode_table|: opcodes must be
+// defined, functions must be non-empty and end with a terminator, operands must
+// lie within the bytecode, local slots must be within the function
+// local_count, constants must be fully present, and branch targets must be
+// instruction boundaries. The BytecodeReader relies on this to skip bounds
+// checks when executing and refuses to execute modules that have not been
+// validated.
 class BytecodeValidator {
  public:
+  // Validates the bytecode of a single function.
   static Status Validate(const Context& context, const Module& module,
+                         OpcodeTable opcode_table,
                          const BytecodeDef& bytecode_def);
+
+  // Validates the bytecode of all functions in |module| and marks the module
+  // as validated.
+  static Status ValidateModule(const Context& context, Module* module,
+                               OpcodeTable opcode_table);
 };
 
 }  // namespace vm
@@ -40,8 +40,13 @@ Status Context::RegisterNativeFunction(std::string name,
 }
 
 Status Context::RegisterModule(std::unique_ptr<Module> module) {
-  // Attempt to link the module.
-  RETURN_IF_ERROR(module->mutable_function_table()->ResolveImports(
+  RETURN_IF_ERROR(LinkModule(module.get()));
+  AddLinkedModule(std::move(module));
+  return OkStatus();
+}
+
+Status Context::LinkModule(Module* module) {
+  return module->mutable_function_table()->ResolveImports(
       [&](const Module& importing_module,
           const FunctionDef& import_function_def) -> StatusOr<ImportFunction> {
         absl::string_view export_name = WrapString(import_function_def.name());
@@ -72,10 +77,11 @@ Status Context::RegisterModule(std::unique_ptr<Module> module) {
 
         return NotFoundErrorBuilder(ABSL_LOC)
                << "Import '" << export_name << "' could not be resolved";
-      }));
+      });
+}
 
+void Context::AddLinkedModule(std::unique_ptr<Module> module) {
   modules_.push_back(std::move(module));
-  return OkStatus();
 }
 
 StatusOr<const Module*> Context::LookupModule(
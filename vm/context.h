@@ -79,6 +79,15 @@ class Context {
   StatusOr<Module*> LookupModule(absl::string_view module_name);
   StatusOr<const Function> LookupExport(absl::string_view export_name) const;
 
+ protected:
+  // Resolves the imports of |module| against the registered native functions
+  // and modules. |module| itself is not registered so that subclasses may
+  // reject it after linking.
+  Status LinkModule(Module* module);
+
+  // Registers a |module| that has been linked with LinkModule.
+  void AddLinkedModule(std::unique_ptr<Module> module);
+
  private:
   int id_;
   std::vector<std::pair<std::string, NativeFunction>> native_functions_;
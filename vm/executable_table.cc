@@ -14,8 +14,12 @@
 
 #include "third_party/mlir_edge/iree/vm/executable_table.h"
 
+#include <utility>
+
 #include "third_party/mlir_edge/iree/base/flatbuffer_util.h"
 #include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/base/tracing.h"
+#include "third_party/mlir_edge/iree/hal/executable_spec.h"
 
 namespace iree {
 namespace vm {
@@ -61,5 +65,79 @@ ExecutableTable::LookupMultiArchExecutable(int executable_ordinal) const {
       executable_ordinal);
 }
 
+StatusOr<hal::Executable*> ExecutableTable::LookupExecutable(
+    const std::shared_ptr<hal::Device>& device, int executable_ordinal) const {
+  ASSIGN_OR_RETURN(const auto* multi_arch_executable_def,
+                   LookupMultiArchExecutable(executable_ordinal));
+
+  absl::MutexLock lock(&mutex_);
+  auto it = device_executables_.find(device.get());
+  if (it == device_executables_.end() || it->second.device.lock() != device) {
+    // Either the first lookup for the device or the entry belongs to a
+    // destroyed device that was at the same address. Drop the executables
+    // held for all destroyed devices before preparing for this one.
+    for (auto prune_it = device_executables_.begin();
+         prune_it != device_executables_.end();) {
+      if (prune_it->second.device.expired()) {
+        device_executables_.erase(prune_it++);
+      } else {
+        ++prune_it;
+      }
+    }
+    DeviceExecutables device_executables;
+    device_executables.device = device;
+    device_executables.executable_cache = device->CreateExecutableCache();
+    device_executables.executables.resize(
+        executable_table_def_.multi_arch_executables()->size());
+    it = device_executables_
+             .emplace(device.get(), std::move(device_executables))
+             .first;
+  }
+  auto& device_executables = it->second;
+  auto& executable = device_executables.executables[executable_ordinal];
+  if (executable) {
+    return executable.get();
+  }
+
+  // NOTE: preparation happens under the lock. This only occurs once per
+  // executable per device and keeps concurrent callers from preparing the
+  // same executable multiple times.
+  ASSIGN_OR_RETURN(executable,
+                   PrepareExecutable(device_executables.executable_cache.get(),
+                                     *multi_arch_executable_def));
+  return executable.get();
+}
+
+StatusOr<ref_ptr<hal::Executable>> ExecutableTable::PrepareExecutable(
+    hal::ExecutableCache* executable_cache,
+    const MultiArchExecutableDef& multi_arch_executable_def) const {
+  IREE_TRACE_SCOPE0("ExecutableTable::PrepareExecutable");
+  for (auto* executable_def : *multi_arch_executable_def.executables()) {
+    if (!executable_cache->CanPrepareFormat(executable_def->format())) {
+      continue;
+    }
+    hal::ExecutableSpec executable_spec;
+    executable_spec.format = executable_def->format();
+    executable_spec.executable_data =
+        absl::Span<const uint8_t>(executable_def->contents()->data(),
+                                  executable_def->contents()->size());
+    auto caching_mode = hal::ExecutableCachingMode::kDefault |
+                        hal::ExecutableCachingMode::kAliasProvidedData;
+    auto supported_features =
+        static_cast<uint32_t>(executable_def->supported_features());
+    if (supported_features &
+        static_cast<uint32_t>(ExecutableFeature::kFastMath)) {
+      caching_mode |= hal::ExecutableCachingMode::kAllowFastMath;
+    }
+    if (supported_features &
+        static_cast<uint32_t>(ExecutableFeature::kCompensatedSummation)) {
+      caching_mode |= hal::ExecutableCachingMode::kCompensatedSummation;
+    }
+    return executable_cache->PrepareExecutable(caching_mode, executable_spec);
+  }
+  return InvalidArgumentErrorBuilder(ABSL_LOC)
+         << "No executable found for the current driver";
+}
+
 }  // namespace vm
 }  // namespace iree
@@ -15,7 +15,17 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_VM_EXECUTABLE_TABLE_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_VM_EXECUTABLE_TABLE_H_
 
+#include <memory>
+#include <vector>
+
+#include "third_party/absl/base/thread_annotations.h"
+#include "third_party/absl/container/flat_hash_map.h"
+#include "third_party/absl/synchronization/mutex.h"
+#include "third_party/mlir_edge/iree/base/ref_ptr.h"
 #include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/device.h"
+#include "third_party/mlir_edge/iree/hal/executable.h"
+#include "third_party/mlir_edge/iree/hal/executable_cache.h"
 #include "third_party/mlir_edge/iree/schemas/executable_table_def_generated.h"
 
 namespace iree {
@@ -42,10 +52,38 @@ class ExecutableTable {
 
   // TODO(benvanik): resolve executable by ID+format+features (ExecutableDef).
 
-  // TODO(benvanik): insert/get HAL executables (thread-safe!).
+  // Returns a HAL executable prepared for |device| from the multi-arch
+  // executable with the given ordinal. Executables are prepared on first use
+  // and retained by the table so that subsequent lookups for the same
+  // device and ordinal are just a table lookup. Executables prepared for
+  // devices that have since been destroyed are released on the next miss.
+  //
+  // The returned executable is valid for as long as both the table and
+  // |device| are alive.
+  StatusOr<hal::Executable*> LookupExecutable(
+      const std::shared_ptr<hal::Device>& device, int executable_ordinal) const;
 
  private:
+  // Prepared executables for a single device, indexed by executable ordinal.
+  struct DeviceExecutables {
+    // The device the executables were prepared for. Entries are keyed by the
+    // raw device pointer so this detects when the device has been destroyed
+    // and another allocated at the same address.
+    std::weak_ptr<hal::Device> device;
+    // The cache the executables were prepared with. It must outlive them.
+    std::shared_ptr<hal::ExecutableCache> executable_cache;
+    std::vector<ref_ptr<hal::Executable>> executables;
+  };
+
+  StatusOr<ref_ptr<hal::Executable>> PrepareExecutable(
+      hal::ExecutableCache* executable_cache,
+      const MultiArchExecutableDef& multi_arch_executable_def) const;
+
   const ExecutableTableDef& executable_table_def_;
+
+  mutable absl::Mutex mutex_;
+  mutable absl::flat_hash_map<hal::Device*, DeviceExecutables>
+      device_executables_ ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace vm
@@ -14,7 +14,7 @@
 
 #include "third_party/mlir_edge/iree/vm/fiber_state.h"
 
-#include <iterator>
+#include <vector>
 
 #include "third_party/absl/strings/str_join.h"
 #include "third_party/mlir_edge/iree/base/status.h"
@@ -57,18 +57,20 @@ Status FiberState::Step(StepTarget step_target,
 
 namespace {
 struct StackFrameFormatter {
-  void operator()(std::string* out, const StackFrame& stack_frame) const {
-    out->append(absl::StrCat(stack_frame.module().name(), ":",
-                             stack_frame.function().name(), "@",
-                             stack_frame.offset()));
+  void operator()(std::string* out, const StackFrame* stack_frame) const {
+    out->append(absl::StrCat(stack_frame->module().name(), ":",
+                             stack_frame->function().name(), "@",
+                             stack_frame->offset()));
   }
 };
 }  // namespace
 
 std::string FiberState::DebugString() const {
-  auto frames = stack_.frames();
-  return absl::StrJoin(frames.begin(), frames.end(), "\n",
-                       StackFrameFormatter());
+  std::vector<const StackFrame*> frames(stack_.depth());
+  for (int i = 0; i < frames.size(); ++i) {
+    frames[i] = &stack_.frame(i);
+  }
+  return absl::StrJoin(frames, "\n", StackFrameFormatter());
 }
 
 }  // namespace vm
@@ -97,6 +97,9 @@ class FunctionTable {
 
   using BreakpointTable = absl::flat_hash_map<int, BreakpointCallback>;
 
+  // Returns true if breakpoints have been registered for any function.
+  bool has_breakpoints() const { return !breakpoint_tables_.empty(); }
+
   // Returns the breakpoint table mapping offset to breakpoint callback.
   // Returns nullptr if the given function does not have a breakpoint table.
   //
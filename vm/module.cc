@@ -16,6 +16,9 @@
 
 #include "third_party/absl/memory/memory.h"
 #include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/base/tracing.h"
+#include "third_party/mlir_edge/iree/hal/heap_buffer.h"
+#include "third_party/mlir_edge/iree/vm/sequencer_command_batch.h"
 
 namespace iree {
 namespace vm {
@@ -73,5 +76,69 @@ Module::Module(std::unique_ptr<ModuleFile> module_file)
 
 Module::~Module() = default;
 
+StatusOr<hal::BufferView> Module::GetOrAllocateStatic(
+    const FunctionDef& function_def, int offset, const Shape& shape,
+    const hal::BufferView& initial_value) const {
+  absl::MutexLock lock(&static_mutex_);
+  auto key = std::make_pair(&function_def, offset);
+  auto it = static_buffers_.find(key);
+  if (it != static_buffers_.end()) {
+    return it->second;
+  }
+
+  IREE_TRACE_SCOPE0("Module::GetOrAllocateStatic");
+  hal::BufferView buffer_view;
+  buffer_view.shape = shape;
+  buffer_view.element_size = initial_value.element_size;
+  size_t allocation_size = buffer_view.byte_length();
+  if (initial_value.byte_length() != allocation_size) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Static initial value " << initial_value.DebugStringShort()
+           << " does not match static shape " << shape.DebugString();
+  }
+
+  if (allocation_size <= static_arena_.block_size()) {
+    uint8_t* data = static_arena_.AllocateBytes(allocation_size);
+    buffer_view.buffer = hal::HeapBuffer::WrapMutable(
+        hal::MemoryType::kHostLocal, hal::MemoryAccess::kAll,
+        hal::BufferUsage::kAll, data, allocation_size);
+  } else {
+    buffer_view.buffer = hal::HeapBuffer::AllocateUninitialized(
+        hal::MemoryType::kHostLocal, hal::BufferUsage::kAll, allocation_size);
+  }
+  if (allocation_size > 0) {
+    RETURN_IF_ERROR(buffer_view.buffer->CopyData(
+        0, initial_value.buffer.get(), 0, allocation_size));
+  }
+
+  static_buffers_.emplace(key, buffer_view);
+  return buffer_view;
+}
+
+RecordedCommandSequence* Module::GetOrCreateRecordedCommands(
+    const FunctionDef& function_def, int offset,
+    const std::shared_ptr<hal::Device>& device) const {
+  absl::MutexLock lock(&recorded_commands_mutex_);
+  auto key = std::make_tuple(&function_def, offset, device.get());
+  auto it = recorded_commands_.find(key);
+  if (it == recorded_commands_.end() || it->second.device.lock() != device) {
+    // Recorded command buffers reference device resources and must not be
+    // resubmitted to another device allocated at the same address.
+    for (auto prune_it = recorded_commands_.begin();
+         prune_it != recorded_commands_.end();) {
+      if (prune_it->second.device.expired()) {
+        recorded_commands_.erase(prune_it++);
+      } else {
+        ++prune_it;
+      }
+    }
+    RecordedCommands recorded_commands;
+    recorded_commands.device = device;
+    recorded_commands.sequence = absl::make_unique<RecordedCommandSequence>();
+    it = recorded_commands_.emplace(key, std::move(recorded_commands)).first;
+  }
+  return it->second.sequence.get();
+}
+
 }  // namespace vm
 }  // namespace iree
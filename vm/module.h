@@ -16,8 +16,16 @@
 #define THIRD_PARTY_MLIR_EDGE_IREE_VM_MODULE_H_
 
 #include <memory>
+#include <tuple>
+#include <utility>
 
+#include "third_party/absl/base/thread_annotations.h"
+#include "third_party/absl/container/flat_hash_map.h"
+#include "third_party/absl/synchronization/mutex.h"
+#include "third_party/mlir_edge/iree/base/arena.h"
 #include "third_party/mlir_edge/iree/base/flatbuffer_util.h"
+#include "third_party/mlir_edge/iree/base/shape.h"
+#include "third_party/mlir_edge/iree/hal/buffer_view.h"
 #include "third_party/mlir_edge/iree/schemas/module_def_generated.h"
 #include "third_party/mlir_edge/iree/vm/executable_table.h"
 #include "third_party/mlir_edge/iree/vm/function_table.h"
@@ -25,6 +33,8 @@
 namespace iree {
 namespace vm {
 
+class RecordedCommandSequence;
+
 using ModuleFile = FlatBufferFile<ModuleDef>;
 
 // A loaded bytecode module.
@@ -48,6 +58,31 @@ class Module {
   const ExecutableTable& executable_table() const { return executable_table_; }
   ExecutableTable* mutable_executable_table() { return &executable_table_; }
 
+  // True once BytecodeValidator has verified all function bytecode in the
+  // module. BytecodeReader only executes validated modules as it elides
+  // bounds checks on operands.
+  bool bytecode_validated() const { return bytecode_validated_; }
+  void set_bytecode_validated() { bytecode_validated_ = true; }
+
+  // Returns the buffer for the alloc_static at |offset| within |function_def|.
+  // The first request allocates the buffer from the module static storage and
+  // initializes it with the contents of |initial_value|; all later requests
+  // (from any invocation or thread) return the same buffer. Static buffers
+  // live as long as the module.
+  StatusOr<hal::BufferView> GetOrAllocateStatic(
+      const FunctionDef& function_def, int offset, const Shape& shape,
+      const hal::BufferView& initial_value) const;
+
+  // Returns the sequence the sequencer records the command batch beginning at
+  // |offset| within |function_def| into when executing on |device|. The first
+  // request creates an empty sequence; later requests (from any invocation or
+  // thread) return the same one so that it may be resubmitted. Recorded
+  // sequences live as long as both the module and |device|; sequences for
+  // destroyed devices are released when the next sequence is created.
+  RecordedCommandSequence* GetOrCreateRecordedCommands(
+      const FunctionDef& function_def, int offset,
+      const std::shared_ptr<hal::Device>& device) const;
+
  private:
   explicit Module(std::unique_ptr<ModuleFile> module_file);
 
@@ -55,6 +90,28 @@ class Module {
   const ModuleDef& module_def_;
   FunctionTable function_table_;
   ExecutableTable executable_table_;
+  bool bytecode_validated_ = false;
+
+  // Storage for alloc_static buffers, populated lazily as they are first hit.
+  // Small buffers are packed into the arena and larger ones get their own
+  // allocation.
+  mutable absl::Mutex static_mutex_;
+  mutable Arena static_arena_ ABSL_GUARDED_BY(static_mutex_);
+  mutable absl::flat_hash_map<std::pair<const FunctionDef*, int>,
+                              hal::BufferView>
+      static_buffers_ ABSL_GUARDED_BY(static_mutex_);
+
+  // Command sequences recorded by the sequencer, created as they are first hit.
+  // |device| detects entries left behind by a destroyed device whose address
+  // has been reused.
+  struct RecordedCommands {
+    std::weak_ptr<hal::Device> device;
+    std::unique_ptr<RecordedCommandSequence> sequence;
+  };
+  mutable absl::Mutex recorded_commands_mutex_;
+  mutable absl::flat_hash_map<std::tuple<const FunctionDef*, int, hal::Device*>,
+                              RecordedCommands>
+      recorded_commands_ ABSL_GUARDED_BY(recorded_commands_mutex_);
 };
 
 }  // namespace vm
@@ -0,0 +1,488 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/vm/sequencer_command_batch.h"
+
+#include <cstring>
+
+#include "third_party/absl/container/flat_hash_map.h"
+#include "third_party/absl/container/inlined_vector.h"
+#include "third_party/absl/time/time.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/base/tracing.h"
+#include "third_party/mlir_edge/iree/hal/command_queue.h"
+
+namespace iree {
+namespace vm {
+
+namespace {
+
+// Returns true if |lhs| and |rhs| differ only in the buffers they reference.
+bool SameParameters(const SequencerCommand& lhs, const SequencerCommand& rhs) {
+  if (lhs.type != rhs.type || lhs.buffers.size() != rhs.buffers.size() ||
+      lhs.source_offset != rhs.source_offset ||
+      lhs.target_offset != rhs.target_offset || lhs.length != rhs.length ||
+      lhs.pattern_length != rhs.pattern_length ||
+      std::memcmp(lhs.pattern, rhs.pattern, sizeof(lhs.pattern)) != 0 ||
+      lhs.executable != rhs.executable || lhs.entry_point != rhs.entry_point ||
+      lhs.workload != rhs.workload ||
+      lhs.has_workload_buffer != rhs.has_workload_buffer ||
+      lhs.bindings.size() != rhs.bindings.size()) {
+    return false;
+  }
+  for (int i = 0; i < lhs.bindings.size(); ++i) {
+    const auto& lhs_binding = lhs.bindings[i];
+    const auto& rhs_binding = rhs.bindings[i];
+    if (lhs_binding.access != rhs_binding.access ||
+        lhs_binding.element_size != rhs_binding.element_size ||
+        lhs_binding.shape != rhs_binding.shape) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Records |command| into |command_buffer| using |buffers| in place of the
+// buffers the command was issued with.
+Status RecordCommand(hal::CommandBuffer* command_buffer,
+                     const SequencerCommand& command,
+                     absl::Span<hal::Buffer* const> buffers) {
+  switch (command.type) {
+    case SequencerCommand::Type::kFillBuffer:
+      return command_buffer->FillBuffer(buffers[0], command.target_offset,
+                                        command.length, command.pattern,
+                                        command.pattern_length);
+    case SequencerCommand::Type::kFillBufferIndirect:
+      return command_buffer->FillBufferIndirect(buffers[0], buffers[1],
+                                                buffers[2], buffers[3]);
+    case SequencerCommand::Type::kCopyBuffer:
+      return command_buffer->CopyBuffer(buffers[0], command.source_offset,
+                                        buffers[1], command.target_offset,
+                                        command.length);
+    case SequencerCommand::Type::kDispatch: {
+      absl::InlinedVector<hal::BufferBinding, 8> bindings = command.bindings;
+      for (int i = 0; i < bindings.size(); ++i) {
+        bindings[i].buffer = buffers[i];
+      }
+      hal::DispatchRequest dispatch_request;
+      dispatch_request.executable = command.executable;
+      dispatch_request.entry_point = command.entry_point;
+      dispatch_request.workload = command.workload;
+      dispatch_request.workload_buffer =
+          command.has_workload_buffer ? buffers.back() : nullptr;
+      dispatch_request.bindings = bindings;
+      return command_buffer->Dispatch(dispatch_request);
+    }
+  }
+  return InternalErrorBuilder(ABSL_LOC)
+         << "Unknown command type " << static_cast<int>(command.type);
+}
+
+}  // namespace
+
+bool SequencerCommand::IsWrite(int index) const {
+  switch (type) {
+    case Type::kFillBuffer:
+    case Type::kFillBufferIndirect:
+      return index == 0;
+    case Type::kCopyBuffer:
+      return index == 1;
+    case Type::kDispatch:
+      return index < bindings.size() &&
+             AnyBitSet(bindings[index].access & hal::MemoryAccess::kWrite);
+  }
+  return false;
+}
+
+bool SequencerCommand::IsIndirectParameter(int index) const {
+  switch (type) {
+    case Type::kFillBufferIndirect:
+      return index > 0;
+    case Type::kDispatch:
+      return has_workload_buffer &&
+             index == static_cast<int>(buffers.size()) - 1;
+    default:
+      return false;
+  }
+}
+
+RecordedCommandSequence::RecordedCommandSequence() = default;
+
+RecordedCommandSequence::~RecordedCommandSequence() = default;
+
+void RecordedCommandSequence::Reset() {
+  command_buffer_.reset();
+  commands_.clear();
+  buffer_refs_.clear();
+  slot_views_.clear();
+  slots_.clear();
+}
+
+void RecordedCommandSequence::ResetAllocations() {
+  for (auto& slot : slots_) {
+    slot->ResetAllocation();
+  }
+}
+
+SequencerCommandBatch::SequencerCommandBatch(hal::Device* device)
+    : device_(device) {}
+
+SequencerCommandBatch::~SequencerCommandBatch() { Reset(); }
+
+void SequencerCommandBatch::set_recording_fn(RecordingFn recording_fn) {
+  if (AllBitsSet(device_->info().supported_features(),
+                 hal::DeviceFeature::kDeferredBinding)) {
+    recording_fn_ = std::move(recording_fn);
+  }
+}
+
+void SequencerCommandBatch::Issue(SequencerCommand command) {
+  if (commands_.empty() && recording_fn_) {
+    auto* recording = recording_fn_();
+    if (recording && recording->mutex_.TryLock()) {
+      recording_ = recording;
+    }
+  }
+  for (int i = 0; i < command.buffers.size(); ++i) {
+    auto* buffer = command.buffers[i];
+    retained_buffers_.push_back(add_ref(buffer));
+    if (command.IsWrite(i)) {
+      pending_write_set_.insert(buffer->allocated_buffer());
+    } else {
+      pending_read_set_.insert(buffer->allocated_buffer());
+    }
+  }
+  commands_.push_back(std::move(command));
+}
+
+Status SequencerCommandBatch::FillBuffer(hal::Buffer* target_buffer,
+                                         device_size_t target_offset,
+                                         device_size_t length,
+                                         const void* pattern,
+                                         size_t pattern_length) {
+  SequencerCommand command;
+  if (pattern_length > sizeof(command.pattern)) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Fill pattern length " << pattern_length << " is too large";
+  }
+  command.type = SequencerCommand::Type::kFillBuffer;
+  command.buffers.push_back(target_buffer);
+  command.target_offset = target_offset;
+  command.length = length;
+  std::memcpy(command.pattern, pattern, pattern_length);
+  command.pattern_length = pattern_length;
+  Issue(std::move(command));
+  return OkStatus();
+}
+
+Status SequencerCommandBatch::FillBufferIndirect(hal::Buffer* target_buffer,
+                                                 hal::Buffer* value_buffer,
+                                                 hal::Buffer* offset_buffer,
+                                                 hal::Buffer* length_buffer) {
+  SequencerCommand command;
+  command.type = SequencerCommand::Type::kFillBufferIndirect;
+  command.buffers = {target_buffer, value_buffer, offset_buffer,
+                     length_buffer};
+  Issue(std::move(command));
+  return OkStatus();
+}
+
+Status SequencerCommandBatch::CopyBuffer(hal::Buffer* source_buffer,
+                                         device_size_t source_offset,
+                                         hal::Buffer* target_buffer,
+                                         device_size_t target_offset,
+                                         device_size_t length) {
+  SequencerCommand command;
+  command.type = SequencerCommand::Type::kCopyBuffer;
+  command.buffers = {source_buffer, target_buffer};
+  command.source_offset = source_offset;
+  command.target_offset = target_offset;
+  command.length = length;
+  Issue(std::move(command));
+  return OkStatus();
+}
+
+Status SequencerCommandBatch::Dispatch(
+    const hal::DispatchRequest& dispatch_request) {
+  SequencerCommand command;
+  command.type = SequencerCommand::Type::kDispatch;
+  command.executable = dispatch_request.executable;
+  command.entry_point = dispatch_request.entry_point;
+  command.workload = dispatch_request.workload;
+  command.bindings.assign(dispatch_request.bindings.begin(),
+                          dispatch_request.bindings.end());
+  for (const auto& binding : dispatch_request.bindings) {
+    command.buffers.push_back(binding.buffer);
+  }
+  if (dispatch_request.workload_buffer) {
+    command.has_workload_buffer = true;
+    command.buffers.push_back(dispatch_request.workload_buffer);
+  }
+  Issue(std::move(command));
+  return OkStatus();
+}
+
+StatusOr<ref_ptr<hal::CommandBuffer>> SequencerCommandBatch::RecordCommands(
+    hal::CommandBufferModeBitfield mode,
+    absl::Span<hal::Buffer* const> buffers) {
+  IREE_TRACE_SCOPE0("SequencerCommandBatch::RecordCommands");
+  ASSIGN_OR_RETURN(
+      auto command_buffer,
+      device_->CreateCommandBuffer(
+          mode,
+          hal::CommandCategory::kTransfer | hal::CommandCategory::kDispatch));
+  RETURN_IF_ERROR(command_buffer->Begin());
+
+  // Allocations read and written since the last barrier.
+  absl::flat_hash_set<hal::Buffer*> barrier_read_set;
+  absl::flat_hash_set<hal::Buffer*> barrier_write_set;
+
+  size_t buffer_index = 0;
+  for (const auto& command : commands_) {
+    auto command_buffers =
+        buffers.subspan(buffer_index, command.buffers.size());
+    buffer_index += command.buffers.size();
+
+    // Insert an execution barrier if the command depends on commands
+    // recorded since the last barrier.
+    // Indirect parameters written by prior commands are read when the command
+    // is processed (such as by vkCmdDispatchIndirect) and not just by the
+    // dispatch/transfer itself so the barrier must cover that stage as well.
+    bool needs_barrier = false;
+    bool needs_indirect_barrier = false;
+    for (int i = 0; i < command_buffers.size(); ++i) {
+      auto* allocated_buffer = command_buffers[i]->allocated_buffer();
+      bool is_written = barrier_write_set.contains(allocated_buffer);
+      if (is_written ||
+          (command.IsWrite(i) && barrier_read_set.contains(allocated_buffer))) {
+        needs_barrier = true;
+      }
+      if (is_written && command.IsIndirectParameter(i)) {
+        needs_indirect_barrier = true;
+      }
+    }
+    if (needs_barrier) {
+      auto target_stage =
+          hal::ExecutionStage::kDispatch | hal::ExecutionStage::kTransfer;
+      hal::MemoryBarrier memory_barrier;
+      memory_barrier.source_scope =
+          hal::AccessScope::kDispatchWrite | hal::AccessScope::kTransferWrite;
+      memory_barrier.target_scope =
+          hal::AccessScope::kDispatchRead | hal::AccessScope::kDispatchWrite |
+          hal::AccessScope::kTransferRead | hal::AccessScope::kTransferWrite;
+      if (needs_indirect_barrier) {
+        target_stage |= hal::ExecutionStage::kCommandProcess;
+        memory_barrier.target_scope |= hal::AccessScope::kIndirectCommandRead;
+      }
+      RETURN_IF_ERROR(command_buffer->ExecutionBarrier(
+          hal::ExecutionStage::kDispatch | hal::ExecutionStage::kTransfer,
+          target_stage, {memory_barrier}, {}));
+      barrier_read_set.clear();
+      barrier_write_set.clear();
+    }
+    for (int i = 0; i < command_buffers.size(); ++i) {
+      auto* allocated_buffer = command_buffers[i]->allocated_buffer();
+      if (command.IsWrite(i)) {
+        barrier_write_set.insert(allocated_buffer);
+      } else {
+        barrier_read_set.insert(allocated_buffer);
+      }
+    }
+
+    RETURN_IF_ERROR(
+        RecordCommand(command_buffer.get(), command, command_buffers));
+  }
+
+  RETURN_IF_ERROR(command_buffer->End());
+  return command_buffer;
+}
+
+bool SequencerCommandBatch::BindRecording() {
+  auto& recording = *recording_;
+  if (!recording.command_buffer_ ||
+      recording.commands_.size() != commands_.size()) {
+    return false;
+  }
+
+  // Each slot must map to exactly one allocation and each allocation to
+  // exactly one slot; barriers were only recorded between uses of the same
+  // slot.
+  absl::InlinedVector<hal::Buffer*, 16> slot_allocations(
+      recording.slots_.size(), nullptr);
+  absl::flat_hash_set<hal::Buffer*> bound_allocations;
+  size_t buffer_index = 0;
+  for (int i = 0; i < commands_.size(); ++i) {
+    const auto& command = commands_[i];
+    if (!SameParameters(command, recording.commands_[i])) return false;
+    for (auto* buffer : command.buffers) {
+      const auto& buffer_ref = recording.buffer_refs_[buffer_index++];
+      if (buffer->byte_offset() != buffer_ref.byte_offset ||
+          buffer->byte_length() != buffer_ref.byte_length) {
+        return false;
+      }
+      auto* allocated_buffer = buffer->allocated_buffer();
+      auto*& slot_allocation = slot_allocations[buffer_ref.slot];
+      if (slot_allocation == allocated_buffer) continue;
+      const auto& slot = recording.slots_[buffer_ref.slot];
+      if (slot_allocation ||
+          allocated_buffer->memory_type() != slot->memory_type() ||
+          !bound_allocations.insert(allocated_buffer).second) {
+        return false;
+      }
+      slot_allocation = allocated_buffer;
+    }
+  }
+
+  for (int i = 0; i < slot_allocations.size(); ++i) {
+    if (!recording.slots_[i]
+             ->BindAllocation(add_ref(slot_allocations[i]), 0, kWholeBuffer)
+             .ok()) {
+      recording.ResetAllocations();
+      return false;
+    }
+  }
+  return true;
+}
+
+StatusOr<bool> SequencerCommandBatch::RecordForReuse() {
+  IREE_TRACE_SCOPE0("SequencerCommandBatch::RecordForReuse");
+  auto& recording = *recording_;
+  recording.Reset();
+
+  // Assign a slot to each distinct allocation and reference it through a view
+  // with the same range as the buffer the command was issued with.
+  auto* allocator = device_->allocator();
+  absl::flat_hash_map<hal::Buffer*, int> allocation_slots;
+  std::vector<hal::Buffer*> slot_allocations;
+  std::vector<hal::Buffer*> views;
+  for (const auto& command : commands_) {
+    for (auto* buffer : command.buffers) {
+      auto* allocated_buffer = buffer->allocated_buffer();
+      auto it = allocation_slots.find(allocated_buffer);
+      if (it == allocation_slots.end()) {
+        if (!allocator->CanUseBuffer(allocated_buffer,
+                                     allocated_buffer->usage())) {
+          recording.Reset();
+          return false;
+        }
+        it = allocation_slots
+                 .emplace(allocated_buffer, recording.slots_.size())
+                 .first;
+        recording.slots_.push_back(make_ref<hal::DeferredBuffer>(
+            allocator, allocated_buffer->memory_type(),
+            allocated_buffer->allowed_access(), allocated_buffer->usage(),
+            allocated_buffer->byte_length()));
+        slot_allocations.push_back(allocated_buffer);
+      }
+      ASSIGN_OR_RETURN(auto view,
+                       hal::Buffer::Subspan(
+                           add_ref(recording.slots_[it->second].get()),
+                           buffer->byte_offset(), buffer->byte_length()));
+      recording.buffer_refs_.push_back(
+          {it->second, buffer->byte_offset(), buffer->byte_length()});
+      views.push_back(view.get());
+      recording.slot_views_.push_back(std::move(view));
+    }
+  }
+
+  ASSIGN_OR_RETURN(recording.command_buffer_,
+                   RecordCommands(hal::CommandBufferMode::kNone, views));
+
+  // Keep only the parameters; the buffers of this batch may be released once
+  // it completes.
+  recording.commands_ = commands_;
+  size_t view_index = 0;
+  for (auto& command : recording.commands_) {
+    for (auto*& buffer : command.buffers) {
+      buffer = views[view_index++];
+    }
+  }
+
+  for (int i = 0; i < slot_allocations.size(); ++i) {
+    RETURN_IF_ERROR(recording.slots_[i]->BindAllocation(
+        add_ref(slot_allocations[i]), 0, kWholeBuffer));
+  }
+  return true;
+}
+
+Status SequencerCommandBatch::FlushForHostRead(hal::Buffer* buffer) {
+  if (!buffer || !pending_write_set_.contains(buffer->allocated_buffer())) {
+    return OkStatus();
+  }
+  return Flush();
+}
+
+Status SequencerCommandBatch::FlushForHostWrite(hal::Buffer* buffer) {
+  if (!buffer) return OkStatus();
+  auto* allocated_buffer = buffer->allocated_buffer();
+  if (!pending_write_set_.contains(allocated_buffer) &&
+      !pending_read_set_.contains(allocated_buffer)) {
+    return OkStatus();
+  }
+  return Flush();
+}
+
+Status SequencerCommandBatch::Flush() {
+  if (commands_.empty()) return OkStatus();
+  IREE_TRACE_SCOPE0("SequencerCommandBatch::Flush");
+
+  // Prefer resubmitting the recorded sequence; otherwise record the batch,
+  // into the sequence if possible so that the next batch can reuse it.
+  ref_ptr<hal::CommandBuffer> command_buffer;
+  if (recording_) {
+    bool has_recording = BindRecording();
+    if (!has_recording) {
+      ASSIGN_OR_RETURN(has_recording, RecordForReuse());
+    }
+    if (has_recording) {
+      command_buffer = add_ref(recording_->command_buffer_.get());
+    }
+  }
+  if (!command_buffer) {
+    absl::InlinedVector<hal::Buffer*, 32> buffers;
+    for (const auto& command : commands_) {
+      buffers.insert(buffers.end(), command.buffers.begin(),
+                     command.buffers.end());
+    }
+    ASSIGN_OR_RETURN(command_buffer,
+                     RecordCommands(hal::CommandBufferMode::kOneShot, buffers));
+  }
+
+  auto* command_buffer_ptr = command_buffer.get();
+  auto* queue = device_->dispatch_queues().front();
+  hal::SubmissionBatch batch;
+  batch.command_buffers = absl::MakeConstSpan(&command_buffer_ptr, 1);
+  ASSIGN_OR_RETURN(auto fence, device_->CreateFence(0u));
+  RETURN_IF_ERROR(queue->Submit(batch, {fence.get(), 1u}));
+  RETURN_IF_ERROR(
+      device_->WaitAllFences({{fence.get(), 1u}}, absl::InfiniteFuture()));
+
+  Reset();
+  return OkStatus();
+}
+
+void SequencerCommandBatch::Reset() {
+  if (recording_) {
+    recording_->ResetAllocations();
+    recording_->mutex_.Unlock();
+    recording_ = nullptr;
+  }
+  commands_.clear();
+  retained_buffers_.clear();
+  pending_read_set_.clear();
+  pending_write_set_.clear();
+}
+
+}  // namespace vm
+}  // namespace iree
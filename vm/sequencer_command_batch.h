@@ -0,0 +1,235 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_MLIR_EDGE_IREE_VM_SEQUENCER_COMMAND_BATCH_H_
+#define THIRD_PARTY_MLIR_EDGE_IREE_VM_SEQUENCER_COMMAND_BATCH_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "third_party/absl/container/flat_hash_set.h"
+#include "third_party/absl/container/inlined_vector.h"
+#include "third_party/absl/synchronization/mutex.h"
+#include "third_party/absl/types/span.h"
+#include "third_party/mlir_edge/iree/base/ref_ptr.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/buffer.h"
+#include "third_party/mlir_edge/iree/hal/command_buffer.h"
+#include "third_party/mlir_edge/iree/hal/deferred_buffer.h"
+#include "third_party/mlir_edge/iree/hal/device.h"
+
+namespace iree {
+namespace vm {
+
+// A command issued to a SequencerCommandBatch.
+// Commands are only recorded into a command buffer when the batch is flushed
+// so that a matching RecordedCommandSequence can be submitted instead.
+struct SequencerCommand {
+  enum class Type {
+    kFillBuffer,
+    kFillBufferIndirect,
+    kCopyBuffer,
+    kDispatch,
+  };
+  Type type;
+
+  // Buffers referenced by the command in a fixed order per type:
+  //   kFillBuffer: target
+  //   kFillBufferIndirect: target, value, offset, length
+  //   kCopyBuffer: source, target
+  //   kDispatch: one per binding followed by the optional workload buffer
+  absl::InlinedVector<hal::Buffer*, 8> buffers;
+
+  device_size_t source_offset = 0;
+  device_size_t target_offset = 0;
+  device_size_t length = 0;
+  uint8_t pattern[4] = {0};
+  size_t pattern_length = 0;
+
+  hal::Executable* executable = nullptr;
+  int entry_point = 0;
+  std::array<int32_t, 3> workload = {{0, 0, 0}};
+  bool has_workload_buffer = false;
+  // Binding buffers are taken from |buffers| when the command is recorded.
+  absl::InlinedVector<hal::BufferBinding, 8> bindings;
+
+  // True if buffers[|index|] is written by the command.
+  bool IsWrite(int index) const;
+
+  // True if buffers[|index|] holds indirect command parameters (such as the
+  // dispatch workload) that are read while the command is processed.
+  bool IsIndirectParameter(int index) const;
+};
+
+// A reusable command buffer recorded by a SequencerCommandBatch along with the
+// commands it contains.
+//
+// The recorded commands reference DeferredBuffer slots instead of the buffers
+// the sequencer passed in, one slot per distinct allocation. When a later batch
+// issues the same commands against allocations with the same aliasing the
+// slots are rebound to those allocations and the command buffer is submitted
+// again without being re-recorded.
+//
+// Only used on devices with hal::DeviceFeature::kDeferredBinding.
+//
+// Thread-safe; a sequence is only used by one batch at a time and batches
+// that find it in use fall back to recording a one-shot command buffer.
+class RecordedCommandSequence {
+ public:
+  RecordedCommandSequence();
+  RecordedCommandSequence(const RecordedCommandSequence&) = delete;
+  RecordedCommandSequence& operator=(const RecordedCommandSequence&) = delete;
+  ~RecordedCommandSequence();
+
+ private:
+  friend class SequencerCommandBatch;
+
+  // Location of a buffer referenced by a recorded command.
+  struct BufferRef {
+    int slot;
+    device_size_t byte_offset;
+    device_size_t byte_length;
+  };
+
+  // Drops the recorded command buffer and all slots.
+  void Reset();
+
+  // Unbinds all slots from their allocations.
+  void ResetAllocations();
+
+  // Held by the batch using the sequence from its first command until flush.
+  absl::Mutex mutex_;
+
+  ref_ptr<hal::CommandBuffer> command_buffer_;
+  // Recorded commands; buffer pointers reference |slot_views_|.
+  std::vector<SequencerCommand> commands_;
+  // Slot and range of each buffer in |commands_|, in order.
+  std::vector<BufferRef> buffer_refs_;
+  std::vector<ref_ptr<hal::DeferredBuffer>> slots_;
+  std::vector<ref_ptr<hal::Buffer>> slot_views_;
+};
+
+// Records transfer and dispatch commands issued by the sequencer into a single
+// command buffer that is only submitted once the host needs to observe the
+// results (or the sequence returns).
+//
+// Buffers referenced by recorded commands are retained until the batch has
+// been submitted and has completed so that locals may be reassigned or
+// discarded while commands are pending. Execution barriers are only inserted
+// between commands that have a read-after-write, write-after-read, or
+// write-after-write dependency on the same allocation.
+//
+// If a recording function is provided and the device supports deferred
+// binding then each batch is recorded into the RecordedCommandSequence it
+// returns for the first command of the batch and resubmitted from there on
+// later invocations. This turns the per-call recording cost of fixed command
+// sequences into a comparison of the issued commands and a single submit.
+//
+// Thread-compatible.
+class SequencerCommandBatch {
+ public:
+  // Returns the sequence the batch beginning at the current sequencer
+  // instruction should be recorded into, or nullptr to record a one-shot
+  // command buffer.
+  using RecordingFn = std::function<RecordedCommandSequence*()>;
+
+  explicit SequencerCommandBatch(hal::Device* device);
+  SequencerCommandBatch(const SequencerCommandBatch&) = delete;
+  SequencerCommandBatch& operator=(const SequencerCommandBatch&) = delete;
+  ~SequencerCommandBatch();
+
+  void set_recording_fn(RecordingFn recording_fn);
+
+  // True if commands have been issued that have not yet been submitted.
+  bool has_pending_commands() const { return !commands_.empty(); }
+
+  // Records a fill of |target_buffer| with the given repeating pattern.
+  Status FillBuffer(hal::Buffer* target_buffer,
+                    device_size_t target_offset, device_size_t length,
+                    const void* pattern, size_t pattern_length);
+
+  // Records a fill of |target_buffer| with the value, offset, and length read
+  // from the given buffers when the fill executes.
+  Status FillBufferIndirect(hal::Buffer* target_buffer,
+                            hal::Buffer* value_buffer,
+                            hal::Buffer* offset_buffer,
+                            hal::Buffer* length_buffer);
+
+  // Records a copy between two buffers.
+  Status CopyBuffer(hal::Buffer* source_buffer, device_size_t source_offset,
+                    hal::Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length);
+
+  // Records a dispatch. Bindings with MemoryAccess::kWrite are treated as
+  // being written by the dispatch and all others as read.
+  Status Dispatch(const hal::DispatchRequest& dispatch_request);
+
+  // Ensures that all pending writes to |buffer| have completed so that the
+  // host may read its contents. No-op if no pending command writes it.
+  Status FlushForHostRead(hal::Buffer* buffer);
+
+  // Ensures that all pending reads and writes of |buffer| have completed so
+  // that the host may write its contents. No-op if no pending command
+  // accesses it.
+  Status FlushForHostWrite(hal::Buffer* buffer);
+
+  // Submits all pending commands and waits for them to complete.
+  // No-op if there are no pending commands.
+  Status Flush();
+
+ private:
+  // Appends a command to the batch, retaining and tracking its buffers.
+  void Issue(SequencerCommand command);
+
+  // Records all pending commands into a new command buffer with |buffers|
+  // (in command order) in place of the buffers the commands were issued with.
+  StatusOr<ref_ptr<hal::CommandBuffer>> RecordCommands(
+      hal::CommandBufferModeBitfield mode,
+      absl::Span<hal::Buffer* const> buffers);
+
+  // Binds the slots of |recording_| to the allocations of the pending
+  // commands if they match the recorded commands. Returns false if the
+  // recording cannot be reused.
+  bool BindRecording();
+
+  // Records the pending commands into |recording_| and binds its slots.
+  // Returns false if the commands reference allocations the device cannot
+  // rebind.
+  StatusOr<bool> RecordForReuse();
+
+  // Drops all pending state after submission.
+  void Reset();
+
+  hal::Device* device_;
+  RecordingFn recording_fn_;
+
+  // Sequence used by the current batch, if any. Its mutex_ is held.
+  RecordedCommandSequence* recording_ = nullptr;
+
+  std::vector<SequencerCommand> commands_;
+
+  // Buffers referenced by pending commands. Retained until completion.
+  std::vector<ref_ptr<hal::Buffer>> retained_buffers_;
+
+  // Allocations read and written by any pending command.
+  absl::flat_hash_set<hal::Buffer*> pending_read_set_;
+  absl::flat_hash_set<hal::Buffer*> pending_write_set_;
+};
+
+}  // namespace vm
+}  // namespace iree
+
+#endif  // THIRD_PARTY_MLIR_EDGE_IREE_VM_SEQUENCER_COMMAND_BATCH_H_
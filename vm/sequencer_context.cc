@@ -14,9 +14,18 @@
 
 #include "third_party/mlir_edge/iree/vm/sequencer_context.h"
 
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "third_party/absl/container/inlined_vector.h"
+#include "third_party/absl/memory/memory.h"
+#include "third_party/absl/synchronization/blocking_counter.h"
 #include "third_party/mlir_edge/iree/base/flatbuffer_util.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/hal/buffer_view.h"
+#include "third_party/mlir_edge/iree/vm/bytecode_tables_sequencer.h"
+#include "third_party/mlir_edge/iree/vm/bytecode_validator.h"
 #include "third_party/mlir_edge/iree/vm/fiber_state.h"
 #include "third_party/mlir_edge/iree/vm/sequencer_dispatch.h"
 
@@ -107,7 +116,12 @@ Status SequencerContext::RegisterNativeFunction(
 
 Status SequencerContext::RegisterModule(std::unique_ptr<Module> module) {
   auto* module_ptr = module.get();
-  RETURN_IF_ERROR(Context::RegisterModule(std::move(module)));
+  // Validated after linking so that call_import targets can be checked but
+  // before registering so that invalid modules can never be resolved.
+  RETURN_IF_ERROR(LinkModule(module_ptr));
+  RETURN_IF_ERROR(BytecodeValidator::ValidateModule(*this, module_ptr,
+                                                    sequencer_opcode_table()));
+  AddLinkedModule(std::move(module));
   if (instance_->debug_server()) {
     RETURN_IF_ERROR(
         instance_->debug_server()->RegisterContextModule(this, module_ptr));
@@ -115,9 +129,157 @@ Status SequencerContext::RegisterModule(std::unique_ptr<Module> module) {
   return OkStatus();
 }
 
-Status SequencerContext::Invoke(FiberState* fiber_state, Function function,
-                                absl::Span<BufferView> args,
-                                absl::Span<BufferView> results) const {
+Status SequencerContext::Invoke(
+    FiberState* fiber_state, Function function, absl::Span<BufferView> args,
+    absl::Span<BufferView> results,
+    const hal::PlacementSpec& placement_spec) const {
+  ASSIGN_OR_RETURN(auto placement,
+                   instance_->device_manager()->ResolvePlacement(
+                       placement_spec));
+  return InvokeOnPlacement(fiber_state, function, args, results, placement);
+}
+
+Status SequencerContext::InvokeSharded(
+    FiberState* fiber_state, Function function, absl::Span<BufferView> args,
+    absl::Span<BufferView> results,
+    absl::Span<const hal::PlacementSpec> placement_specs) const {
+  if (placement_specs.empty()) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "At least one placement is required";
+  }
+  if (args.size() != function.input_count()) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Function " << function.name() << " requires "
+           << function.input_count() << " inputs but " << args.size()
+           << " provided";
+  }
+  if (results.size() != function.result_count()) {
+    return InvalidArgumentErrorBuilder(ABSL_LOC)
+           << "Function " << function.name() << " requires "
+           << function.result_count() << " outputs but " << results.size()
+           << " provided";
+  }
+  int shard_count = placement_specs.size();
+  if (shard_count == 1) {
+    return Invoke(fiber_state, function, args, results, placement_specs[0]);
+  }
+
+  std::vector<hal::DevicePlacement> placements;
+  placements.reserve(shard_count);
+  for (const auto& placement_spec : placement_specs) {
+    ASSIGN_OR_RETURN(auto placement,
+                     instance_->device_manager()->ResolvePlacement(
+                         placement_spec));
+    placements.push_back(std::move(placement));
+  }
+
+  // Split each arg into contiguous shards along the batch dimension. The
+  // shards alias the arg buffers so no data is copied.
+  std::vector<std::vector<BufferView>> shard_args(shard_count);
+  for (int i = 0; i < args.size(); ++i) {
+    const auto& arg = args[i];
+    if (arg.shape.empty() || arg.shape[0] % shard_count != 0) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Function " << function.name() << " argument " << i
+             << " with shape " << arg.shape.DebugString()
+             << " cannot be split into " << shard_count << " shards";
+    }
+    absl::InlinedVector<int32_t, kMaxRank> start_indices(arg.shape.size(), 0);
+    absl::InlinedVector<int32_t, kMaxRank> lengths(arg.shape.begin(),
+                                                   arg.shape.end());
+    lengths[0] = arg.shape[0] / shard_count;
+    for (int shard = 0; shard < shard_count; ++shard) {
+      start_indices[0] = shard * lengths[0];
+      ASSIGN_OR_RETURN(auto shard_arg, arg.Slice(start_indices, lengths));
+      shard_args[shard].push_back(std::move(shard_arg));
+    }
+  }
+
+  // Run each shard on a host thread of its placement's device so that shards
+  // of devices pinned to a CPU set are sequenced from those CPUs. The first
+  // shard uses |fiber_state| and the rest get their own fibers. Devices
+  // without host threads run their shard on a temporary thread instead.
+  std::vector<std::vector<BufferView>> shard_results(shard_count);
+  std::vector<Status> shard_statuses(shard_count);
+  std::vector<std::unique_ptr<FiberState>> shard_fiber_states;
+  shard_fiber_states.reserve(shard_count - 1);
+  for (int shard = 0; shard < shard_count; ++shard) {
+    shard_results[shard].resize(results.size());
+    if (shard > 0) {
+      shard_fiber_states.push_back(absl::make_unique<FiberState>(instance_));
+    }
+  }
+  absl::BlockingCounter pending_shards(shard_count);
+  auto invoke_shard = [&](int shard) {
+    auto* shard_fiber_state =
+        shard == 0 ? fiber_state : shard_fiber_states[shard - 1].get();
+    shard_statuses[shard] = InvokeOnPlacement(
+        shard_fiber_state, function, absl::MakeSpan(shard_args[shard]),
+        absl::MakeSpan(shard_results[shard]), placements[shard]);
+    pending_shards.DecrementCount();
+  };
+  std::vector<std::thread> fallback_threads;
+  for (int shard = 0; shard < shard_count; ++shard) {
+    auto schedule_status = placements[shard].device->ScheduleHostTask(
+        [&invoke_shard, shard]() { invoke_shard(shard); });
+    if (IsUnimplemented(schedule_status)) {
+      fallback_threads.emplace_back(
+          [&invoke_shard, shard]() { invoke_shard(shard); });
+    } else if (!schedule_status.ok()) {
+      shard_statuses[shard] = std::move(schedule_status);
+      pending_shards.DecrementCount();
+    }
+  }
+  pending_shards.Wait();
+  for (auto& fallback_thread : fallback_threads) {
+    fallback_thread.join();
+  }
+  for (int shard = 0; shard < shard_count; ++shard) {
+    RETURN_IF_ERROR(shard_statuses[shard]) << "Shard " << shard;
+  }
+
+  // Concatenate the shard results along the batch dimension.
+  for (int i = 0; i < results.size(); ++i) {
+    const auto& first_result = shard_results[0][i];
+    for (int shard = 1; shard < shard_count; ++shard) {
+      const auto& shard_result = shard_results[shard][i];
+      if (shard_result.shape != first_result.shape ||
+          shard_result.element_size != first_result.element_size) {
+        return InternalErrorBuilder(ABSL_LOC)
+               << "Shard " << shard << " result " << i << " "
+               << shard_result.DebugStringShort()
+               << " does not match shard 0 result "
+               << first_result.DebugStringShort();
+      }
+    }
+    if (first_result.shape.empty()) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Function " << function.name() << " result " << i
+             << " is a scalar and cannot be concatenated across shards";
+    }
+    auto shard_length = first_result.byte_length();
+    Shape result_shape = first_result.shape;
+    result_shape[0] *= shard_count;
+    ASSIGN_OR_RETURN(
+        auto result_buffer,
+        instance_->device_manager()->TryAllocateDeviceVisibleBuffer(
+            hal::BufferUsage::kAll, shard_length * shard_count, placements));
+    for (int shard = 0; shard < shard_count; ++shard) {
+      RETURN_IF_ERROR(result_buffer->CopyData(
+          shard * shard_length, shard_results[shard][i].buffer.get(), 0,
+          shard_length));
+    }
+    results[i] = BufferView(std::move(result_buffer), result_shape,
+                            first_result.element_size);
+  }
+
+  return OkStatus();
+}
+
+Status SequencerContext::InvokeOnPlacement(
+    FiberState* fiber_state, Function function, absl::Span<BufferView> args,
+    absl::Span<BufferView> results,
+    const hal::DevicePlacement& placement) const {
   // Verify arg/result counts.
   if (args.size() != function.input_count()) {
     return InvalidArgumentErrorBuilder(ABSL_LOC)
@@ -152,8 +314,6 @@ Status SequencerContext::Invoke(FiberState* fiber_state, Function function,
   //   record dispatch
   //   submit
   //   wait on fence
-  ASSIGN_OR_RETURN(auto placement,
-                   instance_->device_manager()->ResolvePlacement({}));
   RETURN_IF_ERROR(
       DispatchSequence(placement, stack, callee_stack_frame, results));
 
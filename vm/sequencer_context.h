@@ -22,6 +22,8 @@
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/base/status.h"
 #include "third_party/mlir_edge/iree/hal/buffer_view.h"
+#include "third_party/mlir_edge/iree/hal/device_manager.h"
+#include "third_party/mlir_edge/iree/hal/device_placement.h"
 #include "third_party/mlir_edge/iree/vm/context.h"
 #include "third_party/mlir_edge/iree/vm/function.h"
 #include "third_party/mlir_edge/iree/vm/instance.h"
@@ -43,9 +45,41 @@ class SequencerContext final : public Context {
   // TODO(benvanik): helpers to make passing args easier
   Status Invoke(FiberState* fiber_state, vm::Function function,
                 absl::Span<hal::BufferView> args,
-                absl::Span<hal::BufferView> results) const;
+                absl::Span<hal::BufferView> results) const {
+    return Invoke(fiber_state, function, args, results, {});
+  }
+
+  // Invokes |function| on the device placement resolved from
+  // |placement_spec|. Contexts running one model instance per device (such as
+  // one per socket) should pass a spec selecting their device so that all
+  // work and transient allocations stay local to it.
+  Status Invoke(FiberState* fiber_state, vm::Function function,
+                absl::Span<hal::BufferView> args,
+                absl::Span<hal::BufferView> results,
+                const hal::PlacementSpec& placement_spec) const;
+
+  // Invokes |function| data-parallel across one placement per entry in
+  // |placement_specs|. Each arg is split evenly along its outermost (batch)
+  // dimension into shards that must match the function signature and each
+  // shard runs concurrently on its own placement. Shard results are
+  // concatenated along the outermost dimension into |results|.
+  //
+  // Each shard is sequenced on a host thread of its placement's device (see
+  // hal::Device::ScheduleHostTask), pinned to the device CPUs where the device
+  // has a CPU set. |fiber_state| is used by the first shard and the remaining
+  // shards run on temporary fibers.
+  Status InvokeSharded(FiberState* fiber_state, vm::Function function,
+                       absl::Span<hal::BufferView> args,
+                       absl::Span<hal::BufferView> results,
+                       absl::Span<const hal::PlacementSpec> placement_specs)
+      const;
 
  private:
+  Status InvokeOnPlacement(FiberState* fiber_state, vm::Function function,
+                           absl::Span<hal::BufferView> args,
+                           absl::Span<hal::BufferView> results,
+                           const hal::DevicePlacement& placement) const;
+
   std::shared_ptr<Instance> instance_;
 };
 
@@ -0,0 +1,231 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "third_party/mlir_edge/iree/vm/sequencer_context.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "testing/base/public/gmock.h"
+#include "testing/base/public/gunit.h"
+#include "third_party/absl/memory/memory.h"
+#include "third_party/flatbuffers/include/flatbuffers/flatbuffers.h"
+#include "third_party/mlir_edge/iree/base/logging.h"
+#include "third_party/mlir_edge/iree/base/shape.h"
+#include "third_party/mlir_edge/iree/base/status.h"
+#include "third_party/mlir_edge/iree/hal/buffer_view.h"
+#include "third_party/mlir_edge/iree/hal/device_info.h"
+#include "third_party/mlir_edge/iree/hal/interpreter/interpreter_device.h"
+#include "third_party/mlir_edge/iree/schemas/bytecode/sequencer_bytecode_v0.h"
+#include "third_party/mlir_edge/iree/schemas/module_def_generated.h"
+#include "third_party/mlir_edge/iree/vm/fiber_state.h"
+#include "third_party/mlir_edge/iree/vm/instance.h"
+#include "third_party/mlir_edge/iree/vm/module.h"
+
+namespace iree {
+namespace vm {
+namespace {
+
+using ::iree::hal::BufferView;
+using ::testing::ElementsAreArray;
+
+constexpr int8_t kReturn = static_cast<int8_t>(SequencerOpcode::kReturn);
+
+// Returns an f32 memref type with the given |shape|.
+std::unique_ptr<TypeDefT> MakeMemRefType(std::vector<int> shape) {
+  FloatTypeDefT float_type;
+  float_type.width = 32;
+  MemRefTypeDefT memref_type;
+  memref_type.element_type = absl::make_unique<ElementTypeDefT>();
+  memref_type.element_type->type_union.Set(std::move(float_type));
+  memref_type.shape = std::move(shape);
+  auto type = absl::make_unique<TypeDefT>();
+  type->type_union.Set(std::move(memref_type));
+  return type;
+}
+
+// Returns a function "main" with |contents| as its bytecode.
+std::unique_ptr<FunctionDefT> MakeFunction(std::vector<int8_t> contents) {
+  auto function_def = absl::make_unique<FunctionDefT>();
+  function_def->name = "main";
+  function_def->type = absl::make_unique<FunctionTypeDefT>();
+  function_def->bytecode = absl::make_unique<BytecodeDefT>();
+  function_def->bytecode->contents = std::move(contents);
+  return function_def;
+}
+
+// Returns a function "main" that returns its f32 argument of |shape|.
+std::unique_ptr<FunctionDefT> MakeIdentityFunction(std::vector<int> shape) {
+  // return(count=1, local=0)
+  auto function_def = MakeFunction({kReturn, 1, 0, 0});
+  function_def->type->inputs.push_back(MakeMemRefType(shape));
+  function_def->type->results.push_back(MakeMemRefType(shape));
+  function_def->bytecode->local_count = 1;
+  return function_def;
+}
+
+// Builds a module exporting the single function |function_def|.
+std::unique_ptr<Module> MakeModule(std::unique_ptr<FunctionDefT> function_def) {
+  ModuleDefT module_def;
+  module_def.name = "module";
+  module_def.function_table = absl::make_unique<FunctionTableDefT>();
+  module_def.function_table->functions.push_back(std::move(function_def));
+  module_def.function_table->exports.push_back(0);
+  module_def.executable_table = absl::make_unique<ExecutableTableDefT>();
+
+  ::flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(ModuleDef::Pack(fbb, &module_def), ModuleDefIdentifier());
+  std::vector<uint8_t> buffer(fbb.GetBufferPointer(),
+                              fbb.GetBufferPointer() + fbb.GetSize());
+  auto module_file_or =
+      ModuleFile::FromBuffer(ModuleDefIdentifier(), std::move(buffer));
+  CHECK(module_file_or.ok()) << module_file_or.status();
+  auto module_or = Module::FromFile(std::move(module_file_or).ValueOrDie());
+  CHECK(module_or.ok()) << module_or.status();
+  return std::move(module_or).ValueOrDie();
+}
+
+TEST(SequencerContextTest, RegistersValidModule) {
+  SequencerContext context(std::make_shared<Instance>());
+  ASSERT_TRUE(context.RegisterModule(MakeModule(MakeFunction({kReturn, 0})))
+                  .ok());
+  EXPECT_EQ(1u, context.modules().size());
+  EXPECT_TRUE(context.LookupExport("main").ok());
+}
+
+TEST(SequencerContextTest, RejectsMalformedModule) {
+  SequencerContext context(std::make_shared<Instance>());
+  // The return is missing its result count operand.
+  auto status = context.RegisterModule(MakeModule(MakeFunction({kReturn})));
+  EXPECT_TRUE(IsInvalidArgument(status)) << status;
+
+  // Nothing from the rejected module may be resolved for invocation.
+  EXPECT_TRUE(context.modules().empty());
+  EXPECT_TRUE(IsNotFound(context.LookupExport("main").status()));
+}
+
+class SequencerContextShardingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    instance_ = std::make_shared<Instance>();
+    for (const char* name : {"cpu0", "cpu1"}) {
+      hal::InterpreterDevice::Options options;
+      options.worker_count = 0;
+      devices_.push_back(std::make_shared<hal::InterpreterDevice>(
+          hal::DeviceInfo(name, hal::DeviceFeature::kNone), options));
+      ASSERT_TRUE(
+          instance_->device_manager()->RegisterDevice(devices_.back()).ok());
+    }
+    placement_specs_.resize(devices_.size());
+    placement_specs_[0].device_name = "cpu0";
+    placement_specs_[1].device_name = "cpu1";
+    context_ = absl::make_unique<SequencerContext>(instance_);
+  }
+
+  // Registers a module with a function returning its argument of |shape|.
+  Function RegisterIdentityFunction(std::vector<int> shape) {
+    CHECK_OK(context_->RegisterModule(
+        MakeModule(MakeIdentityFunction(std::move(shape)))));
+    auto function_or = context_->LookupExport("main");
+    CHECK(function_or.ok()) << function_or.status();
+    return function_or.ValueOrDie();
+  }
+
+  // Returns a |rows|x|columns| f32 buffer view holding 0, 1, 2, ...
+  BufferView MakeIota(int rows, int columns) {
+    std::vector<float> contents(rows * columns);
+    for (size_t i = 0; i < contents.size(); ++i) contents[i] = i;
+    auto buffer_or = devices_[0]->allocator()->Allocate(
+        hal::MemoryType::kHostLocal | hal::MemoryType::kDeviceVisible,
+        hal::BufferUsage::kAll, contents.size() * sizeof(float));
+    CHECK(buffer_or.ok()) << buffer_or.status();
+    auto buffer = std::move(buffer_or).ValueOrDie();
+    CHECK_OK(buffer->WriteData(0, contents.data(),
+                               contents.size() * sizeof(float)));
+    return BufferView(std::move(buffer), Shape{rows, columns}, sizeof(float));
+  }
+
+  static std::vector<float> ReadContents(const BufferView& buffer_view) {
+    std::vector<float> contents(buffer_view.shape.element_count());
+    CHECK_OK(buffer_view.buffer->ReadData(0, contents.data(),
+                                          contents.size() * sizeof(float)));
+    return contents;
+  }
+
+  std::shared_ptr<Instance> instance_;
+  std::vector<std::shared_ptr<hal::Device>> devices_;
+  std::vector<hal::PlacementSpec> placement_specs_;
+  std::unique_ptr<SequencerContext> context_;
+};
+
+TEST_F(SequencerContextShardingTest, SplitsAndConcatenatesBatch) {
+  auto function = RegisterIdentityFunction({2, 3});
+  FiberState fiber_state(instance_);
+  std::vector<BufferView> args = {MakeIota(4, 3)};
+  std::vector<BufferView> results(1);
+  auto status = context_->InvokeSharded(&fiber_state, function,
+                                        absl::MakeSpan(args),
+                                        absl::MakeSpan(results),
+                                        placement_specs_);
+  ASSERT_TRUE(status.ok()) << status;
+
+  // Each shard returns its half of the batch and the halves are concatenated
+  // back in shard order.
+  EXPECT_EQ((Shape{4, 3}), results[0].shape);
+  EXPECT_THAT(ReadContents(results[0]),
+              ElementsAreArray(ReadContents(args[0])));
+}
+
+TEST_F(SequencerContextShardingTest, ShardsOnSameDevice) {
+  auto function = RegisterIdentityFunction({1, 3});
+  FiberState fiber_state(instance_);
+  std::vector<BufferView> args = {MakeIota(2, 3)};
+  std::vector<BufferView> results(1);
+  std::vector<hal::PlacementSpec> placement_specs(2, placement_specs_[1]);
+  auto status = context_->InvokeSharded(&fiber_state, function,
+                                        absl::MakeSpan(args),
+                                        absl::MakeSpan(results),
+                                        placement_specs);
+  ASSERT_TRUE(status.ok()) << status;
+  EXPECT_THAT(ReadContents(results[0]),
+              ElementsAreArray(ReadContents(args[0])));
+}
+
+TEST_F(SequencerContextShardingTest, RejectsIndivisibleBatch) {
+  auto function = RegisterIdentityFunction({2, 3});
+  FiberState fiber_state(instance_);
+  std::vector<BufferView> args = {MakeIota(5, 3)};
+  std::vector<BufferView> results(1);
+  EXPECT_TRUE(IsInvalidArgument(context_->InvokeSharded(
+      &fiber_state, function, absl::MakeSpan(args), absl::MakeSpan(results),
+      placement_specs_)));
+}
+
+TEST_F(SequencerContextShardingTest, RejectsShardsNotMatchingSignature) {
+  auto function = RegisterIdentityFunction({2, 3});
+  FiberState fiber_state(instance_);
+  // Splits evenly but into 3x3 shards.
+  std::vector<BufferView> args = {MakeIota(6, 3)};
+  std::vector<BufferView> results(1);
+  EXPECT_TRUE(IsInvalidArgument(context_->InvokeSharded(
+      &fiber_state, function, absl::MakeSpan(args), absl::MakeSpan(results),
+      placement_specs_)));
+}
+
+}  // namespace
+}  // namespace vm
+}  // namespace iree
@@ -13,7 +13,10 @@
 // limitations under the License.
 
 // Implements a full bytecode dispatch system for sequencer ops.
-// TODO(benvanik): rework to be async against CommandBuffers.
+//
+// Transfer and dispatch ops are recorded into a SequencerCommandBatch and are
+// only submitted when the host needs to observe their results (such as when
+// evaluating a branch condition or returning from the entry function).
 
 #include "third_party/mlir_edge/iree/vm/sequencer_dispatch.h"
 
@@ -37,6 +40,7 @@
 #include "third_party/mlir_edge/iree/vm/bytecode_util.h"
 #include "third_party/mlir_edge/iree/vm/function.h"
 #include "third_party/mlir_edge/iree/vm/opcode_info.h"
+#include "third_party/mlir_edge/iree/vm/sequencer_command_batch.h"
 
 namespace iree {
 namespace vm {
@@ -136,10 +140,27 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
   // into different functions.
   BytecodeReader reader(stack);
   RETURN_IF_ERROR(reader.SwitchStackFrame(entry_stack_frame));
+  // ReadOpcode does not update the frame offset in optimized builds so write
+  // it back however we leave; otherwise errors report a stale offset.
+  auto sync_offset = MakeCleanup([&reader]() { reader.SyncOffset(); });
+
+  // Commands recorded since the last time the host needed to observe results.
+  // Any op that reads buffer contents on the host must flush pending writes.
+  SequencerCommandBatch command_batch(placement.device.get());
+  reader.set_host_read_fn([&command_batch](hal::Buffer* buffer) {
+    return command_batch.FlushForHostRead(buffer);
+  });
+  // Each batch is recorded once per call site and resubmitted with the
+  // buffers of later invocations when the device supports rebinding them.
+  command_batch.set_recording_fn([stack, &reader, &placement]() {
+    const auto& function = stack->current_frame()->function();
+    return function.module().GetOrCreateRecordedCommands(
+        function.def(), reader.offset(), placement.device);
+  });
 
 #define DISPATCH_NEXT()                                                   \
   {                                                                       \
-    uint8_t opcode = *reader.AdvanceOffset().ValueOrDie();                \
+    ASSIGN_OR_RETURN(uint8_t opcode, reader.ReadOpcode());                \
     DVLOG(1) << "Sequencer dispatching op code: "                         \
              << GetOpcodeInfo(sequencer_opcode_table(), opcode).mnemonic; \
     goto* kDispatchTable[opcode];                                         \
@@ -183,6 +204,8 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
         break;
       }
       case ImportFunction::LinkType::kNativeFunction: {
+        // Native functions may access any buffer so we must flush all work.
+        RETURN_IF_ERROR(command_batch.Flush());
         ASSIGN_OR_RETURN(auto* new_stack_frame,
                          stack->PushFrame(*target_function));
         RETURN_IF_ERROR(reader.CopyInputsAndSwitchStackFrame(old_stack_frame,
@@ -206,7 +229,11 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     auto* old_stack_frame = stack->current_frame();
     auto* new_stack_frame = stack->caller_frame();
     if (old_stack_frame == entry_stack_frame) {
-      // Returning from entry function. Marshal results from the return stmt.
+      // Returning from entry function. Wait for all pending work so that the
+      // results are available to the caller.
+      RETURN_IF_ERROR(command_batch.Flush());
+
+      // Marshal results from the return stmt.
       ASSIGN_OR_RETURN(int32_t src_count, reader.ReadCount());
       for (int i = 0; i < src_count; ++i) {
         ASSIGN_OR_RETURN(auto* src_local,
@@ -234,6 +261,7 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     // Evaluate condition first so we can do the copies as we read them for
     // which side of the branch we take.
     ASSIGN_OR_RETURN(auto* cond_local, reader.ReadLocal());
+    RETURN_IF_ERROR(command_batch.FlushForHostRead(cond_local->buffer.get()));
     bool cond_value = BufferViewIsTrue(*cond_local);
     ASSIGN_OR_RETURN(int32_t true_offset, reader.ReadBlockOffset());
 
@@ -251,8 +279,57 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
   });
 
   DISPATCH_CORE_OPCODE(kDynamicDispatch, {
-    return UnimplementedErrorBuilder(ABSL_LOC)
-           << "Unimplemented dynamic_dispatch";
+    ASSIGN_OR_RETURN(auto dispatch_ordinal, reader.ReadInt32());
+    ASSIGN_OR_RETURN(auto export_ordinal, reader.ReadUint16_t());
+    auto& executable_table =
+        stack->current_frame()->module().executable_table();
+    ASSIGN_OR_RETURN(
+        auto* multi_arch_executable_def,
+        executable_table.LookupMultiArchExecutable(dispatch_ordinal));
+    if (export_ordinal >= multi_arch_executable_def->entry_point_count()) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Invalid executable export ordinal " << export_ordinal;
+    }
+    ASSIGN_OR_RETURN(auto* executable,
+                     executable_table.LookupExecutable(placement.device,
+                                                       dispatch_ordinal),
+                     _.LogError());
+
+    // The workload is consumed by the device when the dispatch executes so
+    // that values computed by prior commands need not be read back here.
+    ASSIGN_OR_RETURN(auto* workload_local, reader.ReadLocal());
+    if (workload_local->element_size != sizeof(int32_t) ||
+        workload_local->shape.element_count() != 3) {
+      return InvalidArgumentErrorBuilder(ABSL_LOC)
+             << "Dynamic workload must be 3 int32 values; got "
+             << workload_local->shape.DebugString() << " of "
+             << static_cast<int>(workload_local->element_size)
+             << " byte elements";
+    }
+
+    std::vector<hal::BufferBinding> bindings;
+    ASSIGN_OR_RETURN(int input_count, reader.ReadCount());
+    for (int i = 0; i < input_count; ++i) {
+      ASSIGN_OR_RETURN(auto* input_local, reader.ReadLocal());
+      bindings.push_back(
+          hal::BufferBinding(hal::MemoryAccess::kRead, *input_local));
+    }
+    ASSIGN_OR_RETURN(int output_count, reader.ReadCount());
+    for (int i = 0; i < output_count; ++i) {
+      ASSIGN_OR_RETURN(auto* output_local, reader.ReadLocal());
+      bindings.push_back(
+          hal::BufferBinding(hal::MemoryAccess::kWrite, *output_local));
+    }
+    ASSIGN_OR_RETURN(int result_count, reader.ReadCount());
+    CHECK_EQ(0, result_count) << "Results not yet implemented";
+
+    hal::DispatchRequest dispatch_request;
+    dispatch_request.executable = executable;
+    dispatch_request.entry_point = export_ordinal;
+    dispatch_request.workload = {0, 0, 0};
+    dispatch_request.workload_buffer = workload_local->buffer.get();
+    dispatch_request.bindings = bindings;
+    RETURN_IF_ERROR(command_batch.Dispatch(dispatch_request));
   });
 
   DISPATCH_CORE_OPCODE(kStaticDispatch, {
@@ -268,34 +345,10 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
       return InvalidArgumentErrorBuilder(ABSL_LOC)
              << "Invalid executable export ordinal " << export_ordinal;
     }
-    auto* executable_def = multi_arch_executable_def->executables()->Get(0);
-    hal::ExecutableSpec executable_spec;
-    executable_spec.format = executable_def->format();
-    executable_spec.executable_data = absl::Span<const uint8_t>(
-        executable_def->contents()->data(), executable_def->contents()->size());
-    auto executable_cache = placement.device->CreateExecutableCache();
-    ref_ptr<hal::Executable> executable;
-    for (auto* executable_def : *multi_arch_executable_def->executables()) {
-      if (!executable_cache->CanPrepareFormat(executable_def->format())) {
-        continue;
-      }
-      hal::ExecutableSpec executable_spec;
-      executable_spec.format = executable_def->format();
-      executable_spec.executable_data =
-          absl::Span<const uint8_t>(executable_def->contents()->data(),
-                                    executable_def->contents()->size());
-      ASSIGN_OR_RETURN(executable,
-                       executable_cache->PrepareExecutable(
-                           hal::ExecutableCachingMode::kDefault |
-                               hal::ExecutableCachingMode::kAliasProvidedData,
-                           executable_spec),
-                       _.LogError());
-      break;
-    }
-    if (!executable) {
-      return InvalidArgumentErrorBuilder(ABSL_LOC)
-             << "No executable found for the current driver";
-    }
+    ASSIGN_OR_RETURN(auto* executable,
+                     executable_table.LookupExecutable(placement.device,
+                                                       dispatch_ordinal),
+                     _.LogError());
 
     ASSIGN_OR_RETURN(int workload_x, reader.ReadInt32());
     ASSIGN_OR_RETURN(int workload_y, reader.ReadInt32());
@@ -305,9 +358,8 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     ASSIGN_OR_RETURN(int input_count, reader.ReadCount());
     for (int i = 0; i < input_count; ++i) {
       ASSIGN_OR_RETURN(auto* input_local, reader.ReadLocal());
-      bindings.push_back(hal::BufferBinding(
-          input_local->buffer->allowed_access() & hal::MemoryAccess::kAll,
-          *input_local));
+      bindings.push_back(
+          hal::BufferBinding(hal::MemoryAccess::kRead, *input_local));
     }
     ASSIGN_OR_RETURN(int output_count, reader.ReadCount());
     for (int i = 0; i < output_count; ++i) {
@@ -318,44 +370,39 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     ASSIGN_OR_RETURN(int result_count, reader.ReadCount());
     CHECK_EQ(0, result_count) << "Results not yet implemented";
 
-    ASSIGN_OR_RETURN(
-        auto cmd,
-        placement.device->CreateCommandBuffer(
-            hal::CommandBufferMode::kOneShot,
-            hal::CommandCategory::kTransfer | hal::CommandCategory::kDispatch),
-        _.LogError());
-    RETURN_IF_ERROR(cmd->Begin());
     hal::DispatchRequest dispatch_request;
-    dispatch_request.executable = executable.get();
+    dispatch_request.executable = executable;
     dispatch_request.entry_point = export_ordinal;
     dispatch_request.workload[0] = workload_x;
     dispatch_request.workload[1] = workload_y;
     dispatch_request.workload[2] = workload_z;
     dispatch_request.bindings = bindings;
-    RETURN_IF_ERROR(cmd->Dispatch(dispatch_request));
-    RETURN_IF_ERROR(cmd->End());
-    auto* cmd_ptr = cmd.get();
-
-    auto* queue = placement.device->dispatch_queues().front();
-    hal::SubmissionBatch batch;
-    batch.command_buffers = absl::MakeConstSpan(&cmd_ptr, 1);
-    ASSIGN_OR_RETURN(auto fence, placement.device->CreateFence(0u));
-    RETURN_IF_ERROR(queue->Submit(batch, {fence.get(), 1u}));
-    RETURN_IF_ERROR(placement.device->WaitAllFences({{fence.get(), 1u}},
-                                                    absl::InfiniteFuture()));
+    RETURN_IF_ERROR(command_batch.Dispatch(dispatch_request));
   });
 
   DISPATCH_CORE_OPCODE(kAllocStatic, {
-    return UnimplementedErrorBuilder(ABSL_LOC) << "Unimplemented alloc_static";
+    // The instruction offset identifies the static within the function.
+    int static_offset = reader.offset();
+    ASSIGN_OR_RETURN(auto shape_dims, reader.ReadIndexList());
+    ASSIGN_OR_RETURN(auto initial_value, reader.ReadConstant());
+    ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    const auto& function = stack->current_frame()->function();
+    ASSIGN_OR_RETURN(*dst_local, function.module().GetOrAllocateStatic(
+                                     function.def(), static_offset,
+                                     Shape(shape_dims), initial_value));
   });
 
+  // Frame storage is rewound when the frame is popped but commands referencing
+  // it may still be pending in the command batch, so stack allocations are
+  // only supported by the interpreter. The compiler never emits them here.
   DISPATCH_CORE_OPCODE(kAllocStack, {
-    return UnimplementedErrorBuilder(ABSL_LOC) << "Unimplemented alloc_stack";
+    return UnimplementedErrorBuilder(ABSL_LOC)
+           << "alloc_stack is not supported by the sequencer";
   });
 
   DISPATCH_CORE_OPCODE(kAllocStackInit, {
     return UnimplementedErrorBuilder(ABSL_LOC)
-           << "Unimplemented alloc_stack_init";
+           << "alloc_stack_init is not supported by the sequencer";
   });
 
   DISPATCH_CORE_OPCODE(kAllocHeap, {
@@ -377,7 +424,7 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     auto* allocator = placement.device->allocator();
     ASSIGN_OR_RETURN(
         dst_local->buffer,
-        allocator->Allocate(
+        allocator->AllocateUninitialized(
             hal::MemoryType::kHostLocal | hal::MemoryType::kDeviceVisible,
             hal::BufferUsage::kAll, allocation_size));
   });
@@ -390,12 +437,17 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
 
   DISPATCH_CORE_OPCODE(kComputeRange, {
     ASSIGN_OR_RETURN(auto shape_data, reader.ReadSlotElements<int32_t>());
-    ASSIGN_OR_RETURN(auto element_size, reader.ReadUint8_t());
+    ASSIGN_OR_RETURN(auto element_size, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto indices, reader.ReadSlotElements<int32_t>());
     ASSIGN_OR_RETURN(auto lengths, reader.ReadSlotElements<int32_t>());
     ASSIGN_OR_RETURN(auto* dst_offset_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto* dst_length_local, reader.ReadLocal());
 
+    RETURN_IF_ERROR(
+        command_batch.FlushForHostWrite(dst_offset_local->buffer.get()));
+    RETURN_IF_ERROR(
+        command_batch.FlushForHostWrite(dst_length_local->buffer.get()));
+
     Shape shape(shape_data);
     ASSIGN_OR_RETURN(device_size_t dst_offset,
                      CalculateOffset(indices, shape, element_size));
@@ -427,6 +479,7 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
   DISPATCH_CORE_OPCODE(kShape, {
     ASSIGN_OR_RETURN(auto* src_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    RETURN_IF_ERROR(command_batch.FlushForHostWrite(dst_local->buffer.get()));
     RETURN_IF_ERROR(dst_local->buffer->WriteData(
         0, src_local->shape.subspan().data(),
         src_local->shape.subspan().size() * sizeof(int32_t)));
@@ -435,6 +488,7 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
   DISPATCH_CORE_OPCODE(kLength, {
     ASSIGN_OR_RETURN(auto* src_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    RETURN_IF_ERROR(command_batch.FlushForHostWrite(dst_local->buffer.get()));
     int32_t length = src_local->shape.element_count();
     RETURN_IF_ERROR(dst_local->buffer->WriteData(0, &length, sizeof(int32_t)));
   });
@@ -449,7 +503,7 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     ASSIGN_OR_RETURN(auto offset, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto length, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto type, reader.ReadType());
-    ASSIGN_OR_RETURN(auto shape_data, reader.ReadSlotElements<int32_t>());
+    ASSIGN_OR_RETURN(auto shape_data, reader.ReadIndexList());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     Shape new_shape = Shape{shape_data};
     if (new_shape.element_count() * type.element_size() != length) {
@@ -470,9 +524,9 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto dst_offset_span, reader.ReadSlotElements<int32_t>());
     ASSIGN_OR_RETURN(auto length_span, reader.ReadSlotElements<int32_t>());
-    RETURN_IF_ERROR(dst_local->buffer->CopyData(
-        dst_offset_span.front(), src_local->buffer.get(),
-        src_offset_span.front(), length_span.front()));
+    RETURN_IF_ERROR(command_batch.CopyBuffer(
+        src_local->buffer.get(), src_offset_span.front(),
+        dst_local->buffer.get(), dst_offset_span.front(), length_span.front()));
   });
 
   DISPATCH_CORE_OPCODE(kStaticCopy, {
@@ -481,13 +535,30 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto dst_offset, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto length, reader.ReadInt32());
-    RETURN_IF_ERROR(dst_local->buffer->CopyData(
-        dst_offset, src_local->buffer.get(), src_offset, length));
+    RETURN_IF_ERROR(command_batch.CopyBuffer(src_local->buffer.get(),
+                                             src_offset, dst_local->buffer.get(),
+                                             dst_offset, length));
   });
 
   DISPATCH_CORE_OPCODE(kDynamicFill, {
-    // TODO(b/139299169): implement indirect fills to avoid CPU readback.
-    return UnimplementedErrorBuilder(ABSL_LOC) << "Unimplemented dynamic_fill";
+    // Parameters are read by the device when the fill executes to avoid
+    // flushing the batch for a CPU readback.
+    ASSIGN_OR_RETURN(auto* value_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* dst_offset_local, reader.ReadLocal());
+    ASSIGN_OR_RETURN(auto* length_local, reader.ReadLocal());
+    for (const auto* param_local : {value_local, dst_offset_local,
+                                    length_local}) {
+      if (param_local->element_size != sizeof(int32_t)) {
+        return InvalidArgumentErrorBuilder(ABSL_LOC)
+               << "Dynamic fill parameters must be int32 scalars; got "
+               << static_cast<int>(param_local->element_size)
+               << " byte elements";
+      }
+    }
+    RETURN_IF_ERROR(command_batch.FillBufferIndirect(
+        dst_local->buffer.get(), value_local->buffer.get(),
+        dst_offset_local->buffer.get(), length_local->buffer.get()));
   });
 
   DISPATCH_CORE_OPCODE(kStaticFill, {
@@ -495,7 +566,9 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto dst_offset, reader.ReadInt32());
     ASSIGN_OR_RETURN(auto length, reader.ReadInt32());
-    RETURN_IF_ERROR(dst_local->buffer->Fill32(dst_offset, length, value));
+    RETURN_IF_ERROR(command_batch.FillBuffer(dst_local->buffer.get(),
+                                             dst_offset, length, &value,
+                                             sizeof(value)));
   });
 
   DISPATCH_CORE_OPCODE(kClone, {
@@ -503,11 +576,14 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
     dst_local->element_size = src_local->element_size;
     dst_local->shape = src_local->shape;
-    ASSIGN_OR_RETURN(dst_local->buffer, placement.device->allocator()->Allocate(
-                                            src_local->buffer->memory_type(),
-                                            src_local->buffer->usage(),
-                                            src_local->buffer->byte_length()));
-    RETURN_IF_ERROR(dst_local->buffer->CopyData(0, src_local->buffer.get()));
+    ASSIGN_OR_RETURN(dst_local->buffer,
+                     placement.device->allocator()->AllocateUninitialized(
+                         src_local->buffer->memory_type(),
+                         src_local->buffer->usage(),
+                         src_local->buffer->byte_length()));
+    RETURN_IF_ERROR(command_batch.CopyBuffer(
+        src_local->buffer.get(), 0, dst_local->buffer.get(), 0,
+        src_local->buffer->byte_length()));
   });
 
   DISPATCH_CORE_OPCODE(kAssign, {
@@ -521,6 +597,7 @@ Status DispatchSequence(const hal::DevicePlacement& placement, Stack* stack,
     ASSIGN_OR_RETURN(auto* lhs_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto* rhs_local, reader.ReadLocal());
     ASSIGN_OR_RETURN(auto* dst_local, reader.ReadLocal());
+    RETURN_IF_ERROR(command_batch.FlushForHostRead(cond_local->buffer.get()));
     *dst_local = BufferViewIsTrue(*cond_local) ? *lhs_local : *rhs_local;
   });
 
@@ -14,7 +14,8 @@
 
 #include "third_party/mlir_edge/iree/vm/stack.h"
 
-#include <iterator>
+#include <algorithm>
+#include <vector>
 
 #include "third_party/absl/strings/str_join.h"
 #include "third_party/mlir_edge/iree/base/status.h"
@@ -22,18 +23,34 @@
 namespace iree {
 namespace vm {
 
-constexpr int Stack::kMaxStackDepth;
+constexpr int Stack::kDefaultMaxStackDepth;
+constexpr int Stack::kFrameSegmentSize;
+constexpr size_t Stack::kLocalsBlockSize;
+constexpr size_t Stack::kFrameStorageBlockSize;
+constexpr size_t Stack::kFrameStorageAlignment;
 
-Stack::Stack() = default;
+Stack::Stack(int max_stack_depth) : max_stack_depth_(max_stack_depth) {}
 
 Stack::~Stack() = default;
 
-StatusOr<StackFrame*> Stack::PushFrame(Function function) {
-  if (stack_depth_ + 1 > kMaxStackDepth) {
+StatusOr<absl::Span<hal::BufferView>> Stack::PrepareFrame(int local_count) {
+  if (stack_depth_ + 1 > max_stack_depth_) {
     return InternalErrorBuilder(ABSL_LOC)
-           << "Max stack depth of " << kMaxStackDepth << " exceeded";
+           << "Max stack depth of " << max_stack_depth_ << " exceeded";
+  }
+  if (static_cast<size_t>(stack_depth_) ==
+      frame_segments_.size() * kFrameSegmentSize) {
+    frame_segments_.emplace_back(new StackFrame[kFrameSegmentSize]);
+    frame_marks_.resize(frame_segments_.size() * kFrameSegmentSize);
   }
-  stack_[stack_depth_++] = StackFrame(function);
+  frame_marks_[stack_depth_] = {locals_top_, storage_top_};
+  return AllocateLocals(local_count);
+}
+
+StatusOr<StackFrame*> Stack::PushFrame(Function function) {
+  ASSIGN_OR_RETURN(auto locals,
+                   PrepareFrame(StackFrame::GetLocalCount(function)));
+  *frame_at(stack_depth_++) = StackFrame(function, locals);
 
   // TODO(benvanik): WTF scope enter.
 
@@ -41,11 +58,9 @@ StatusOr<StackFrame*> Stack::PushFrame(Function function) {
 }
 
 StatusOr<StackFrame*> Stack::PushFrame(const ImportFunction& function) {
-  if (stack_depth_ + 1 > kMaxStackDepth) {
-    return InternalErrorBuilder(ABSL_LOC)
-           << "Max stack depth of " << kMaxStackDepth << " exceeded";
-  }
-  stack_[stack_depth_++] = StackFrame(function);
+  ASSIGN_OR_RETURN(auto locals,
+                   PrepareFrame(StackFrame::GetLocalCount(function)));
+  *frame_at(stack_depth_++) = StackFrame(function, locals);
 
   // TODO(benvanik): WTF scope enter.
 
@@ -60,22 +75,100 @@ Status Stack::PopFrame() {
   // TODO(benvanik): WTF scope leave.
 
   --stack_depth_;
+  auto* frame = frame_at(stack_depth_);
+
+  // Drop the references held by the frame locals so that reused stacks don't
+  // keep buffers alive (or reference released frame storage).
+  for (auto& local : frame->mutable_locals()) {
+    local = hal::BufferView();
+  }
+  *frame = StackFrame();
+
+  const auto& frame_marks = frame_marks_[stack_depth_];
+  locals_top_ = frame_marks.locals;
+  storage_top_ = frame_marks.storage;
   return OkStatus();
 }
 
+absl::Span<hal::BufferView> Stack::AllocateLocals(size_t count) {
+  if (count == 0) return {};
+  if (locals_top_.block_index < locals_blocks_.size() &&
+      locals_top_.block_offset > 0 &&
+      locals_top_.block_offset + count >
+          locals_blocks_[locals_top_.block_index].capacity) {
+    // Doesn't fit in the remainder of the current block; move on to the next.
+    ++locals_top_.block_index;
+    locals_top_.block_offset = 0;
+  }
+  if (locals_top_.block_index == locals_blocks_.size()) {
+    locals_blocks_.emplace_back();
+  }
+  auto& block = locals_blocks_[locals_top_.block_index];
+  if (block.capacity < count) {
+    // The block is unused (we are at its start) but too small; replace it.
+    locals_capacity_ -= block.capacity;
+    block.capacity = std::max(count, kLocalsBlockSize);
+    block.locals.reset(new hal::BufferView[block.capacity]);
+    locals_capacity_ += block.capacity;
+  }
+  // Locals are reset when their frame is popped so they are ready for reuse.
+  auto locals = absl::MakeSpan(
+      block.locals.get() + locals_top_.block_offset, count);
+  locals_top_.block_offset += count;
+  return locals;
+}
+
+StatusOr<uint8_t*> Stack::AllocateFrameStorage(size_t length) {
+  if (stack_depth_ == 0) {
+    return FailedPreconditionErrorBuilder(ABSL_LOC)
+           << "Frame storage requires a frame";
+  }
+  length = (length + kFrameStorageAlignment - 1) / kFrameStorageAlignment *
+           kFrameStorageAlignment;
+  if (storage_top_.block_index < storage_blocks_.size() &&
+      storage_top_.block_offset > 0 &&
+      storage_top_.block_offset + length >
+          storage_blocks_[storage_top_.block_index].capacity) {
+    // Doesn't fit in the remainder of the current block; move on to the next.
+    ++storage_top_.block_index;
+    storage_top_.block_offset = 0;
+  }
+  if (storage_top_.block_index == storage_blocks_.size()) {
+    storage_blocks_.emplace_back();
+  }
+  auto& block = storage_blocks_[storage_top_.block_index];
+  if (block.capacity < length) {
+    // The block is unused (we are at its start) but too small; replace it.
+    frame_storage_capacity_ -= block.capacity;
+    block.capacity = std::max(length, kFrameStorageBlockSize);
+    block.allocation.reset(
+        new uint8_t[block.capacity + kFrameStorageAlignment]);
+    auto address = reinterpret_cast<uintptr_t>(block.allocation.get());
+    block.data = reinterpret_cast<uint8_t*>(
+        (address + kFrameStorageAlignment - 1) & ~(kFrameStorageAlignment - 1));
+    frame_storage_capacity_ += block.capacity;
+  }
+  uint8_t* storage = block.data + storage_top_.block_offset;
+  storage_top_.block_offset += length;
+  return storage;
+}
+
 namespace {
 struct StackFrameFormatter {
-  void operator()(std::string* out, const StackFrame& stack_frame) const {
-    out->append(absl::StrCat(stack_frame.module().name(), ":",
-                             stack_frame.function().name(), "@",
-                             stack_frame.offset()));
+  void operator()(std::string* out, const StackFrame* stack_frame) const {
+    out->append(absl::StrCat(stack_frame->module().name(), ":",
+                             stack_frame->function().name(), "@",
+                             stack_frame->offset()));
   }
 };
 }  // namespace
 
 std::string Stack::DebugString() const {
-  return absl::StrJoin(std::begin(stack_), std::begin(stack_) + stack_depth_,
-                       "\n", StackFrameFormatter());
+  std::vector<const StackFrame*> frames(stack_depth_);
+  for (int i = 0; i < stack_depth_; ++i) {
+    frames[i] = frame_at(i);
+  }
+  return absl::StrJoin(frames, "\n", StackFrameFormatter());
 }
 
 }  // namespace vm
@@ -15,7 +15,11 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_VM_STACK_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_VM_STACK_H_
 
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/base/status.h"
@@ -26,45 +30,146 @@ namespace vm {
 
 // VM call stack.
 //
+// Frames are allocated in fixed-size segments as the stack deepens so that
+// deep or recursive call graphs only pay for the depth they use while frame
+// pointers remain stable across pushes. Frame locals are carved from
+// contiguous blocks sized by each function's local count and released in LIFO
+// order when frames are popped.
+//
+// Each frame may also bump-allocate storage for its temporary buffers (such as
+// those from alloc_stack) that is released all at once when the frame is
+// popped.
+//
+// Frame segments, locals blocks, and storage blocks are retained across pushes
+// and pops so that steady-state invocations on a reused stack (such as that of
+// a reused fiber) perform no heap allocations.
+//
 // Stacks are thread-compatible.
 class Stack {
  public:
-  static constexpr int kMaxStackDepth = 32;
+  // Default limit on the number of frames on the stack.
+  static constexpr int kDefaultMaxStackDepth = 1024;
 
-  Stack();
+  explicit Stack(int max_stack_depth = kDefaultMaxStackDepth);
   Stack(const Stack&) = delete;
   Stack& operator=(const Stack&) = delete;
   ~Stack();
 
-  absl::Span<const StackFrame> frames() const {
-    return absl::MakeConstSpan(stack_, stack_depth_);
-  }
-  absl::Span<StackFrame> mutable_frames() {
-    return absl::MakeSpan(stack_, stack_depth_);
+  // Maximum number of frames that may be pushed before PushFrame fails.
+  // May be raised at any time to allow deeper call graphs.
+  int max_stack_depth() const { return max_stack_depth_; }
+  void set_max_stack_depth(int max_stack_depth) {
+    max_stack_depth_ = max_stack_depth;
   }
 
+  // Number of frames currently on the stack.
+  int depth() const { return stack_depth_; }
+
+  // Returns the frame at |index| where 0 is the bottom of the stack.
+  const StackFrame& frame(int index) const { return *frame_at(index); }
+  StackFrame* mutable_frame(int index) { return frame_at(index); }
+
   StackFrame* current_frame() {
-    return stack_depth_ > 0 ? &stack_[stack_depth_ - 1] : nullptr;
+    return stack_depth_ > 0 ? frame_at(stack_depth_ - 1) : nullptr;
   }
   const StackFrame* current_frame() const {
-    return stack_depth_ > 0 ? &stack_[stack_depth_ - 1] : nullptr;
+    return stack_depth_ > 0 ? frame_at(stack_depth_ - 1) : nullptr;
   }
   StackFrame* caller_frame() {
-    return stack_depth_ > 1 ? &stack_[stack_depth_ - 2] : nullptr;
+    return stack_depth_ > 1 ? frame_at(stack_depth_ - 2) : nullptr;
   }
   const StackFrame* caller_frame() const {
-    return stack_depth_ > 1 ? &stack_[stack_depth_ - 2] : nullptr;
+    return stack_depth_ > 1 ? frame_at(stack_depth_ - 2) : nullptr;
   }
 
   StatusOr<StackFrame*> PushFrame(Function function);
   StatusOr<StackFrame*> PushFrame(const ImportFunction& function);
   Status PopFrame();
 
+  // Allocates |length| bytes of uninitialized storage owned by the current
+  // frame. The storage is released when the frame is popped and any buffers
+  // referencing it must not be used after that (including by asynchronous
+  // work).
+  StatusOr<uint8_t*> AllocateFrameStorage(size_t length);
+
+  // Total bytes of storage blocks retained for frame allocations.
+  size_t frame_storage_capacity() const { return frame_storage_capacity_; }
+
+  // Total locals retained in locals blocks.
+  size_t locals_capacity() const { return locals_capacity_; }
+
   std::string DebugString() const;
 
  private:
-  StackFrame stack_[kMaxStackDepth];
+  // Number of frames allocated together as the stack deepens.
+  static constexpr int kFrameSegmentSize = 32;
+  // Number of locals in each locals block. Frames with more locals get a
+  // dedicated block.
+  static constexpr size_t kLocalsBlockSize = 256;
+  // Size of the blocks frame storage is bump-allocated from. Larger
+  // allocations get a dedicated block.
+  static constexpr size_t kFrameStorageBlockSize = 64 * 1024;
+  // Alignment of each frame storage allocation.
+  static constexpr size_t kFrameStorageAlignment = 64;
+
+  struct LocalsBlock {
+    std::unique_ptr<hal::BufferView[]> locals;
+    size_t capacity = 0;
+  };
+
+  struct StorageBlock {
+    std::unique_ptr<uint8_t[]> allocation;
+    // |allocation| rounded up to kFrameStorageAlignment.
+    uint8_t* data = nullptr;
+    size_t capacity = 0;
+  };
+
+  // Position within a list of blocks.
+  struct BlockMark {
+    size_t block_index = 0;
+    size_t block_offset = 0;
+  };
+
+  // Positions of the locals and frame storage tops when a frame was pushed.
+  struct FrameMarks {
+    BlockMark locals;
+    BlockMark storage;
+  };
+
+  StackFrame* frame_at(int index) const {
+    return &frame_segments_[index / kFrameSegmentSize]
+                           [index % kFrameSegmentSize];
+  }
+
+  // Reserves a new frame slot and records the current block marks for it.
+  // Returns the span of |local_count| locals for the frame.
+  StatusOr<absl::Span<hal::BufferView>> PrepareFrame(int local_count);
+
+  // Allocates |count| default-initialized locals for the frame being pushed.
+  absl::Span<hal::BufferView> AllocateLocals(size_t count);
+
+  int max_stack_depth_;
   int stack_depth_ = 0;
+
+  // Frames in segments of kFrameSegmentSize. Segments are never freed while
+  // the stack is alive so frame pointers remain valid as the stack grows.
+  std::vector<std::unique_ptr<StackFrame[]>> frame_segments_;
+  // Block marks at the time each frame was pushed, indexed by depth.
+  std::vector<FrameMarks> frame_marks_;
+
+  // Blocks in allocation order. Blocks after locals_top_.block_index are
+  // unused and kept for reuse.
+  std::vector<LocalsBlock> locals_blocks_;
+  size_t locals_capacity_ = 0;
+  // Next free local in the locals blocks.
+  BlockMark locals_top_;
+
+  // Blocks in allocation order. Blocks after storage_top_.block_index are
+  // unused and kept for reuse.
+  std::vector<StorageBlock> storage_blocks_;
+  size_t frame_storage_capacity_ = 0;
+  // Next free byte in the frame storage blocks.
+  BlockMark storage_top_;
 };
 
 }  // namespace vm
@@ -19,18 +19,26 @@
 namespace iree {
 namespace vm {
 
-StackFrame::StackFrame(Function function) : function_(function) {
+// static
+int StackFrame::GetLocalCount(const Function& function) {
+  const auto* bytecode_def = function.def().bytecode();
+  if (bytecode_def) {
+    return bytecode_def->local_count();
+  }
+  return function.input_count() + function.result_count();
+}
+
+StackFrame::StackFrame(Function function, absl::Span<hal::BufferView> locals)
+    : function_(function), locals_(locals) {
   const auto* bytecode_def = function_.def().bytecode();
   if (bytecode_def) {
     offset_limit_ = bytecode_def->contents()->Length();
-    locals_.resize(bytecode_def->local_count());
-  } else {
-    locals_.resize(function_.input_count() + function_.result_count());
   }
 }
 
-StackFrame::StackFrame(const ImportFunction& function)
-    : function_(function), import_function_(&function) {}
+StackFrame::StackFrame(const ImportFunction& function,
+                       absl::Span<hal::BufferView> locals)
+    : function_(function), import_function_(&function), locals_(locals) {}
 
 Status StackFrame::set_offset(int offset) {
   if (offset < 0 || offset > offset_limit_) {
@@ -15,8 +15,6 @@
 #ifndef THIRD_PARTY_MLIR_EDGE_IREE_VM_STACK_FRAME_H_
 #define THIRD_PARTY_MLIR_EDGE_IREE_VM_STACK_FRAME_H_
 
-#include <vector>
-
 #include "third_party/absl/types/span.h"
 #include "third_party/mlir_edge/iree/hal/buffer_view.h"
 #include "third_party/mlir_edge/iree/vm/function.h"
@@ -32,11 +30,18 @@ namespace vm {
 // possible. This means that most state is stored either entirely within the
 // frame or references to non-pointer values (such as other function indices).
 // BufferViews require special care to allow rendezvous and liveness tracking.
+//
+// Locals are not owned by the frame; they are carved from storage owned by the
+// Stack that must outlive the frame.
 class StackFrame {
  public:
+  // Returns the number of locals a frame for |function| requires.
+  static int GetLocalCount(const Function& function);
+
   StackFrame() = default;
-  explicit StackFrame(Function function);
-  explicit StackFrame(const ImportFunction& function);
+  StackFrame(Function function, absl::Span<hal::BufferView> locals);
+  StackFrame(const ImportFunction& function,
+             absl::Span<hal::BufferView> locals);
   StackFrame(const StackFrame&) = delete;
   StackFrame& operator=(const StackFrame&) = delete;
   StackFrame(StackFrame&&) = default;
@@ -54,21 +59,16 @@ class StackFrame {
     return &locals_[ordinal];
   }
 
-  inline absl::Span<const hal::BufferView> locals() const {
-    return absl::MakeConstSpan(locals_);
-  }
-  inline absl::Span<hal::BufferView> mutable_locals() {
-    return absl::MakeSpan(locals_);
-  }
+  inline absl::Span<const hal::BufferView> locals() const { return locals_; }
+  inline absl::Span<hal::BufferView> mutable_locals() { return locals_; }
 
  private:
   Function function_;
-  const ImportFunction* import_function_;
+  const ImportFunction* import_function_ = nullptr;
   int offset_ = 0;
   int offset_limit_ = 0;
 
-  // TODO(benvanik): replace with a placed allocation.
-  std::vector<hal::BufferView> locals_;
+  absl::Span<hal::BufferView> locals_;
 };
 
 }  // namespace vm